@@ -5,7 +5,7 @@ in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
 in vec3 ViewPos;
-in vec4 FragPosLightSpace;
+in float ViewDepth;
 
 // Material properties
 struct Material {
@@ -14,35 +14,6 @@ struct Material {
     float shininess;
 };
 
-// Point light properties
-struct PointLight {
-    vec3 position;
-    
-    float constant;
-    float linear;
-    float quadratic;
-    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-
-// Spotlight properties
-struct SpotLight {
-    vec3 position;
-    vec3 direction;
-    float cutOff;
-    float outerCutOff;
-    
-    float constant;
-    float linear;
-    float quadratic;
-    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-};
-
 // Directional light properties
 struct DirLight {
     vec3 direction;
@@ -53,22 +24,83 @@ struct DirLight {
 };
 
 uniform Material material;
-uniform PointLight pointLight;
-uniform SpotLight spotLight;
 uniform DirLight dirLight;
 
 uniform vec3 viewPos;
 uniform bool useBlinnPhong;
-uniform bool enableSpotLight;
 uniform bool enableDirLight;
 
 // Shadow mapping uniforms
-uniform sampler2D shadowMap;
-uniform mat4 lightSpaceMatrix;
+uniform sampler2DArray shadowMap;
+uniform sampler2DArrayShadow shadowMapCompare;
 uniform float shadowBias;
 uniform float normalBias;
 uniform int filterMode;
 uniform float shadowMapSize;
+uniform bool shadowDebugView; // Output the raw shadow factor (filter benchmark capture)
+
+// Cascaded shadow map, one array layer per cascade
+const int MAX_CASCADES = 4;
+uniform int cascadeCount;
+uniform float cascadeSplits[MAX_CASCADES];
+uniform mat4 lightSpaceMatrices[MAX_CASCADES];
+
+// Clustered point and spot lights, binned into froxels by ClusteredLighting
+const int CLUSTER_X = 16;  // Must match ClusteredLighting.h
+const int CLUSTER_Y = 9;
+const int CLUSTER_Z = 24;
+uniform samplerBuffer clusterLights;    // Four texels per light
+uniform usamplerBuffer clusterRecords;  // Index offset and count per froxel
+uniform usamplerBuffer clusterIndices;
+uniform int clusterLightCount;
+uniform vec2 clusterTileSize;
+uniform float clusterDepthScale;
+uniform float clusterDepthBias;
+
+int ClusterIndex(float viewDepth) {
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / clusterTileSize), ivec2(0), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+    int slice = clamp(int(floor(log(max(viewDepth, 1e-4)) * clusterDepthScale + clusterDepthBias)), 0, CLUSTER_Z - 1);
+    return tile.x + CLUSTER_X * (tile.y + CLUSTER_Y * slice);
+}
+
+// Sum the lights of this fragment's froxel (Blinn-Phong specular)
+vec3 CalcClusteredLights(vec3 normal, vec3 fragPos, vec3 viewDir, float viewDepth,
+                         vec3 albedo, vec3 specularColor, float shininess) {
+    vec3 result = vec3(0.0);
+    if (clusterLightCount == 0) {
+        return result;
+    }
+    uvec2 record = texelFetch(clusterRecords, ClusterIndex(viewDepth)).rg;
+    for (uint i = 0u; i < record.y; ++i) {
+        int base = int(texelFetch(clusterIndices, int(record.x + i)).r) * 4;
+        vec4 positionRadius = texelFetch(clusterLights, base);
+        vec4 colorAmbient = texelFetch(clusterLights, base + 1);
+        vec4 directionOuter = texelFetch(clusterLights, base + 2);
+        vec4 innerAttenuation = texelFetch(clusterLights, base + 3);
+
+        vec3 toLight = positionRadius.xyz - fragPos;
+        float distance = length(toLight);
+        if (distance >= positionRadius.w) {
+            continue;
+        }
+        vec3 lightDir = toLight / max(distance, 1e-4);
+
+        // Fade to zero at the binning radius so froxel borders never show
+        float window = clamp(1.0 - pow(distance / positionRadius.w, 4.0), 0.0, 1.0);
+        float attenuation = window * window /
+            (1.0 + innerAttenuation.y * distance + innerAttenuation.z * distance * distance);
+
+        // Point lights carry a cone wider than the sphere, so intensity is 1
+        float theta = dot(lightDir, -directionOuter.xyz);
+        float intensity = clamp((theta - directionOuter.w) / (innerAttenuation.x - directionOuter.w), 0.0, 1.0);
+
+        float diff = max(dot(normal, lightDir), 0.0);
+        float spec = pow(max(dot(normal, normalize(lightDir + viewDir)), 0.0), shininess);
+        vec3 lit = colorAmbient.a * albedo + intensity * (diff * albedo + spec * specularColor);
+        result += colorAmbient.rgb * attenuation * lit;
+    }
+    return result;
+}
 
 // Filter mode constants
 const int FILTER_NEAREST = 0;
@@ -76,32 +108,91 @@ const int FILTER_LINEAR = 1;
 const int FILTER_PCF_2x2 = 2;
 const int FILTER_PCF_3x3 = 3;
 const int FILTER_PCF_5x5 = 4;
+const int FILTER_HARDWARE_PCF = 5;
+const int FILTER_HARDWARE_PCF_3x3 = 6;
+const int FILTER_POISSON_DISK = 7;
+
+// Poisson disk kernel (unit radius), rotated per pixel
+const int POISSON_TAPS = 8;
+const float POISSON_RADIUS = 2.0; // In texels
+const vec2 POISSON_DISK[POISSON_TAPS] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2( 0.94558609, -0.76890725),
+    vec2(-0.09418410, -0.92938870), vec2( 0.34495938,  0.29387760),
+    vec2(-0.91588581,  0.45771432), vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543,  0.27676845), vec2( 0.97484398,  0.75648379)
+);
+
+// Per-pixel rotation angle from interleaved gradient noise
+float PoissonRotation(vec2 fragCoord) {
+    return 6.2831853 * fract(52.9829189 * fract(dot(fragCoord, vec2(0.06711056, 0.00583715))));
+}
+
+// Pick the first cascade whose split distance covers this depth
+int SelectCascade(float viewDepth) {
+    for (int i = 0; i < cascadeCount - 1; ++i) {
+        if (viewDepth < cascadeSplits[i]) {
+            return i;
+        }
+    }
+    return cascadeCount - 1;
+}
 
 // Shadow calculation function
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir) {
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    projCoords = projCoords * 0.5 + 0.5;
-    if (projCoords.z > 1.0 || projCoords.x < 0.0 || projCoords.x > 1.0 ||
-        projCoords.y < 0.0 || projCoords.y > 1.0) {
+float ShadowCalculation(vec3 worldPos, vec3 normal, vec3 lightDir) {
+    // Fall through to the next cascade if a lagging cascade misses the fragment
+    vec3 projCoords = vec3(2.0);
+    int layer = SelectCascade(ViewDepth);
+    for (; layer < cascadeCount; ++layer) {
+        vec4 fragPosLightSpace = lightSpaceMatrices[layer] * vec4(worldPos, 1.0);
+        projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+        if (projCoords.x >= 0.0 && projCoords.x <= 1.0 &&
+            projCoords.y >= 0.0 && projCoords.y <= 1.0) {
+            break;
+        }
+    }
+    if (layer >= cascadeCount || projCoords.z > 1.0) {
         return 0.0;
     }
     float currentDepth = projCoords.z;
+    float cascade = float(layer);
     float bias = max(shadowBias * (1.0 - max(dot(normal, lightDir), 0.0)), shadowBias * 0.1);
     float shadow = 0.0;
     if (filterMode == FILTER_NEAREST) {
-        float closestDepth = texture(shadowMap, projCoords.xy).r;
+        float closestDepth = texture(shadowMap, vec3(projCoords.xy, cascade)).r;
         shadow = currentDepth - bias > closestDepth ? 1.0 : 0.0;
     } else if (filterMode == FILTER_LINEAR) {
-        float closestDepth = texture(shadowMap, projCoords.xy).r;
+        float closestDepth = texture(shadowMap, vec3(projCoords.xy, cascade)).r;
         shadow = currentDepth - bias > closestDepth ? 1.0 : 0.0;
+    } else if (filterMode == FILTER_HARDWARE_PCF) {
+        // Comparison samplers return the lit fraction
+        shadow = 1.0 - texture(shadowMapCompare, vec4(projCoords.xy, cascade, currentDepth - bias));
+    } else if (filterMode == FILTER_HARDWARE_PCF_3x3) {
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMapCompare, 0).xy);
+        float lit = 0.0;
+        lit += texture(shadowMapCompare, vec4(projCoords.xy + vec2(-0.5, -0.5) * texelSize, cascade, currentDepth - bias));
+        lit += texture(shadowMapCompare, vec4(projCoords.xy + vec2( 0.5, -0.5) * texelSize, cascade, currentDepth - bias));
+        lit += texture(shadowMapCompare, vec4(projCoords.xy + vec2(-0.5,  0.5) * texelSize, cascade, currentDepth - bias));
+        lit += texture(shadowMapCompare, vec4(projCoords.xy + vec2( 0.5,  0.5) * texelSize, cascade, currentDepth - bias));
+        shadow = 1.0 - lit * 0.25;
+    } else if (filterMode == FILTER_POISSON_DISK) {
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMapCompare, 0).xy);
+        float angle = PoissonRotation(gl_FragCoord.xy);
+        mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+        float lit = 0.0;
+        for (int i = 0; i < POISSON_TAPS; ++i) {
+            vec2 offset = rotation * POISSON_DISK[i] * POISSON_RADIUS * texelSize;
+            lit += texture(shadowMapCompare, vec4(projCoords.xy + offset, cascade, currentDepth - bias));
+        }
+        shadow = 1.0 - lit / float(POISSON_TAPS);
     } else {
-        vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
-        int kernelSize = (filterMode == FILTER_PCF_5x5) ? 2 : 1;
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
+        int kernelMin = (filterMode == FILTER_PCF_5x5) ? -2 : ((filterMode == FILTER_PCF_2x2) ? 0 : -1);
+        int kernelMax = (filterMode == FILTER_PCF_5x5) ? 2 : 1;
         int sampleCount = 0;
-        for(int x = -kernelSize; x <= kernelSize; ++x) {
-            for(int y = -kernelSize; y <= kernelSize; ++y) {
+        for(int x = kernelMin; x <= kernelMax; ++x) {
+            for(int y = kernelMin; y <= kernelMax; ++y) {
                 vec2 offset = vec2(x, y) * texelSize;
-                float pcfDepth = texture(shadowMap, projCoords.xy + offset).r;
+                float pcfDepth = texture(shadowMap, vec3(projCoords.xy + offset, cascade)).r;
                 shadow += currentDepth - bias > pcfDepth ? 1.0 : 0.0;
                 sampleCount++;
             }
@@ -113,8 +204,6 @@ float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir) {
 
 // Function declarations
 vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
 
 void main()
 {
@@ -129,18 +218,20 @@ void main()
     vec3 mainLightDir = vec3(0.0);
     if (enableDirLight) {
         mainLightDir = normalize(-dirLight.direction);
-        shadow = ShadowCalculation(FragPosLightSpace, norm, mainLightDir);
+        shadow = ShadowCalculation(FragPos, norm, mainLightDir);
         result += (1.0 - shadow) * CalcDirLight(dirLight, norm, viewDir);
     }
     
-    // Point light
-    result += CalcPointLight(pointLight, norm, FragPos, viewDir);
-    
-    // Spotlight
-    if (enableSpotLight) {
-        result += CalcSpotLight(spotLight, norm, FragPos, viewDir);
+    if (shadowDebugView) {
+        FragColor = vec4(vec3(1.0 - shadow), 1.0);
+        return;
     }
     
+    // Point and spot lights of this froxel
+    result += CalcClusteredLights(norm, FragPos, viewDir, ViewDepth,
+                                  vec3(texture(material.diffuse, TexCoord)),
+                                  vec3(texture(material.specular, TexCoord)), material.shininess);
+    
     FragColor = vec4(result, 1.0);
 }
 
@@ -171,84 +262,3 @@ vec3 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
     
     return (ambient + diffuse + specular);
 }
-
-// Calculate point light
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
-{
-    vec3 lightDir = normalize(light.position - fragPos);
-    
-    // Diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    
-    // Specular shading
-    float spec;
-    if (useBlinnPhong) {
-        // Blinn-Phong
-        vec3 halfwayDir = normalize(lightDir + viewDir);
-        spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
-    } else {
-        // Standard Phong
-        vec3 reflectDir = reflect(-lightDir, normal);
-        spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    }
-    
-    // Attenuation
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
-    
-    // Combine results
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoord));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoord));
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoord));
-    
-    ambient *= attenuation;
-    diffuse *= attenuation;
-    specular *= attenuation;
-    
-    return (ambient + diffuse + specular);
-}
-
-// Calculate spotlight
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
-{
-    vec3 lightDir = normalize(light.position - fragPos);
-    
-    // Diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    
-    // Specular shading
-    float spec;
-    if (useBlinnPhong) {
-        // Blinn-Phong
-        vec3 halfwayDir = normalize(lightDir + viewDir);
-        spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
-    } else {
-        // Standard Phong
-        vec3 reflectDir = reflect(-lightDir, normal);
-        spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    }
-    
-    // Spotlight intensity
-    float theta = dot(lightDir, normalize(-light.direction));
-    float epsilon = light.cutOff - light.outerCutOff;
-    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
-    
-    // Attenuation
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
-    
-    // Combine results
-    vec3 ambient = light.ambient * vec3(texture(material.diffuse, TexCoord));
-    vec3 diffuse = light.diffuse * diff * vec3(texture(material.diffuse, TexCoord));
-    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoord));
-    
-    // Apply spotlight intensity (ambient light not affected)
-    diffuse *= intensity;
-    specular *= intensity;
-    
-    ambient *= attenuation;
-    diffuse *= attenuation;
-    specular *= attenuation;
-    
-    return (ambient + diffuse + specular);
-}
@@ -7,13 +7,15 @@ out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 out vec3 ViewPos;
-out vec4 FragPosLightSpace;
+out float ViewDepth;
+
+// Shared with depth_prepass.vert so the GL_EQUAL colour pass matches
+invariant gl_Position;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform vec3 viewPos;
-uniform mat4 lightSpaceMatrix;
 
 void main()
 {
@@ -21,7 +23,7 @@ void main()
     Normal = mat3(transpose(inverse(model))) * aNormal;
     TexCoord = aTexCoord;
     ViewPos = viewPos;
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
+    ViewDepth = -(view * vec4(FragPos, 1.0)).z;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
@@ -0,0 +1,16 @@
+#version 410 core
+// Position-only path for the depth pre-pass and overdraw view. gl_Position must
+// match the lit vertex shaders exactly, so the expression is kept identical.
+layout (location = 0) in vec3 aPos;
+
+invariant gl_Position;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+void main()
+{
+    vec3 worldPos = vec3(model * vec4(aPos, 1.0));
+    gl_Position = projection * view * vec4(worldPos, 1.0);
+}
@@ -0,0 +1,8 @@
+#version 410 core
+// Overdraw view: blended additively, so each shaded layer brightens the pixel by one step
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(0.12, 0.05, 0.02, 1.0);
+}
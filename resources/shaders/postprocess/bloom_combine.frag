@@ -0,0 +1,15 @@
+#version 410 core
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D sceneTexture;
+uniform sampler2D bloomTexture;
+uniform float bloomIntensity;
+
+void main() {
+    vec3 sceneColor = texture(sceneTexture, TexCoord).rgb;
+    vec3 bloomColor = texture(bloomTexture, TexCoord).rgb;
+
+    // Stay in HDR, tone mapping runs afterwards
+    FragColor = vec4(sceneColor + bloomColor * bloomIntensity, 1.0);
+}
@@ -0,0 +1,19 @@
+#version 410 core
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D sourceTexture;
+uniform vec2 sourceTexelSize;
+
+// Dual-filter (Kawase) downsample: 5 bilinear taps cover a 4x4 texel area
+void main() {
+    vec2 halfPixel = 0.5 * sourceTexelSize;
+
+    vec3 sum = texture(sourceTexture, TexCoord).rgb * 4.0;
+    sum += texture(sourceTexture, TexCoord - halfPixel).rgb;
+    sum += texture(sourceTexture, TexCoord + halfPixel).rgb;
+    sum += texture(sourceTexture, TexCoord + vec2(halfPixel.x, -halfPixel.y)).rgb;
+    sum += texture(sourceTexture, TexCoord - vec2(halfPixel.x, -halfPixel.y)).rgb;
+
+    FragColor = vec4(sum / 8.0, 1.0);
+}
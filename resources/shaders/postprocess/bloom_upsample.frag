@@ -0,0 +1,22 @@
+#version 410 core
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D sourceTexture;
+uniform vec2 sourceTexelSize;
+
+// Dual-filter (Kawase) upsample: 8-tap tent, additively blended into the larger mip
+void main() {
+    vec2 halfPixel = 0.5 * sourceTexelSize;
+
+    vec3 sum = texture(sourceTexture, TexCoord + vec2(-halfPixel.x * 2.0, 0.0)).rgb;
+    sum += texture(sourceTexture, TexCoord + vec2(-halfPixel.x, halfPixel.y)).rgb * 2.0;
+    sum += texture(sourceTexture, TexCoord + vec2(0.0, halfPixel.y * 2.0)).rgb;
+    sum += texture(sourceTexture, TexCoord + vec2(halfPixel.x, halfPixel.y)).rgb * 2.0;
+    sum += texture(sourceTexture, TexCoord + vec2(halfPixel.x * 2.0, 0.0)).rgb;
+    sum += texture(sourceTexture, TexCoord + vec2(halfPixel.x, -halfPixel.y)).rgb * 2.0;
+    sum += texture(sourceTexture, TexCoord + vec2(0.0, -halfPixel.y * 2.0)).rgb;
+    sum += texture(sourceTexture, TexCoord + vec2(-halfPixel.x, -halfPixel.y)).rgb * 2.0;
+
+    FragColor = vec4(sum / 12.0, 1.0);
+}
@@ -0,0 +1,50 @@
+#version 410 core
+in vec2 TexCoord;
+out vec4 FragColor;
+
+uniform sampler2D sourceTexture;
+uniform vec2 sourceTexelSize;
+uniform float threshold;
+uniform float softKnee;
+uniform bool useKarisAverage;
+
+// Soft-knee bright pass: smooth ramp into the threshold instead of a hard cut
+vec3 BrightPass(vec3 color) {
+    float brightness = max(color.r, max(color.g, color.b));
+    float knee = threshold * softKnee + 1e-5;
+    float soft = clamp(brightness - threshold + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee);
+    float contribution = max(soft, brightness - threshold) / max(brightness, 1e-5);
+    return color * contribution;
+}
+
+// Karis average weight, keeps single bright texels from flickering
+float KarisWeight(vec3 color) {
+    float luma = dot(color, vec3(0.2126, 0.7152, 0.0722));
+    return 1.0 / (1.0 + luma);
+}
+
+void main() {
+    // Dual-filter downsample: centre plus four diagonal half-texel taps
+    vec2 halfPixel = 0.5 * sourceTexelSize;
+    vec3 taps[5];
+    taps[0] = texture(sourceTexture, TexCoord).rgb;
+    taps[1] = texture(sourceTexture, TexCoord - halfPixel).rgb;
+    taps[2] = texture(sourceTexture, TexCoord + halfPixel).rgb;
+    taps[3] = texture(sourceTexture, TexCoord + vec2(halfPixel.x, -halfPixel.y)).rgb;
+    taps[4] = texture(sourceTexture, TexCoord - vec2(halfPixel.x, -halfPixel.y)).rgb;
+
+    vec3 sum = vec3(0.0);
+    float weightSum = 0.0;
+    for (int i = 0; i < 5; ++i) {
+        vec3 color = BrightPass(taps[i]);
+        float weight = (i == 0) ? 4.0 : 1.0;
+        if (useKarisAverage) {
+            weight *= KarisWeight(color);
+        }
+        sum += color * weight;
+        weightSum += weight;
+    }
+
+    FragColor = vec4(sum / weightSum, 1.0);
+}
@@ -5,11 +5,12 @@ out vec4 FragColor;
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
-in vec4 FragPosLightSpace;
+in float ViewDepth;
 
 // Material properties
 uniform sampler2D texture_diffuse1;
-uniform sampler2D shadowMap;
+uniform sampler2DArray shadowMap;
+uniform sampler2DArrayShadow shadowMapCompare;
 
 // Lighting properties
 uniform vec3 lightPos;
@@ -22,7 +23,13 @@ uniform float shadowBias;
 uniform float normalBias;
 uniform int filterMode;
 uniform float shadowMapSize;
-uniform mat4 lightSpaceMatrix;
+uniform bool shadowDebugView; // Output the raw shadow factor (filter benchmark capture)
+
+// Cascaded shadow map, one array layer per cascade
+const int MAX_CASCADES = 4;
+uniform int cascadeCount;
+uniform float cascadeSplits[MAX_CASCADES];
+uniform mat4 lightSpaceMatrices[MAX_CASCADES];
 
 // Filter mode constants
 const int FILTER_NEAREST = 0;
@@ -30,60 +37,128 @@ const int FILTER_LINEAR = 1;
 const int FILTER_PCF_2x2 = 2;
 const int FILTER_PCF_3x3 = 3;
 const int FILTER_PCF_5x5 = 4;
+const int FILTER_HARDWARE_PCF = 5;
+const int FILTER_HARDWARE_PCF_3x3 = 6;
+const int FILTER_POISSON_DISK = 7;
+
+// Poisson disk kernel (unit radius), rotated per pixel
+const int POISSON_TAPS = 8;
+const float POISSON_RADIUS = 2.0; // In texels
+const vec2 POISSON_DISK[POISSON_TAPS] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2( 0.94558609, -0.76890725),
+    vec2(-0.09418410, -0.92938870), vec2( 0.34495938,  0.29387760),
+    vec2(-0.91588581,  0.45771432), vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543,  0.27676845), vec2( 0.97484398,  0.75648379)
+);
+
+// Per-pixel rotation angle from interleaved gradient noise
+float PoissonRotation(vec2 fragCoord) {
+    return 6.2831853 * fract(52.9829189 * fract(dot(fragCoord, vec2(0.06711056, 0.00583715))));
+}
+
+/**
+ * Pick the first cascade whose split distance covers this depth
+ */
+int SelectCascade(float viewDepth)
+{
+    for (int i = 0; i < cascadeCount - 1; ++i) {
+        if (viewDepth < cascadeSplits[i]) {
+            return i;
+        }
+    }
+    return cascadeCount - 1;
+}
 
 /**
  * Calculate shadow value
- * @param projCoords Projection coordinates
+ * @param worldPos World position (already offset along the normal)
  * @param bias Depth bias
  * @return Shadow value (0.0 = completely in shadow, 1.0 = completely lit)
  */
-float ShadowCalculation(vec4 fragPosLightSpace, float bias)
+float ShadowCalculation(vec3 worldPos, float bias)
 {
-    // Perform perspective division
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    
-    // Transform to [0,1] range
-    projCoords = projCoords * 0.5 + 0.5;
+    // Cascades refreshed less often than every frame can lag the camera,
+    // so fall through to the next cascade if the fragment left this one
+    vec3 projCoords = vec3(2.0);
+    int layer = SelectCascade(ViewDepth);
+    for (; layer < cascadeCount; ++layer) {
+        vec4 fragPosLightSpace = lightSpaceMatrices[layer] * vec4(worldPos, 1.0);
+        projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+        if (projCoords.x >= 0.0 && projCoords.x <= 1.0 &&
+            projCoords.y >= 0.0 && projCoords.y <= 1.0) {
+            break;
+        }
+    }
     
-    // If outside shadow map range, consider not in shadow
-    if (projCoords.z > 1.0 || projCoords.x < 0.0 || projCoords.x > 1.0 || 
-        projCoords.y < 0.0 || projCoords.y > 1.0) {
+    // If outside every cascade, consider not in shadow
+    if (layer >= cascadeCount || projCoords.z > 1.0) {
         return 1.0;
     }
     
     // Get current fragment depth
     float currentDepth = projCoords.z;
+    float cascade = float(layer);
     
     // Choose shadow calculation method based on filter mode
     if (filterMode == FILTER_NEAREST) {
         // Nearest neighbor filtering - hard shadows
-        float closestDepth = texture(shadowMap, projCoords.xy).r;
+        float closestDepth = texture(shadowMap, vec3(projCoords.xy, cascade)).r;
         return currentDepth - bias > closestDepth ? 0.0 : 1.0;
     }
     else if (filterMode == FILTER_LINEAR) {
         // Linear filtering
-        float closestDepth = texture(shadowMap, projCoords.xy).r;
+        float closestDepth = texture(shadowMap, vec3(projCoords.xy, cascade)).r;
         return currentDepth - bias > closestDepth ? 0.0 : 1.0;
     }
+    else if (filterMode == FILTER_HARDWARE_PCF) {
+        // One comparison fetch, bilinearly filtered by the texture unit (2x2 PCF)
+        return texture(shadowMapCompare, vec4(projCoords.xy, cascade, currentDepth - bias));
+    }
+    else if (filterMode == FILTER_HARDWARE_PCF_3x3) {
+        // Four bilinear comparison fetches cover a 3x3 texel footprint
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMapCompare, 0).xy);
+        float shadow = 0.0;
+        shadow += texture(shadowMapCompare, vec4(projCoords.xy + vec2(-0.5, -0.5) * texelSize, cascade, currentDepth - bias));
+        shadow += texture(shadowMapCompare, vec4(projCoords.xy + vec2( 0.5, -0.5) * texelSize, cascade, currentDepth - bias));
+        shadow += texture(shadowMapCompare, vec4(projCoords.xy + vec2(-0.5,  0.5) * texelSize, cascade, currentDepth - bias));
+        shadow += texture(shadowMapCompare, vec4(projCoords.xy + vec2( 0.5,  0.5) * texelSize, cascade, currentDepth - bias));
+        return shadow * 0.25;
+    }
+    else if (filterMode == FILTER_POISSON_DISK) {
+        // Rotated Poisson taps trade banding for fine noise
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMapCompare, 0).xy);
+        float angle = PoissonRotation(gl_FragCoord.xy);
+        mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+        float shadow = 0.0;
+        for (int i = 0; i < POISSON_TAPS; ++i) {
+            vec2 offset = rotation * POISSON_DISK[i] * POISSON_RADIUS * texelSize;
+            shadow += texture(shadowMapCompare, vec4(projCoords.xy + offset, cascade, currentDepth - bias));
+        }
+        return shadow / float(POISSON_TAPS);
+    }
     else {
         // PCF (Percentage Closer Filtering) soft shadows
         float shadow = 0.0;
-        vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
         
-        int kernelSize;
+        int kernelMin;
+        int kernelMax;
         if (filterMode == FILTER_PCF_2x2) {
-            kernelSize = 1;
+            kernelMin = 0;
+            kernelMax = 1;
         } else if (filterMode == FILTER_PCF_3x3) {
-            kernelSize = 1;
+            kernelMin = -1;
+            kernelMax = 1;
         } else { // FILTER_PCF_5x5
-            kernelSize = 2;
+            kernelMin = -2;
+            kernelMax = 2;
         }
         
         int sampleCount = 0;
-        for(int x = -kernelSize; x <= kernelSize; ++x) {
-            for(int y = -kernelSize; y <= kernelSize; ++y) {
+        for(int x = kernelMin; x <= kernelMax; ++x) {
+            for(int y = kernelMin; y <= kernelMax; ++y) {
                 vec2 offset = vec2(x, y) * texelSize;
-                float pcfDepth = texture(shadowMap, projCoords.xy + offset).r;
+                float pcfDepth = texture(shadowMap, vec3(projCoords.xy + offset, cascade)).r;
                 shadow += currentDepth - bias > pcfDepth ? 0.0 : 1.0;
                 sampleCount++;
             }
@@ -132,10 +207,14 @@ void main()
     
     // Add normal bias to reduce shadow artifacts
     vec3 offsetPos = FragPos + normal * normalBias;
-    vec4 offsetLightSpace = lightSpaceMatrix * vec4(offsetPos, 1.0);
     
     // Calculate shadow value
-    float shadow = ShadowCalculation(offsetLightSpace, bias);
+    float shadow = ShadowCalculation(offsetPos, bias);
+    
+    if (shadowDebugView) {
+        FragColor = vec4(vec3(shadow), 1.0);
+        return;
+    }
     
     // Apply shadow: ambient light not affected by shadow, diffuse and specular affected by shadow
     vec3 ambient = 0.15 * color;
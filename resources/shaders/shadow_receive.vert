@@ -7,12 +7,11 @@ layout (location = 2) in vec2 aTexCoord;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
-out vec4 FragPosLightSpace;
+out float ViewDepth;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
 uniform mat3 normalMatrix;
 
 void main()
@@ -26,8 +25,8 @@ void main()
     // Pass texture coordinates
     TexCoord = aTexCoord;
     
-    // Calculate position in light space
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
+    // View-space depth selects the shadow cascade
+    ViewDepth = -(view * vec4(FragPos, 1.0)).z;
     
     // Calculate final vertex position
     gl_Position = projection * view * vec4(FragPos, 1.0);
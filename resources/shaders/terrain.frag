@@ -6,6 +6,7 @@ in vec3 Normal;
 in vec2 TexCoord;
 in vec3 VertexColor;
 in vec4 FragPosLightSpace;
+in float ViewDepth;
 
 uniform vec3 lightPos;
 uniform vec3 lightColor;
@@ -26,6 +27,63 @@ const int FILTER_PCF_2x2 = 2;
 const int FILTER_PCF_3x3 = 3;
 const int FILTER_PCF_5x5 = 4;
 
+// Clustered point and spot lights, binned into froxels by ClusteredLighting
+const int CLUSTER_X = 16;  // Must match ClusteredLighting.h
+const int CLUSTER_Y = 9;
+const int CLUSTER_Z = 24;
+uniform samplerBuffer clusterLights;    // Four texels per light
+uniform usamplerBuffer clusterRecords;  // Index offset and count per froxel
+uniform usamplerBuffer clusterIndices;
+uniform int clusterLightCount;
+uniform vec2 clusterTileSize;
+uniform float clusterDepthScale;
+uniform float clusterDepthBias;
+
+int ClusterIndex(float viewDepth) {
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / clusterTileSize), ivec2(0), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+    int slice = clamp(int(floor(log(max(viewDepth, 1e-4)) * clusterDepthScale + clusterDepthBias)), 0, CLUSTER_Z - 1);
+    return tile.x + CLUSTER_X * (tile.y + CLUSTER_Y * slice);
+}
+
+// Sum the lights of this fragment's froxel (Blinn-Phong specular)
+vec3 CalcClusteredLights(vec3 normal, vec3 fragPos, vec3 viewDir, float viewDepth,
+                         vec3 albedo, vec3 specularColor, float shininess) {
+    vec3 result = vec3(0.0);
+    if (clusterLightCount == 0) {
+        return result;
+    }
+    uvec2 record = texelFetch(clusterRecords, ClusterIndex(viewDepth)).rg;
+    for (uint i = 0u; i < record.y; ++i) {
+        int base = int(texelFetch(clusterIndices, int(record.x + i)).r) * 4;
+        vec4 positionRadius = texelFetch(clusterLights, base);
+        vec4 colorAmbient = texelFetch(clusterLights, base + 1);
+        vec4 directionOuter = texelFetch(clusterLights, base + 2);
+        vec4 innerAttenuation = texelFetch(clusterLights, base + 3);
+
+        vec3 toLight = positionRadius.xyz - fragPos;
+        float distance = length(toLight);
+        if (distance >= positionRadius.w) {
+            continue;
+        }
+        vec3 lightDir = toLight / max(distance, 1e-4);
+
+        // Fade to zero at the binning radius so froxel borders never show
+        float window = clamp(1.0 - pow(distance / positionRadius.w, 4.0), 0.0, 1.0);
+        float attenuation = window * window /
+            (1.0 + innerAttenuation.y * distance + innerAttenuation.z * distance * distance);
+
+        // Point lights carry a cone wider than the sphere, so intensity is 1
+        float theta = dot(lightDir, -directionOuter.xyz);
+        float intensity = clamp((theta - directionOuter.w) / (innerAttenuation.x - directionOuter.w), 0.0, 1.0);
+
+        float diff = max(dot(normal, lightDir), 0.0);
+        float spec = pow(max(dot(normal, normalize(lightDir + viewDir)), 0.0), shininess);
+        vec3 lit = colorAmbient.a * albedo + intensity * (diff * albedo + spec * specularColor);
+        result += colorAmbient.rgb * attenuation * lit;
+    }
+    return result;
+}
+
 float ShadowCalculation(vec4 fragPosLightSpace, float bias)
 {
     vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
@@ -90,6 +148,7 @@ void main()
 
     // Combine lighting with shadow and vertex color (biome color)
     vec3 result = (ambient + shadow * (diffuse + specular)) * VertexColor;
+    result += CalcClusteredLights(norm, FragPos, viewDir, ViewDepth, VertexColor, vec3(0.2), 32.0);
 
     // Add slight fog based on distance for atmosphere
     float distance = length(viewPos - FragPos);
@@ -9,6 +9,10 @@ out vec3 Normal;
 out vec2 TexCoord;
 out vec3 VertexColor;
 out vec4 FragPosLightSpace;
+out float ViewDepth;
+
+// Shared with depth_prepass.vert so the GL_EQUAL colour pass matches
+invariant gl_Position;
 
 uniform mat4 model;
 uniform mat4 view;
@@ -22,6 +26,7 @@ void main()
     TexCoord = aTexCoord;
     VertexColor = aColor;
     FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
+    ViewDepth = -(view * vec4(FragPos, 1.0)).z;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
 }
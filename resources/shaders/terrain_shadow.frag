@@ -6,10 +6,15 @@ in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
 in vec3 VertexColor;
-in vec4 FragPosLightSpace;
+in float ViewDepth;
 
-// Shadow map
-uniform sampler2D shadowMap;
+// Cascaded shadow map, one array layer per cascade
+const int MAX_CASCADES = 4;
+uniform sampler2DArray shadowMap;
+uniform sampler2DArrayShadow shadowMapCompare;
+uniform int cascadeCount;
+uniform float cascadeSplits[MAX_CASCADES];
+uniform mat4 lightSpaceMatrices[MAX_CASCADES];
 
 // Lighting properties
 uniform vec3 lightPos;
@@ -21,6 +26,7 @@ uniform float shadowBias;
 uniform float normalBias;
 uniform int filterMode;
 uniform float shadowMapSize;
+uniform bool shadowDebugView; // Output the raw shadow factor (filter benchmark capture)
 
 // Filter mode constants
 const int FILTER_NEAREST = 0;
@@ -28,60 +34,182 @@ const int FILTER_LINEAR = 1;
 const int FILTER_PCF_2x2 = 2;
 const int FILTER_PCF_3x3 = 3;
 const int FILTER_PCF_5x5 = 4;
+const int FILTER_HARDWARE_PCF = 5;
+const int FILTER_HARDWARE_PCF_3x3 = 6;
+const int FILTER_POISSON_DISK = 7;
+
+// Clustered point and spot lights, binned into froxels by ClusteredLighting
+const int CLUSTER_X = 16;  // Must match ClusteredLighting.h
+const int CLUSTER_Y = 9;
+const int CLUSTER_Z = 24;
+uniform samplerBuffer clusterLights;    // Four texels per light
+uniform usamplerBuffer clusterRecords;  // Index offset and count per froxel
+uniform usamplerBuffer clusterIndices;
+uniform int clusterLightCount;
+uniform vec2 clusterTileSize;
+uniform float clusterDepthScale;
+uniform float clusterDepthBias;
+
+int ClusterIndex(float viewDepth) {
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy / clusterTileSize), ivec2(0), ivec2(CLUSTER_X - 1, CLUSTER_Y - 1));
+    int slice = clamp(int(floor(log(max(viewDepth, 1e-4)) * clusterDepthScale + clusterDepthBias)), 0, CLUSTER_Z - 1);
+    return tile.x + CLUSTER_X * (tile.y + CLUSTER_Y * slice);
+}
+
+// Sum the lights of this fragment's froxel (Blinn-Phong specular)
+vec3 CalcClusteredLights(vec3 normal, vec3 fragPos, vec3 viewDir, float viewDepth,
+                         vec3 albedo, vec3 specularColor, float shininess) {
+    vec3 result = vec3(0.0);
+    if (clusterLightCount == 0) {
+        return result;
+    }
+    uvec2 record = texelFetch(clusterRecords, ClusterIndex(viewDepth)).rg;
+    for (uint i = 0u; i < record.y; ++i) {
+        int base = int(texelFetch(clusterIndices, int(record.x + i)).r) * 4;
+        vec4 positionRadius = texelFetch(clusterLights, base);
+        vec4 colorAmbient = texelFetch(clusterLights, base + 1);
+        vec4 directionOuter = texelFetch(clusterLights, base + 2);
+        vec4 innerAttenuation = texelFetch(clusterLights, base + 3);
+
+        vec3 toLight = positionRadius.xyz - fragPos;
+        float distance = length(toLight);
+        if (distance >= positionRadius.w) {
+            continue;
+        }
+        vec3 lightDir = toLight / max(distance, 1e-4);
+
+        // Fade to zero at the binning radius so froxel borders never show
+        float window = clamp(1.0 - pow(distance / positionRadius.w, 4.0), 0.0, 1.0);
+        float attenuation = window * window /
+            (1.0 + innerAttenuation.y * distance + innerAttenuation.z * distance * distance);
+
+        // Point lights carry a cone wider than the sphere, so intensity is 1
+        float theta = dot(lightDir, -directionOuter.xyz);
+        float intensity = clamp((theta - directionOuter.w) / (innerAttenuation.x - directionOuter.w), 0.0, 1.0);
+
+        float diff = max(dot(normal, lightDir), 0.0);
+        float spec = pow(max(dot(normal, normalize(lightDir + viewDir)), 0.0), shininess);
+        vec3 lit = colorAmbient.a * albedo + intensity * (diff * albedo + spec * specularColor);
+        result += colorAmbient.rgb * attenuation * lit;
+    }
+    return result;
+}
+
+// Poisson disk kernel (unit radius), rotated per pixel
+const int POISSON_TAPS = 8;
+const float POISSON_RADIUS = 2.0; // In texels
+const vec2 POISSON_DISK[POISSON_TAPS] = vec2[](
+    vec2(-0.94201624, -0.39906216), vec2( 0.94558609, -0.76890725),
+    vec2(-0.09418410, -0.92938870), vec2( 0.34495938,  0.29387760),
+    vec2(-0.91588581,  0.45771432), vec2(-0.81544232, -0.87912464),
+    vec2(-0.38277543,  0.27676845), vec2( 0.97484398,  0.75648379)
+);
+
+// Per-pixel rotation angle from interleaved gradient noise
+float PoissonRotation(vec2 fragCoord) {
+    return 6.2831853 * fract(52.9829189 * fract(dot(fragCoord, vec2(0.06711056, 0.00583715))));
+}
+
+// Pick the first cascade whose split distance covers this depth
+int SelectCascade(float viewDepth) {
+    for (int i = 0; i < cascadeCount - 1; ++i) {
+        if (viewDepth < cascadeSplits[i]) {
+            return i;
+        }
+    }
+    return cascadeCount - 1;
+}
 
 // Calculate shadow value
-float ShadowCalculation(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir) {
-    // Perform perspective division
-    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
-    
-    // Transform to [0,1] range
-    projCoords = projCoords * 0.5 + 0.5;
+float ShadowCalculation(vec3 worldPos, vec3 normal, vec3 lightDir) {
+    // Cascades refreshed less often than every frame can lag the camera,
+    // so fall through to the next cascade if the fragment left this one
+    vec3 projCoords = vec3(2.0);
+    int layer = SelectCascade(ViewDepth);
+    for (; layer < cascadeCount; ++layer) {
+        vec4 fragPosLightSpace = lightSpaceMatrices[layer] * vec4(worldPos, 1.0);
+        projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w * 0.5 + 0.5;
+        if (projCoords.x >= 0.0 && projCoords.x <= 1.0 &&
+            projCoords.y >= 0.0 && projCoords.y <= 1.0) {
+            break;
+        }
+    }
     
     // Calculate bias based on normal and light direction
     float bias = max(shadowBias * (1.0 - dot(normal, lightDir)), normalBias);
     
-    // If outside shadow map range, consider not in shadow
-    if (projCoords.z > 1.0 || projCoords.x < 0.0 || projCoords.x > 1.0 ||
-        projCoords.y < 0.0 || projCoords.y > 1.0) {
+    // If outside every cascade, consider not in shadow
+    if (layer >= cascadeCount || projCoords.z > 1.0) {
         return 1.0;
     }
     
     // Get current fragment depth
     float currentDepth = projCoords.z;
+    float cascade = float(layer);
     
     // Choose shadow calculation method based on filter mode
     if (filterMode == FILTER_NEAREST) {
         // Nearest neighbor filtering - hard shadows
-        float closestDepth = texture(shadowMap, projCoords.xy).r;
+        float closestDepth = texture(shadowMap, vec3(projCoords.xy, cascade)).r;
         return currentDepth - bias > closestDepth ? 0.0 : 1.0;
     }
     else if (filterMode == FILTER_LINEAR) {
         // Linear filtering
-        float closestDepth = texture(shadowMap, projCoords.xy).r;
+        float closestDepth = texture(shadowMap, vec3(projCoords.xy, cascade)).r;
         return currentDepth - bias > closestDepth ? 0.0 : 1.0;
     }
+    else if (filterMode == FILTER_HARDWARE_PCF) {
+        // One comparison fetch, bilinearly filtered by the texture unit (2x2 PCF)
+        return texture(shadowMapCompare, vec4(projCoords.xy, cascade, currentDepth - bias));
+    }
+    else if (filterMode == FILTER_HARDWARE_PCF_3x3) {
+        // Four bilinear comparison fetches cover a 3x3 texel footprint
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMapCompare, 0).xy);
+        float shadow = 0.0;
+        shadow += texture(shadowMapCompare, vec4(projCoords.xy + vec2(-0.5, -0.5) * texelSize, cascade, currentDepth - bias));
+        shadow += texture(shadowMapCompare, vec4(projCoords.xy + vec2( 0.5, -0.5) * texelSize, cascade, currentDepth - bias));
+        shadow += texture(shadowMapCompare, vec4(projCoords.xy + vec2(-0.5,  0.5) * texelSize, cascade, currentDepth - bias));
+        shadow += texture(shadowMapCompare, vec4(projCoords.xy + vec2( 0.5,  0.5) * texelSize, cascade, currentDepth - bias));
+        return shadow * 0.25;
+    }
+    else if (filterMode == FILTER_POISSON_DISK) {
+        // Rotated Poisson taps trade banding for fine noise
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMapCompare, 0).xy);
+        float angle = PoissonRotation(gl_FragCoord.xy);
+        mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+        float shadow = 0.0;
+        for (int i = 0; i < POISSON_TAPS; ++i) {
+            vec2 offset = rotation * POISSON_DISK[i] * POISSON_RADIUS * texelSize;
+            shadow += texture(shadowMapCompare, vec4(projCoords.xy + offset, cascade, currentDepth - bias));
+        }
+        return shadow / float(POISSON_TAPS);
+    }
     else {
         // PCF (Percentage Closer Filtering) soft shadows
         float shadow = 0.0;
-        vec2 texelSize = 1.0 / textureSize(shadowMap, 0);
+        vec2 texelSize = 1.0 / vec2(textureSize(shadowMap, 0).xy);
         
-        int kernelSize;
+        int kernelMin;
+        int kernelMax;
         if (filterMode == FILTER_PCF_2x2) {
-            kernelSize = 1;
+            kernelMin = 0;
+            kernelMax = 1;
         } else if (filterMode == FILTER_PCF_3x3) {
-            kernelSize = 1;
+            kernelMin = -1;
+            kernelMax = 1;
         } else { // FILTER_PCF_5x5
-            kernelSize = 2;
+            kernelMin = -2;
+            kernelMax = 2;
         }
         
-        for(int x = -kernelSize; x <= kernelSize; ++x) {
-            for(int y = -kernelSize; y <= kernelSize; ++y) {
-                float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+        for(int x = kernelMin; x <= kernelMax; ++x) {
+            for(int y = kernelMin; y <= kernelMax; ++y) {
+                float pcfDepth = texture(shadowMap, vec3(projCoords.xy + vec2(x, y) * texelSize, cascade)).r;
                 shadow += currentDepth - bias > pcfDepth ? 0.0 : 1.0;
             }
         }
         
-        int totalSamples = (kernelSize * 2 + 1) * (kernelSize * 2 + 1);
+        int totalSamples = (kernelMax - kernelMin + 1) * (kernelMax - kernelMin + 1);
         shadow /= float(totalSamples);
         
         return shadow;
@@ -106,11 +234,17 @@ void main()
     vec3 specular = 0.2 * spec * lightColor;
     
     // Calculate shadow
-    float shadow = ShadowCalculation(FragPosLightSpace, norm, lightDir);
+    float shadow = ShadowCalculation(FragPos, norm, lightDir);
+    
+    if (shadowDebugView) {
+        FragColor = vec4(vec3(shadow), 1.0);
+        return;
+    }
     
     // Combine lighting and shadow (ambient light not affected by shadow)
     vec3 lighting = ambient + shadow * (diffuse + specular);
     vec3 result = lighting * VertexColor;
+    result += CalcClusteredLights(norm, FragPos, viewDir, ViewDepth, VertexColor, vec3(0.2), 32.0);
     
     // Add distance-based fog effect
     float distance = length(viewPos - FragPos);
@@ -9,12 +9,14 @@ out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
 out vec3 VertexColor;
-out vec4 FragPosLightSpace;
+out float ViewDepth;
+
+// Shared with depth_prepass.vert so the GL_EQUAL colour pass matches
+invariant gl_Position;
 
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
-uniform mat4 lightSpaceMatrix;
 
 void main()
 {
@@ -28,8 +30,8 @@ void main()
     TexCoord = aTexCoord;
     VertexColor = aColor;
     
-    // Calculate position in light space
-    FragPosLightSpace = lightSpaceMatrix * vec4(FragPos, 1.0);
+    // View-space depth selects the shadow cascade
+    ViewDepth = -(view * vec4(FragPos, 1.0)).z;
     
     // Calculate final position
     gl_Position = projection * view * vec4(FragPos, 1.0);
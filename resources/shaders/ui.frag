@@ -1,17 +1,17 @@
 #version 410 core
 in vec2 TexCoord;
+in vec4 Color;
 
 out vec4 FragColor;
 
-uniform vec4 color;
-uniform bool useTexture;
-uniform sampler2D ourTexture;
+// Glyph atlas: signed distance in the red channel, 0.5 on the glyph edge.
+// Solid quads sample a cell that is fully inside (1.0).
+uniform sampler2D uiAtlas;
 
 void main()
 {
-    if (useTexture) {
-        FragColor = texture(ourTexture, TexCoord) * color;
-    } else {
-        FragColor = color;
-    }
+    float distance = texture(uiAtlas, TexCoord).r;
+    float width = max(fwidth(distance) * 0.7, 1.0e-4);
+    float coverage = smoothstep(0.5 - width, 0.5 + width, distance);
+    FragColor = vec4(Color.rgb, Color.a * coverage);
 }
@@ -1,20 +1,16 @@
 #version 410 core
-layout (location = 0) in vec2 aPos;        // Position
-layout (location = 1) in vec2 aTexCoord;   // Texture coordinates
+layout (location = 0) in vec2 aPos;        // Screen-space position (pixels, y down)
+layout (location = 1) in vec2 aTexCoord;   // Glyph atlas coordinates
+layout (location = 2) in vec4 aColor;      // Vertex colour (straight alpha)
 
 out vec2 TexCoord;
+out vec4 Color;
 
 uniform mat4 projection;
-uniform vec2 position;
-uniform vec2 size;
 
 void main()
 {
-    // Transform vertex to UI space
-    vec2 vertexPos = aPos * size + position;
-    
-    // Convert to normalized device coordinates
-    gl_Position = projection * vec4(vertexPos, 0.0, 1.0);
-    
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
     TexCoord = aTexCoord;
+    Color = aColor;
 }
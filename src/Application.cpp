@@ -115,6 +115,9 @@ bool Application::Initialize() {
     
     glEnable(GL_DEPTH_TEST);
 
+    // Started early so textures and models below can be queued to it
+    m_assetStreamer = std::make_unique<AssetStreamer>();
+
     
     m_camera = std::make_unique<Camera>(glm::vec3(0.0f, 2.0f, 3.0f));
 
@@ -179,18 +182,11 @@ bool Application::Initialize() {
     CreateDefaultTexture();
     
     
-    m_diffuseTexture = LoadTexture("../wood_diffuse.ppm");  
-    m_specularTexture = LoadTexture("../metal_specular.ppm");
-    
-    
-    if (m_diffuseTexture == 0) {
-        m_diffuseTexture = CreateDefaultTexture(glm::vec3(0.8f, 0.6f, 0.4f)); 
-        std::cout << "Using default diffuse texture" << std::endl;
-    }
-    if (m_specularTexture == 0) {
-        m_specularTexture = CreateDefaultTexture(glm::vec3(0.6f, 0.6f, 0.7f)); 
-        std::cout << "Using default specular texture" << std::endl;
-    }
+    // Placeholders are replaced in place once the streamer has decoded the files
+    m_diffuseTexture = CreateDefaultTexture(glm::vec3(0.8f, 0.6f, 0.4f)); 
+    m_specularTexture = CreateDefaultTexture(glm::vec3(0.6f, 0.6f, 0.7f)); 
+    m_assetStreamer->RequestTexture(m_diffuseTexture, { "../wood_diffuse.ppm", "resources/textures/wood_diffuse.ppm" });
+    m_assetStreamer->RequestTexture(m_specularTexture, { "../metal_specular.ppm", "resources/textures/metal_specular.ppm" });
     
     
     m_basicMaterial.ambient = glm::vec3(0.2f, 0.2f, 0.2f);
@@ -229,15 +225,55 @@ bool Application::Initialize() {
     
     
     InitializeShadowMapping();
+    
+    
+    InitializePostProcessing();
+    
+    
+    m_renderGraph = std::make_unique<RenderGraph>();
+    
+    
+    m_gpuCulling = std::make_unique<GpuCulling>();
+    if (m_gpuCulling->Initialize()) {
+        m_modelCulling = std::make_unique<GpuCulling::Batch>();
+    } else {
+        m_gpuCulling.reset();
+    }
+    
+    
+    m_depthPrePass = std::make_unique<DepthPrePass>();
+    if (!m_depthPrePass->Initialize()) {
+        m_depthPrePass.reset();
+    }
+    
+    // Give the lit programs their buffer sampler units before anything draws with them
+    m_clusteredLighting = std::make_unique<ClusteredLighting>();
+    m_clusteredLighting->Initialize();
+    for (Shader* shader : { m_blinnPhongShader.get(), m_terrainShader.get(), m_terrainShadowShader.get() }) {
+        shader->Use();
+        m_clusteredLighting->Apply(*shader);
+    }
+    
+    
+    m_performanceOverlay = std::make_unique<PerformanceOverlay>();
+    if (!m_performanceOverlay->Initialize()) {
+        m_performanceOverlay.reset();
+    }
 
     std::cout << "Application initialized successfully!" << std::endl;
     std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << std::endl;
+    std::cout << "Geometry batching: " << (GeometryPool::SupportsMultiDrawIndirect()
+        ? "multi-draw indirect" : "base-vertex draws (no GL 4.3)") << std::endl;
     std::cout << "Controls:" << std::endl;
     std::cout << "  WASD - Move camera" << std::endl;
     std::cout << "  Mouse - Look around" << std::endl;
     std::cout << "  Scroll - Zoom" << std::endl;
     std::cout << "  ESC - Exit" << std::endl;
     std::cout << "  F3 - Toggle Shadows, F4 - Shadow Quality" << std::endl;
+    std::cout << "  F1 - Performance Overlay, F2 - Export Performance Log" << std::endl;
+    std::cout << "  F5 - Benchmark Shadow Filters, F6 - Post-Processing Quality" << std::endl;
+    std::cout << "  F7 - Benchmark Mesh Optimization, F8 - GPU Culling" << std::endl;
+    std::cout << "  F9 - Depth Pre-Pass, F10 - Overdraw View" << std::endl;
     
     return true;
 }
@@ -404,6 +440,15 @@ void Application::Run() {
         
         m_profiler.BeginFrame();
         
+        // Dynamic vertex, command and item data of this frame go to the next ring segment
+        StreamBuffer::Get().BeginFrame();
+        
+        // Finished background loads get a bounded slice of GL time per frame
+        {
+            PROFILE_SECTION("Asset Uploads");
+            m_assetStreamer->ProcessUploads(ASSET_UPLOAD_BUDGET_MS);
+        }
+        
         
         float currentFrame = glfwGetTime();
         m_deltaTime = currentFrame - m_lastFrame;
@@ -428,12 +473,13 @@ void Application::Run() {
         }
         
         
+        // Read by the overlay on the next frame
         if (m_enablePerformanceOverlay) {
-            PerformanceMonitor::RenderOverlay();
-            PerformanceMonitor::LogPerformanceWarnings();
+            ReportPerformanceCounters();
         }
 
         
+        StreamBuffer::Get().EndFrame();
         glfwSwapBuffers(m_window);
         glfwPollEvents();
         
@@ -444,8 +490,24 @@ void Application::Run() {
 
 void Application::Shutdown() {
     
+    m_performanceOverlay.reset();
     ShutdownGUI();
     
+    // Model buffers must be freed while the GL context still exists;
+    // stop the loaders first so no upload lands after the cache is cleared
+    if (m_assetStreamer) {
+        m_assetStreamer->Shutdown();
+    }
+    m_gameModels.clear();
+    ModelCache::Get().Clear();
+    m_modelCulling.reset();
+    m_gpuCulling.reset();
+    m_depthPrePass.reset();
+    m_clusteredLighting.reset();
+    GpuCulling::Batch::ReleaseAll();
+    GeometryPool::ReleaseAll();
+    StreamBuffer::Get().Shutdown();
+    
     
     ShutdownAudio();
     
@@ -616,6 +678,72 @@ void Application::ProcessInput() {
     }
     if (glfwGetKey(m_window, GLFW_KEY_F4) == GLFW_RELEASE) shadowQualityPressed = false;
     
+    static bool shadowBenchmarkPressed = false;
+    if (glfwGetKey(m_window, GLFW_KEY_F5) == GLFW_PRESS && !shadowBenchmarkPressed) {
+        if (m_shadowManager && m_shadowBenchmark && m_enableShadows && m_currentState == GameState::IN_GAME) {
+            auto shadowMap = m_shadowManager->GetShadowMapping(0);
+            if (shadowMap && !m_shadowBenchmark->IsRunning()) {
+                int framebufferWidth, framebufferHeight;
+                glfwGetFramebufferSize(m_window, &framebufferWidth, &framebufferHeight);
+                m_shadowBenchmark->Start(shadowMap, framebufferWidth, framebufferHeight);
+            }
+        }
+        shadowBenchmarkPressed = true;
+    }
+    if (glfwGetKey(m_window, GLFW_KEY_F5) == GLFW_RELEASE) shadowBenchmarkPressed = false;
+    
+    static bool postProcessQualityPressed = false;
+    if (glfwGetKey(m_window, GLFW_KEY_F6) == GLFW_PRESS && !postProcessQualityPressed) {
+        if (m_postProcessManager) {
+            int next = (static_cast<int>(m_postProcessManager->GetQuality()) + 1) % 4;
+            m_postProcessManager->SetQuality(static_cast<PostProcessManager::PostProcessQuality>(next));
+        }
+        postProcessQualityPressed = true;
+    }
+    if (glfwGetKey(m_window, GLFW_KEY_F6) == GLFW_RELEASE) postProcessQualityPressed = false;
+    
+    static bool vertexCacheBenchmarkPressed = false;
+    if (glfwGetKey(m_window, GLFW_KEY_F7) == GLFW_PRESS && !vertexCacheBenchmarkPressed) {
+        RunVertexCacheBenchmark();
+        vertexCacheBenchmarkPressed = true;
+    }
+    if (glfwGetKey(m_window, GLFW_KEY_F7) == GLFW_RELEASE) vertexCacheBenchmarkPressed = false;
+    
+    static bool gpuCullingPressed = false;
+    if (glfwGetKey(m_window, GLFW_KEY_F8) == GLFW_PRESS && !gpuCullingPressed) {
+        if (m_gpuCulling) {
+            m_gpuCulling->SetEnabled(!m_gpuCulling->IsEnabled());
+            // Flags from before the toggle would hide models for a frame
+            m_modelCulling->Release();
+            m_modelVisibility.clear();
+            m_culledModelKeys.clear();
+            std::cout << "GPU culling: " << (m_gpuCulling->IsEnabled() ? "ON" : "OFF") << std::endl;
+        }
+        gpuCullingPressed = true;
+    }
+    if (glfwGetKey(m_window, GLFW_KEY_F8) == GLFW_RELEASE) gpuCullingPressed = false;
+    
+    static bool depthPrePassPressed = false;
+    if (glfwGetKey(m_window, GLFW_KEY_F9) == GLFW_PRESS && !depthPrePassPressed) {
+        if (m_depthPrePass) {
+            m_depthPrePass->SetEnabled(!m_depthPrePass->IsEnabled());
+            std::cout << "Depth pre-pass: " << (m_depthPrePass->IsEnabled() ? "ON" : "OFF") << std::endl;
+        }
+        depthPrePassPressed = true;
+    }
+    if (glfwGetKey(m_window, GLFW_KEY_F9) == GLFW_RELEASE) depthPrePassPressed = false;
+    
+    static bool overdrawViewPressed = false;
+    if (glfwGetKey(m_window, GLFW_KEY_F10) == GLFW_PRESS && !overdrawViewPressed) {
+        if (m_depthPrePass) {
+            m_depthPrePass->SetOverdrawView(!m_depthPrePass->IsOverdrawView());
+            std::cout << "Overdraw view: " << (m_depthPrePass->IsOverdrawView() ? "ON" : "OFF")
+                      << " (" << m_depthPrePass->GetOverdraw() << " shaded fragments per pixel)" << std::endl;
+        }
+        overdrawViewPressed = true;
+    }
+    if (glfwGetKey(m_window, GLFW_KEY_F10) == GLFW_RELEASE) overdrawViewPressed = false;
+    
     
     static bool audioTogglePressed = false;
     static bool volumeUpPressed = false;
@@ -768,71 +896,143 @@ void Application::Render() {
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // Every pass of the frame is declared up front so the graph can alias transient targets
+    RenderGraph& graph = *m_renderGraph;
+    graph.BeginFrame();
+    RenderGraph::ResourceHandle backbuffer = graph.ImportBackbuffer("Backbuffer");
     
     if (m_currentState == GameState::IN_GAME) {
         
-        RenderGameScene();
+        RenderGraph::ResourceHandle shadowMap = RenderGraph::INVALID_RESOURCE;
+        ShadowMapping* shadowMapping = m_shadowManager ? m_shadowManager->GetShadowMapping(0) : nullptr;
+        if (m_enableShadows && shadowMapping) {
+            shadowMap = graph.ImportTexture("ShadowMap", shadowMapping->GetShadowMapTexture(),
+                                            shadowMapping->GetMemoryUsage());
+        }
+        graph.AddPass("Shadow", {}, { shadowMap }, [this]() { RenderShadowPass(); });
+        
+        // Scene goes to the HDR target when post-processing is active
+        if (m_postProcessManager && m_postProcessManager->IsActive()) {
+            m_postProcessManager->AddScenePass(graph, shadowMap, [this]() { RenderGameScene(); });
+            AddCullingPass(graph, m_postProcessManager->GetSceneDepth());
+            m_postProcessManager->AddPostProcessPasses(graph, backbuffer);
+        } else {
+            graph.AddPass("Scene", { shadowMap }, { backbuffer }, [this]() { RenderGameScene(); });
+            AddCullingPass(graph, RenderGraph::INVALID_RESOURCE);
+        }
         
         drawCalls += 100; 
         triangles += 50000; 
     }
     else if (m_currentState == GameState::MAIN_MENU) {
         
-        RenderMenuBackground();
+        graph.AddPass("MenuBackground", {}, { backbuffer }, [this]() { RenderMenuBackground(); });
         drawCalls += 5; 
         triangles += 100; 
     }
     
     
-    
-    GLint currentProgram;
-    glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-    
-    
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_DEPTH_TEST);
-    
-    
-    // Only render GUI for main menu
-    if (m_currentState == GameState::MAIN_MENU) {
+    graph.AddPass("GUI", {}, { backbuffer }, [this]() {
+        GLint currentProgram;
+        glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
+        
+        
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glDisable(GL_DEPTH_TEST);
+        
+        
+        // Only render GUI for main menu
+        if (m_currentState == GameState::MAIN_MENU) {
+            glUseProgram(0);
 
-        glUseProgram(0);
-
-        RenderGUI();
-        glUseProgram(0);
-    }
+            RenderGUI();
+            glUseProgram(0);
+        }
+        
+        
+        if (m_enablePerformanceOverlay && m_performanceOverlay) {
+            m_performanceOverlay->Render(m_windowWidth, m_windowHeight);
+        }
+        
+        
+        if (currentProgram != 0) {
+            glUseProgram(currentProgram);
+        }
+    });
+    
+    graph.Compile();
+    graph.Execute();
     
     drawCalls += 10; 
     triangles += 200;
     
     
-    if (currentProgram != 0) {
-        glUseProgram(currentProgram);
-    }
-    
-    
     m_profiler.UpdateDrawCallStats(drawCalls, triangles);
 }
 
-void Application::RenderGameScene() {
-    // Generate shadow maps
+void Application::RenderShadowPass() {
+    glm::mat4 view = m_camera->GetViewMatrix();
+    float aspect = (float)m_windowWidth / (float)m_windowHeight;
+    
+    // Generate cascaded shadow maps covering the full terrain view distance
     if (m_enableShadows && m_shadowManager) {
-        auto* shadowMapping = m_shadowManager->GetShadowMapping(0);
-        if (shadowMapping) {
-            shadowMapping->BeginShadowMapPass();
-            RenderShadowMap();
-            shadowMapping->EndShadowMapPass(m_windowWidth, m_windowHeight);
+        m_shadowManager->RenderCascadedShadowMaps(
+            view, glm::radians(m_camera->Zoom), aspect, 0.1f, 200.0f,
+            [this](const glm::mat4& lightSpaceMatrix) { RenderShadowMap(lightSpaceMatrix, true); },
+            [this](const glm::mat4& lightSpaceMatrix) { RenderShadowMap(lightSpaceMatrix, false); },
+            m_windowWidth, m_windowHeight);
+    }
+}
+
+void Application::RenderGameScene() {
+    glm::mat4 view = m_camera->GetViewMatrix();
+    float aspect = (float)m_windowWidth / (float)m_windowHeight;
+    
+    glm::mat4 projection = glm::perspective(glm::radians(m_camera->Zoom), aspect, 0.1f, 100.0f);
+    
+    // Last frame's model culling results, if the GPU has finished them
+    m_modelCullItems.clear();
+    m_modelCullKeys.clear();
+    if (m_modelCulling && m_modelCulling->ResolveVisibility()) {
+        // Flags follow the item order of the frame that was culled; keying them by
+        // object keeps a collected treasure or a newly streamed model from shifting them
+        m_modelVisibility.clear();
+        for (size_t i = 0; i < m_culledModelKeys.size(); i++) {
+            m_modelVisibility[m_culledModelKeys[i]] = m_modelCulling->IsVisible(i);
         }
     }
     
-    glm::mat4 view = m_camera->GetViewMatrix();
-    glm::mat4 projection = glm::perspective(glm::radians(m_camera->Zoom), 
-        (float)m_windowWidth / (float)m_windowHeight, 0.1f, 100.0f);
-
+    // Transforms and detail levels are fixed once so every pass draws the same geometry
+    GatherTreasureDraws();
+    GatherModelDraws();
+    GatherLights(view, aspect);
+    
+    // Terrain is culled once; the depth pre-pass and the colour pass draw the same commands
+    if (m_terrainEnabled && m_terrainGenerator) {
+        glm::mat4 terrainProjection = glm::perspective(glm::radians(m_camera->Zoom), aspect, 0.1f, 200.0f);
+        m_terrainGenerator->CullTerrain(m_gpuCulling.get(), terrainProjection * view);
+    }
+    
+    if (m_depthPrePass) {
+        if (m_depthPrePass->IsEnabled()) {
+            m_depthPrePass->BeginDepthPass();
+            RenderOpaqueUnlit(m_depthPrePass->GetDepthShader());
+        }
+        m_depthPrePass->BeginColorPass();
+        
+        if (m_depthPrePass->IsOverdrawView()) {
+            RenderOpaqueUnlit(m_depthPrePass->GetOverdrawShader());
+            m_depthPrePass->EndColorPass();
+            return;
+        }
+    }
+    
+    // Filter benchmark times only the lit colour pass, not the culling or depth pre-pass before it
+    bool benchmarking = m_shadowBenchmark && m_shadowBenchmark->IsRunning();
+    if (benchmarking) {
+        m_shadowBenchmark->BeginFrame();
+    }
     
     m_blinnPhongShader->Use();
     m_blinnPhongShader->SetMat4("view", view);
@@ -867,8 +1067,14 @@ void Application::RenderGameScene() {
     if (!m_terrainEnabled || !m_terrainGenerator) {
         RenderSimpleGround();
     }
-
     
+    if (m_depthPrePass) {
+        m_depthPrePass->EndColorPass();
+    }
+    
+    if (benchmarking) {
+        m_shadowBenchmark->EndFrame();
+    }
 }
 
 void Application::RenderMenuBackground() {
@@ -900,7 +1106,7 @@ void Application::InitializeTreasureGame() {
     }
     
     
-    m_treasureGame.treasures.clear();
+    m_treasureGame.ClearTreasures();
     
     
     glm::vec3 keyPos1 = glm::vec3(8.0f, 0.5f, 12.0f);
@@ -972,18 +1178,14 @@ void Application::CheckTreasureInteraction() {
     m_treasureGame.nearestTreasureId = -1;
     m_treasureGame.distanceToNearestTreasure = 999.0f;
     
-    
-    for (auto& treasure : m_treasureGame.treasures) {
-        if (treasure.status == TreasureStatus::COLLECTED || 
-            treasure.status == TreasureStatus::UNLOCKED) continue;
-        
-        float distance = glm::distance(m_treasureGame.playerPosition, treasure.position);
-        
-        
-        if (distance < m_treasureGame.distanceToNearestTreasure) {
-            m_treasureGame.distanceToNearestTreasure = distance;
-            m_treasureGame.nearestTreasureId = treasure.id;
-        }
+    // Collected and unlocked treasures are dropped from the grid, so the nearest entry is always live
+    size_t nearestIndex = 0;
+    float distance = 0.0f;
+    if (m_treasureGame.treasureGrid.FindNearest(m_treasureGame.playerPosition, std::numeric_limits<float>::max(),
+                                                nearestIndex, distance)) {
+        const TreasureData& treasure = m_treasureGame.treasures[nearestIndex];
+        m_treasureGame.distanceToNearestTreasure = distance;
+        m_treasureGame.nearestTreasureId = treasure.id;
         
         
         if (distance < interactionDistance) {
@@ -1057,6 +1259,62 @@ void Application::HandleVictoryCondition() {
     }
 }
 
+void Application::GatherTreasureDraws() {
+    m_treasureDraws.clear();
+    float time = glfwGetTime();
+    
+    for (const auto& treasure : m_treasureGame.treasures) {
+        if (treasure.status == TreasureStatus::COLLECTED || 
+            treasure.status == TreasureStatus::UNLOCKED) continue;
+        
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, treasure.position);
+        
+        ModelObject* treasureModel = nullptr;
+        std::string modelPrefix;
+        
+        if (treasure.type == TreasureType::ANCIENT_KEY) {
+            modelPrefix = "collectible_";
+            model = glm::rotate(model, time * 1.5f, glm::vec3(0.0f, 1.0f, 0.0f));   
+            model = glm::scale(model, glm::vec3(0.016f, 0.016f, 0.016f));            
+            
+        } else if (treasure.type == TreasureType::TREASURE_CHEST) {
+            modelPrefix = "chest_";
+            model = glm::rotate(model, time * 0.8f, glm::vec3(0.0f, 1.0f, 0.0f));   
+            model = glm::scale(model, glm::vec3(0.01f, 0.01f, 0.01f)); 
+        }
+        
+        for (auto& gameModel : m_gameModels) {
+            if (gameModel.name.find(modelPrefix) == 0) {
+                treasureModel = &gameModel;
+                break;
+            }
+        }
+        
+        // Missing or still streaming; runs every frame, so skip quietly
+        if (!treasureModel) {
+            continue;
+        }
+        
+        OpaqueDraw draw = { nullptr, model, 0, 0.0f, &treasure, nullptr };
+        if (treasureModel->model->IsReady()) {
+            if (!IsModelVisible(*treasureModel->model, model, static_cast<uint64_t>(treasure.id))) {
+                continue;
+            }
+            int& lod = m_treasureLods[treasure.id];
+            lod = SelectModelLod(*treasureModel->model, model, lod);
+            draw.model = treasureModel->model.get();
+            draw.lod = lod;
+        } else {
+            draw.transform = GetPendingMarkerTransform(treasure.position);
+        }
+        draw.distance = glm::length(glm::vec3(draw.transform[3]) - m_camera->Position);
+        m_treasureDraws.push_back(draw);
+    }
+    
+    SortFrontToBack(m_treasureDraws);
+}
+
 void Application::RenderTreasureGame() {
     if (!m_blinnPhongShader || !m_camera) return;
     
@@ -1075,20 +1333,11 @@ void Application::RenderTreasureGame() {
     m_blinnPhongShader->SetVec3("light.specular", 2.5f, 2.5f, 2.5f);  
     m_blinnPhongShader->SetFloat("material.shininess", 64.0f);
     
-    for (const auto& treasure : m_treasureGame.treasures) {
-        if (treasure.status == TreasureStatus::COLLECTED || 
-            treasure.status == TreasureStatus::UNLOCKED) continue;
-        
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, treasure.position);
-        
-        ModelObject* treasureModel = nullptr;
-        std::string modelPrefix;
-        float time = glfwGetTime(); 
+    float time = glfwGetTime(); 
+    for (const OpaqueDraw& draw : m_treasureDraws) {
+        const TreasureData& treasure = *draw.treasure;
         
         if (treasure.type == TreasureType::ANCIENT_KEY) {
-            modelPrefix = "collectible_";
-            
             // Bind key texture
             BindKeyTexture();
             
@@ -1099,17 +1348,7 @@ void Application::RenderTreasureGame() {
             m_blinnPhongShader->SetVec3("light.specular", 4.0f, 3.5f, 2.2f); 
             m_blinnPhongShader->SetFloat("material.shininess", 180.0f);       
             
-            float rotationSpeed = 1.8f + sin(time * 0.4f + treasure.id) * 0.5f; 
-            float floatHeight = sin(time * 2.5f + treasure.id) * 0.2f;           
-            float pulse = 1.0f + sin(time * 4.0f + treasure.id) * 0.08f;         
-            float shimmer = sin(time * 6.0f + treasure.id) * 0.03f;              
-            
-            model = glm::rotate(model, time * 1.5f, glm::vec3(0.0f, 1.0f, 0.0f));   
-            model = glm::scale(model, glm::vec3(0.016f, 0.016f, 0.016f));            
-            
         } else if (treasure.type == TreasureType::TREASURE_CHEST) {
-            modelPrefix = "chest_";
-            
             // Bind chest texture
             BindChestTexture();
             
@@ -1119,38 +1358,11 @@ void Application::RenderTreasureGame() {
             m_blinnPhongShader->SetVec3("light.diffuse", 1.6f * mysticalGlow, 1.2f * mysticalGlow, 0.7f);   
             m_blinnPhongShader->SetVec3("light.specular", 1.4f, 1.1f, 0.7f);  
             m_blinnPhongShader->SetFloat("material.shininess", 120.0f);        
-            
-            float breathe = 1.0f + sin(time * 1.2f + treasure.id) * 0.04f;       
-            float gentleSway = sin(time * 0.8f + treasure.id) * 0.025f;          
-            float slowRotate = time * 0.1f + treasure.id * 0.5f;                 
-            float glowPulse = 1.0f + sin(time * 2.0f + treasure.id) * 0.02f;     
-            
-            model = glm::rotate(model, time * 0.8f, glm::vec3(0.0f, 1.0f, 0.0f));   
-            model = glm::scale(model, glm::vec3(0.01f, 0.01f, 0.01f)); 
         }
         
-        for (auto& gameModel : m_gameModels) {
-            if (gameModel.name.find(modelPrefix) == 0) {
-                treasureModel = &gameModel;
-                std::cout << "[DEBUG] Found model: " << gameModel.name << " for prefix: " << modelPrefix << std::endl;
-                break;
-            }
-        }
-        
-        if (!treasureModel) {
-            std::cout << "[DEBUG] No model found for prefix: " << modelPrefix << std::endl;
-            std::cout << "[DEBUG] Available models:" << std::endl;
-            for (const auto& gameModel : m_gameModels) {
-                std::cout << "  - " << gameModel.name << std::endl;
-            }
-        }
-        
-        m_blinnPhongShader->SetMat4("model", model);
-        
         if (treasure.id == m_treasureGame.nearestTreasureId && 
             m_treasureGame.distanceToNearestTreasure < 5.0f) {
             
-            float time = glfwGetTime();
             float proximity = 1.0f - (m_treasureGame.distanceToNearestTreasure / 5.0f); 
             float glow = 1.0f + sin(time * 4.0f) * 0.3f * proximity; 
             
@@ -1164,11 +1376,7 @@ void Application::RenderTreasureGame() {
         }
         
 
-        if (treasureModel && treasureModel->model) {
-            treasureModel->model->Draw(*m_blinnPhongShader);
-        } else {
-
-        }
+        DrawOpaque(draw, *m_blinnPhongShader, false);
         
 
         m_blinnPhongShader->SetVec3("light.ambient", 0.8f, 0.7f, 0.6f);  
@@ -1178,8 +1386,6 @@ void Application::RenderTreasureGame() {
     }
 }
 
-
-
 void Application::InitializeAdvancedLighting() {
     
     m_advancedLighting.pointLightPos = m_lightPos;
@@ -1229,29 +1435,10 @@ void Application::UpdateAdvancedLighting() {
 void Application::SetupLightingUniforms(Shader& shader) {
     
     shader.SetBool("useBlinnPhong", m_advancedLighting.useBlinnPhong);
-    shader.SetBool("enableSpotLight", m_advancedLighting.enableSpotLight);
     shader.SetBool("enableDirLight", m_advancedLighting.enableDirLight);
     
-    
-    shader.SetVec3("pointLight.position", m_advancedLighting.pointLightPos);
-    shader.SetFloat("pointLight.constant", m_advancedLighting.pointLightConstant);
-    shader.SetFloat("pointLight.linear", m_advancedLighting.pointLightLinear);
-    shader.SetFloat("pointLight.quadratic", m_advancedLighting.pointLightQuadratic);
-    shader.SetVec3("pointLight.ambient", 0.2f, 0.2f, 0.2f);
-    shader.SetVec3("pointLight.diffuse", 0.8f, 0.8f, 0.8f);
-    shader.SetVec3("pointLight.specular", 1.0f, 1.0f, 1.0f);
-    
-    
-    shader.SetVec3("spotLight.position", m_advancedLighting.spotLightPos);
-    shader.SetVec3("spotLight.direction", m_advancedLighting.spotLightDir);
-    shader.SetFloat("spotLight.cutOff", m_advancedLighting.spotLightCutOff);
-    shader.SetFloat("spotLight.outerCutOff", m_advancedLighting.spotLightOuterCutOff);
-    shader.SetFloat("spotLight.constant", 1.0f);
-    shader.SetFloat("spotLight.linear", 0.09f);
-    shader.SetFloat("spotLight.quadratic", 0.032f);
-    shader.SetVec3("spotLight.ambient", 0.1f, 0.1f, 0.1f);
-    shader.SetVec3("spotLight.diffuse", 1.0f, 1.0f, 1.0f);
-    shader.SetVec3("spotLight.specular", 1.0f, 1.0f, 1.0f);
+    // Point and spot lights come from the froxel grid built in GatherLights
+    m_clusteredLighting->Apply(shader);
     
     
     shader.SetVec3("dirLight.direction", m_advancedLighting.dirLightDir);
@@ -1263,18 +1450,21 @@ void Application::SetupLightingUniforms(Shader& shader) {
     if (m_enableShadows && m_shadowManager) {
         auto* shadowMapping = m_shadowManager->GetShadowMapping(0);
         if (shadowMapping) {
-            shader.SetMat4("lightSpaceMatrix", shadowMapping->GetLightSpaceMatrix());
+            shadowMapping->SetCascadeUniforms(&shader);
             
-            // Bind shadow map texture
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, shadowMapping->GetShadowMapTexture());
-            shader.SetInt("shadowMap", 2);
+            // Bind shadow map texture array (raw depth + hardware compare views);
+            // units above the mesh material range so the sampler objects never leak onto them
+            shadowMapping->BindShadowMap(8);
+            shader.SetInt("shadowMap", 8);
+            shadowMapping->BindShadowCompareMap(9);
+            shader.SetInt("shadowMapCompare", 9);
             
             // Shadow parameters
             shader.SetFloat("shadowBias", 0.005f);
             shader.SetFloat("normalBias", 0.01f);
-            shader.SetInt("filterMode", 3); // PCF_3x3
-            shader.SetFloat("shadowMapSize", 2048.0f);
+            shader.SetInt("filterMode", static_cast<int>(shadowMapping->GetFilterMode()));
+            shader.SetFloat("shadowMapSize", static_cast<float>(shadowMapping->GetShadowMapSize()));
+            shader.SetBool("shadowDebugView", m_shadowBenchmark && m_shadowBenchmark->IsCapturing());
         }
     }
 }
@@ -1283,6 +1473,40 @@ void Application::SetupLightingUniforms(Shader& shader) {
 
 
 
+void Application::GatherLights(const glm::mat4& view, float aspect) {
+    m_clusteredLighting->BeginFrame();
+    
+    // Most important first: a full froxel drops the lights added last
+    m_clusteredLighting->AddLight(ClusteredLight::Point(
+        m_advancedLighting.pointLightPos, glm::vec3(0.8f),
+        m_advancedLighting.pointLightLinear, m_advancedLighting.pointLightQuadratic, 0.25f));
+    
+    if (m_advancedLighting.enableSpotLight) {
+        m_clusteredLighting->AddLight(ClusteredLight::Spot(
+            m_advancedLighting.spotLightPos, m_advancedLighting.spotLightDir, glm::vec3(1.0f),
+            m_advancedLighting.spotLightCutOff, m_advancedLighting.spotLightOuterCutOff,
+            0.09f, 0.032f, 0.1f));
+    }
+    
+    // Uncollected treasures glow so they can be spotted in the dark
+    float pulse = 0.85f + 0.15f * sin(glfwGetTime() * 3.0f);
+    for (const auto& treasure : m_treasureGame.treasures) {
+        if (treasure.status == TreasureStatus::COLLECTED || 
+            treasure.status == TreasureStatus::UNLOCKED) continue;
+        
+        glm::vec3 glow = treasure.type == TreasureType::ANCIENT_KEY
+            ? glm::vec3(1.0f, 0.8f, 0.3f) : glm::vec3(1.0f, 0.6f, 0.2f);
+        m_clusteredLighting->AddLight(ClusteredLight::Point(
+            treasure.position + glm::vec3(0.0f, 0.5f, 0.0f), glow * pulse, 0.35f, 0.44f));
+    }
+    
+    // Tiles follow the target the scene passes render into
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    m_clusteredLighting->Build(view, glm::radians(m_camera->Zoom), aspect, 0.1f, CULLING_FAR_PLANE,
+                               viewport[2], viewport[3]);
+}
+
 void Application::InitializeModels() {
     std::cout << "\n=== Initializing 3D Model Loading System ===" << std::endl;
     
@@ -1352,6 +1576,8 @@ void Application::InitializeModels() {
         
         m_modelsLoaded = true;
         std::cout << "Successfully loaded and placed " << m_gameModels.size() << " 3D models with collision volumes." << std::endl;
+        std::cout << "Model cache: " << ModelCache::Get().GetModelCount() << " unique models for "
+                  << m_gameModels.size() << " instances" << std::endl;
         
     } catch (const std::exception& e) {
         std::cerr << "Model loading failed: " << e.what() << std::endl;
@@ -1364,7 +1590,7 @@ void Application::LoadGameModel(const std::string& modelPath, const std::string&
                                const glm::vec3& scale, bool animated) {
     try {
         ModelObject modelObj;
-        modelObj.model = std::make_unique<Model>(modelPath);
+        modelObj.model = ModelCache::Get().LoadAsync(modelPath, *m_assetStreamer);
         
         
         if (m_terrainGenerator) {
@@ -1393,7 +1619,7 @@ void Application::LoadGameModel(const std::string& modelPath, const std::string&
         modelObj.name = name;
         
         m_gameModels.push_back(std::move(modelObj));
-        std::cout << "Loaded model: " << name << " (" << modelPath << ")" << std::endl;
+        std::cout << "Queued model: " << name << " (" << modelPath << ")" << std::endl;
         
     } catch (const std::exception& e) {
         std::cerr << "Cannot load model " << modelPath << ": " << e.what() << std::endl;
@@ -1425,8 +1651,44 @@ void Application::UpdateModels() {
     }
 }
 
+void Application::GatherModelDraws() {
+    m_modelDraws.clear();
+    if (!m_modelsLoaded) return;
+    
+    for (size_t index = 0; index < m_gameModels.size(); index++) {
+        ModelObject& modelObj = m_gameModels[index];
+        
+        glm::mat4 model = glm::mat4(1.0f);
+        model = glm::translate(model, modelObj.position);
+        
+        
+        model = glm::rotate(model, modelObj.rotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
+        model = glm::rotate(model, modelObj.rotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
+        model = glm::rotate(model, modelObj.rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
+        
+        
+        model = glm::scale(model, modelObj.scale);
+        
+        OpaqueDraw draw = { nullptr, model, 0, 0.0f, nullptr, &modelObj };
+        if (modelObj.model->IsReady()) {
+            if (!IsModelVisible(*modelObj.model, model, GAME_MODEL_CULL_KEY + index)) {
+                continue;
+            }
+            modelObj.lod = SelectModelLod(*modelObj.model, model, modelObj.lod);
+            draw.model = modelObj.model.get();
+            draw.lod = modelObj.lod;
+        } else {
+            draw.transform = GetPendingMarkerTransform(modelObj.position);
+        }
+        draw.distance = glm::length(glm::vec3(draw.transform[3]) - m_camera->Position);
+        m_modelDraws.push_back(draw);
+    }
+    
+    SortFrontToBack(m_modelDraws);
+}
+
 void Application::RenderModels() {
-    if (!m_modelsLoaded || m_gameModels.empty()) return;
+    if (m_modelDraws.empty()) return;
     
     
     m_blinnPhongShader->Use();
@@ -1436,28 +1698,15 @@ void Application::RenderModels() {
     
     
     glm::mat4 view = m_camera->GetViewMatrix();
-    glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)m_windowWidth / (float)m_windowHeight, 0.1f, 100.0f);
+    glm::mat4 projection = glm::perspective(glm::radians(m_camera->Zoom), (float)m_windowWidth / (float)m_windowHeight, 0.1f, 100.0f);
     
     m_blinnPhongShader->SetMat4("view", view);
     m_blinnPhongShader->SetMat4("projection", projection);
     m_blinnPhongShader->SetVec3("viewPos", m_camera->Position);
     
     
-    for (const auto& modelObj : m_gameModels) {
-        
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::translate(model, modelObj.position);
-        
-        
-        model = glm::rotate(model, modelObj.rotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, modelObj.rotation.y, glm::vec3(0.0f, 1.0f, 0.0f));
-        model = glm::rotate(model, modelObj.rotation.z, glm::vec3(0.0f, 0.0f, 1.0f));
-        
-        
-        model = glm::scale(model, modelObj.scale);
-        
-        m_blinnPhongShader->SetMat4("model", model);
-        
+    for (const OpaqueDraw& draw : m_modelDraws) {
+        const ModelObject& modelObj = *draw.object;
         
         if (modelObj.name.find("treasure") != std::string::npos) {
             
@@ -1496,10 +1745,153 @@ void Application::RenderModels() {
         }
         
         
-        modelObj.model->Draw(*m_blinnPhongShader);
+        DrawOpaque(draw, *m_blinnPhongShader, false);
     }
 }
 
+void Application::RunVertexCacheBenchmark() {
+    if (!m_shadowMapShader) {
+        return;
+    }
+    
+    // Blocks for a moment: imports the raw models and reads queries back
+    VertexCacheBenchmark benchmark;
+    if (m_terrainGenerator) {
+        benchmark.AddTerrainGrid(m_terrainGenerator->GetChunkSize());
+    }
+    benchmark.AddTerrainGrid(64);
+    benchmark.AddModelFile("resources/models/key.obj");
+    benchmark.AddModelFile("resources/models/treasure_chest.obj");
+    benchmark.AddModelFile("resources/models/signature.obj");
+    benchmark.Run(*m_shadowMapShader);
+}
+
+glm::mat4 Application::GetPendingMarkerTransform(const glm::vec3& position) const {
+    // Small marker cube so streamed objects don't pop in from nothing
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+    return glm::scale(model, glm::vec3(0.3f));
+}
+
+glm::mat4 Application::GetGroundTransform() const {
+    glm::mat4 groundModel = glm::mat4(1.0f);
+    groundModel = glm::translate(groundModel, glm::vec3(0.0f, -0.5f, 0.0f));
+    return glm::scale(groundModel, glm::vec3(50.0f, 1.0f, 50.0f));
+}
+
+void Application::SortFrontToBack(std::vector<OpaqueDraw>& draws) {
+    // Nearer surfaces fill the depth buffer first so early-Z rejects what they cover
+    std::sort(draws.begin(), draws.end(),
+              [](const OpaqueDraw& a, const OpaqueDraw& b) { return a.distance < b.distance; });
+}
+
+void Application::DrawOpaque(const OpaqueDraw& draw, Shader& shader, bool depthOnly) {
+    if (!draw.model) {
+        m_cube->Draw(shader, draw.transform);
+        return;
+    }
+    shader.SetMat4("model", draw.transform);
+    if (depthOnly) {
+        draw.model->DrawDepth(draw.lod);
+    } else {
+        draw.model->Draw(shader, draw.lod);
+    }
+}
+
+void Application::RenderOpaqueUnlit(Shader& shader) {
+    glm::mat4 view = m_camera->GetViewMatrix();
+    float aspect = (float)m_windowWidth / (float)m_windowHeight;
+    
+    // Same matrices as the lit draws, so GL_EQUAL holds in the colour pass
+    shader.Use();
+    shader.SetMat4("view", view);
+    shader.SetMat4("projection", glm::perspective(glm::radians(m_camera->Zoom), aspect, 0.1f, 100.0f));
+    for (const OpaqueDraw& draw : m_treasureDraws) {
+        DrawOpaque(draw, shader, true);
+    }
+    for (const OpaqueDraw& draw : m_modelDraws) {
+        DrawOpaque(draw, shader, true);
+    }
+    
+    if (m_terrainEnabled && m_terrainGenerator) {
+        glm::mat4 terrainProjection = glm::perspective(glm::radians(m_camera->Zoom), aspect, 0.1f, 200.0f);
+        m_terrainGenerator->RenderTerrain(shader, view, terrainProjection, true);
+    } else if (m_quad) {
+        m_quad->Draw(shader, GetGroundTransform());
+    }
+}
+
+int Application::SelectModelLod(const Model& model, const glm::mat4& transform, int currentLod) const {
+    if (model.GetLodCount() <= 1) {
+        return 0;
+    }
+
+    // Bounding sphere in world space
+    glm::vec3 center = glm::vec3(transform * glm::vec4((model.boundsMin + model.boundsMax) * 0.5f, 1.0f));
+    float scale = std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2])) });
+    float radius = glm::length(model.boundsMax - model.boundsMin) * 0.5f * scale;
+
+    float distance = glm::length(center - m_camera->Position);
+    if (distance <= radius) {
+        return 0;
+    }
+
+    // Projected diameter in pixels; the model's LOD errors are fractions of it
+    float screenSize = radius / (distance * std::tan(glm::radians(m_camera->Zoom) * 0.5f)) * m_windowHeight;
+    return model.SelectLod(screenSize, currentLod);
+}
+
+bool Application::IsModelVisible(const Model& model, const glm::mat4& transform, uint64_t key) {
+    if (!m_gpuCulling || !m_gpuCulling->IsEnabled()) {
+        return true;
+    }
+
+    // Hidden models stay in the batch so they are re-tested every frame
+    CullItem item{};
+    item.boundsMin = glm::vec4(model.boundsMin, 0.0f);
+    item.boundsMax = glm::vec4(model.boundsMax, 0.0f);
+    item.transform = transform;
+    m_modelCullItems.push_back(item);
+    m_modelCullKeys.push_back(key);
+    
+    // Objects without a result yet are drawn
+    auto it = m_modelVisibility.find(key);
+    return it == m_modelVisibility.end() || it->second;
+}
+
+void Application::AddCullingPass(RenderGraph& graph, RenderGraph::ResourceHandle sceneDepth) {
+    if (!m_gpuCulling || !m_gpuCulling->IsEnabled()) {
+        return;
+    }
+
+    // Without the HDR target there is no depth texture; culling falls back to the frustum
+    if (sceneDepth == RenderGraph::INVALID_RESOURCE) {
+        graph.AddPass("GpuCulling", {}, {}, [this]() { RunGpuCulling(0, 0, 0); });
+        return;
+    }
+    graph.AddPass("GpuCulling", { sceneDepth }, {}, [this, &graph, sceneDepth]() {
+        RunGpuCulling(graph.GetTexture(sceneDepth), m_postProcessManager->GetFrameWidth(),
+                      m_postProcessManager->GetFrameHeight());
+    });
+}
+
+void Application::RunGpuCulling(GLuint sceneDepth, int width, int height) {
+    float aspect = (float)m_windowWidth / (float)m_windowHeight;
+    glm::mat4 viewProjection = glm::perspective(glm::radians(m_camera->Zoom), aspect, 0.1f, CULLING_FAR_PLANE)
+                             * m_camera->GetViewMatrix();
+
+    // Next frame's terrain and model tests run against this frame's depth
+    if (sceneDepth != 0) {
+        m_gpuCulling->BuildDepthPyramid(sceneDepth, width, height, viewProjection, 0.1f, CULLING_FAR_PLANE);
+    } else {
+        m_gpuCulling->InvalidateDepthPyramid();
+    }
+
+    // Models move and come and go every frame, so their items are replaced each time
+    m_modelCulling->SetItems(m_modelCullItems);
+    m_gpuCulling->Cull(*m_modelCulling, viewProjection, true);
+    m_culledModelKeys = m_modelCullKeys;
+}
+
 
 
 
@@ -1583,6 +1975,11 @@ void Application::UpdateTerrain() {
         
         m_physicsManager->ClearTerrainCollision();
         
+        // New or removed chunks change what the cached static shadows contain
+        if (m_shadowManager) {
+            m_shadowManager->InvalidateStaticShadows();
+        }
+        
         
         std::vector<glm::vec3> terrainVertices;
         std::vector<unsigned int> terrainIndices;
@@ -1608,9 +2005,7 @@ void Application::RenderSimpleGround() {
     m_blinnPhongShader->SetFloat("material.shininess", 16.0f);
     
     
-    glm::mat4 groundModel = glm::mat4(1.0f);
-    groundModel = glm::translate(groundModel, glm::vec3(0.0f, -0.5f, 0.0f));
-    groundModel = glm::scale(groundModel, glm::vec3(50.0f, 1.0f, 50.0f));
+    glm::mat4 groundModel = GetGroundTransform();
     
     m_blinnPhongShader->SetMat4("model", groundModel);
     
@@ -1629,7 +2024,7 @@ void Application::RenderTerrain() {
         
         
         glm::mat4 view = m_camera->GetViewMatrix();
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 
+        glm::mat4 projection = glm::perspective(glm::radians(m_camera->Zoom), 
                                               (float)m_windowWidth / (float)m_windowHeight, 
                                               0.1f, 200.0f);
         glm::mat4 model = glm::mat4(1.0f);
@@ -1645,30 +2040,33 @@ void Application::RenderTerrain() {
         
         auto* shadowMapping = m_shadowManager->GetShadowMapping(0);
         if (shadowMapping) {
-            glm::mat4 lightSpaceMatrix = shadowMapping->GetLightSpaceMatrix();
-            m_terrainShadowShader->SetMat4("lightSpaceMatrix", lightSpaceMatrix);
+            shadowMapping->SetCascadeUniforms(m_terrainShadowShader.get());
+            
             
+            shadowMapping->BindShadowMap(8);
+            m_terrainShadowShader->SetInt("shadowMap", 8);
+            shadowMapping->BindShadowCompareMap(9);
+            m_terrainShadowShader->SetInt("shadowMapCompare", 9);
             
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, shadowMapping->GetShadowMapTexture());
-            m_terrainShadowShader->SetInt("shadowMap", 1);
+            m_terrainShadowShader->SetInt("filterMode", static_cast<int>(shadowMapping->GetFilterMode()));
+            m_terrainShadowShader->SetFloat("shadowMapSize", static_cast<float>(shadowMapping->GetShadowMapSize()));
         }
         
         
         m_terrainShadowShader->SetFloat("shadowBias", 0.005f);
         m_terrainShadowShader->SetFloat("normalBias", 0.01f);
-        m_terrainShadowShader->SetInt("filterMode", 3); 
-        m_terrainShadowShader->SetFloat("shadowMapSize", 2048.0f);
+        m_terrainShadowShader->SetBool("shadowDebugView", m_shadowBenchmark && m_shadowBenchmark->IsCapturing());
+        m_clusteredLighting->Apply(*m_terrainShadowShader);
         
         
-        m_terrainGenerator->RenderTerrain(*m_terrainShadowShader, view, projection);
+        m_terrainGenerator->RenderTerrain(*m_terrainShadowShader, view, projection, true);
     } else {
         
         m_terrainShader->Use();
         
         
         glm::mat4 view = m_camera->GetViewMatrix();
-        glm::mat4 projection = glm::perspective(glm::radians(45.0f), 
+        glm::mat4 projection = glm::perspective(glm::radians(m_camera->Zoom), 
                                               (float)m_windowWidth / (float)m_windowHeight, 
                                               0.1f, 200.0f);
         
@@ -1678,9 +2076,10 @@ void Application::RenderTerrain() {
         m_terrainShader->SetVec3("lightPos", m_lightPos);
         m_terrainShader->SetVec3("lightColor", m_lightColor);
         m_terrainShader->SetVec3("viewPos", m_camera->Position);
+        m_clusteredLighting->Apply(*m_terrainShader);
         
         
-        m_terrainGenerator->RenderTerrain(*m_terrainShader, view, projection);
+        m_terrainGenerator->RenderTerrain(*m_terrainShader, view, projection, true);
     }
 }
 
@@ -1825,9 +2224,10 @@ void Application::InitializeShadowMapping() {
     m_shadowManager = std::make_unique<ShadowMappingManager>();
     
     
-    auto mainShadowMap = m_shadowManager->AddShadowLight(
+    // Four cascades at HIGH resolution replace a single stretched ULTRA map
+    auto mainShadowMap = m_shadowManager->AddCascadedShadowLight(
         0, 
-        ShadowMapping::LightType::DIRECTIONAL, 
+        4, 
         ShadowMapping::ShadowQuality::HIGH 
     );
     
@@ -1849,6 +2249,14 @@ void Application::InitializeShadowMapping() {
         mainShadowMap->SetNormalBias(0.05f);
         mainShadowMap->EnableSlopeScaledBias(true);
         
+        // Far cascades change slowly on screen, refresh them less often
+        mainShadowMap->SetCascadeSplitLambda(0.75f);
+        mainShadowMap->SetCascadeUpdateInterval(2, 2);
+        mainShadowMap->SetCascadeUpdateInterval(3, 4);
+        
+        // Four bilinear comparison taps match the old 9-tap manual PCF footprint
+        mainShadowMap->SetFilterMode(ShadowMapping::FilterMode::HARDWARE_PCF_3x3);
+        
         std::cout << "✅ Main directional light shadow mapping configured" << std::endl;
     }
     
@@ -1856,38 +2264,61 @@ void Application::InitializeShadowMapping() {
     m_shadowManager->SetGlobalShadowsEnabled(m_enableShadows);
     m_shadowManager->SetGlobalShadowStrength(m_shadowStrength);
     
+    m_shadowBenchmark = std::make_unique<ShadowFilterBenchmark>();
+    
     std::cout << "✅ Shadow mapping system initialized successfully!" << std::endl;
     std::cout << "Shadow Features:" << std::endl;
-    std::cout << "  - High-quality directional light shadows" << std::endl;
+    std::cout << "  - Cascaded directional light shadows" << std::endl;
     std::cout << "  - PCF soft shadow filtering" << std::endl;
     std::cout << "  - Automatic bias adjustment" << std::endl;
     std::cout << "  - Real-time shadow rendering" << std::endl;
 }
 
-void Application::RenderShadowMap() {
-    if (!m_enableShadows || !m_shadowManager) {
+void Application::InitializePostProcessing() {
+    std::cout << "=== Initializing Post-Processing ===" << std::endl;
+    
+    // HDR targets match the framebuffer, which differs from the window size on high-DPI displays
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(m_window, &framebufferWidth, &framebufferHeight);
+    
+    m_postProcessManager = std::make_unique<PostProcessManager>();
+    if (!m_postProcessManager->Initialize(framebufferWidth, framebufferHeight)) {
+        std::cerr << "Post-processing unavailable, rendering directly to the backbuffer" << std::endl;
+        m_postProcessManager.reset();
         return;
     }
     
-    auto* shadowMapping = m_shadowManager->GetShadowMapping(0);
-    if (!shadowMapping) {
+    // Scene shaders already output display-ready colour, so keep tone mapping gentle
+    auto* toneMapping = m_postProcessManager->GetToneMappingEffect();
+    toneMapping->SetMode(ToneMappingEffect::Mode::ACES);
+    toneMapping->SetExposure(1.0f);
+    toneMapping->SetGamma(1.0f);
+    
+    m_postProcessManager->SetQuality(PostProcessManager::PostProcessQuality::ADVANCED);
+    
+    std::cout << "✅ Post-processing initialized (F6 cycles quality)" << std::endl;
+}
+
+void Application::RenderShadowMap(const glm::mat4& lightSpaceMatrix, bool staticCasters) {
+    if (!m_enableShadows || !m_shadowManager) {
         return;
     }
     
     // Use shadow map shader
     if (m_shadowMapShader) {
         m_shadowMapShader->Use();
-        m_shadowMapShader->SetMat4("lightSpaceMatrix", shadowMapping->GetLightSpaceMatrix());
+        m_shadowMapShader->SetMat4("lightSpaceMatrix", lightSpaceMatrix);
         
-        // Render terrain to shadow map
-        if (m_terrainEnabled && m_terrainGenerator) {
+        // Render terrain to shadow map (static, cached between terrain updates)
+        if (staticCasters && m_terrainEnabled && m_terrainGenerator) {
             m_terrainGenerator->RenderTerrain(*m_shadowMapShader, glm::mat4(1.0f), glm::mat4(1.0f));
         }
         
         // Render game objects to shadow map - use actual game object positions
         int renderedObjects = 0;
         for (const auto& treasure : m_treasureGame.treasures) {
-            if (treasure.status == TreasureStatus::UNCOLLECTED) {
+            // Treasures spin every frame, so they are always dynamic casters
+            if (!staticCasters && treasure.status == TreasureStatus::UNCOLLECTED) {
                 // Find corresponding model
                 const ModelObject* treasureModel = nullptr;
                 std::string modelPrefix;
@@ -1920,8 +2351,12 @@ void Application::RenderShadowMap() {
                         model = glm::scale(model, glm::vec3(0.01f, 0.01f, 0.01f));
                     }
                     
+                    // Shadow texels are coarser than screen pixels, so casters can drop a level
+                    auto lod = m_treasureLods.find(treasure.id);
+                    int shadowLod = (lod != m_treasureLods.end() ? lod->second : 0) + SHADOW_LOD_BIAS;
+                    
                     m_shadowMapShader->SetMat4("model", model);
-                    treasureModel->model->Draw(*m_shadowMapShader);
+                    treasureModel->model->Draw(*m_shadowMapShader, std::min(shadowLod, treasureModel->model->GetLodCount() - 1));
                     renderedObjects++;
                 }
             }
@@ -1929,7 +2364,7 @@ void Application::RenderShadowMap() {
         
         // Render signature model to shadow map
         for (const auto& gameModel : m_gameModels) {
-            if (gameModel.name.find("signature") != std::string::npos) {
+            if (gameModel.name.find("signature") != std::string::npos && gameModel.isAnimated != staticCasters) {
                 glm::mat4 model = glm::mat4(1.0f);
                 model = glm::translate(model, gameModel.position);
                 model = glm::rotate(model, gameModel.rotation.x, glm::vec3(1.0f, 0.0f, 0.0f));
@@ -1938,7 +2373,7 @@ void Application::RenderShadowMap() {
                 model = glm::scale(model, gameModel.scale);
                 
                 m_shadowMapShader->SetMat4("model", model);
-                gameModel.model->Draw(*m_shadowMapShader);
+                gameModel.model->Draw(*m_shadowMapShader, std::min(gameModel.lod + SHADOW_LOD_BIAS, gameModel.model->GetLodCount() - 1));
                 renderedObjects++;
             }
         }
@@ -1959,34 +2394,44 @@ void Application::UpdateGUI(float deltaTime) {
 void Application::UpdateGameStatusGUI() {
     if (!m_guiManager) return;
     
+    // Handles are resolved once and stay valid until the elements are destroyed
+    if (!m_statusText) {
+        m_statusText = m_guiManager->GetHandle<CustomGUI::UIText>("gameStatus");
+        m_statusKeysShown = -1;
+    }
+    if (!m_performanceText) {
+        m_performanceText = m_guiManager->GetHandle<CustomGUI::UIText>("performanceInfo");
+    }
     
-    auto statusElement = m_guiManager->GetElementById("gameStatus");
-    if (statusElement) {
-        auto statusText = std::dynamic_pointer_cast<CustomGUI::UIText>(statusElement);
-        if (statusText) {
-            std::string status = "Ancient Treasure Hunter - Keys: " + 
-                               std::to_string(m_treasureGame.keysCollected) + "/1, Chests: " +
-                               std::to_string(m_treasureGame.chestsUnlocked) + "/1";
-            statusText->SetText(status);
-        }
+    // The status line only changes with the counters, so only rebuild it then
+    if (m_statusText && (m_treasureGame.keysCollected != m_statusKeysShown ||
+                         m_treasureGame.chestsUnlocked != m_statusChestsShown)) {
+        std::string status = "Ancient Treasure Hunter - Keys: " + 
+                           std::to_string(m_treasureGame.keysCollected) + "/1, Chests: " +
+                           std::to_string(m_treasureGame.chestsUnlocked) + "/1";
+        m_statusText->SetText(status);
+        m_statusKeysShown = m_treasureGame.keysCollected;
+        m_statusChestsShown = m_treasureGame.chestsUnlocked;
     }
     
+    // FPS and position change every frame; refresh them at a readable rate so
+    // the cached GUI geometry is not rebuilt each frame
+    const float statusRefreshInterval = 0.25f;
+    m_statusRefreshTimer += m_deltaTime;
+    if (m_statusRefreshTimer < statusRefreshInterval) return;
+    m_statusRefreshTimer = 0.0f;
     
-    auto perfElement = m_guiManager->GetElementById("performanceInfo");
-    if (perfElement) {
-        auto perfText = std::dynamic_pointer_cast<CustomGUI::UIText>(perfElement);
-        if (perfText) {
-            float fps = (m_deltaTime > 0) ? 1.0f / m_deltaTime : 0.0f;
-            glm::vec3 pos = m_camera->Position;
-            
-            std::stringstream info;
-            info << "FPS: " << static_cast<int>(fps) 
-                 << " | Position: (" << static_cast<int>(pos.x) 
-                 << ", " << static_cast<int>(pos.y) 
-                 << ", " << static_cast<int>(pos.z) << ")";
-            
-            perfText->SetText(info.str());
-        }
+    if (m_performanceText) {
+        float fps = (m_deltaTime > 0) ? 1.0f / m_deltaTime : 0.0f;
+        glm::vec3 pos = m_camera->Position;
+        
+        std::stringstream info;
+        info << "FPS: " << static_cast<int>(fps) 
+             << " | Position: (" << static_cast<int>(pos.x) 
+             << ", " << static_cast<int>(pos.y) 
+             << ", " << static_cast<int>(pos.z) << ")";
+        
+        m_performanceText->SetText(info.str());
     }
 }
 
@@ -1996,6 +2441,55 @@ void Application::RenderGUI() {
     }
 }
 
+void Application::ReportPerformanceCounters() {
+    if (m_postProcessManager) {
+        m_profiler.ReportGpuTime("Bloom", m_postProcessManager->GetEffectGpuTime(PostProcessManager::TimedEffect::BLOOM));
+        m_profiler.ReportGpuTime("Tone Mapping", m_postProcessManager->GetEffectGpuTime(PostProcessManager::TimedEffect::TONE_MAPPING));
+        m_profiler.ReportGpuTime("FXAA", m_postProcessManager->GetEffectGpuTime(PostProcessManager::TimedEffect::FXAA));
+    }
+    
+    if (m_terrainGenerator) {
+        m_profiler.SetCounter("Terrain chunks", m_terrainGenerator->GetChunkCount());
+    }
+    if (m_physicsManager) {
+        m_profiler.SetCounter("Physics actors", m_physicsManager->GetActorCount());
+    }
+    
+    if (m_renderGraph) {
+        const RenderGraph::MemoryStats& stats = m_renderGraph->GetMemoryStats();
+        m_profiler.SetMemoryCounter("Render target pool", stats.pooledBytes);
+        m_profiler.SetMemoryCounter("Imported targets", stats.importedBytes);
+    }
+    m_profiler.SetCounter("Cached models", ModelCache::Get().GetModelCount());
+    ModelCache::Stats modelStats = ModelCache::Get().GetStats();
+    m_profiler.SetCounter("Models streaming", modelStats.pending);
+    m_profiler.SetMemoryCounter("Model buffers", modelStats.gpuBytes);
+    GeometryPool::Stats geometryStats = GeometryPool::GetTotalStats();
+    m_profiler.SetCounter("Geometry allocations", geometryStats.allocations);
+    m_profiler.SetMemoryCounter("Geometry pools", geometryStats.capacityBytes);
+    if (m_gpuCulling) {
+        m_profiler.SetCounter("Models culled", m_modelCulling->GetHiddenCount());
+        m_profiler.SetMemoryCounter("Hi-Z pyramid", m_gpuCulling->GetPyramidBytes());
+    }
+    if (m_depthPrePass) {
+        // 100 means every pixel was shaded exactly once
+        m_profiler.SetCounter("Overdraw %", static_cast<size_t>(m_depthPrePass->GetOverdraw() * 100.0f));
+    }
+    StreamBuffer::Stats ringStats = StreamBuffer::Get().GetStats();
+    m_profiler.SetMemoryCounter("Streamed per frame", ringStats.bytesLastFrame);
+    m_profiler.SetMemoryCounter("Stream ring", ringStats.capacityBytes);
+    m_profiler.SetCounter("Stream fence waits", ringStats.fenceWaits);
+    m_profiler.SetCounter("Clustered lights", m_clusteredLighting->GetLightCount());
+    m_profiler.SetCounter("Cluster light refs", m_clusteredLighting->GetIndexCount());
+    m_profiler.SetMemoryCounter("Light clusters", m_clusteredLighting->GetMemoryUsage());
+    if (m_assetStreamer) {
+        AssetStreamer::Stats streamStats = m_assetStreamer->GetStats();
+        m_profiler.SetCounter("Asset jobs", streamStats.queuedJobs + streamStats.activeJobs);
+        m_profiler.SetCounter("Pending uploads", streamStats.pendingUploads);
+    }
+    m_profiler.SetMemoryCounter("Profiler", m_profiler.GetEstimatedMemoryUsage());
+}
+
 
 void Application::RenderShadowDemoScene() {
     
@@ -2536,6 +3030,10 @@ void Application::FramebufferSizeCallback(GLFWwindow* window, int width, int hei
         app->m_windowWidth = width;
         app->m_windowHeight = height;
         glViewport(0, 0, width, height);
+        
+        if (app->m_postProcessManager) {
+            app->m_postProcessManager->OnWindowResize(width, height);
+        }
     }
 }
 
@@ -2625,50 +3123,28 @@ void Application::LoadGameTextures() {
         "../../resources/textures/chest_texture.jpg"
     };
     
-    // Load key texture
-    m_keyTexture = 0;
-    for (const auto& path : keyTexturePaths) {
-        m_keyTexture = LoadTexture(path);
-        if (m_keyTexture != 0) {
-            std::cout << "Successfully loaded key texture from: " << path << std::endl;
-            break;
-        }
-    }
-    
-    if (m_keyTexture == 0) {
-        std::cout << "Warning: Failed to load key texture, using default" << std::endl;
-        // Create default texture
-        unsigned char defaultKeyTexture[] = { 255, 215, 0, 255 }; // Gold color
-        glGenTextures(1, &m_keyTexture);
-        glBindTexture(GL_TEXTURE_2D, m_keyTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, defaultKeyTexture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
+    // Solid colours stand in until the streamer uploads the decoded images
+    // into the same texture names; they stay if no candidate path loads
+    unsigned char defaultKeyTexture[] = { 255, 215, 0, 255 }; // Gold color
+    glGenTextures(1, &m_keyTexture);
+    glBindTexture(GL_TEXTURE_2D, m_keyTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, defaultKeyTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     
-    // Load chest texture
-    m_chestTexture = 0;
-    for (const auto& path : chestTexturePaths) {
-        m_chestTexture = LoadTexture(path);
-        if (m_chestTexture != 0) {
-            std::cout << "Successfully loaded chest texture from: " << path << std::endl;
-            break;
-        }
-    }
+    unsigned char defaultChestTexture[] = { 139, 69, 19, 255 }; // Brown color
+    glGenTextures(1, &m_chestTexture);
+    glBindTexture(GL_TEXTURE_2D, m_chestTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, defaultChestTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
     
-    if (m_chestTexture == 0) {
-        std::cout << "Warning: Failed to load chest texture, using default" << std::endl;
-        // Create default texture
-        unsigned char defaultChestTexture[] = { 139, 69, 19, 255 }; // Brown color
-        glGenTextures(1, &m_chestTexture);
-        glBindTexture(GL_TEXTURE_2D, m_chestTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, defaultChestTexture);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
+    m_assetStreamer->RequestTexture(m_keyTexture, std::move(keyTexturePaths));
+    m_assetStreamer->RequestTexture(m_chestTexture, std::move(chestTexturePaths));
     
     m_texturesLoaded = true;
-    std::cout << "Game textures loaded successfully!" << std::endl;
+    std::cout << "Game textures queued for streaming" << std::endl;
 }
 
 void Application::BindKeyTexture() {
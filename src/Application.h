@@ -8,6 +8,7 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
 #include <iostream> 
 
 
@@ -29,6 +30,8 @@ class PerformanceProfiler;
 #include "Camera.h"
 #include "Shader.h"
 #include "Model.h"
+#include "ModelCache.h"
+#include "AssetStreamer.h"
 #include "Texture.h"
 #include "Geometry.h"
 #include "PhysicsManager.h"
@@ -37,7 +40,16 @@ class PerformanceProfiler;
 #include "LayoutManager.h"
 #include "GameInteraction.h"
 #include "ShadowMapping.h"
+#include "ShadowFilterBenchmark.h"
+#include "VertexCacheBenchmark.h"
+#include "PostProcessing.h"
+#include "RenderGraph.h"
+#include "GpuCulling.h"
+#include "DepthPrePass.h"
+#include "ClusteredLighting.h"
+#include "StreamBuffer.h"
 #include "PerformanceProfiler.h"
+#include "PerformanceOverlay.h"
 #include "GameState.h"
 #include "CustomGUI/GUIManager.h"
 #include "IrrklangAudioManager.h"
@@ -162,14 +174,16 @@ struct BallProjectile {
     glm::vec3 color;
 };
 
+// Placed instance of a shared model: the mesh data lives in ModelCache
 struct ModelObject {
-    std::unique_ptr<Model> model;
+    ModelHandle model;
     glm::vec3 position;
     glm::vec3 rotation;
     glm::vec3 scale;
     float animationTime;
     bool isAnimated;
     std::string name;
+    int lod = 0;            // Detail level drawn last frame
 };
 
 class Application {
@@ -213,12 +227,35 @@ private:
     
     
     CustomGUI::GUIManager* m_guiManager;
+    CustomGUI::UIHandle<CustomGUI::UIText> m_statusText;
+    CustomGUI::UIHandle<CustomGUI::UIText> m_performanceText;
+    int m_statusKeysShown = -1;             // Counters last written to the status text
+    int m_statusChestsShown = -1;
+    float m_statusRefreshTimer = 0.0f;      // Time since the FPS/position text was rebuilt
     
     
     bool m_enablePerformanceOverlay;
+    std::unique_ptr<PerformanceOverlay> m_performanceOverlay;
     
     
     std::unique_ptr<ShadowMappingManager> m_shadowManager;
+    std::unique_ptr<ShadowFilterBenchmark> m_shadowBenchmark;
+    std::unique_ptr<PostProcessManager> m_postProcessManager;
+    std::unique_ptr<RenderGraph> m_renderGraph;
+    
+    // Models are tested on the GPU but still drawn one by one, so their
+    // visibility is read back and applied a frame later
+    std::unique_ptr<GpuCulling> m_gpuCulling;
+    std::unique_ptr<GpuCulling::Batch> m_modelCulling;
+    std::vector<CullItem> m_modelCullItems;         // Models drawn this frame, in draw order
+    std::vector<uint64_t> m_modelCullKeys;          // Stable object key of each item above
+    std::vector<uint64_t> m_culledModelKeys;        // Keys of the last culled item list
+    std::unordered_map<uint64_t, bool> m_modelVisibility;  // Object key -> last resolved result
+    static constexpr uint64_t GAME_MODEL_CULL_KEY = 1ull << 32;    // Added to m_gameModels indices; treasures use their ID
+    static constexpr float CULLING_FAR_PLANE = 200.0f;  // Farthest plane any scene pass uses
+    
+    std::unique_ptr<DepthPrePass> m_depthPrePass;
+    std::unique_ptr<ClusteredLighting> m_clusteredLighting;
     bool m_enableShadows;
     float m_shadowStrength;
     
@@ -264,6 +301,21 @@ private:
     
     
     std::vector<ModelObject> m_gameModels;
+    std::unordered_map<int, int> m_treasureLods;   // Treasure ID -> detail level drawn last frame
+    
+    // Opaque objects of the frame, gathered once so the depth pre-pass and
+    // the colour pass draw identical transforms and detail levels
+    struct OpaqueDraw {
+        const Model* model;             // nullptr: marker cube for a model still streaming
+        glm::mat4 transform;
+        int lod;
+        float distance;                 // From the camera; each list is drawn front to back
+        const TreasureData* treasure;   // Treasure-game object (picks its own lights), or nullptr
+        const ModelObject* object;      // Scene model (picks its own material), or nullptr
+    };
+    std::vector<OpaqueDraw> m_treasureDraws;
+    std::vector<OpaqueDraw> m_modelDraws;
+    static constexpr int SHADOW_LOD_BIAS = 1;       // Extra detail levels dropped for shadow casters
     bool m_modelsLoaded;
     
     
@@ -323,6 +375,10 @@ private:
     // Cube for rendering
     std::unique_ptr<Cube> m_cube;
     
+    // Background model/texture loading; uploads are drained once per frame
+    std::unique_ptr<AssetStreamer> m_assetStreamer;
+    static constexpr float ASSET_UPLOAD_BUDGET_MS = 2.0f;
+    
     // Texture related
     unsigned int m_keyTexture = 0;
     unsigned int m_chestTexture = 0;
@@ -338,6 +394,7 @@ private:
     void ProcessInput();
     void Update();
     void Render();
+    void RenderShadowPass();
     void RenderGameScene();
     void RenderLightCube(const glm::mat4& view, const glm::mat4& projection);
     void RenderMenuBackground();
@@ -367,6 +424,7 @@ private:
     void InitializeAdvancedLighting();
     void UpdateAdvancedLighting();
     void SetupLightingUniforms(Shader& shader);
+    void GatherLights(const glm::mat4& view, float aspect);
     
     
     void InitializeModels();
@@ -375,6 +433,17 @@ private:
                       const glm::vec3& scale = glm::vec3(1.0f), bool animated = false);
     void UpdateModels();
     void RenderModels();
+    void GatherModelDraws();
+    void GatherTreasureDraws();
+    glm::mat4 GetPendingMarkerTransform(const glm::vec3& position) const;
+    glm::mat4 GetGroundTransform() const;
+    static void SortFrontToBack(std::vector<OpaqueDraw>& draws);
+    void DrawOpaque(const OpaqueDraw& draw, Shader& shader, bool depthOnly);
+    void RenderOpaqueUnlit(Shader& shader);
+    int SelectModelLod(const Model& model, const glm::mat4& transform, int currentLod) const;
+    bool IsModelVisible(const Model& model, const glm::mat4& transform, uint64_t key);
+    void AddCullingPass(RenderGraph& graph, RenderGraph::ResourceHandle sceneDepth);
+    void RunGpuCulling(GLuint sceneDepth, int width, int height);
     
     
     void UpdateTerrain();
@@ -407,12 +476,15 @@ private:
     
     
     void InitializeShadowMapping();
-    void RenderShadowMap();
+    void RenderShadowMap(const glm::mat4& lightSpaceMatrix, bool staticCasters);
+    void InitializePostProcessing();
     
     // State management methods
     void SetPendingStateChange(GameState newState);
     void UpdateCursorMode();
     void RenderGUI();
+    void ReportPerformanceCounters();
+    void RunVertexCacheBenchmark();
     
     // Terrain initialization
     void InitializeTerrain();
@@ -0,0 +1,211 @@
+﻿/**
+ * @file AssetStreamer.cpp
+ * @brief Worker pool, image decoding and the budgeted upload queue
+ */
+
+#include "AssetStreamer.h"
+#include <stb_image.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+AssetStreamer::AssetStreamer(unsigned int workerCount)
+    : m_activeJobs(0)
+    , m_completedUploads(0)
+    , m_lastUploadMs(0.0f)
+    , m_stopping(false)
+{
+    if (workerCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    workerCount = std::min(workerCount, MAX_WORKERS);
+
+    for (unsigned int i = 0; i < workerCount; i++) {
+        m_workers.emplace_back(&AssetStreamer::WorkerLoop, this);
+    }
+    std::cout << "[AssetStreamer] Started " << workerCount << " loader threads" << std::endl;
+}
+
+AssetStreamer::~AssetStreamer() {
+    Shutdown();
+}
+
+void AssetStreamer::Submit(LoadJob job) {
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        if (m_stopping) {
+            return;
+        }
+        m_jobs.push_back(std::move(job));
+    }
+    m_jobAvailable.notify_one();
+}
+
+void AssetStreamer::RequestTexture(GLuint texture, std::vector<std::string> candidatePaths) {
+    Submit([texture, candidatePaths = std::move(candidatePaths)]() -> UploadStep {
+        auto image = std::make_shared<ImageData>();
+        for (const std::string& path : candidatePaths) {
+            if (DecodeImage(path, *image)) {
+                std::cout << "[AssetStreamer] Decoded " << path << " (" << image->width << "x" << image->height
+                          << ", " << image->channels << " channels)" << std::endl;
+                return [texture, image]() { UploadImage(texture, *image); };
+            }
+        }
+        std::cerr << "[AssetStreamer] Could not load " << (candidatePaths.empty() ? std::string("<none>") : candidatePaths.front())
+                  << "; keeping placeholder" << std::endl;
+        return UploadStep();
+    });
+}
+
+size_t AssetStreamer::ProcessUploads(float budgetMs) {
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t processed = 0;
+
+    while (true) {
+        UploadStep step;
+        {
+            std::lock_guard<std::mutex> lock(m_uploadMutex);
+            if (m_uploads.empty()) {
+                break;
+            }
+            step = std::move(m_uploads.front());
+            m_uploads.pop_front();
+        }
+
+        step();
+        processed++;
+
+        float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        if (elapsedMs >= budgetMs) {
+            break;
+        }
+    }
+
+    m_completedUploads += processed;
+    m_lastUploadMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    return processed;
+}
+
+bool AssetStreamer::IsIdle() const {
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        if (!m_jobs.empty() || m_activeJobs > 0) {
+            return false;
+        }
+    }
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    return m_uploads.empty();
+}
+
+AssetStreamer::Stats AssetStreamer::GetStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        stats.queuedJobs = m_jobs.size();
+        stats.activeJobs = m_activeJobs;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_uploadMutex);
+        stats.pendingUploads = m_uploads.size();
+    }
+    stats.completedUploads = m_completedUploads;
+    stats.lastUploadMs = m_lastUploadMs;
+    return stats;
+}
+
+void AssetStreamer::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        if (m_stopping) {
+            return;
+        }
+        m_stopping = true;
+        m_jobs.clear();
+    }
+    m_jobAvailable.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+
+    std::lock_guard<std::mutex> lock(m_uploadMutex);
+    m_uploads.clear();
+}
+
+void AssetStreamer::WorkerLoop() {
+    // Decode in file order regardless of what the GL thread last set for Texture
+    stbi_set_flip_vertically_on_load_thread(0);
+
+    while (true) {
+        LoadJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_jobMutex);
+            m_jobAvailable.wait(lock, [this]() { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) {
+                return;
+            }
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_activeJobs++;
+        }
+
+        UploadStep step;
+        try {
+            step = job();
+        } catch (const std::exception& e) {
+            std::cerr << "[AssetStreamer] Load job failed: " << e.what() << std::endl;
+        }
+
+        // Publish before the job stops counting as active so IsIdle() never sees a gap
+        {
+            std::lock_guard<std::mutex> lock(m_uploadMutex);
+            if (step) {
+                m_uploads.push_back(std::move(step));
+            }
+        }
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_activeJobs--;
+    }
+}
+
+bool AssetStreamer::DecodeImage(const std::string& path, ImageData& image) {
+    int width, height, channels;
+    unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+    if (!data) {
+        return false;
+    }
+
+    image.width = width;
+    image.height = height;
+    image.channels = channels;
+    image.pixels.assign(data, data + static_cast<size_t>(width) * height * channels);
+    stbi_image_free(data);
+    return true;
+}
+
+void AssetStreamer::UploadImage(GLuint texture, const ImageData& image) {
+    GLenum format = GL_RGB;
+    if (image.channels == 1)
+        format = GL_RED;
+    else if (image.channels == 2)
+        format = GL_RG;
+    else if (image.channels == 4)
+        format = GL_RGBA;
+
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
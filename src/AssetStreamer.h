@@ -0,0 +1,115 @@
+﻿/**
+ * @file AssetStreamer.h
+ * @brief Background asset loading with a budgeted GL upload queue
+ *
+ * File I/O and decoding (images, ASSIMP imports, cooked meshes) run on a
+ * small worker pool. Each job hands back an upload step that needs the GL
+ * context; the render thread runs queued steps from ProcessUploads() until
+ * its per-frame time budget is spent, so a burst of finished loads never
+ * stalls a frame for long.
+ *
+ * Callers keep drawing placeholders until the upload step runs:
+ * RequestTexture() fills a texture name that already holds a placeholder
+ * image, and ModelCache::LoadAsync() hands out models that report
+ * IsReady() once their meshes are on the GPU.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Worker pool plus GL-thread upload queue
+ */
+class AssetStreamer {
+public:
+    using UploadStep = std::function<void()>;       // Runs on the GL thread
+    using LoadJob = std::function<UploadStep()>;    // Runs on a worker; may return an empty step
+
+    struct Stats {
+        size_t queuedJobs;          // Waiting for a worker
+        size_t activeJobs;          // Being loaded right now
+        size_t pendingUploads;      // Loaded, waiting for GL time
+        size_t completedUploads;
+        float lastUploadMs;         // GL time spent in the last ProcessUploads()
+    };
+
+    /**
+     * @brief Decoded 8-bit image
+     */
+    struct ImageData {
+        int width;
+        int height;
+        int channels;
+        std::vector<unsigned char> pixels;
+    };
+
+    /**
+     * @param workerCount Worker threads; 0 picks one less than the hardware threads
+     */
+    explicit AssetStreamer(unsigned int workerCount = 0);
+    ~AssetStreamer();
+
+    AssetStreamer(const AssetStreamer&) = delete;
+    AssetStreamer& operator=(const AssetStreamer&) = delete;
+
+    void Submit(LoadJob job);
+
+    /**
+     * @brief Decode an image on a worker and upload it into an existing texture
+     *
+     * @param texture Texture name currently holding a placeholder; it is
+     *                left untouched if no candidate can be decoded
+     * @param candidatePaths Files tried in order
+     */
+    void RequestTexture(GLuint texture, std::vector<std::string> candidatePaths);
+
+    /**
+     * @brief Run queued upload steps on the GL thread
+     *
+     * Steps are not split, so one large upload can overrun the budget;
+     * at least one step runs per call so loading always progresses.
+     *
+     * @param budgetMs Time after which no further step is started
+     * @return Number of steps run
+     */
+    size_t ProcessUploads(float budgetMs);
+
+    /**
+     * @brief True when nothing is queued, loading or waiting for upload
+     */
+    bool IsIdle() const;
+
+    Stats GetStats() const;
+
+    /**
+     * @brief Stop the workers and drop outstanding jobs and uploads
+     */
+    void Shutdown();
+
+    static bool DecodeImage(const std::string& path, ImageData& image);
+    static void UploadImage(GLuint texture, const ImageData& image);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<LoadJob> m_jobs;
+    std::deque<UploadStep> m_uploads;
+    mutable std::mutex m_jobMutex;
+    mutable std::mutex m_uploadMutex;
+    std::condition_variable m_jobAvailable;
+    size_t m_activeJobs;
+    size_t m_completedUploads;
+    float m_lastUploadMs;
+    bool m_stopping;
+
+    static constexpr unsigned int MAX_WORKERS = 4;
+};
@@ -0,0 +1,277 @@
+﻿#include "ClusteredLighting.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+ClusteredLight ClusteredLight::Point(const glm::vec3& position, const glm::vec3& color,
+                                     float linear, float quadratic, float ambient) {
+    // A cone wider than the sphere: every direction is inside
+    return { position, color, ambient, linear, quadratic, glm::vec3(0.0f), -1.0f, -2.0f };
+}
+
+ClusteredLight ClusteredLight::Spot(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color,
+                                    float cosInner, float cosOuter, float linear, float quadratic, float ambient) {
+    return { position, color, ambient, linear, quadratic, glm::normalize(direction), cosInner, cosOuter };
+}
+
+ClusteredLighting::ClusteredLighting()
+    : m_tileSize(1.0f)
+    , m_depthScale(0.0f)
+    , m_depthBias(0.0f)
+    , m_initialized(false)
+    , m_streamed(false)
+    , m_textureAlignment(16)
+{
+}
+
+ClusteredLighting::~ClusteredLighting() {
+    Shutdown();
+}
+
+bool ClusteredLighting::Initialize() {
+    auto create = [](BufferTexture& target, GLenum format) {
+        glGenBuffers(1, &target.buffer);
+        glBindBuffer(GL_TEXTURE_BUFFER, target.buffer);
+        glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+        target.bytes = 16;
+        target.format = format;
+        glGenTextures(1, &target.texture);
+        glBindTexture(GL_TEXTURE_BUFFER, target.texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, format, target.buffer);
+    };
+    create(m_lightBuffer, GL_RGBA32F);
+    create(m_recordBuffer, GL_RG32UI);
+    create(m_indexBuffer, GL_R32UI);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    m_streamed = GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_texture_buffer_range;
+    if (m_streamed) {
+        GLint alignment = 0;
+        glGetIntegerv(GL_TEXTURE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        m_textureAlignment = std::max<size_t>(static_cast<size_t>(alignment), 16);
+    }
+
+    m_lights.reserve(MAX_LIGHTS);
+    m_records.resize(CLUSTER_COUNT * 2, 0);
+    m_clusterFill.resize(CLUSTER_COUNT, 0);
+    m_initialized = true;
+
+    std::cout << "[ClusteredLighting] " << CLUSTER_X << "x" << CLUSTER_Y << "x" << CLUSTER_Z
+              << " froxels, up to " << MAX_LIGHTS_PER_CLUSTER << " lights each" << std::endl;
+    return true;
+}
+
+void ClusteredLighting::Shutdown() {
+    for (BufferTexture* target : { &m_lightBuffer, &m_recordBuffer, &m_indexBuffer }) {
+        if (target->texture != 0) {
+            glDeleteTextures(1, &target->texture);
+        }
+        if (target->buffer != 0) {
+            glDeleteBuffers(1, &target->buffer);
+        }
+        *target = {};
+    }
+    m_initialized = false;
+    m_streamed = false;
+}
+
+void ClusteredLighting::BeginFrame() {
+    m_lights.clear();
+}
+
+bool ClusteredLighting::AddLight(const ClusteredLight& light) {
+    if (m_lights.size() >= MAX_LIGHTS) {
+        return false;
+    }
+    m_lights.push_back(light);
+    return true;
+}
+
+float ClusteredLighting::ComputeRadius(const ClusteredLight& light) {
+    // Distance where 1 / (1 + l*d + q*d^2) * brightness drops to the cutoff
+    float brightness = std::max({ light.color.r, light.color.g, light.color.b });
+    float target = brightness / ATTENUATION_CUTOFF - 1.0f;
+    if (target <= 0.0f) {
+        return 0.0f;
+    }
+    float radius = MAX_LIGHT_RADIUS;
+    if (light.quadratic > 0.0f) {
+        radius = (-light.linear + std::sqrt(light.linear * light.linear + 4.0f * light.quadratic * target))
+               / (2.0f * light.quadratic);
+    } else if (light.linear > 0.0f) {
+        radius = target / light.linear;
+    }
+    return std::min(radius, MAX_LIGHT_RADIUS);
+}
+
+int ClusteredLighting::GetSlice(float viewDepth) const {
+    int slice = static_cast<int>(std::floor(std::log(viewDepth) * m_depthScale + m_depthBias));
+    return std::clamp(slice, 0, CLUSTER_Z - 1);
+}
+
+void ClusteredLighting::Build(const glm::mat4& view, float fovY, float aspect, float nearPlane, float farPlane,
+                              int viewportWidth, int viewportHeight) {
+    if (!m_initialized) {
+        return;
+    }
+
+    m_tileSize = glm::vec2(static_cast<float>(std::max(viewportWidth, 1)) / CLUSTER_X,
+                           static_cast<float>(std::max(viewportHeight, 1)) / CLUSTER_Y);
+    float logRange = std::log(farPlane / nearPlane);
+    m_depthScale = CLUSTER_Z / logRange;
+    m_depthBias = -CLUSTER_Z * std::log(nearPlane) / logRange;
+
+    float tanHalfY = std::tan(fovY * 0.5f);
+    float tanHalfX = tanHalfY * aspect;
+
+    // Pass 1: froxel range of every light and the per-froxel counts
+    std::fill(m_clusterFill.begin(), m_clusterFill.end(), 0);
+    m_lightData.clear();
+    m_lightRanges.clear();
+    for (const ClusteredLight& light : m_lights) {
+        float radius = ComputeRadius(light);
+        m_lightData.push_back(glm::vec4(light.position, radius));
+        m_lightData.push_back(glm::vec4(light.color, light.ambient));
+        m_lightData.push_back(glm::vec4(light.direction, light.cosOuter));
+        m_lightData.push_back(glm::vec4(light.cosInner, light.linear, light.quadratic, 0.0f));
+
+        glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.0f));
+        float nearDepth = std::max(-center.z - radius, nearPlane);
+        float farDepth = -center.z + radius;
+        if (radius <= 0.0f || farDepth < nearPlane) {
+            m_lightRanges.push_back(glm::ivec3(0));
+            m_lightRanges.push_back(glm::ivec3(-1));
+            continue;
+        }
+
+        // Screen extent of the sphere's view-space box; x/d and y/d peak at a corner
+        glm::vec2 ndcMin(1.0f), ndcMax(-1.0f);
+        for (float depth : { nearDepth, farDepth }) {
+            for (float dx : { -radius, radius }) {
+                for (float dy : { -radius, radius }) {
+                    glm::vec2 ndc((center.x + dx) / (depth * tanHalfX), (center.y + dy) / (depth * tanHalfY));
+                    ndcMin = glm::min(ndcMin, ndc);
+                    ndcMax = glm::max(ndcMax, ndc);
+                }
+            }
+        }
+        if (ndcMin.x > 1.0f || ndcMin.y > 1.0f || ndcMax.x < -1.0f || ndcMax.y < -1.0f) {
+            m_lightRanges.push_back(glm::ivec3(0));
+            m_lightRanges.push_back(glm::ivec3(-1));
+            continue;
+        }
+
+        auto tile = [](float ndc, int tiles) {
+            return std::clamp(static_cast<int>(std::floor((ndc * 0.5f + 0.5f) * tiles)), 0, tiles - 1);
+        };
+        glm::ivec3 minCluster(tile(ndcMin.x, CLUSTER_X), tile(ndcMin.y, CLUSTER_Y), GetSlice(nearDepth));
+        glm::ivec3 maxCluster(tile(ndcMax.x, CLUSTER_X), tile(ndcMax.y, CLUSTER_Y), GetSlice(farDepth));
+        m_lightRanges.push_back(minCluster);
+        m_lightRanges.push_back(maxCluster);
+
+        for (int z = minCluster.z; z <= maxCluster.z; z++) {
+            for (int y = minCluster.y; y <= maxCluster.y; y++) {
+                for (int x = minCluster.x; x <= maxCluster.x; x++) {
+                    GLuint& count = m_clusterFill[x + CLUSTER_X * (y + CLUSTER_Y * z)];
+                    count = std::min(count + 1, MAX_LIGHTS_PER_CLUSTER);
+                }
+            }
+        }
+    }
+
+    // Offsets from the capped counts
+    GLuint offset = 0;
+    for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+        m_records[cluster * 2] = offset;
+        m_records[cluster * 2 + 1] = 0;
+        offset += m_clusterFill[cluster];
+    }
+
+    // Pass 2: write the indices; froxels that are full drop later lights
+    m_indices.assign(std::max<GLuint>(offset, 1), 0);
+    for (size_t light = 0; light < m_lights.size(); light++) {
+        const glm::ivec3& minCluster = m_lightRanges[light * 2];
+        const glm::ivec3& maxCluster = m_lightRanges[light * 2 + 1];
+        for (int z = minCluster.z; z <= maxCluster.z; z++) {
+            for (int y = minCluster.y; y <= maxCluster.y; y++) {
+                for (int x = minCluster.x; x <= maxCluster.x; x++) {
+                    int cluster = x + CLUSTER_X * (y + CLUSTER_Y * z);
+                    GLuint& count = m_records[cluster * 2 + 1];
+                    if (count < m_clusterFill[cluster]) {
+                        m_indices[m_records[cluster * 2] + count] = static_cast<GLuint>(light);
+                        count++;
+                    }
+                }
+            }
+        }
+    }
+    m_indices.resize(offset);
+
+    if (m_lightData.empty()) {
+        m_lightData.push_back(glm::vec4(0.0f));
+    }
+    Upload(m_lightBuffer, m_lightData.data(), m_lightData.size() * sizeof(glm::vec4));
+    Upload(m_recordBuffer, m_records.data(), m_records.size() * sizeof(GLuint));
+    Upload(m_indexBuffer, m_indices.data(), std::max<size_t>(m_indices.size(), 1) * sizeof(GLuint));
+}
+
+void ClusteredLighting::Upload(BufferTexture& target, const void* data, size_t bytes) {
+    target.bytes = bytes;
+    if (m_streamed) {
+        target.stream = StreamBuffer::Get().Write(data, bytes, m_textureAlignment);
+        if (target.stream.buffer != 0) {
+            glBindTexture(GL_TEXTURE_BUFFER, target.texture);
+            glTexBufferRange(GL_TEXTURE_BUFFER, target.format, target.stream.buffer,
+                             static_cast<GLintptr>(target.stream.offset), static_cast<GLsizeiptr>(bytes));
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+            return;
+        }
+    }
+
+    // glTexBuffer on 4.1 can only view a whole buffer, so a ring range cannot be
+    // attached; orphan our own buffer instead so the upload never waits for last
+    // frame's draws
+    glBindBuffer(GL_TEXTURE_BUFFER, target.buffer);
+    glBufferData(GL_TEXTURE_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, data);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    if (m_streamed) {
+        // The ring write failed; point the texture back at our own buffer
+        glBindTexture(GL_TEXTURE_BUFFER, target.texture);
+        glTexBuffer(GL_TEXTURE_BUFFER, target.format, target.buffer);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+}
+
+void ClusteredLighting::Apply(Shader& shader) const {
+    // Sampler units are always assigned: buffer samplers left on unit 0 would clash with the material textures
+    shader.SetInt("clusterLights", LIGHT_TEXTURE_UNIT);
+    shader.SetInt("clusterRecords", RECORD_TEXTURE_UNIT);
+    shader.SetInt("clusterIndices", INDEX_TEXTURE_UNIT);
+    // Ring ranges only hold the frame that wrote them; a frame that skipped Build() gets no cluster lights
+    auto resident = [](const BufferTexture& target) {
+        return target.stream.buffer == 0 || StreamBuffer::Get().IsResident(target.stream);
+    };
+    bool current = resident(m_lightBuffer) && resident(m_recordBuffer) && resident(m_indexBuffer);
+    shader.SetInt("clusterLightCount", m_initialized && current ? static_cast<int>(m_lights.size()) : 0);
+    if (!m_initialized) {
+        return;
+    }
+
+    glActiveTexture(GL_TEXTURE0 + LIGHT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_lightBuffer.texture);
+    glActiveTexture(GL_TEXTURE0 + RECORD_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_recordBuffer.texture);
+    glActiveTexture(GL_TEXTURE0 + INDEX_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, m_indexBuffer.texture);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.SetVec2("clusterTileSize", m_tileSize);
+    shader.SetFloat("clusterDepthScale", m_depthScale);
+    shader.SetFloat("clusterDepthBias", m_depthBias);
+}
+
+size_t ClusteredLighting::GetMemoryUsage() const {
+    return m_lightBuffer.bytes + m_recordBuffer.bytes + m_indexBuffer.bytes;
+}
@@ -0,0 +1,145 @@
+﻿/**
+ * @file ClusteredLighting.h
+ * @brief Clustered forward shading for many point and spot lights
+ *
+ * The view frustum is split into a CLUSTER_X x CLUSTER_Y x CLUSTER_Z
+ * grid of froxels: screen tiles in XY and exponentially spaced slices of
+ * view depth in Z. Every frame the lights submitted with AddLight() are
+ * binned on the CPU:
+ * - Each light's bounding sphere is turned into a range of froxels from
+ *   its view-space box
+ * - Per-froxel counts are prefix-summed into (offset, count) records and
+ *   the light indices are written into one compact list
+ *
+ * Lights, records and indices are uploaded to three buffer textures, so
+ * the lit fragment shaders only need GL 3.1 features. With GL 4.3 (or
+ * ARB_texture_buffer_range) the data is written to the StreamBuffer ring
+ * and each texture views its range of it; the 4.1 baseline can only
+ * attach whole buffers, so there each buffer is orphaned and refilled.
+ * A fragment finds
+ * its froxel from gl_FragCoord and its view depth and loops over that
+ * froxel's lights only. Each froxel keeps at most MAX_LIGHTS_PER_CLUSTER
+ * lights, which bounds the per-pixel cost; lights added first win, so
+ * submit the important ones first.
+ *
+ * Light radii come from the attenuation: a light is cut off where it falls
+ * below ATTENUATION_CUTOFF of its colour, with a smooth window so the
+ * edge does not show.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <vector>
+#include "Shader.h"
+#include "StreamBuffer.h"
+
+/**
+ * @brief One point or spot light
+ */
+struct ClusteredLight {
+    glm::vec3 position;
+    glm::vec3 color;        // Diffuse and specular colour
+    float ambient;          // Fraction of the colour added regardless of the surface normal
+    float linear;           // Attenuation 1 / (1 + linear * d + quadratic * d^2)
+    float quadratic;
+    glm::vec3 direction;    // Spot axis; unused for point lights
+    float cosInner;         // Full intensity inside this cone
+    float cosOuter;         // Zero intensity outside this cone
+
+    static ClusteredLight Point(const glm::vec3& position, const glm::vec3& color,
+                                float linear, float quadratic, float ambient = 0.0f);
+    static ClusteredLight Spot(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& color,
+                               float cosInner, float cosOuter, float linear, float quadratic, float ambient = 0.0f);
+};
+
+/**
+ * @brief Per-frame light list, froxel binning and the buffers the shaders read
+ *
+ * Per frame: BeginFrame(), AddLight() for every light, Build() with the
+ * camera, then Apply() on each lit program before drawing with it.
+ */
+class ClusteredLighting {
+public:
+    static constexpr int CLUSTER_X = 16;                // Must match the lit fragment shaders
+    static constexpr int CLUSTER_Y = 9;
+    static constexpr int CLUSTER_Z = 24;
+    static constexpr int CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+    static constexpr size_t MAX_LIGHTS = 1024;
+    static constexpr GLuint MAX_LIGHTS_PER_CLUSTER = 32;
+
+    ClusteredLighting();
+    ~ClusteredLighting();
+
+    bool Initialize();
+    void Shutdown();
+
+    void BeginFrame();
+
+    /**
+     * @return False once MAX_LIGHTS lights were added this frame
+     */
+    bool AddLight(const ClusteredLight& light);
+
+    /**
+     * @brief Bin this frame's lights into froxels and upload everything
+     *
+     * @param view Camera view matrix
+     * @param fovY Vertical field of view in radians
+     * @param aspect Viewport aspect ratio
+     * @param nearPlane Start of the first depth slice
+     * @param farPlane End of the last depth slice; farther fragments use the last slice
+     * @param viewportWidth Size of the target the lit passes render to, in pixels
+     * @param viewportHeight
+     */
+    void Build(const glm::mat4& view, float fovY, float aspect, float nearPlane, float farPlane,
+               int viewportWidth, int viewportHeight);
+
+    /**
+     * @brief Bind the light buffers and set the cluster uniforms on the active program
+     */
+    void Apply(Shader& shader) const;
+
+    size_t GetLightCount() const { return m_lights.size(); }
+    size_t GetIndexCount() const { return m_indices.size(); }
+    size_t GetMemoryUsage() const;
+
+private:
+    struct BufferTexture {
+        GLuint buffer = 0;              // Own storage for the 4.1 path and failed ring writes
+        GLuint texture = 0;
+        GLenum format = GL_R32UI;
+        size_t bytes = 0;
+        StreamAllocation stream;        // Ring range the texture views, if streamed
+    };
+
+    static float ComputeRadius(const ClusteredLight& light);
+    int GetSlice(float viewDepth) const;
+    void Upload(BufferTexture& target, const void* data, size_t bytes);
+
+    std::vector<ClusteredLight> m_lights;
+    std::vector<glm::vec4> m_lightData;     // LIGHT_TEXELS per light
+    std::vector<GLuint> m_records;          // Offset, count per froxel
+    std::vector<GLuint> m_indices;
+    std::vector<GLuint> m_clusterFill;      // Lights binned into each froxel so far
+    std::vector<glm::ivec3> m_lightRanges;  // Min/max froxel per light, two entries each
+
+    BufferTexture m_lightBuffer;
+    BufferTexture m_recordBuffer;
+    BufferTexture m_indexBuffer;
+
+    glm::vec2 m_tileSize;
+    float m_depthScale;                     // Slice = log(depth) * scale + bias
+    float m_depthBias;
+    bool m_initialized;
+    bool m_streamed;                        // Texture buffer ranges available
+    size_t m_textureAlignment;              // Offset alignment for texture buffer ranges
+
+    static constexpr int LIGHT_TEXELS = 4;
+    static constexpr float ATTENUATION_CUTOFF = 0.02f;
+    static constexpr float MAX_LIGHT_RADIUS = 100.0f;
+    static constexpr GLuint LIGHT_TEXTURE_UNIT = 10;    // Clear of the material, shadow and Hi-Z units
+    static constexpr GLuint RECORD_TEXTURE_UNIT = 11;
+    static constexpr GLuint INDEX_TEXTURE_UNIT = 12;
+};
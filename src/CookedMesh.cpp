@@ -0,0 +1,373 @@
+﻿/**
+ * @file CookedMesh.cpp
+ * @brief Cooked mesh file validation, mapping and writing
+ */
+
+#include "CookedMesh.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+static_assert(sizeof(Vertex) == 14 * sizeof(float), "Cooked vertices are stored in the GPU layout of Vertex");
+
+namespace {
+
+    size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    std::string GetDirectory(const std::string& path) {
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        return parent.empty() ? std::string(".") : parent.generic_string();
+    }
+
+}
+
+CookedMeshFile::CookedMeshFile()
+    : m_boundsMin(0.0f)
+    , m_boundsMax(0.0f)
+{
+}
+
+std::string CookedMeshFile::GetCookedPath(const std::string& sourcePath, unsigned int importFlags) {
+    std::ostringstream name;
+    name << GetDirectory(sourcePath) << "/cooked/" << std::filesystem::path(sourcePath).filename().generic_string()
+         << "." << std::hex << std::setw(8) << std::setfill('0') << importFlags << ".mesh";
+    return name.str();
+}
+
+bool CookedMeshFile::Open(const std::string& sourcePath, unsigned int importFlags) {
+    Close();
+
+    if (!m_file.Open(GetCookedPath(sourcePath, importFlags))) {
+        return false;
+    }
+    if (!Parse(GetDirectory(sourcePath), importFlags)) {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void CookedMeshFile::Close() {
+    m_meshes.clear();
+    m_file.Close();
+}
+
+bool CookedMeshFile::Parse(const std::string& directory, unsigned int importFlags) {
+    const unsigned char* data = m_file.GetData();
+    size_t fileSize = m_file.GetSize();
+
+    if (fileSize < sizeof(Header)) {
+        return false;
+    }
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.magic != MAGIC || header.version != VERSION ||
+        header.importFlags != importFlags || header.vertexSize != sizeof(Vertex)) {
+        return false;
+    }
+
+    size_t dependencyStart = sizeof(Header);
+    size_t meshStart = dependencyStart + size_t(header.dependencyCount) * sizeof(DependencyRecord);
+    size_t textureStart = meshStart + size_t(header.meshCount) * sizeof(MeshRecord);
+    size_t lodStart = textureStart + size_t(header.textureCount) * sizeof(TextureRecord);
+    size_t stringStart = lodStart + size_t(header.lodCount) * sizeof(LodRecord);
+    if (stringStart + header.stringBytes > fileSize) {
+        return false;
+    }
+    const char* strings = reinterpret_cast<const char*>(data + stringStart);
+    auto readString = [&](uint32_t offset, uint32_t length, std::string& out) {
+        if (size_t(offset) + length > header.stringBytes) {
+            return false;
+        }
+        out.assign(strings + offset, length);
+        return true;
+    };
+
+    // Sources first: a stale file is rejected before any mesh is looked at
+    for (uint32_t i = 0; i < header.dependencyCount; i++) {
+        DependencyRecord record;
+        std::memcpy(&record, data + dependencyStart + i * sizeof(DependencyRecord), sizeof(record));
+        std::string name;
+        if (!readString(record.pathOffset, record.pathLength, name) ||
+            !IsDependencyCurrent(directory + "/" + name, record)) {
+            return false;
+        }
+    }
+
+    std::vector<TextureRef> textures(header.textureCount);
+    for (uint32_t i = 0; i < header.textureCount; i++) {
+        TextureRecord record;
+        std::memcpy(&record, data + textureStart + i * sizeof(TextureRecord), sizeof(record));
+        if (!readString(record.typeOffset, record.typeLength, textures[i].type) ||
+            !readString(record.pathOffset, record.pathLength, textures[i].path)) {
+            return false;
+        }
+    }
+
+    m_meshes.reserve(header.meshCount);
+    for (uint32_t i = 0; i < header.meshCount; i++) {
+        MeshRecord record;
+        std::memcpy(&record, data + meshStart + i * sizeof(MeshRecord), sizeof(record));
+
+        uint64_t vertexBytes = uint64_t(record.vertexCount) * sizeof(Vertex);
+        uint64_t indexBytes = uint64_t(record.indexCount) * sizeof(unsigned int);
+        if (record.vertexOffset % alignof(Vertex) != 0 || record.indexOffset % alignof(unsigned int) != 0 ||
+            record.vertexOffset + vertexBytes > fileSize || record.indexOffset + indexBytes > fileSize ||
+            size_t(record.firstTexture) + record.textureCount > textures.size() ||
+            size_t(record.firstLod) + record.lodCount > header.lodCount) {
+            return false;
+        }
+
+        std::vector<MeshLod> lods(record.lodCount);
+        for (uint32_t l = 0; l < record.lodCount; l++) {
+            LodRecord lodRecord;
+            std::memcpy(&lodRecord, data + lodStart + size_t(record.firstLod + l) * sizeof(LodRecord), sizeof(lodRecord));
+            if (uint64_t(lodRecord.indexOffset) + lodRecord.indexCount > record.indexCount) {
+                return false;
+            }
+            lods[l] = { lodRecord.indexOffset, lodRecord.indexCount, lodRecord.error };
+        }
+
+        MeshView view;
+        view.vertices = std::span<const Vertex>(
+            reinterpret_cast<const Vertex*>(data + record.vertexOffset), record.vertexCount);
+        view.indices = std::span<const unsigned int>(
+            reinterpret_cast<const unsigned int*>(data + record.indexOffset), record.indexCount);
+        view.lods = std::move(lods);
+        view.textures.assign(textures.begin() + record.firstTexture,
+                             textures.begin() + record.firstTexture + record.textureCount);
+        view.boundsMin = glm::vec3(record.boundsMin[0], record.boundsMin[1], record.boundsMin[2]);
+        view.boundsMax = glm::vec3(record.boundsMax[0], record.boundsMax[1], record.boundsMax[2]);
+        m_meshes.push_back(std::move(view));
+    }
+
+    m_boundsMin = glm::vec3(header.boundsMin[0], header.boundsMin[1], header.boundsMin[2]);
+    m_boundsMax = glm::vec3(header.boundsMax[0], header.boundsMax[1], header.boundsMax[2]);
+    return true;
+}
+
+bool CookedMeshFile::Write(const std::string& sourcePath, unsigned int importFlags, const std::vector<MeshView>& meshes) {
+    std::string sourceDirectory = GetDirectory(sourcePath);
+    std::vector<char> strings;
+    auto addString = [&strings](const std::string& text, uint32_t& offset, uint32_t& length) {
+        offset = static_cast<uint32_t>(strings.size());
+        length = static_cast<uint32_t>(text.size());
+        strings.insert(strings.end(), text.begin(), text.end());
+    };
+
+    // The model file plus any MTL libraries it pulls materials from
+    std::vector<DependencyRecord> dependencies;
+    std::vector<std::string> dependencyNames{ std::filesystem::path(sourcePath).filename().generic_string() };
+    for (size_t i = 0; i < dependencyNames.size(); i++) {
+        std::string path = sourceDirectory + "/" + dependencyNames[i];
+        MappedFile source;
+        DependencyRecord record{};
+        if (!source.Open(path) || !ReadFileStamp(path, record.size, record.writeTime)) {
+            if (i == 0) {
+                std::cerr << "[CookedMesh] Cannot read source " << path << std::endl;
+                return false;
+            }
+            continue;
+        }
+        record.hash = HashBytes(source.GetData(), source.GetSize());
+        addString(dependencyNames[i], record.pathOffset, record.pathLength);
+        dependencies.push_back(record);
+
+        if (i == 0) {
+            std::string extension = std::filesystem::path(sourcePath).extension().generic_string();
+            std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+            if (extension == ".obj") {
+                std::vector<std::string> libraries = FindMaterialLibraries(source.GetData(), source.GetSize());
+                dependencyNames.insert(dependencyNames.end(), libraries.begin(), libraries.end());
+            }
+        }
+    }
+
+    std::vector<MeshRecord> meshRecords(meshes.size());
+    std::vector<TextureRecord> textureRecords;
+    std::vector<LodRecord> lodRecords;
+    glm::vec3 boundsMin(0.0f), boundsMax(0.0f);
+    for (size_t i = 0; i < meshes.size(); i++) {
+        const MeshView& mesh = meshes[i];
+        MeshRecord& record = meshRecords[i];
+        record.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+        record.indexCount = static_cast<uint32_t>(mesh.indices.size());
+        record.firstTexture = static_cast<uint32_t>(textureRecords.size());
+        record.textureCount = static_cast<uint32_t>(mesh.textures.size());
+        record.firstLod = static_cast<uint32_t>(lodRecords.size());
+        record.lodCount = static_cast<uint32_t>(mesh.lods.size());
+        for (const MeshLod& lod : mesh.lods) {
+            lodRecords.push_back({ lod.indexOffset, lod.indexCount, lod.error });
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            record.boundsMin[axis] = mesh.boundsMin[axis];
+            record.boundsMax[axis] = mesh.boundsMax[axis];
+        }
+        boundsMin = i == 0 ? mesh.boundsMin : glm::min(boundsMin, mesh.boundsMin);
+        boundsMax = i == 0 ? mesh.boundsMax : glm::max(boundsMax, mesh.boundsMax);
+
+        for (const TextureRef& texture : mesh.textures) {
+            TextureRecord textureRecord;
+            addString(texture.type, textureRecord.typeOffset, textureRecord.typeLength);
+            addString(texture.path, textureRecord.pathOffset, textureRecord.pathLength);
+            textureRecords.push_back(textureRecord);
+        }
+    }
+
+    Header header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.importFlags = importFlags;
+    header.vertexSize = sizeof(Vertex);
+    header.dependencyCount = static_cast<uint32_t>(dependencies.size());
+    header.meshCount = static_cast<uint32_t>(meshRecords.size());
+    header.textureCount = static_cast<uint32_t>(textureRecords.size());
+    header.lodCount = static_cast<uint32_t>(lodRecords.size());
+    header.stringBytes = static_cast<uint32_t>(strings.size());
+    for (int axis = 0; axis < 3; axis++) {
+        header.boundsMin[axis] = boundsMin[axis];
+        header.boundsMax[axis] = boundsMax[axis];
+    }
+
+    // Geometry follows the tables, each block aligned for direct use from the mapping
+    size_t offset = sizeof(Header) + dependencies.size() * sizeof(DependencyRecord) +
+                    meshRecords.size() * sizeof(MeshRecord) + textureRecords.size() * sizeof(TextureRecord) +
+                    lodRecords.size() * sizeof(LodRecord) + strings.size();
+    for (MeshRecord& record : meshRecords) {
+        offset = AlignUp(offset, DATA_ALIGNMENT);
+        record.vertexOffset = offset;
+        offset += size_t(record.vertexCount) * sizeof(Vertex);
+        offset = AlignUp(offset, DATA_ALIGNMENT);
+        record.indexOffset = offset;
+        offset += size_t(record.indexCount) * sizeof(unsigned int);
+    }
+
+    std::string cookedPath = GetCookedPath(sourcePath, importFlags);
+    std::string temporaryPath = cookedPath + ".tmp";
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cookedPath).parent_path(), error);
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "[CookedMesh] Cannot write " << temporaryPath << std::endl;
+            return false;
+        }
+
+        size_t written = 0;
+        auto write = [&](const void* bytes, size_t size) {
+            file.write(static_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+            written += size;
+        };
+        auto pad = [&](size_t target) {
+            static const char zeros[DATA_ALIGNMENT] = {};
+            write(zeros, target - written);
+        };
+
+        write(&header, sizeof(header));
+        write(dependencies.data(), dependencies.size() * sizeof(DependencyRecord));
+        write(meshRecords.data(), meshRecords.size() * sizeof(MeshRecord));
+        write(textureRecords.data(), textureRecords.size() * sizeof(TextureRecord));
+        write(lodRecords.data(), lodRecords.size() * sizeof(LodRecord));
+        write(strings.data(), strings.size());
+        for (size_t i = 0; i < meshes.size(); i++) {
+            pad(meshRecords[i].vertexOffset);
+            write(meshes[i].vertices.data(), meshes[i].vertices.size() * sizeof(Vertex));
+            pad(meshRecords[i].indexOffset);
+            write(meshes[i].indices.data(), meshes[i].indices.size() * sizeof(unsigned int));
+        }
+
+        if (!file) {
+            std::cerr << "[CookedMesh] Failed while writing " << temporaryPath << std::endl;
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+
+    // Replace in one step so a crash never leaves a half-written cooked file
+    std::filesystem::rename(temporaryPath, cookedPath, error);
+    if (error) {
+        std::filesystem::remove(cookedPath, error);
+        std::filesystem::rename(temporaryPath, cookedPath, error);
+    }
+    if (error) {
+        std::cerr << "[CookedMesh] Cannot replace " << cookedPath << ": " << error.message() << std::endl;
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    std::cout << "[CookedMesh] Wrote " << cookedPath << " (" << meshes.size() << " meshes, "
+              << offset / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+bool CookedMeshFile::IsDependencyCurrent(const std::string& path, const DependencyRecord& record) {
+    uint64_t size;
+    int64_t writeTime;
+    if (!ReadFileStamp(path, size, writeTime) || size != record.size) {
+        return false;
+    }
+    if (writeTime == record.writeTime) {
+        return true;
+    }
+
+    // Touched but maybe not changed: the content hash decides
+    MappedFile source;
+    return source.Open(path) && HashBytes(source.GetData(), source.GetSize()) == record.hash;
+}
+
+bool CookedMeshFile::ReadFileStamp(const std::string& path, uint64_t& size, int64_t& writeTime) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+    writeTime = static_cast<int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+uint64_t CookedMeshFile::HashBytes(const unsigned char* data, size_t size) {
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::vector<std::string> CookedMeshFile::FindMaterialLibraries(const unsigned char* data, size_t size) {
+    std::vector<std::string> libraries;
+    const char* text = reinterpret_cast<const char*>(data);
+    const char keyword[] = "mtllib";
+    const size_t keywordLength = sizeof(keyword) - 1;
+
+    size_t lineStart = 0;
+    while (lineStart < size) {
+        const char* end = static_cast<const char*>(std::memchr(text + lineStart, '\n', size - lineStart));
+        size_t lineEnd = end ? static_cast<size_t>(end - text) : size;
+
+        if (lineEnd - lineStart > keywordLength && std::memcmp(text + lineStart, keyword, keywordLength) == 0 &&
+            (text[lineStart + keywordLength] == ' ' || text[lineStart + keywordLength] == '\t')) {
+            std::string name(text + lineStart + keywordLength, lineEnd - lineStart - keywordLength);
+            size_t first = name.find_first_not_of(" \t");
+            size_t last = name.find_last_not_of(" \t\r");
+            if (first != std::string::npos) {
+                libraries.push_back(name.substr(first, last - first + 1));
+            }
+        }
+        lineStart = lineEnd + 1;
+    }
+    return libraries;
+}
@@ -0,0 +1,148 @@
+﻿/**
+ * @file CookedMesh.h
+ * @brief Binary mesh cache that lets models skip ASSIMP after the first import
+ *
+ * The first import of a model writes a cooked file beside it
+ * (<model dir>/cooked/<file>.<import flags>.mesh) holding:
+ * - Vertices and indices exactly as they are uploaded to the GPU, with
+ *   every detail level's indices in one block and a table of their ranges
+ * - Per-mesh texture references (type and path relative to the model)
+ * - Per-mesh and whole-model bounds
+ * - Size, write time and content hash of the source file and the MTL
+ *   libraries it references
+ *
+ * Later loads map the cooked file and upload straight from the mapping.
+ * A dependency whose size or write time changed is hashed again, and the
+ * cooked file is only used while every hash still matches.
+ */
+
+#pragma once
+
+#include "Mesh.h"
+#include "MappedFile.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reader and writer for one cooked model file
+ */
+class CookedMeshFile {
+public:
+    struct TextureRef {
+        std::string type;       // Shader sampler prefix, e.g. "texture_diffuse"
+        std::string path;       // Relative to the model's directory
+    };
+
+    /**
+     * @brief One mesh, pointing into the mapped file
+     */
+    struct MeshView {
+        std::span<const Vertex> vertices;
+        std::span<const unsigned int> indices;     // Every detail level, finest first
+        std::vector<MeshLod> lods;                  // Ranges of indices; empty means one level
+        std::vector<TextureRef> textures;
+        glm::vec3 boundsMin;
+        glm::vec3 boundsMax;
+    };
+
+    CookedMeshFile();
+
+    /**
+     * @brief Map the cooked file for a model if it is still valid
+     * @return False if it is missing, malformed, from another format
+     *         version or older than its sources
+     */
+    bool Open(const std::string& sourcePath, unsigned int importFlags);
+    void Close();
+
+    /**
+     * @brief Meshes of the open file; the spans are valid until Close()
+     */
+    const std::vector<MeshView>& GetMeshes() const { return m_meshes; }
+    glm::vec3 GetBoundsMin() const { return m_boundsMin; }
+    glm::vec3 GetBoundsMax() const { return m_boundsMax; }
+    size_t GetFileSize() const { return m_file.GetSize(); }
+
+    /**
+     * @brief Cook freshly imported meshes
+     *
+     * Uses no GL, so it can run on a loader thread.
+     *
+     * @param sourcePath Model file the meshes were imported from
+     * @param importFlags ASSIMP flags used for the import
+     * @param meshes Imported mesh data; texture paths relative to the model
+     * @return False if the file could not be written
+     */
+    static bool Write(const std::string& sourcePath, unsigned int importFlags, const std::vector<MeshView>& meshes);
+
+    static std::string GetCookedPath(const std::string& sourcePath, unsigned int importFlags);
+
+private:
+    // On-disk records; every offset is from the start of the file
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t importFlags;
+        uint32_t vertexSize;
+        uint32_t dependencyCount;
+        uint32_t meshCount;
+        uint32_t textureCount;
+        uint32_t stringBytes;
+        float boundsMin[3];
+        float boundsMax[3];
+        uint32_t lodCount;
+        uint32_t reserved;
+    };
+
+    struct DependencyRecord {
+        uint64_t size;
+        int64_t writeTime;
+        uint64_t hash;
+        uint32_t pathOffset;    // Into the string table
+        uint32_t pathLength;
+    };
+
+    struct MeshRecord {
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint32_t firstTexture;
+        uint32_t textureCount;
+        uint32_t firstLod;
+        uint32_t lodCount;
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    struct LodRecord {
+        uint32_t indexOffset;   // Relative to the mesh's first index
+        uint32_t indexCount;
+        float error;
+    };
+
+    struct TextureRecord {
+        uint32_t typeOffset;
+        uint32_t typeLength;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+    };
+
+    bool Parse(const std::string& directory, unsigned int importFlags);
+    static bool IsDependencyCurrent(const std::string& path, const DependencyRecord& record);
+    static bool ReadFileStamp(const std::string& path, uint64_t& size, int64_t& writeTime);
+    static uint64_t HashBytes(const unsigned char* data, size_t size);
+    static std::vector<std::string> FindMaterialLibraries(const unsigned char* data, size_t size);
+
+    MappedFile m_file;
+    std::vector<MeshView> m_meshes;
+    glm::vec3 m_boundsMin;
+    glm::vec3 m_boundsMax;
+
+    static constexpr uint32_t MAGIC = 0x4853454D;      // "MESH"
+    static constexpr uint32_t VERSION = 3;              // 2: MeshOptimizer order, 3: LOD table
+    static constexpr size_t DATA_ALIGNMENT = 16;
+};
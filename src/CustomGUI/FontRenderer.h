@@ -7,11 +7,11 @@
  * 
  * Features:
  * - 8x8 bitmap font for ASCII characters 32-126
- * - Hardware-accelerated OpenGL rendering
+ * - Glyphs shared with UIText through a single GlyphAtlas texture
+ * - One draw call per string, streamed through the shared StreamBuffer ring
  * - Alpha blending support for transparent backgrounds
- * - Scalable text with nearest-neighbor filtering
+ * - Scalable text from signed distance fields (sharp at any size)
  * - Custom color support for text rendering
- * - Optimized vertex buffer management
  */
 
 #pragma once
@@ -19,32 +19,20 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <string>
-#include <map>
+#include <vector>
 #include <memory>
 #include <iostream>
+#include "GlyphAtlas.h"
 
 namespace CustomGUI {
 
-/**
- * @brief Character data structure for font rendering
- * 
- * Contains all necessary information to render a single character
- * including texture handle, dimensions, and positioning data.
- */
-struct Character {
-    GLuint textureID;   // OpenGL texture ID for this character
-    glm::ivec2 size;    // Character dimensions in pixels (width, height)
-    glm::ivec2 bearing; // Offset from baseline to character top-left (x, y)
-    GLuint advance;     // Horizontal advance to next character position
-};
-
 /**
  * @brief Bitmap font renderer class
  * 
  * Manages the complete pipeline for rendering bitmap text including:
- * - Character texture generation from bitmap data
+ * - A reference to the shared glyph atlas
  * - OpenGL shader program compilation and management
- * - Vertex buffer objects for efficient rendering
+ * - A streamed vertex buffer holding one quad per character
  * - Text positioning and scaling calculations
  * 
  * Usage:
@@ -67,8 +55,8 @@ public:
     /**
      * @brief Initialize the font rendering system
      * 
-     * Sets up OpenGL shaders, vertex buffers, and generates
-     * character textures from bitmap font data.
+     * Sets up OpenGL shaders and vertex buffers and acquires the
+     * shared glyph atlas.
      * 
      * @return true if initialization successful, false otherwise
      */
@@ -77,8 +65,8 @@ public:
     /**
      * @brief Render a text string to the screen
      * 
-     * Draws the specified text using bitmap font textures with
-     * support for scaling and custom colors.
+     * Builds one quad per character and draws the whole string in a
+     * single call, with support for scaling and custom colors.
      * 
      * @param text String to render
      * @param x Starting X coordinate in screen space
@@ -109,18 +97,11 @@ private:
      */
     bool LoadDefaultFont();
     
-    /**
-     * @brief Generate OpenGL textures for all characters
-     * 
-     * Converts bitmap font data into individual OpenGL textures
-     * for each printable ASCII character (32-126).
-     */
-    void GenerateCharacterTextures();
-    
     // OpenGL rendering resources
-    GLuint VAO, VBO;                        // Vertex array and buffer objects
+    GLuint VAO;                             // Vertex array; the vertices live in the StreamBuffer ring
     GLuint shaderProgram;                   // Compiled shader program
-    std::map<char, Character> characters;   // Character texture database
+    GlyphAtlas* atlas;                      // Shared glyph atlas (owned by GlyphAtlas)
+    std::vector<float> vertices;            // Scratch vertex stream for RenderText
     glm::mat4 projectionMatrix;             // Current projection matrix
     
     // Static font data (defined in implementation file)
@@ -4,10 +4,13 @@
 #include "UIButton.h"
 #include "UIPanel.h"
 #include "UIText.h"
-#include "../Shader.h"
+#include "UIBatch.h"
+#include "UIHandle.h"
+#include "UIHitGrid.h"
 #include <vector>
 #include <memory>
 #include <map>
+#include <unordered_map>
 
 namespace CustomGUI {
 
@@ -16,12 +19,15 @@ namespace CustomGUI {
         static GUIManager* instance;
         
         std::vector<std::shared_ptr<UIElement>> rootElements;
+        std::unordered_map<std::string, std::weak_ptr<UIElement>> elementIndex;  // Whole tree, by ID
         UIElement* focusedElement;
         UIElement* hoveredElement;
         
         
-        std::unique_ptr<Shader> uiShader;
-        unsigned int quadVAO, quadVBO, quadEBO;
+        UIBatch batch;
+        unsigned int builtRevision;     // UIElement tree revision held in the batch
+        UIHitGrid hitGrid;
+        unsigned int hitGridRevision;   // UIElement layout revision hitGrid was built from
         unsigned int screenWidth, screenHeight;
         
         
@@ -54,6 +60,18 @@ namespace CustomGUI {
         void RemoveElement(const std::string& elementId);
         void ClearElements();
         std::shared_ptr<UIElement> GetElementById(const std::string& elementId);  
+
+        /**
+         * @brief Resolve an element once into a typed handle; invalid if missing or of another type
+         */
+        template <typename T>
+        UIHandle<T> GetHandle(const std::string& elementId) {
+            return UIHandle<T>(std::dynamic_pointer_cast<T>(GetElementById(elementId)));
+        }
+
+        
+        void IndexElement(const std::shared_ptr<UIElement>& element);
+        void UnindexElement(const std::shared_ptr<UIElement>& element);
         
         
         glm::vec2 ScreenToGUI(glm::vec2 screenPos) const;
@@ -65,11 +83,13 @@ namespace CustomGUI {
         unsigned int GetScreenHeight() const { return screenHeight; }
         
         void RenderQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+        UIBatch& GetBatch() { return batch; }
         
     private:
-        void InitializeRenderingResources();
         void RenderElement(UIElement* element);
+        glm::mat4 GetProjection() const;
         void SortElementsByZOrder();
+        void UpdateHitGrid();
     };
 
 } 
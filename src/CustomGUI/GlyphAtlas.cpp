@@ -0,0 +1,413 @@
+﻿#include "GlyphAtlas.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace CustomGUI {
+
+    GlyphAtlas* GlyphAtlas::sharedAtlas = nullptr;
+    int GlyphAtlas::refCount = 0;
+
+    
+    static const unsigned char font8x8_basic[128][8] = {
+        
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+        
+        { 0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00},
+        
+        { 0x66, 0x66, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00},
+        
+        { 0x6C, 0x6C, 0xFE, 0x6C, 0xFE, 0x6C, 0x6C, 0x00},
+        
+        { 0x30, 0x7C, 0xC0, 0x78, 0x0C, 0xF8, 0x30, 0x00},
+        
+        { 0x00, 0xC6, 0xCC, 0x18, 0x30, 0x66, 0xC6, 0x00},
+        
+        { 0x38, 0x6C, 0x38, 0x76, 0xDC, 0xCC, 0x76, 0x00},
+        
+        { 0x60, 0x60, 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00},
+        
+        { 0x18, 0x30, 0x60, 0x60, 0x60, 0x30, 0x18, 0x00},
+        
+        { 0x60, 0x30, 0x18, 0x18, 0x18, 0x30, 0x60, 0x00},
+        
+        { 0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00},
+        
+        { 0x00, 0x30, 0x30, 0xFC, 0x30, 0x30, 0x00, 0x00},
+        
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x60},
+        
+        { 0x00, 0x00, 0x00, 0xFC, 0x00, 0x00, 0x00, 0x00},
+        
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00},
+        
+        { 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x80, 0x00},
+        
+        { 0x7C, 0xC6, 0xCE, 0xDE, 0xF6, 0xE6, 0x7C, 0x00},
+        
+        { 0x30, 0x70, 0x30, 0x30, 0x30, 0x30, 0xFC, 0x00},
+        
+        { 0x78, 0xCC, 0x0C, 0x38, 0x60, 0xCC, 0xFC, 0x00},
+        
+        { 0x78, 0xCC, 0x0C, 0x38, 0x0C, 0xCC, 0x78, 0x00},
+        
+        { 0x1C, 0x3C, 0x6C, 0xCC, 0xFE, 0x0C, 0x1E, 0x00},
+        
+        { 0xFC, 0xC0, 0xF8, 0x0C, 0x0C, 0xCC, 0x78, 0x00},
+        
+        { 0x38, 0x60, 0xC0, 0xF8, 0xCC, 0xCC, 0x78, 0x00},
+        
+        { 0xFC, 0xCC, 0x0C, 0x18, 0x30, 0x30, 0x30, 0x00},
+        
+        { 0x78, 0xCC, 0xCC, 0x78, 0xCC, 0xCC, 0x78, 0x00},
+        
+        { 0x78, 0xCC, 0xCC, 0x7C, 0x0C, 0x18, 0x70, 0x00},
+        
+        { 0x00, 0x30, 0x30, 0x00, 0x00, 0x30, 0x30, 0x00},
+        
+        { 0x00, 0x30, 0x30, 0x00, 0x00, 0x30, 0x30, 0x60},
+        
+        { 0x18, 0x30, 0x60, 0xC0, 0x60, 0x30, 0x18, 0x00},
+        
+        { 0x00, 0x00, 0xFC, 0x00, 0x00, 0xFC, 0x00, 0x00},
+        
+        { 0x60, 0x30, 0x18, 0x0C, 0x18, 0x30, 0x60, 0x00},
+        
+        { 0x78, 0xCC, 0x0C, 0x18, 0x18, 0x00, 0x18, 0x00},
+        
+        { 0x7C, 0xC6, 0xDE, 0xDE, 0xDE, 0xC0, 0x78, 0x00},
+        
+        { 0x30, 0x78, 0xCC, 0xCC, 0xFC, 0xCC, 0xCC, 0x00},
+        
+        { 0xFC, 0x66, 0x66, 0x7C, 0x66, 0x66, 0xFC, 0x00},
+        
+        { 0x3C, 0x66, 0xC0, 0xC0, 0xC0, 0x66, 0x3C, 0x00},
+        
+        { 0xF8, 0x6C, 0x66, 0x66, 0x66, 0x6C, 0xF8, 0x00},
+        
+        { 0xFE, 0x62, 0x68, 0x78, 0x68, 0x62, 0xFE, 0x00},
+        
+        { 0xFE, 0x62, 0x68, 0x78, 0x68, 0x60, 0xF0, 0x00},
+        
+        { 0x3C, 0x66, 0xC0, 0xC0, 0xCE, 0x66, 0x3E, 0x00},
+        
+        { 0xCC, 0xCC, 0xCC, 0xFC, 0xCC, 0xCC, 0xCC, 0x00},
+        
+        { 0x78, 0x30, 0x30, 0x30, 0x30, 0x30, 0x78, 0x00},
+        
+        { 0x1E, 0x0C, 0x0C, 0x0C, 0xCC, 0xCC, 0x78, 0x00},
+        
+        { 0xE6, 0x66, 0x6C, 0x78, 0x6C, 0x66, 0xE6, 0x00},
+        
+        { 0xF0, 0x60, 0x60, 0x60, 0x62, 0x66, 0xFE, 0x00},
+        
+        { 0xC6, 0xEE, 0xFE, 0xFE, 0xD6, 0xC6, 0xC6, 0x00},
+        
+        { 0xC6, 0xE6, 0xF6, 0xDE, 0xCE, 0xC6, 0xC6, 0x00},
+        
+        { 0x78, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0x78, 0x00},
+        
+        { 0xFC, 0x66, 0x66, 0x7C, 0x60, 0x60, 0xF0, 0x00},
+        
+        { 0x78, 0xCC, 0xCC, 0xCC, 0xDC, 0x78, 0x1C, 0x00},
+        
+        { 0xFC, 0x66, 0x66, 0x7C, 0x6C, 0x66, 0xE6, 0x00},
+        
+        { 0x78, 0xCC, 0xE0, 0x70, 0x1C, 0xCC, 0x78, 0x00},
+        
+        { 0xFC, 0xB4, 0x30, 0x30, 0x30, 0x30, 0x78, 0x00},
+        
+        { 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFC, 0x00},
+        
+        { 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0x78, 0x30, 0x00},
+        
+        { 0xC6, 0xC6, 0xC6, 0xD6, 0xFE, 0xEE, 0xC6, 0x00},
+        
+        { 0xC6, 0xC6, 0x6C, 0x38, 0x38, 0x6C, 0xC6, 0x00},
+        
+        { 0xCC, 0xCC, 0xCC, 0x78, 0x30, 0x30, 0x78, 0x00},
+        
+        { 0xFE, 0xC6, 0x8C, 0x18, 0x32, 0x66, 0xFE, 0x00},
+        
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, 
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}  
+    };
+
+    
+    static const unsigned char* FontBitmap(unsigned int c) {
+        if (c >= 32 && c <= 90) {
+            return font8x8_basic[c - 32];
+        }
+        if (c >= 97 && c <= 122) {
+            return font8x8_basic[(c - 97) + (65 - 32)];
+        }
+        return font8x8_basic[0];
+    }
+
+    GlyphAtlas::GlyphAtlas()
+        : texture(0)
+        , atlasWidth(0)
+        , atlasHeight(0)
+        , glyphs{}
+        , whiteUV(0.0f)
+    {
+    }
+
+    GlyphAtlas::~GlyphAtlas() {
+        if (texture) {
+            glDeleteTextures(1, &texture);
+            texture = 0;
+        }
+    }
+
+    GlyphAtlas* GlyphAtlas::Acquire() {
+        if (!sharedAtlas) {
+            sharedAtlas = new GlyphAtlas();
+            if (!sharedAtlas->Build()) {
+                delete sharedAtlas;
+                sharedAtlas = nullptr;
+                return nullptr;
+            }
+        }
+        ++refCount;
+        return sharedAtlas;
+    }
+
+    void GlyphAtlas::Release() {
+        if (refCount > 0 && --refCount == 0) {
+            delete sharedAtlas;
+            sharedAtlas = nullptr;
+        }
+    }
+
+    bool GlyphAtlas::Build() {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        
+        const int rows = (128 + 1 + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+        atlasWidth = ATLAS_COLUMNS * CELL_SIZE;
+        atlasHeight = rows * CELL_SIZE;
+
+        std::vector<unsigned char> pixels(static_cast<size_t>(atlasWidth) * atlasHeight, 0);
+
+        for (int c = 0; c < 128; ++c) {
+            const unsigned char* fontData = FontBitmap(c);
+
+            int cellX = (c % ATLAS_COLUMNS) * CELL_SIZE;
+            int cellY = (c / ATLAS_COLUMNS) * CELL_SIZE;
+
+            bool blank = true;
+            for (int y = 0; y < GLYPH_SIZE; ++y) {
+                blank = blank && fontData[y] == 0;
+            }
+
+            Glyph& glyph = glyphs[c];
+            glyph.uvMin = glm::vec2(static_cast<float>(cellX + SDF_PADDING) / atlasWidth,
+                                    static_cast<float>(cellY + SDF_PADDING) / atlasHeight);
+            glyph.uvMax = glm::vec2(static_cast<float>(cellX + SDF_PADDING + GLYPH_SIZE * SDF_SCALE) / atlasWidth,
+                                    static_cast<float>(cellY + SDF_PADDING + GLYPH_SIZE * SDF_SCALE) / atlasHeight);
+            glyph.size = glm::ivec2(GLYPH_SIZE, GLYPH_SIZE);
+            glyph.bearing = glm::ivec2(0, GLYPH_SIZE);
+            glyph.advance = GLYPH_SIZE;
+            glyph.blank = blank;
+        }
+
+        
+        
+        unsigned int workerCount = std::max(1u, std::min(std::thread::hardware_concurrency(), MAX_WORKERS));
+        std::vector<std::thread> workers;
+        for (unsigned int worker = 0; worker < workerCount; ++worker) {
+            workers.emplace_back([this, worker, workerCount, &pixels]() {
+                for (unsigned int c = worker; c < 128; c += workerCount) {
+                    GenerateDistanceField(FontBitmap(c), pixels.data(), atlasWidth,
+                                          (c % ATLAS_COLUMNS) * CELL_SIZE, (c / ATLAS_COLUMNS) * CELL_SIZE);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        
+        int whiteX = (128 % ATLAS_COLUMNS) * CELL_SIZE;
+        int whiteY = (128 / ATLAS_COLUMNS) * CELL_SIZE;
+        for (int y = 0; y < CELL_SIZE; ++y) {
+            for (int x = 0; x < CELL_SIZE; ++x) {
+                pixels[(whiteY + y) * atlasWidth + whiteX + x] = 255;
+            }
+        }
+        whiteUV = glm::vec2((whiteX + CELL_SIZE * 0.5f) / atlasWidth,
+                            (whiteY + CELL_SIZE * 0.5f) / atlasHeight);
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+
+        GLint previousAlignment;
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasWidth, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+
+        
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if (texture == 0) {
+            std::cerr << "[GlyphAtlas] ERROR: Failed to create atlas texture" << std::endl;
+            return false;
+        }
+
+        auto endTime = std::chrono::high_resolution_clock::now();
+        float buildMs = std::chrono::duration<float, std::milli>(endTime - startTime).count();
+        std::cout << "[GlyphAtlas] Generated 128 SDF glyphs on " << workerCount << " threads into one "
+                  << atlasWidth << "x" << atlasHeight << " texture (" << buildMs << " ms)" << std::endl;
+        return true;
+    }
+
+    void GlyphAtlas::GenerateDistanceField(const unsigned char* bitmap, unsigned char* pixels,
+                                           int rowStride, int cellX, int cellY) {
+        
+        
+        for (int ty = 0; ty < CELL_SIZE; ++ty) {
+            for (int tx = 0; tx < CELL_SIZE; ++tx) {
+                float px = (tx + 0.5f - SDF_PADDING) / SDF_SCALE;
+                float py = (ty + 0.5f - SDF_PADDING) / SDF_SCALE;
+
+                int cx = static_cast<int>(std::floor(px));
+                int cy = static_cast<int>(std::floor(py));
+                bool inside = cx >= 0 && cx < GLYPH_SIZE && cy >= 0 && cy < GLYPH_SIZE &&
+                              (bitmap[cy] & (1 << (7 - cx))) != 0;
+
+                
+                float nearest = inside
+                    ? std::min(std::min(px, py), std::min(GLYPH_SIZE - px, GLYPH_SIZE - py))
+                    : SDF_SPREAD;
+
+                for (int y = 0; y < GLYPH_SIZE; ++y) {
+                    for (int x = 0; x < GLYPH_SIZE; ++x) {
+                        bool set = (bitmap[y] & (1 << (7 - x))) != 0;
+                        if (set == inside) continue;
+
+                        float dx = std::max(std::max(x - px, px - (x + 1)), 0.0f);
+                        float dy = std::max(std::max(y - py, py - (y + 1)), 0.0f);
+                        nearest = std::min(nearest, std::sqrt(dx * dx + dy * dy));
+                    }
+                }
+
+                float signedDistance = inside ? -nearest : nearest;
+                float value = glm::clamp(0.5f - signedDistance / (2.0f * SDF_SPREAD), 0.0f, 1.0f);
+                pixels[(cellY + ty) * rowStride + cellX + tx] = static_cast<unsigned char>(value * 255.0f + 0.5f);
+            }
+        }
+    }
+
+    const Glyph& GlyphAtlas::GetGlyph(unsigned char c) const {
+        return glyphs[c < 128 ? c : '?'];
+    }
+
+    float GlyphAtlas::MeasureWidth(const std::string& text, float scale) const {
+        return GetLayout(text, scale).width;
+    }
+
+    const TextLayout& GlyphAtlas::GetLayout(const std::string& text, float scale) const {
+        LayoutKey key{ text, scale };
+        auto it = layoutCache.find(key);
+        if (it != layoutCache.end()) {
+            return it->second;
+        }
+
+        
+        if (layoutCache.size() >= MAX_CACHED_LAYOUTS) {
+            layoutCache.clear();
+        }
+
+        TextLayout layout;
+        layout.rects.reserve(text.size());
+        layout.uvs.reserve(text.size());
+
+        float penX = 0.0f;
+        for (char c : text) {
+            const Glyph& glyph = GetGlyph(static_cast<unsigned char>(c));
+
+            if (!glyph.blank) {
+                float x0 = penX + glyph.bearing.x * scale;
+                float y0 = -(glyph.size.y - glyph.bearing.y) * scale;
+                layout.rects.push_back(glm::vec4(x0, y0, x0 + glyph.size.x * scale, y0 + glyph.size.y * scale));
+                layout.uvs.push_back(glm::vec4(glyph.uvMin.x, glyph.uvMin.y, glyph.uvMax.x, glyph.uvMax.y));
+            }
+
+            penX += glyph.advance * scale;
+        }
+        layout.width = penX;
+
+        return layoutCache.emplace(std::move(key), std::move(layout)).first->second;
+    }
+
+    size_t GlyphAtlas::AppendQuads(const std::string& text, float x, float y, float scale,
+                                   std::vector<float>& vertices) const {
+        const TextLayout& layout = GetLayout(text, scale);
+        vertices.reserve(vertices.size() + layout.rects.size() * VERTICES_PER_GLYPH * FLOATS_PER_VERTEX);
+
+        for (size_t i = 0; i < layout.rects.size(); ++i) {
+            const glm::vec4& r = layout.rects[i];
+            const glm::vec4& uv = layout.uvs[i];
+
+            float x0 = x + r.x, y0 = y + r.y;
+            float x1 = x + r.z, y1 = y + r.w;
+
+            const float quad[VERTICES_PER_GLYPH * FLOATS_PER_VERTEX] = {
+                x0, y1, uv.x, uv.w,
+                x0, y0, uv.x, uv.y,
+                x1, y0, uv.z, uv.y,
+
+                x0, y1, uv.x, uv.w,
+                x1, y0, uv.z, uv.y,
+                x1, y1, uv.z, uv.w
+            };
+            vertices.insert(vertices.end(), quad, quad + VERTICES_PER_GLYPH * FLOATS_PER_VERTEX);
+        }
+
+        return layout.rects.size() * VERTICES_PER_GLYPH;
+    }
+
+}
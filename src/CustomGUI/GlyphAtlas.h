@@ -0,0 +1,126 @@
+﻿#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace CustomGUI {
+
+    /**
+     * @brief Placement of one character inside the shared glyph atlas
+     */
+    struct Glyph {
+        glm::vec2    uvMin;      // Atlas UV of the glyph box's top-left corner
+        glm::vec2    uvMax;      // Atlas UV of the glyph box's bottom-right corner
+        glm::ivec2   size;       // Glyph size in font pixels
+        glm::ivec2   bearing;    // Offset from baseline to glyph top-left
+        unsigned int advance;    // Horizontal advance in font pixels
+        bool         blank;      // No set pixels; layout skips its quad
+    };
+
+    /**
+     * @brief Positioned glyph quads for one string at one scale
+     */
+    struct TextLayout {
+        std::vector<glm::vec4> rects;   // x0, y0, x1, y1 relative to the pen position
+        std::vector<glm::vec4> uvs;     // uMin, vMin, uMax, vMax
+        float width;
+    };
+
+    /**
+     * @brief Single-texture signed distance field store for the 8x8 font
+     *
+     * All 128 ASCII glyphs are converted to signed distance fields and
+     * packed into one GL_R8 texture. A texel stores 0.5 on the glyph edge,
+     * rising inside and falling outside, so text shaders can threshold it
+     * with smoothstep and render any size from the same page without
+     * blurring or per-size textures. The fields are computed analytically
+     * from the bitmap's pixel squares at startup, split across worker
+     * threads.
+     *
+     * Layouts are cached by (string, scale) so repeated labels skip the
+     * per-character walk. Text renderers turn a string into textured quads
+     * with AppendQuads() and draw it in one call.
+     *
+     * The atlas is shared: every text renderer calls Acquire() once and
+     * Release() when it shuts down; the texture lives while any user holds it.
+     */
+    class GlyphAtlas {
+    public:
+        static constexpr int GLYPH_SIZE = 8;
+        static constexpr int FLOATS_PER_VERTEX = 4;     // x, y, u, v
+        static constexpr int VERTICES_PER_GLYPH = 6;
+
+        static GlyphAtlas* Acquire();
+        static void Release();
+
+        GLuint GetTexture() const { return texture; }
+        const Glyph& GetGlyph(unsigned char c) const;
+
+        // Centre of a solid (fully inside) cell, so untextured quads can share the atlas
+        glm::vec2 GetWhiteUV() const { return whiteUV; }
+
+        float MeasureWidth(const std::string& text, float scale) const;
+
+        /**
+         * @brief Cached glyph quads for text; valid until the next GetLayout call
+         */
+        const TextLayout& GetLayout(const std::string& text, float scale) const;
+
+        /**
+         * @brief Append two triangles per character of text to vertices
+         *
+         * Vertices are {x, y, u, v} in screen space with y pointing down.
+         * Non-ASCII characters are drawn as '?'.
+         *
+         * @return Number of vertices appended
+         */
+        size_t AppendQuads(const std::string& text, float x, float y, float scale,
+                           std::vector<float>& vertices) const;
+
+    private:
+        GlyphAtlas();
+        ~GlyphAtlas();
+
+        struct LayoutKey {
+            std::string text;
+            float scale;
+
+            bool operator==(const LayoutKey& other) const {
+                return scale == other.scale && text == other.text;
+            }
+        };
+
+        struct LayoutKeyHash {
+            size_t operator()(const LayoutKey& key) const {
+                return std::hash<std::string>()(key.text) ^ (std::hash<float>()(key.scale) * 31);
+            }
+        };
+
+        bool Build();
+        static void GenerateDistanceField(const unsigned char* bitmap, unsigned char* pixels,
+                                          int rowStride, int cellX, int cellY);
+
+        GLuint texture;
+        int atlasWidth;
+        int atlasHeight;
+        Glyph glyphs[128];
+        glm::vec2 whiteUV;
+
+        mutable std::unordered_map<LayoutKey, TextLayout, LayoutKeyHash> layoutCache;
+
+        static GlyphAtlas* sharedAtlas;
+        static int refCount;
+
+        static constexpr int ATLAS_COLUMNS = 16;
+        static constexpr int SDF_SCALE = 4;                 // Atlas texels per font pixel
+        static constexpr int SDF_PADDING = 4;               // Texels of falloff around the glyph box
+        static constexpr float SDF_SPREAD = static_cast<float>(SDF_PADDING) / SDF_SCALE;   // Font pixels
+        static constexpr int CELL_SIZE = GLYPH_SIZE * SDF_SCALE + 2 * SDF_PADDING;
+        static constexpr size_t MAX_CACHED_LAYOUTS = 1024;
+        static constexpr unsigned int MAX_WORKERS = 8;
+    };
+
+}
@@ -0,0 +1,287 @@
+﻿#include "UIBatch.h"
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+
+namespace CustomGUI {
+
+    UIBatch* UIBatch::activeBatch = nullptr;
+
+    UIBatch::UIBatch()
+        : atlas(nullptr)
+        , vao(0)
+        , projectionLocation(-1)
+        , uploadedIndexCount(0)
+        , projection(1.0f)
+        , viewportHeight(0)
+        , open(false)
+        , stats{}
+    {
+    }
+
+    UIBatch::~UIBatch() {
+        Shutdown();
+    }
+
+    bool UIBatch::Initialize() {
+        atlas = GlyphAtlas::Acquire();
+        if (!atlas) {
+            std::cerr << "[UIBatch] ERROR: Failed to acquire glyph atlas" << std::endl;
+            return false;
+        }
+
+        shader = std::make_unique<Shader>("resources/shaders/ui.vert", "resources/shaders/ui.frag");
+        shader->Use();
+        shader->SetInt("uiAtlas", 0);
+        projectionLocation = glGetUniformLocation(shader->ID, "projection");
+
+        // Vertices and indices live in the shared StreamBuffer ring; Upload() points the VAO at them
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        glBindVertexArray(0);
+
+        std::cout << "[UIBatch] Initialized" << std::endl;
+        return true;
+    }
+
+    void UIBatch::Shutdown() {
+        if (activeBatch == this) {
+            activeBatch = nullptr;
+        }
+        if (vao) {
+            glDeleteVertexArrays(1, &vao);
+            vao = 0;
+        }
+        vertexStream = {};
+        indexStream = {};
+        shader.reset();
+        uploadedIndexCount = 0;
+        if (atlas) {
+            GlyphAtlas::Release();
+            atlas = nullptr;
+        }
+        open = false;
+    }
+
+    void UIBatch::Begin(const glm::mat4& proj) {
+        projection = proj;
+        vertices.clear();
+        indices.clear();
+        commands.clear();
+        StartCommand(false, glm::ivec4(0));
+        open = true;
+        activeBatch = this;
+    }
+
+    void UIBatch::StartCommand(bool scissorEnabled, const glm::ivec4& rect) {
+        if (!commands.empty()) {
+            DrawCommand& last = commands.back();
+            if (last.scissorEnabled == scissorEnabled && (!scissorEnabled || last.scissorRect == rect)) {
+                return;
+            }
+            if (last.indexCount == 0) {
+                last.scissorEnabled = scissorEnabled;
+                last.scissorRect = rect;
+                return;
+            }
+        }
+
+        DrawCommand command;
+        command.firstIndex = indices.size();
+        command.indexCount = 0;
+        command.scissorEnabled = scissorEnabled;
+        command.scissorRect = rect;
+        commands.push_back(command);
+    }
+
+    void UIBatch::SetScissor(const glm::ivec4& rect) {
+        StartCommand(true, rect);
+    }
+
+    void UIBatch::ClearScissor() {
+        StartCommand(false, glm::ivec4(0));
+    }
+
+    void UIBatch::AppendQuad(std::vector<UIVertex>& out, float x0, float y0, float x1, float y1,
+                             const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec4& color) {
+        out.push_back({ glm::vec2(x0, y0), glm::vec2(uv0.x, uv0.y), color });
+        out.push_back({ glm::vec2(x1, y0), glm::vec2(uv1.x, uv0.y), color });
+        out.push_back({ glm::vec2(x1, y1), glm::vec2(uv1.x, uv1.y), color });
+        out.push_back({ glm::vec2(x0, y1), glm::vec2(uv0.x, uv1.y), color });
+    }
+
+    void UIBatch::AppendRect(std::vector<UIVertex>& out, const GlyphAtlas& atlas,
+                             const glm::vec2& position, const glm::vec2& size, const glm::vec4& color) {
+        if (color.a <= 0.0f) return;
+
+        glm::vec2 white = atlas.GetWhiteUV();
+        AppendQuad(out, position.x, position.y, position.x + size.x, position.y + size.y, white, white, color);
+    }
+
+    void UIBatch::AppendBorder(std::vector<UIVertex>& out, const GlyphAtlas& atlas,
+                               const glm::vec2& position, const glm::vec2& size, float width, const glm::vec4& color) {
+        if (width <= 0.0f || color.a <= 0.0f) return;
+
+        glm::vec2 white = atlas.GetWhiteUV();
+        float x0 = position.x, y0 = position.y;
+        float x1 = position.x + size.x, y1 = position.y + size.y;
+
+        
+        AppendQuad(out, x0, y0, x1, y0 + width, white, white, color);
+        AppendQuad(out, x0, y1 - width, x1, y1, white, white, color);
+        AppendQuad(out, x0, y0 + width, x0 + width, y1 - width, white, white, color);
+        AppendQuad(out, x1 - width, y0 + width, x1, y1 - width, white, white, color);
+    }
+
+    void UIBatch::AppendText(std::vector<UIVertex>& out, const GlyphAtlas& atlas, const std::string& text,
+                             float x, float y, float scale, const glm::vec4& color) {
+        const TextLayout& layout = atlas.GetLayout(text, scale);
+        out.reserve(out.size() + layout.rects.size() * 4);
+
+        for (size_t i = 0; i < layout.rects.size(); ++i) {
+            const glm::vec4& r = layout.rects[i];
+            const glm::vec4& uv = layout.uvs[i];
+            AppendQuad(out, x + r.x, y + r.y, x + r.z, y + r.w,
+                       glm::vec2(uv.x, uv.y), glm::vec2(uv.z, uv.w), color);
+        }
+    }
+
+    void UIBatch::CommitQuads(size_t firstVertex) {
+        for (size_t v = firstVertex; v + 3 < vertices.size(); v += 4) {
+            GLuint base = static_cast<GLuint>(v);
+            indices.push_back(base);
+            indices.push_back(base + 1);
+            indices.push_back(base + 2);
+            indices.push_back(base);
+            indices.push_back(base + 2);
+            indices.push_back(base + 3);
+            commands.back().indexCount += 6;
+        }
+    }
+
+    void UIBatch::AddQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color) {
+        if (!open) return;
+
+        size_t first = vertices.size();
+        AppendRect(vertices, *atlas, position, size, color);
+        CommitQuads(first);
+    }
+
+    void UIBatch::AddBorder(const glm::vec2& position, const glm::vec2& size, float width, const glm::vec4& color) {
+        if (!open) return;
+
+        size_t first = vertices.size();
+        AppendBorder(vertices, *atlas, position, size, width, color);
+        CommitQuads(first);
+    }
+
+    void UIBatch::AddText(const std::string& text, float x, float y, float scale, const glm::vec4& color) {
+        if (!open || text.empty()) return;
+
+        size_t first = vertices.size();
+        AppendText(vertices, *atlas, text, x, y, scale, color);
+        CommitQuads(first);
+    }
+
+    void UIBatch::AddVertices(const std::vector<UIVertex>& quadVertices) {
+        if (!open || quadVertices.empty()) return;
+
+        size_t first = vertices.size();
+        vertices.insert(vertices.end(), quadVertices.begin(), quadVertices.end());
+        CommitQuads(first);
+    }
+
+    void UIBatch::Flush() {
+        open = false;
+        if (activeBatch == this) {
+            activeBatch = nullptr;
+        }
+
+        stats.quads = static_cast<int>(vertices.size() / 4);
+        stats.drawCalls = 0;
+        stats.uploadBytes = 0;
+        stats.reused = false;
+        uploadedIndexCount = 0;
+
+        if (indices.empty() || !shader) return;
+        if (!Upload()) return;
+
+        uploadedIndexCount = indices.size();
+        Draw();
+    }
+
+    void UIBatch::Redraw() {
+        stats.drawCalls = 0;
+        stats.uploadBytes = 0;
+        stats.reused = true;
+
+        if (uploadedIndexCount == 0 || !shader) return;
+
+        // Ring data only lasts the frame that wrote it; copy the kept stream forward
+        StreamBuffer& stream = StreamBuffer::Get();
+        if (!stream.IsResident(vertexStream) || !stream.IsResident(indexStream)) {
+            if (!Upload()) return;
+        }
+        Draw();
+    }
+
+    bool UIBatch::Upload() {
+        StreamBuffer& stream = StreamBuffer::Get();
+        vertexStream = stream.Write(vertices.data(), vertices.size() * sizeof(UIVertex));
+        indexStream = stream.Write(indices.data(), indices.size() * sizeof(GLuint), sizeof(GLuint));
+        if (vertexStream.buffer == 0 || indexStream.buffer == 0) {
+            return false;
+        }
+        stats.uploadBytes = vertexStream.bytes + indexStream.bytes;
+        return true;
+    }
+
+    void UIBatch::Draw() {
+        // Stream offsets change every upload, so the attribute pointers are set per draw
+        const char* base = reinterpret_cast<const char*>(vertexStream.offset);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexStream.buffer);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(UIVertex), base + offsetof(UIVertex, position));
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(UIVertex), base + offsetof(UIVertex, uv));
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(UIVertex), base + offsetof(UIVertex, color));
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexStream.buffer);
+
+        shader->Use();
+        if (projectionLocation >= 0) {
+            glUniformMatrix4fv(projectionLocation, 1, GL_FALSE, &projection[0][0]);
+        }
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, atlas->GetTexture());
+
+        bool scissorActive = false;
+        for (const DrawCommand& command : commands) {
+            if (command.indexCount == 0) continue;
+
+            if (command.scissorEnabled) {
+                const glm::ivec4& r = command.scissorRect;
+                glEnable(GL_SCISSOR_TEST);
+                glScissor(r.x, viewportHeight - (r.y + r.w), r.z, r.w);
+                scissorActive = true;
+            } else if (scissorActive) {
+                glDisable(GL_SCISSOR_TEST);
+                scissorActive = false;
+            }
+
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(command.indexCount), GL_UNSIGNED_INT,
+                           (void*)(indexStream.offset + command.firstIndex * sizeof(GLuint)));
+            ++stats.drawCalls;
+        }
+
+        if (scissorActive) {
+            glDisable(GL_SCISSOR_TEST);
+        }
+
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+}
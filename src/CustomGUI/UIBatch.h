@@ -0,0 +1,129 @@
+﻿#pragma once
+
+#include "GlyphAtlas.h"
+#include "../Shader.h"
+#include "../StreamBuffer.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace CustomGUI {
+
+    /**
+     * @brief Vertex of the batched UI stream
+     */
+    struct UIVertex {
+        glm::vec2 position;     // Screen-space pixels, y pointing down
+        glm::vec2 uv;           // Glyph atlas coordinates
+        glm::vec4 color;
+    };
+
+    /**
+     * @brief Immediate-mode batcher for every GUI primitive
+     *
+     * Panels, buttons, borders and text glyphs are appended to one vertex
+     * and index stream. Solid quads sample the atlas' white texel, so the
+     * whole GUI shares a single texture and shader and is drawn with one
+     * glDrawElements per scissor rectangle.
+     *
+     * Usage per frame: Begin(), Add*() from the element tree, Flush().
+     * While a batch is open, GetActive() returns it so elements can submit
+     * without knowing about GUIManager. When nothing in the GUI changed,
+     * Redraw() replays the last flushed stream without rebuilding it. The
+     * kept vertices are still copied into the StreamBuffer ring again,
+     * because ring data only lasts one frame.
+     *
+     * The static Append* helpers write the same geometry into any vertex
+     * list, which is how elements build their cached vertices.
+     */
+    class UIBatch {
+    public:
+        /**
+         * @brief Counters for the last flushed batch
+         */
+        struct Stats {
+            int quads;
+            int drawCalls;
+            size_t uploadBytes;
+            bool reused;            // True when the frame was a Redraw()
+        };
+
+        UIBatch();
+        ~UIBatch();
+
+        bool Initialize();
+        void Shutdown();
+
+        void Begin(const glm::mat4& projection);
+        void Flush();
+        void Redraw();
+
+        void AddQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+        void AddBorder(const glm::vec2& position, const glm::vec2& size, float width, const glm::vec4& color);
+        void AddText(const std::string& text, float x, float y, float scale, const glm::vec4& color);
+
+        /**
+         * @brief Append prebuilt quads (four vertices each, as made by Append*)
+         */
+        void AddVertices(const std::vector<UIVertex>& quadVertices);
+
+        /**
+         * @brief Clip following primitives to a rectangle (pixels, y down)
+         *
+         * A scissor change closes the current draw; equal rectangles merge.
+         */
+        void SetScissor(const glm::ivec4& rect);
+        void ClearScissor();
+
+        void SetViewportHeight(int height) { viewportHeight = height; }
+
+        const GlyphAtlas* GetAtlas() const { return atlas; }
+        const Stats& GetStats() const { return stats; }
+        bool IsOpen() const { return open; }
+        bool HasUploadedFrame() const { return uploadedIndexCount > 0; }
+
+        static UIBatch* GetActive() { return activeBatch; }
+
+        static void AppendQuad(std::vector<UIVertex>& out, float x0, float y0, float x1, float y1,
+                               const glm::vec2& uv0, const glm::vec2& uv1, const glm::vec4& color);
+        static void AppendRect(std::vector<UIVertex>& out, const GlyphAtlas& atlas,
+                               const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+        static void AppendBorder(std::vector<UIVertex>& out, const GlyphAtlas& atlas,
+                                 const glm::vec2& position, const glm::vec2& size, float width, const glm::vec4& color);
+        static void AppendText(std::vector<UIVertex>& out, const GlyphAtlas& atlas, const std::string& text,
+                               float x, float y, float scale, const glm::vec4& color);
+
+    private:
+        struct DrawCommand {
+            size_t firstIndex;
+            size_t indexCount;
+            bool scissorEnabled;
+            glm::ivec4 scissorRect;     // x, y, width, height in UI pixels
+        };
+
+        void CommitQuads(size_t firstVertex);
+        void StartCommand(bool scissorEnabled, const glm::ivec4& rect);
+        bool Upload();
+        void Draw();
+
+        std::unique_ptr<Shader> shader;
+        GlyphAtlas* atlas;
+        GLuint vao;
+        StreamAllocation vertexStream, indexStream;
+        GLint projectionLocation;
+
+        std::vector<UIVertex> vertices;
+        std::vector<GLuint> indices;
+        std::vector<DrawCommand> commands;
+        size_t uploadedIndexCount;
+        glm::mat4 projection;
+        int viewportHeight;
+        bool open;
+        Stats stats;
+
+        static UIBatch* activeBatch;
+    };
+
+}
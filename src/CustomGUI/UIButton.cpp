@@ -1,6 +1,7 @@
 ﻿#include "UIButton.h"
 #include "UIText.h"
 #include "GUIManager.h"
+#include "UIBatch.h"
 #include <iostream>
 #include <algorithm>
 
@@ -23,24 +24,13 @@ namespace CustomGUI {
         if (!visible) return;
 
         
-        glm::vec4 currentColor = normalColor;
-        switch (state) {
-            case ButtonState::HOVERED:
-                currentColor = hoverColor;
-                break;
-            case ButtonState::PRESSED:
-                currentColor = pressedColor;
-                break;
-            case ButtonState::NORMAL:
-            default:
-                currentColor = normalColor;
-                break;
+        UIBatch* batch = UIBatch::GetActive();
+        if (batch) {
+            Submit(*batch);
+            return;
         }
 
-        auto* guiManager = GUIManager::GetInstance();
-        if (guiManager) {
-            guiManager->RenderQuad(position, size, currentColor);
-        }
+        GUIManager::GetInstance()->RenderQuad(position, size, GetColor());
         
         if (!text.empty() && UIText::IsFontSystemInitialized()) {
             glm::vec2 textSize = CalculateTextSize();
@@ -48,17 +38,31 @@ namespace CustomGUI {
             textPos.x = position.x + (size.x - textSize.x) / 2.0f;  
             textPos.y = position.y + (size.y - textSize.y) / 2.0f;  
             
-            std::string cleanText = RemoveEmojis(text);
-
-            std::cout << "[DEBUG_EXIT_TEXT] Button '" << cleanText << "' rendering text at (" << textPos.x << ", " << textPos.y << ")" << std::endl;
-            std::cout << "[DEBUG_EXIT_TEXT] Text color: (" << textColor.r << ", " << textColor.g << ", " << textColor.b << ")" << std::endl;
-            std::cout << "[DEBUG_EXIT_TEXT] Font size scale: " << (fontSize / 16.0f) << std::endl;
-            
-            UIText::RenderTextStatic(cleanText, textPos.x, textPos.y, fontSize / 16.0f, 
+            UIText::RenderTextStatic(RemoveEmojis(text), textPos.x, textPos.y, fontSize / 16.0f, 
                                     glm::vec3(textColor.r, textColor.g, textColor.b));
         }
     }
 
+    void UIButton::BuildGeometry(std::vector<UIVertex>& out, const GlyphAtlas& atlas) {
+        UIBatch::AppendRect(out, atlas, position, size, GetColor());
+
+        if (!text.empty()) {
+            glm::vec2 textSize = CalculateTextSize();
+            glm::vec2 textPos;
+            textPos.x = position.x + (size.x - textSize.x) / 2.0f;  
+            textPos.y = position.y + (size.y - textSize.y) / 2.0f;  
+
+            UIBatch::AppendText(out, atlas, RemoveEmojis(text), textPos.x, textPos.y, fontSize / 16.0f, textColor);
+        }
+    }
+
+    void UIButton::SetState(ButtonState newState) {
+        if (newState != state) {
+            state = newState;
+            MarkDirty();
+        }
+    }
+
     void UIButton::Update(float deltaTime) {
         
     }
@@ -75,7 +79,7 @@ namespace CustomGUI {
         
         if (IsPointInside(mousePos)) {
             std::cout << "✓ Button " << GetId() << " clicked! Executing callback..." << std::endl;
-            state = ButtonState::PRESSED;
+            SetState(ButtonState::PRESSED);
             if (onClick) {
                 onClick();
                 std::cout << "✓ Callback executed for button " << GetId() << std::endl;
@@ -94,12 +98,12 @@ namespace CustomGUI {
         
         if (IsPointInside(mousePos)) {
             if (state != ButtonState::PRESSED) {
-                state = ButtonState::HOVERED;
+                SetState(ButtonState::HOVERED);
             }
             return true;
         } else {
             if (state != ButtonState::PRESSED) {
-                state = ButtonState::NORMAL;
+                SetState(ButtonState::NORMAL);
             }
             return false;
         }
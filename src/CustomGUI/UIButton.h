@@ -34,16 +34,17 @@ namespace CustomGUI {
         bool HandleMouseMove(glm::vec2 mousePos) override;
         
         
-        void SetText(const std::string& newText) { text = newText; }
+        void SetText(const std::string& newText) { if (newText != text) { text = newText; MarkDirty(); } }
         void SetOnClick(std::function<void()> callback) { onClick = callback; }
         void SetNormalColor(const glm::vec4& color) { 
             normalColor = color; 
             SetColor(color);  
+            MarkDirty();
         }
-        void SetHoverColor(const glm::vec4& color) { hoverColor = color; }
-        void SetPressedColor(const glm::vec4& color) { pressedColor = color; }
-        void SetTextColor(const glm::vec4& color) { textColor = color; }
-        void SetFontSize(float size) { fontSize = size; }
+        void SetHoverColor(const glm::vec4& color) { hoverColor = color; MarkDirty(); }
+        void SetPressedColor(const glm::vec4& color) { pressedColor = color; MarkDirty(); }
+        void SetTextColor(const glm::vec4& color) { textColor = color; MarkDirty(); }
+        void SetFontSize(float size) { fontSize = size; MarkDirty(); }
         
         
         glm::vec4 GetColor() const {
@@ -61,8 +62,11 @@ namespace CustomGUI {
         const std::string& GetText() const { return text; }
         ButtonState GetState() const { return state; }
         
+    protected:
+        void BuildGeometry(std::vector<UIVertex>& out, const GlyphAtlas& atlas) override;
+
     private:
-        
+        void SetState(ButtonState newState);
         glm::vec2 CalculateTextSize() const;
         std::string RemoveEmojis(const std::string& str) const;
     };
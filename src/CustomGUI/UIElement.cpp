@@ -2,6 +2,9 @@
 
 namespace CustomGUI {
 
+    unsigned int UIElement::treeRevision = 0;
+    unsigned int UIElement::layoutRevision = 0;
+
     UIElement::UIElement(UIElementType elementType, const std::string& elementId)
         : position(0.0f, 0.0f)
         , size(100.0f, 30.0f)
@@ -11,7 +14,10 @@ namespace CustomGUI {
         , zOrder(0)
         , type(elementType)
         , id(elementId)
+        , manager(nullptr)
+        , dirty(true)
     {
+        MarkTreeChanged();
     }
 
     bool UIElement::IsPointInside(glm::vec2 point) const {
@@ -21,4 +27,22 @@ namespace CustomGUI {
                point.y <= position.y + size.y;
     }
 
+    void UIElement::MarkDirty() {
+        dirty = true;
+        MarkTreeChanged();
+    }
+
+    void UIElement::BuildGeometry(std::vector<UIVertex>& out, const GlyphAtlas& atlas) {
+        UIBatch::AppendRect(out, atlas, position, size, color);
+    }
+
+    void UIElement::Submit(UIBatch& batch) {
+        if (dirty) {
+            cachedVertices.clear();
+            BuildGeometry(cachedVertices, *batch.GetAtlas());
+            dirty = false;
+        }
+        batch.AddVertices(cachedVertices);
+    }
+
 } 
@@ -4,9 +4,13 @@
 #include <functional>
 #include <string>
 #include <memory>
+#include <vector>
+#include "UIBatch.h"
 
 namespace CustomGUI {
 
+    class GUIManager;
+
     enum class UIElementType {
         PANEL,
         BUTTON,
@@ -25,6 +29,27 @@ namespace CustomGUI {
         int zOrder;                 
         UIElementType type;         
         std::string id;             
+        GUIManager* manager;        // Set while the element is in a GUIManager's ID index
+
+        
+        bool dirty;
+        std::vector<UIVertex> cachedVertices;
+
+        /**
+         * @brief Regenerate this element's own quads (children are not included)
+         *
+         * Called only when the element is dirty; the result is cached.
+         */
+        virtual void BuildGeometry(std::vector<UIVertex>& out, const GlyphAtlas& atlas);
+
+        /**
+         * @brief Flag the cached geometry as stale and bump the tree revision
+         */
+        void MarkDirty();
+
+    private:
+        static unsigned int treeRevision;
+        static unsigned int layoutRevision;
 
     public:
         UIElement(UIElementType elementType, const std::string& elementId = "");
@@ -38,14 +63,39 @@ namespace CustomGUI {
 
         
         bool IsPointInside(glm::vec2 point) const;
+
+        /**
+         * @brief Append this element's cached quads, rebuilding them if dirty
+         */
+        void Submit(UIBatch& batch);
+        bool IsDirty() const { return dirty; }
+
+        /**
+         * @brief Revision of the whole GUI; changes whenever anything drawn changes
+         */
+        static unsigned int GetTreeRevision() { return treeRevision; }
+
+        /**
+         * @brief Bump the tree revision without touching cached geometry
+         *
+         * For changes that alter what is drawn but not an element's own
+         * quads: visibility, draw order, added or removed elements.
+         */
+        static void MarkTreeChanged() { ++treeRevision; }
+
+        /**
+         * @brief Revision of element bounds, visibility and order; drives hit-test rebuilds
+         */
+        static unsigned int GetLayoutRevision() { return layoutRevision; }
+        static void MarkLayoutChanged() { ++layoutRevision; ++treeRevision; }
         
         
-        void SetPosition(const glm::vec2& pos) { position = pos; }
-        void SetSize(const glm::vec2& sz) { size = sz; }
-        void SetColor(const glm::vec4& col) { color = col; }
-        void SetVisible(bool vis) { visible = vis; }
-        void SetInteractive(bool inter) { interactive = inter; }
-        void SetZOrder(int order) { zOrder = order; }
+        void SetPosition(const glm::vec2& pos) { if (pos != position) { position = pos; MarkDirty(); MarkLayoutChanged(); } }
+        void SetSize(const glm::vec2& sz) { if (sz != size) { size = sz; MarkDirty(); MarkLayoutChanged(); } }
+        void SetColor(const glm::vec4& col) { if (col != color) { color = col; MarkDirty(); } }
+        void SetVisible(bool vis) { if (vis != visible) { visible = vis; MarkLayoutChanged(); } }
+        void SetInteractive(bool inter) { if (inter != interactive) { interactive = inter; MarkLayoutChanged(); } }
+        void SetZOrder(int order) { if (order != zOrder) { zOrder = order; MarkLayoutChanged(); } }
 
         glm::vec2 GetPosition() const { return position; }
         glm::vec2 GetSize() const { return size; }
@@ -55,6 +105,8 @@ namespace CustomGUI {
         int GetZOrder() const { return zOrder; }
         UIElementType GetType() const { return type; }
         const std::string& GetId() const { return id; }
+        GUIManager* GetManager() const { return manager; }
+        void SetManager(GUIManager* owner) { manager = owner; }
 
         
         glm::vec2 GetCenter() const { return position + size * 0.5f; }
@@ -0,0 +1,31 @@
+﻿#pragma once
+
+#include <memory>
+
+namespace CustomGUI {
+
+    /**
+     * @brief Typed, non-owning reference to a GUI element
+     *
+     * Resolve it once with GUIManager::GetHandle<T>() and keep it; the
+     * string lookup and type check happen only at resolve time. The handle
+     * becomes invalid when the element is destroyed, after which it can
+     * be resolved again.
+     */
+    template <typename T>
+    class UIHandle {
+    public:
+        UIHandle() = default;
+        explicit UIHandle(const std::shared_ptr<T>& target) : element(target) {}
+
+        T* Get() const { return element.lock().get(); }
+        T* operator->() const { return Get(); }
+        bool IsValid() const { return !element.expired(); }
+        explicit operator bool() const { return IsValid(); }
+        void Reset() { element.reset(); }
+
+    private:
+        std::weak_ptr<T> element;
+    };
+
+}
@@ -0,0 +1,82 @@
+﻿#include "UIHitGrid.h"
+#include "UIPanel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace CustomGUI {
+
+    UIHitGrid::UIHitGrid()
+        : columns(0)
+        , rows(0)
+    {
+    }
+
+    void UIHitGrid::Build(const std::vector<std::shared_ptr<UIElement>>& roots,
+                          unsigned int screenWidth, unsigned int screenHeight) {
+        columns = std::max(1, static_cast<int>(std::ceil(screenWidth / CELL_SIZE)));
+        rows = std::max(1, static_cast<int>(std::ceil(screenHeight / CELL_SIZE)));
+
+        cells.assign(static_cast<size_t>(columns) * rows, std::vector<Entry>());
+        members.clear();
+
+        int drawOrder = 0;
+        for (const auto& root : roots) {
+            Collect(root.get(), drawOrder);
+        }
+
+        
+        for (auto& cell : cells) {
+            std::sort(cell.begin(), cell.end(), [](const Entry& a, const Entry& b) {
+                return a.drawOrder > b.drawOrder;
+            });
+        }
+    }
+
+    void UIHitGrid::Collect(UIElement* element, int& drawOrder) {
+        if (!element || !element->IsVisible()) return;
+
+        int order = drawOrder++;
+        if (!element->IsInteractive()) return;
+
+        Insert(element, order);
+
+        if (element->GetType() == UIElementType::PANEL) {
+            for (const auto& child : static_cast<UIPanel*>(element)->GetChildren()) {
+                Collect(child.get(), drawOrder);
+            }
+        }
+    }
+
+    void UIHitGrid::Insert(UIElement* element, int drawOrder) {
+        glm::vec4 bounds = element->GetBounds();
+        if (bounds.z < bounds.x || bounds.w < bounds.y) return;
+
+        
+        int minColumn = glm::clamp(static_cast<int>(std::floor(bounds.x / CELL_SIZE)), 0, columns - 1);
+        int maxColumn = glm::clamp(static_cast<int>(std::floor(bounds.z / CELL_SIZE)), 0, columns - 1);
+        int minRow = glm::clamp(static_cast<int>(std::floor(bounds.y / CELL_SIZE)), 0, rows - 1);
+        int maxRow = glm::clamp(static_cast<int>(std::floor(bounds.w / CELL_SIZE)), 0, rows - 1);
+
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int column = minColumn; column <= maxColumn; ++column) {
+                cells[CellIndex(column, row)].push_back({ element, drawOrder });
+            }
+        }
+        members.insert(element);
+    }
+
+    UIElement* UIHitGrid::Query(glm::vec2 point) const {
+        if (cells.empty()) return nullptr;
+
+        int column = glm::clamp(static_cast<int>(std::floor(point.x / CELL_SIZE)), 0, columns - 1);
+        int row = glm::clamp(static_cast<int>(std::floor(point.y / CELL_SIZE)), 0, rows - 1);
+
+        for (const Entry& entry : cells[CellIndex(column, row)]) {
+            if (entry.element->IsPointInside(point)) {
+                return entry.element;
+            }
+        }
+        return nullptr;
+    }
+
+}
@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include "UIElement.h"
+#include <glm/glm.hpp>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace CustomGUI {
+
+    /**
+     * @brief Uniform grid over interactive element bounds for mouse hit-testing
+     *
+     * Build() walks the element tree once in draw order and records every
+     * visible, interactive element in each grid cell its bounds overlap.
+     * Entries in a cell are kept topmost first, so Query() only tests the
+     * handful of elements under the cursor's cell instead of recursing
+     * through every panel. Rebuild only when UIElement's layout revision
+     * changes.
+     *
+     * Children of invisible or non-interactive panels are skipped, matching
+     * the panels' own HandleClick/HandleMouseMove dispatch.
+     */
+    class UIHitGrid {
+    public:
+        UIHitGrid();
+
+        void Build(const std::vector<std::shared_ptr<UIElement>>& roots,
+                   unsigned int screenWidth, unsigned int screenHeight);
+
+        /**
+         * @brief Topmost interactive element containing point, or nullptr
+         */
+        UIElement* Query(glm::vec2 point) const;
+
+        bool Contains(const UIElement* element) const { return members.count(element) != 0; }
+        size_t GetElementCount() const { return members.size(); }
+
+    private:
+        struct Entry {
+            UIElement* element;
+            int drawOrder;          // Pre-order draw index; higher is drawn later (on top)
+        };
+
+        void Collect(UIElement* element, int& drawOrder);
+        void Insert(UIElement* element, int drawOrder);
+        int CellIndex(int column, int row) const { return row * columns + column; }
+
+        std::vector<std::vector<Entry>> cells;
+        std::unordered_set<const UIElement*> members;
+        int columns;
+        int rows;
+
+        static constexpr float CELL_SIZE = 64.0f;     // Pixels per grid cell
+    };
+
+}
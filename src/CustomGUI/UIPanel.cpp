@@ -1,4 +1,5 @@
 ﻿#include "UIPanel.h"
+#include "GUIManager.h"
 #include <algorithm>
 
 namespace CustomGUI {
@@ -8,7 +9,7 @@ namespace CustomGUI {
         , backgroundColor(0.2f, 0.2f, 0.2f, 0.8f)  
         , borderColor(0.5f, 0.5f, 0.5f, 1.0f)      
         , borderWidth(2.0f)
-        , hasBorder(true)
+        , hasBorder(false)
     {
         size = glm::vec2(300.0f, 200.0f); 
     }
@@ -27,6 +28,13 @@ namespace CustomGUI {
         }
     }
 
+    void UIPanel::BuildGeometry(std::vector<UIVertex>& out, const GlyphAtlas& atlas) {
+        UIBatch::AppendRect(out, atlas, position, size, color);
+        if (hasBorder) {
+            UIBatch::AppendBorder(out, atlas, position, size, borderWidth, borderColor);
+        }
+    }
+
     void UIPanel::Update(float deltaTime) {
         
         for (auto& child : children) {
@@ -72,24 +80,38 @@ namespace CustomGUI {
 
     void UIPanel::AddChild(std::shared_ptr<UIElement> child) {
         if (child) {
-            children.push_back(child);
             
-            
-            std::sort(children.begin(), children.end(), 
+            auto position = std::upper_bound(children.begin(), children.end(), child,
                 [](const std::shared_ptr<UIElement>& a, const std::shared_ptr<UIElement>& b) {
                     return a->GetZOrder() < b->GetZOrder();
                 });
+            children.insert(position, child);
+            if (manager) {
+                manager->IndexElement(child);
+            }
+            MarkLayoutChanged();
         }
     }
 
     void UIPanel::RemoveChild(std::shared_ptr<UIElement> child) {
+        if (manager && child) {
+            manager->UnindexElement(child);
+        }
         children.erase(
             std::remove(children.begin(), children.end(), child),
             children.end()
         );
+        MarkLayoutChanged();
     }
 
     void UIPanel::RemoveChild(const std::string& childId) {
+        if (manager) {
+            for (auto& child : children) {
+                if (child && child->GetId() == childId) {
+                    manager->UnindexElement(child);
+                }
+            }
+        }
         children.erase(
             std::remove_if(children.begin(), children.end(),
                 [&childId](const std::shared_ptr<UIElement>& child) {
@@ -97,10 +119,17 @@ namespace CustomGUI {
                 }),
             children.end()
         );
+        MarkLayoutChanged();
     }
 
     void UIPanel::ClearChildren() {
+        if (manager) {
+            for (auto& child : children) {
+                manager->UnindexElement(child);
+            }
+        }
         children.clear();
+        MarkLayoutChanged();
     }
 
 } 
@@ -32,13 +32,19 @@ namespace CustomGUI {
             backgroundColor = color; 
             SetColor(color);  
         }
-        void SetBorderColor(const glm::vec4& color) { borderColor = color; }
-        void SetBorderWidth(float width) { borderWidth = width; }
-        void SetHasBorder(bool border) { hasBorder = border; }
+        void SetBorderColor(const glm::vec4& color) { borderColor = color; MarkDirty(); }
+        void SetBorderWidth(float width) { borderWidth = width; MarkDirty(); }
+        void SetHasBorder(bool border) { hasBorder = border; MarkDirty(); }
         
         glm::vec4 GetBackgroundColor() const { return backgroundColor; }
+        glm::vec4 GetBorderColor() const { return borderColor; }
+        float GetBorderWidth() const { return borderWidth; }
+        bool HasBorder() const { return hasBorder; }
         const std::vector<std::shared_ptr<UIElement>>& GetChildren() const { return children; }
         size_t GetChildCount() const { return children.size(); }
+
+    protected:
+        void BuildGeometry(std::vector<UIVertex>& out, const GlyphAtlas& atlas) override;
     };
 
 } 
@@ -1,7 +1,9 @@
 ﻿#pragma once
 
 #include "UIElement.h"
+#include "GlyphAtlas.h"
 #include <memory>
+#include <vector>
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -14,14 +16,6 @@ namespace CustomGUI {
         RIGHT
     };
 
-    
-    struct Character {
-        unsigned int textureID;  
-        glm::ivec2   size;       
-        glm::ivec2   bearing;    
-        unsigned int advance;    
-    };
-
     class UIText : public UIElement {
     private:
         std::string text;
@@ -33,13 +27,14 @@ namespace CustomGUI {
         
         static bool fontSystemInitialized;
         static unsigned int fontShaderProgram;
-        static unsigned int fontVAO, fontVBO;
+        static unsigned int fontVAO;     // Vertices are streamed through the StreamBuffer ring
+        static int textColorLocation, projectionLocation;
         static glm::mat4 fontProjection;
-        static Character characters[128]; 
+        static GlyphAtlas* fontAtlas;
+        static std::vector<float> textVertices;
         
         
         static bool InitializeShaders();
-        static void GenerateCharacterTextures();
         static void RenderTextInternal(const std::string& text, float x, float y, float scale, const glm::vec3& color);
 
     public:
@@ -76,6 +71,12 @@ namespace CustomGUI {
         
         glm::vec2 CalculateTextSize() const;
         void AutoSizeToFitText();
+
+    protected:
+        void BuildGeometry(std::vector<UIVertex>& out, const GlyphAtlas& atlas) override;
+
+    private:
+        float GetRenderX(const GlyphAtlas& atlas, float scale) const;
     };
 
 } 
@@ -0,0 +1,105 @@
+﻿#include "DepthPrePass.h"
+#include <iostream>
+
+DepthPrePass::DepthPrePass()
+    : m_queries{}
+    , m_pending{}
+    , m_pixels{}
+    , m_queryFrame(0)
+    , m_overdraw(0.0f)
+    , m_enabled(true)
+    , m_overdrawView(false)
+    , m_depthWritten(false)
+    , m_savedClearColor{}
+{
+}
+
+DepthPrePass::~DepthPrePass() {
+    Shutdown();
+}
+
+bool DepthPrePass::Initialize() {
+    m_depthShader = std::make_unique<Shader>("resources/shaders/depth_prepass.vert", "resources/shaders/shadow_map.frag");
+    m_overdrawShader = std::make_unique<Shader>("resources/shaders/depth_prepass.vert", "resources/shaders/overdraw.frag");
+    if (!m_depthShader->IsLinked() || !m_overdrawShader->IsLinked()) {
+        std::cerr << "[DepthPrePass] Failed to build the depth programs" << std::endl;
+        m_depthShader.reset();
+        m_overdrawShader.reset();
+        return false;
+    }
+
+    glGenQueries(QUERY_FRAMES, m_queries);
+    return true;
+}
+
+void DepthPrePass::Shutdown() {
+    if (m_queries[0] != 0) {
+        glDeleteQueries(QUERY_FRAMES, m_queries);
+    }
+    for (int i = 0; i < QUERY_FRAMES; ++i) {
+        m_queries[i] = 0;
+        m_pending[i] = false;
+    }
+    m_depthShader.reset();
+    m_overdrawShader.reset();
+}
+
+void DepthPrePass::BeginDepthPass() {
+    glEnable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    m_depthWritten = true;
+}
+
+void DepthPrePass::BeginColorPass() {
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    if (m_depthWritten) {
+        glDepthFunc(GL_EQUAL);
+        glDepthMask(GL_FALSE);
+    }
+
+    if (m_overdrawView) {
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, m_savedClearColor);
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+    }
+
+    // The slot about to be reused was issued QUERY_FRAMES - 1 frames ago
+    ResolveQueries();
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    m_pixels[m_queryFrame] = static_cast<size_t>(viewport[2]) * static_cast<size_t>(viewport[3]);
+    glBeginQuery(GL_SAMPLES_PASSED, m_queries[m_queryFrame]);
+}
+
+void DepthPrePass::EndColorPass() {
+    glEndQuery(GL_SAMPLES_PASSED);
+    m_pending[m_queryFrame] = true;
+    m_queryFrame = (m_queryFrame + 1) % QUERY_FRAMES;
+
+    if (m_overdrawView) {
+        glDisable(GL_BLEND);
+        glClearColor(m_savedClearColor[0], m_savedClearColor[1], m_savedClearColor[2], m_savedClearColor[3]);
+    }
+    glDepthFunc(GL_LESS);
+    glDepthMask(GL_TRUE);
+    m_depthWritten = false;
+}
+
+void DepthPrePass::ResolveQueries() {
+    if (!m_pending[m_queryFrame]) {
+        return;
+    }
+
+    GLint available = 0;
+    glGetQueryObjectiv(m_queries[m_queryFrame], GL_QUERY_RESULT_AVAILABLE, &available);
+    if (available && m_pixels[m_queryFrame] > 0) {
+        GLuint64 samples = 0;
+        glGetQueryObjectui64v(m_queries[m_queryFrame], GL_QUERY_RESULT, &samples);
+        m_overdraw = static_cast<float>(static_cast<double>(samples) / m_pixels[m_queryFrame]);
+    }
+    m_pending[m_queryFrame] = false;
+}
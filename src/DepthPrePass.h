@@ -0,0 +1,102 @@
+﻿/**
+ * @file DepthPrePass.h
+ * @brief Depth-only pre-pass and overdraw measurement for the forward scene
+ *
+ * The forward path lights and shadow-filters every fragment it rasterises,
+ * so surfaces drawn before whatever later covers them pay the full cost.
+ * With the pre-pass enabled the opaque scene is first drawn depth-only
+ * through a position-only program; the colour pass then runs with
+ * GL_EQUAL and depth writes off, so each pixel is shaded once.
+ *
+ * The depth program computes gl_Position with the same expression as the
+ * lit vertex shaders and every one of them declares it invariant, which
+ * keeps the depths of the two passes bit-identical.
+ *
+ * The colour pass is wrapped in a GL_SAMPLES_PASSED query. Results are
+ * read back a few frames later, once available, as shaded fragments per
+ * pixel (1.0 means no overdraw). The overdraw view swaps lighting for a
+ * flat additive colour so pixels shaded many times show up brighter.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <memory>
+#include "Shader.h"
+
+/**
+ * @brief Depth pre-pass state switches, programs and the overdraw counter
+ *
+ * Per frame: BeginDepthPass() and draw the opaque scene with
+ * GetDepthShader() (only when enabled), then BeginColorPass(), draw the
+ * lit scene (or everything with GetOverdrawShader() in the overdraw view)
+ * and EndColorPass().
+ */
+class DepthPrePass {
+public:
+    DepthPrePass();
+    ~DepthPrePass();
+
+    bool Initialize();
+    void Shutdown();
+
+    bool IsEnabled() const { return m_enabled; }
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+    bool IsOverdrawView() const { return m_overdrawView; }
+    void SetOverdrawView(bool enabled) { m_overdrawView = enabled; }
+
+    /**
+     * @brief Position-only program; needs model, view and projection
+     */
+    Shader& GetDepthShader() { return *m_depthShader; }
+
+    /**
+     * @brief Flat additive program for the overdraw view; same uniforms as the depth program
+     */
+    Shader& GetOverdrawShader() { return *m_overdrawShader; }
+
+    /**
+     * @brief Write depth only; the caller draws the opaque scene next
+     */
+    void BeginDepthPass();
+
+    /**
+     * @brief Restore colour writes and start counting shaded fragments
+     *
+     * Tests GL_EQUAL without depth writes if BeginDepthPass() ran this
+     * frame. The overdraw view also clears the colour to black and turns
+     * on additive blending.
+     */
+    void BeginColorPass();
+
+    /**
+     * @brief Stop counting and restore the default depth and blend state
+     *
+     * Fragments are averaged over the viewport set at BeginColorPass().
+     */
+    void EndColorPass();
+
+    /**
+     * @brief Shaded fragments per pixel from the latest resolved frame
+     */
+    float GetOverdraw() const { return m_overdraw; }
+
+private:
+    void ResolveQueries();
+
+    static constexpr int QUERY_FRAMES = 3;
+
+    std::unique_ptr<Shader> m_depthShader;
+    std::unique_ptr<Shader> m_overdrawShader;
+
+    GLuint m_queries[QUERY_FRAMES];
+    bool m_pending[QUERY_FRAMES];
+    size_t m_pixels[QUERY_FRAMES];      // Viewport area each query was issued for
+    int m_queryFrame;
+    float m_overdraw;
+
+    bool m_enabled;
+    bool m_overdrawView;
+    bool m_depthWritten;                // BeginDepthPass() ran for the current frame
+    GLfloat m_savedClearColor[4];
+};
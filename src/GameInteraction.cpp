@@ -6,7 +6,7 @@
 
 GameInteraction::GameInteraction(TerrainGenerator* terrain)
     : currentState(GameState::IN_GAME), terrainGenerator(terrain),
-      raycastDistance(10.0f), debugMode(false), currentNearbyItem(nullptr) {
+      maxInteractionRange(0.0f), raycastDistance(10.0f), debugMode(false), currentNearbyItem(nullptr) {
     
     eventSystem = std::make_unique<EventSystem>();
 }
@@ -64,6 +64,9 @@ void GameInteraction::HandleInput(int key, int action, const glm::vec3& playerPo
     if (key == GLFW_KEY_E && action == GLFW_PRESS) {
         if (currentNearbyItem) {
             if (currentNearbyItem->TryCollect(playerPos)) {
+                if (currentNearbyItem->IsCollected()) {
+                    itemGrid.Remove(currentNearbyItem);
+                }
                 
                 AudioEventHandler::PlayEventSound(AudioEvent::ITEM_COLLECTED, currentNearbyItem->GetPosition());
                 
@@ -109,14 +112,15 @@ RayHit GameInteraction::PerformRaycast(const Ray& ray) {
     
     
     glm::vec3 terrainHitPoint;
+    glm::vec3 terrainNormal;
     float terrainDistance;
-    if (RayTerrainIntersection(ray, terrainHitPoint, terrainDistance)) {
+    if (RayTerrainIntersection(ray, terrainHitPoint, terrainDistance, terrainNormal)) {
         if (terrainDistance < closestDistance) {
             result.hit = true;
             result.point = terrainHitPoint;
             result.distance = terrainDistance;
             result.objectName = "terrain";
-            result.normal = glm::vec3(0.0f, 1.0f, 0.0f); 
+            result.normal = terrainNormal;
             closestDistance = terrainDistance;
         }
     }
@@ -146,11 +150,12 @@ RayHit GameInteraction::PerformRaycast(const Ray& ray) {
 void GameInteraction::CheckItemCollection(const glm::vec3& playerPos) {
     currentNearbyItem = nullptr;
     
-    for (auto& item : collectibleItems) {
-        if (item->IsPlayerInRange(playerPos)) {
-            currentNearbyItem = item.get();
-            break; 
-        }
+    // Only items within the largest interaction range can qualify; the closest one wins
+    CollectibleItem* nearest = nullptr;
+    float distance = 0.0f;
+    if (itemGrid.FindNearest(playerPos, maxInteractionRange, nearest, distance,
+                             [&playerPos](CollectibleItem* item) { return item->IsPlayerInRange(playerPos); })) {
+        currentNearbyItem = nearest;
     }
     
     
@@ -165,10 +170,19 @@ void GameInteraction::CheckItemCollection(const glm::vec3& playerPos) {
 void GameInteraction::AddCollectibleItem(CollectibleType type, const glm::vec3& position, 
                                         const std::string& name, int value) {
     auto item = std::make_unique<CollectibleItem>(type, position, name, value);
+    itemGrid.Insert(item.get(), position);
+    maxInteractionRange = std::max(maxInteractionRange, item->GetInteractionRange());
     collectibleItems.push_back(std::move(item));
     treasureGameData.totalKeys = collectibleItems.size();
 }
 
+void GameInteraction::MoveCollectibleItem(CollectibleItem* item, const glm::vec3& position) {
+    item->SetPosition(position);
+    if (itemGrid.Contains(item)) {
+        itemGrid.Update(item, position);
+    }
+}
+
 void GameInteraction::DestroyBlock(const glm::vec3& position) {
     
     EventData eventData(EventType::BLOCK_DESTROYED, position);
@@ -291,26 +305,12 @@ void GameInteraction::SetupEventListeners() {
         [this](const EventData& data) { OnChestOpened(data); });
 }
 
-bool GameInteraction::RayTerrainIntersection(const Ray& ray, glm::vec3& hitPoint, float& distance) {
-    
-    
-    const float stepSize = 0.5f;
-    const int maxSteps = static_cast<int>(raycastDistance / stepSize);
-    
-    for (int i = 1; i <= maxSteps; ++i) {
-        glm::vec3 testPoint = ray.origin + ray.direction * (stepSize * i);
-        
-        if (terrainGenerator) {
-            float terrainHeight = terrainGenerator->GetHeightAt(testPoint.x, testPoint.z);
-            if (testPoint.y <= terrainHeight) {
-                hitPoint = testPoint;
-                distance = stepSize * i;
-                return true;
-            }
-        }
+bool GameInteraction::RayTerrainIntersection(const Ray& ray, glm::vec3& hitPoint, float& distance, glm::vec3& normal) {
+    if (!terrainGenerator) {
+        return false;
     }
     
-    return false;
+    return terrainGenerator->Raycast(ray.origin, ray.direction, raycastDistance, hitPoint, distance, &normal);
 }
 
 bool GameInteraction::RayItemIntersection(const Ray& ray, CollectibleItem* item, float& distance) {
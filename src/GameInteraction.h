@@ -27,6 +27,7 @@
 #include "GameState.h"
 #include "EventSystem.h"
 #include "CollectibleItem.h"
+#include "SpatialHashGrid.h"
 #include "TerrainGenerator.h"
 #include "IrrklangAudioManager.h"
 
@@ -97,11 +98,13 @@ private:
     
     // Item management system
     std::vector<std::unique_ptr<CollectibleItem>> collectibleItems;  // All collectible objects
+    SpatialHashGrid<CollectibleItem*> itemGrid;                      // Uncollected items by position
     
     // World integration
     TerrainGenerator* terrainGenerator;  // Reference to terrain system
     
     // Interaction parameters
+    float maxInteractionRange;  // Largest interaction range of any item
     float raycastDistance;      // Maximum distance for object interaction
     bool debugMode;            // Whether to display debug information
     
@@ -128,6 +131,7 @@ public:
     void CheckItemCollection(const glm::vec3& playerPos);
     void AddCollectibleItem(CollectibleType type, const glm::vec3& position, 
                            const std::string& name, int value = 10);
+    void MoveCollectibleItem(CollectibleItem* item, const glm::vec3& position);
     
     
     void DestroyBlock(const glm::vec3& position);
@@ -165,7 +169,7 @@ private:
     void SetupEventListeners();
     
     
-    bool RayTerrainIntersection(const Ray& ray, glm::vec3& hitPoint, float& distance);
+    bool RayTerrainIntersection(const Ray& ray, glm::vec3& hitPoint, float& distance, glm::vec3& normal);
     
     
     bool RayItemIntersection(const Ray& ray, CollectibleItem* item, float& distance);
@@ -18,6 +18,7 @@
 #include <string>
 #include <vector>
 #include <glm/glm.hpp>
+#include "SpatialHashGrid.h"
 
 /**
  * @brief Primary game states for application flow
@@ -96,6 +97,7 @@ struct AncientTreasureGameData {
     int chestsUnlocked;                     // Number of chests opened
     int totalChests;                        // Total chests in the level
     std::vector<TreasureData> treasures;    // All treasure objects    
+    SpatialHashGrid<size_t> treasureGrid;   // Uncollected treasures, keyed by index into treasures
     std::string currentTask;                // Current objective description
     glm::vec3 playerPosition;               // Player's world coordinates
     bool nearInteractable;                  // True if player can interact with nearby object
@@ -153,9 +155,18 @@ struct AncientTreasureGameData {
                 break;
         }
         
+        treasureGrid.Insert(treasures.size(), pos);
         treasures.push_back(treasure);
     }
     
+    /**
+     * @brief Remove every treasure and its spatial index entry
+     */
+    void ClearTreasures() {
+        treasures.clear();
+        treasureGrid.Clear();
+    }
+    
     /**
      * @brief Attempt to collect a treasure by ID
      * 
@@ -166,16 +177,19 @@ struct AncientTreasureGameData {
      * @return True if collection was successful, false otherwise
      */
     bool CollectTreasure(int treasureId) {
-        for (auto& treasure : treasures) {
+        for (size_t i = 0; i < treasures.size(); i++) {
+            TreasureData& treasure = treasures[i];
             if (treasure.id == treasureId && treasure.status == TreasureStatus::UNCOLLECTED) {
                 if (treasure.type == TreasureType::ANCIENT_KEY) {
                     treasure.status = TreasureStatus::COLLECTED;
+                    treasureGrid.Remove(i);
                     keysCollected++;
                     return true;
                 } else if (treasure.type == TreasureType::TREASURE_CHEST) {
                     // Check if player has the required key
                     if (HasKey(treasure.requiredKeyId)) {
                         treasure.status = TreasureStatus::UNLOCKED;
+                        treasureGrid.Remove(i);
                         chestsUnlocked++;
                         return true;
                     }
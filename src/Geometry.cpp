@@ -1,14 +1,27 @@
 ﻿#include "Geometry.h"
 #include <glm/gtc/matrix_transform.hpp>
 
+static constexpr size_t FLOATS_PER_VERTEX = 8;     // Position, normal, texture coordinates
+
+// Cube, quad and sphere share one vertex format and so one pool
+static GeometryPool& GetPrimitivePool() {
+    static GeometryPool pool("Primitives", {
+        FLOATS_PER_VERTEX * sizeof(float), {
+            { 0, 3, 0 },
+            { 1, 3, 3 * sizeof(float) },
+            { 2, 2, 6 * sizeof(float) }
+        }
+    }, 8 * 1024, 32 * 1024);
+    return pool;
+}
+
 
 Cube::Cube() {
     SetupCube();
 }
 
 Cube::~Cube() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+    GetPrimitivePool().Free(geometry);
 }
 
 void Cube::SetupCube() {
@@ -62,31 +75,23 @@ void Cube::SetupCube() {
         -0.5f,  0.5f, -0.5f,  0.0f,  1.0f,  0.0f,  0.0f, 1.0f
     };
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindVertexArray(VAO);
-
-    
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    // Drawn as a plain triangle list; the shared pool only takes indexed geometry
+    std::vector<unsigned int> indices(vertices.size() / FLOATS_PER_VERTEX);
+    for (unsigned int i = 0; i < indices.size(); i++) {
+        indices[i] = i;
+    }
+    indexCount = static_cast<unsigned int>(indices.size());
+    GetPrimitivePool().Free(geometry);
+    geometry = GetPrimitivePool().Allocate(vertices.data(), vertices.size() / FLOATS_PER_VERTEX,
+                                           indices.data(), indices.size());
 }
 
 void Cube::Draw(Shader& shader, const glm::mat4& model) {
     shader.SetMat4("model", model);
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    GeometryPool& pool = GetPrimitivePool();
+    pool.Bind();
+    pool.Draw(pool.MakeCommand(geometry, 0, indexCount));
+    glBindVertexArray(0);
 }
 
 
@@ -95,9 +100,7 @@ Quad::Quad() {
 }
 
 Quad::~Quad() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    GetPrimitivePool().Free(geometry);
 }
 
 void Quad::SetupQuad() {
@@ -114,35 +117,17 @@ void Quad::SetupQuad() {
         2, 3, 0
     };
 
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    GetPrimitivePool().Free(geometry);
+    geometry = GetPrimitivePool().Allocate(vertices.data(), vertices.size() / FLOATS_PER_VERTEX,
+                                           indices.data(), indices.size());
 }
 
 void Quad::Draw(Shader& shader, const glm::mat4& model) {
     shader.SetMat4("model", model);
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    GeometryPool& pool = GetPrimitivePool();
+    pool.Bind();
+    pool.Draw(pool.MakeCommand(geometry, 0, static_cast<GLuint>(indices.size())));
+    glBindVertexArray(0);
 }
 
 Sphere::Sphere(int segments) : m_segments(segments) {
@@ -150,9 +135,7 @@ Sphere::Sphere(int segments) : m_segments(segments) {
 }
 
 Sphere::~Sphere() {
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    GetPrimitivePool().Free(geometry);
 }
 
 void Sphere::SetupSphere(int segments) {
@@ -202,33 +185,15 @@ void Sphere::SetupSphere(int segments) {
         }
     }
     
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-    
-    glBindVertexArray(VAO);
-    
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-    
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    // Normal attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // Texture coordinate attribute
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    GetPrimitivePool().Free(geometry);
+    geometry = GetPrimitivePool().Allocate(vertices.data(), vertices.size() / FLOATS_PER_VERTEX,
+                                           indices.data(), indices.size());
 }
 
 void Sphere::Draw(Shader& shader, const glm::mat4& model) {
     shader.SetMat4("model", model);
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    GeometryPool& pool = GetPrimitivePool();
+    pool.Bind();
+    pool.Draw(pool.MakeCommand(geometry, 0, static_cast<GLuint>(indices.size())));
+    glBindVertexArray(0);
 }
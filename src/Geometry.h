@@ -8,7 +8,7 @@
  * 
  * Features:
  * - Pre-built geometric primitives with proper vertex data
- * - Automatic OpenGL buffer management
+ * - Geometry sub-allocated from one GeometryPool shared by all primitives
  * - Simple rendering interface
  * - Efficient indexed geometry where applicable
  */
@@ -18,6 +18,7 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <vector>
+#include "GeometryPool.h"
 #include "Shader.h"
 
 /**
@@ -53,8 +54,9 @@ public:
     void SetupCube();
     
 private:
-    unsigned int VAO, VBO;     // OpenGL buffer objects
+    GeometryPool::Handle geometry = GeometryPool::INVALID_HANDLE;   // Range in the primitive pool
     std::vector<float> vertices; // Vertex data (position + texture coords)
+    unsigned int indexCount = 0;
 };
 
 /**
@@ -93,7 +95,7 @@ public:
     void SetupQuad();
     
 private:
-    unsigned int VAO, VBO, EBO; // OpenGL buffer objects
+    GeometryPool::Handle geometry = GeometryPool::INVALID_HANDLE;   // Range in the primitive pool
     std::vector<float> vertices;  // Vertex data (position + texture coords)
     std::vector<unsigned int> indices; // Triangle indices for indexed rendering
 };
@@ -138,7 +140,7 @@ public:
     void SetupSphere(int segments);
     
 private:
-    unsigned int VAO, VBO, EBO;        // OpenGL buffer objects
+    GeometryPool::Handle geometry = GeometryPool::INVALID_HANDLE;   // Range in the primitive pool
     std::vector<float> vertices;       // Vertex data (position + normal + texcoords)
     std::vector<unsigned int> indices; // Triangle indices for indexed rendering
     int m_segments;                    // Tessellation level
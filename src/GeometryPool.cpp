@@ -0,0 +1,338 @@
+﻿#include "GeometryPool.h"
+#include "StreamBuffer.h"
+#include <algorithm>
+#include <iostream>
+
+std::vector<GeometryPool*> GeometryPool::s_pools;
+
+RangeAllocator::RangeAllocator(size_t capacity)
+    : m_capacity(0)
+    , m_used(0)
+{
+    Reset(capacity, 0);
+}
+
+size_t RangeAllocator::Allocate(size_t count) {
+    for (auto it = m_free.begin(); it != m_free.end(); ++it) {
+        if (it->second < count) {
+            continue;
+        }
+        size_t offset = it->first;
+        size_t remaining = it->second - count;
+        m_free.erase(it);
+        if (remaining > 0) {
+            m_free.emplace(offset + count, remaining);
+        }
+        m_used += count;
+        return offset;
+    }
+    return INVALID_OFFSET;
+}
+
+void RangeAllocator::Free(size_t offset, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    m_used -= count;
+
+    auto next = m_free.lower_bound(offset);
+    if (next != m_free.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            count += previous->second;
+            m_free.erase(previous);
+        }
+    }
+    if (next != m_free.end() && offset + count == next->first) {
+        count += next->second;
+        m_free.erase(next);
+    }
+    m_free.emplace(offset, count);
+}
+
+void RangeAllocator::Reset(size_t capacity, size_t used) {
+    m_free.clear();
+    m_capacity = capacity;
+    m_used = used;
+    if (used < capacity) {
+        m_free.emplace(used, capacity - used);
+    }
+}
+
+GeometryPool::GeometryPool(std::string name, VertexFormat format, size_t initialVertices, size_t initialIndices)
+    : m_name(std::move(name))
+    , m_format(std::move(format))
+    , m_initialVertices(std::max<size_t>(initialVertices, 1))
+    , m_initialIndices(std::max<size_t>(initialIndices, 1))
+    , m_vao(0)
+    , m_liveBlocks(0)
+    , m_compactions(0)
+    , m_growths(0)
+{
+    m_vertices.elementSize = m_format.stride;
+    m_indices.elementSize = sizeof(unsigned int);
+    s_pools.push_back(this);
+}
+
+GeometryPool::~GeometryPool() {
+    Release();
+    s_pools.erase(std::remove(s_pools.begin(), s_pools.end(), this), s_pools.end());
+}
+
+GeometryPool::Handle GeometryPool::Allocate(const void* vertexData, size_t vertexCount,
+                                            const unsigned int* indexData, size_t indexCount) {
+    if (m_vao == 0) {
+        CreateBuffers();
+    }
+
+    size_t vertexOffset = 0;
+    if (vertexCount > 0) {
+        vertexOffset = m_vertices.allocator.Allocate(vertexCount);
+        if (vertexOffset == RangeAllocator::INVALID_OFFSET) {
+            Repack(m_vertices, vertexCount, true);
+            vertexOffset = m_vertices.allocator.Allocate(vertexCount);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_vertices.id);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset * m_vertices.elementSize,
+                        vertexCount * m_vertices.elementSize, vertexData);
+    }
+
+    size_t indexOffset = 0;
+    if (indexCount > 0) {
+        indexOffset = m_indices.allocator.Allocate(indexCount);
+        if (indexOffset == RangeAllocator::INVALID_OFFSET) {
+            Repack(m_indices, indexCount, false);
+            indexOffset = m_indices.allocator.Allocate(indexCount);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_indices.id);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset * m_indices.elementSize,
+                        indexCount * m_indices.elementSize, indexData);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    Handle handle;
+    if (!m_freeHandles.empty()) {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    } else {
+        m_blocks.push_back({});
+        handle = static_cast<Handle>(m_blocks.size());
+    }
+
+    Block& block = m_blocks[handle - 1];
+    block.range.baseVertex = static_cast<GLint>(vertexOffset);
+    block.range.vertexCount = static_cast<GLuint>(vertexCount);
+    block.range.firstIndex = static_cast<GLuint>(indexOffset);
+    block.range.indexCount = static_cast<GLuint>(indexCount);
+    block.live = true;
+    m_liveBlocks++;
+    return handle;
+}
+
+void GeometryPool::Free(Handle handle) {
+    if (handle == INVALID_HANDLE || handle > m_blocks.size() || !m_blocks[handle - 1].live) {
+        return;
+    }
+
+    Block& block = m_blocks[handle - 1];
+    m_vertices.allocator.Free(block.range.baseVertex, block.range.vertexCount);
+    m_indices.allocator.Free(block.range.firstIndex, block.range.indexCount);
+    block.live = false;
+    m_freeHandles.push_back(handle);
+    m_liveBlocks--;
+}
+
+DrawElementsIndirectCommand GeometryPool::MakeCommand(Handle handle, GLuint indexOffset, GLuint indexCount) const {
+    const Range& range = GetRange(handle);
+    return { indexCount, 1, range.firstIndex + indexOffset, range.baseVertex, 0 };
+}
+
+void GeometryPool::Bind() const {
+    glBindVertexArray(m_vao);
+}
+
+void GeometryPool::Draw(const DrawElementsIndirectCommand& command) const {
+    const void* offset = reinterpret_cast<const void*>(static_cast<size_t>(command.firstIndex) * sizeof(unsigned int));
+    if (command.instanceCount == 1) {
+        glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT,
+                                 offset, command.baseVertex);
+    } else {
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(command.count), GL_UNSIGNED_INT,
+                                          offset, static_cast<GLsizei>(command.instanceCount), command.baseVertex);
+    }
+}
+
+void GeometryPool::MultiDraw(std::span<const DrawElementsIndirectCommand> commands) {
+    if (commands.empty()) {
+        return;
+    }
+
+    if (!SupportsMultiDrawIndirect()) {
+        for (const DrawElementsIndirectCommand& command : commands) {
+            Draw(command);
+        }
+        return;
+    }
+
+    StreamAllocation stream = StreamBuffer::Get().Write(commands.data(), commands.size_bytes(), sizeof(GLuint));
+    if (stream.buffer == 0) {
+        for (const DrawElementsIndirectCommand& command : commands) {
+            Draw(command);
+        }
+        return;
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, stream.buffer);
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(stream.offset),
+                                static_cast<GLsizei>(commands.size()), 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GeometryPool::MultiDrawIndirect(GLuint commandBuffer, GLsizei maxDrawCount, GLuint countBuffer) const {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+    if (countBuffer != 0 && SupportsIndirectCount()) {
+        glBindBuffer(GL_PARAMETER_BUFFER, countBuffer);
+        if (GLAD_GL_VERSION_4_6) {
+            glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, maxDrawCount, 0);
+        } else {
+            glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0, maxDrawCount, 0);
+        }
+        glBindBuffer(GL_PARAMETER_BUFFER, 0);
+    } else {
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, maxDrawCount, 0);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void GeometryPool::Release() {
+    for (Buffer* buffer : { &m_vertices, &m_indices }) {
+        if (buffer->id != 0) {
+            glDeleteBuffers(1, &buffer->id);
+            buffer->id = 0;
+        }
+        buffer->allocator.Reset(0, 0);
+    }
+    if (m_vao != 0) {
+        glDeleteVertexArrays(1, &m_vao);
+        m_vao = 0;
+    }
+    m_blocks.clear();
+    m_freeHandles.clear();
+    m_liveBlocks = 0;
+}
+
+GeometryPool::Stats GeometryPool::GetStats() const {
+    Stats stats = {};
+    for (const Buffer* buffer : { &m_vertices, &m_indices }) {
+        stats.capacityBytes += buffer->allocator.GetCapacity() * buffer->elementSize;
+        stats.usedBytes += buffer->allocator.GetUsed() * buffer->elementSize;
+        stats.freeRanges += buffer->allocator.GetFreeRangeCount();
+    }
+    stats.allocations = m_liveBlocks;
+    stats.compactions = m_compactions;
+    stats.growths = m_growths;
+    return stats;
+}
+
+bool GeometryPool::SupportsMultiDrawIndirect() {
+    return GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_multi_draw_indirect;
+}
+
+bool GeometryPool::SupportsIndirectCount() {
+    return GLAD_GL_VERSION_4_6 || GLAD_GL_ARB_indirect_parameters;
+}
+
+void GeometryPool::ReleaseAll() {
+    for (GeometryPool* pool : s_pools) {
+        pool->Release();
+    }
+}
+
+GeometryPool::Stats GeometryPool::GetTotalStats() {
+    Stats total = {};
+    for (const GeometryPool* pool : s_pools) {
+        Stats stats = pool->GetStats();
+        total.capacityBytes += stats.capacityBytes;
+        total.usedBytes += stats.usedBytes;
+        total.allocations += stats.allocations;
+        total.freeRanges += stats.freeRanges;
+        total.compactions += stats.compactions;
+        total.growths += stats.growths;
+    }
+    return total;
+}
+
+void GeometryPool::CreateBuffers() {
+    glGenVertexArrays(1, &m_vao);
+    for (Buffer* buffer : { &m_vertices, &m_indices }) {
+        size_t capacity = buffer == &m_vertices ? m_initialVertices : m_initialIndices;
+        glGenBuffers(1, &buffer->id);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer->id);
+        glBufferData(GL_COPY_WRITE_BUFFER, capacity * buffer->elementSize, nullptr, GL_STATIC_DRAW);
+        buffer->allocator.Reset(capacity, 0);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    BindAttributes();
+}
+
+void GeometryPool::BindAttributes() {
+    glBindVertexArray(m_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vertices.id);
+    for (const VertexAttribute& attribute : m_format.attributes) {
+        glEnableVertexAttribArray(attribute.location);
+        glVertexAttribPointer(attribute.location, attribute.components, GL_FLOAT, GL_FALSE,
+                              m_format.stride, reinterpret_cast<const void*>(attribute.offset));
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indices.id);
+    glBindVertexArray(0);
+}
+
+void GeometryPool::Repack(Buffer& buffer, size_t required, bool vertices) {
+    // Packing alone is enough while the live data plus the request fit the current size
+    size_t used = buffer.allocator.GetUsed();
+    size_t capacity = buffer.allocator.GetCapacity();
+    bool grow = false;
+    while (used + required > capacity) {
+        capacity *= 2;
+        grow = true;
+    }
+
+    GLuint packed = 0;
+    glGenBuffers(1, &packed);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, packed);
+    glBufferData(GL_COPY_WRITE_BUFFER, capacity * buffer.elementSize, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer.id);
+
+    size_t cursor = 0;
+    for (Block& block : m_blocks) {
+        GLuint count = vertices ? block.range.vertexCount : block.range.indexCount;
+        if (!block.live || count == 0) {
+            continue;
+        }
+        size_t offset = vertices ? static_cast<size_t>(block.range.baseVertex) : block.range.firstIndex;
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, offset * buffer.elementSize,
+                            cursor * buffer.elementSize, count * buffer.elementSize);
+        if (vertices) {
+            block.range.baseVertex = static_cast<GLint>(cursor);
+        } else {
+            block.range.firstIndex = static_cast<GLuint>(cursor);
+        }
+        cursor += count;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    glDeleteBuffers(1, &buffer.id);
+    buffer.id = packed;
+    buffer.allocator.Reset(capacity, cursor);
+    BindAttributes();
+
+    if (grow) {
+        m_growths++;
+    } else {
+        m_compactions++;
+    }
+    std::cout << "[GeometryPool] " << m_name << (grow ? ": grew " : ": compacted ")
+              << (vertices ? "vertex" : "index") << " buffer to " << capacity << " elements ("
+              << cursor << " in use)" << std::endl;
+}
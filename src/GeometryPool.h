@@ -0,0 +1,230 @@
+﻿/**
+ * @file GeometryPool.h
+ * @brief Shared vertex and index buffers with sub-allocation
+ *
+ * Instead of every mesh owning a VAO, VBO and EBO, all geometry of one
+ * vertex format lives in a single pair of large buffers behind one VAO:
+ * - Allocations are ranges of those buffers, addressed through a handle;
+ *   index data is relative to its own vertex range and drawn with a base
+ *   vertex, so nothing needs rebasing when ranges move
+ * - Freed ranges return to a free list that coalesces neighbours
+ * - When no free range fits, live ranges are packed into fresh buffers
+ *   (compaction), doubling the capacity only if the packed data still
+ *   doesn't leave room
+ * - Draws are DrawElementsIndirectCommand records; MultiDraw() submits a
+ *   batch with one glMultiDrawElementsIndirect on GL 4.3 (or
+ *   ARB_multi_draw_indirect) and falls back to one base-vertex draw per
+ *   command on the GL 4.1 baseline, still without VAO switches
+ *
+ * Buffers are created on the first allocation, so pools can be declared
+ * before the GL context exists. ReleaseAll() must run while it is still
+ * current.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @brief One attribute of a vertex format
+ */
+struct VertexAttribute {
+    GLuint location;
+    GLint components;       // Float components
+    size_t offset;          // Byte offset inside the vertex
+};
+
+/**
+ * @brief Interleaved float vertex layout of a pool
+ */
+struct VertexFormat {
+    GLsizei stride;
+    std::vector<VertexAttribute> attributes;
+};
+
+/**
+ * @brief Layout of one indirect draw, as read by glMultiDrawElementsIndirect
+ */
+struct DrawElementsIndirectCommand {
+    GLuint count;           // Indices to draw
+    GLuint instanceCount;
+    GLuint firstIndex;      // Into the pool's index buffer
+    GLint baseVertex;       // Added to every index
+    GLuint baseInstance;
+};
+
+/**
+ * @brief First-fit allocator over a range of element slots
+ *
+ * Pure bookkeeping: free ranges are kept by offset so a freed range
+ * merges with the free ranges on either side.
+ */
+class RangeAllocator {
+public:
+    static constexpr size_t INVALID_OFFSET = SIZE_MAX;
+
+    explicit RangeAllocator(size_t capacity = 0);
+
+    /**
+     * @return Offset of count free slots, or INVALID_OFFSET if no free range is large enough
+     */
+    size_t Allocate(size_t count);
+    void Free(size_t offset, size_t count);
+
+    /**
+     * @brief Restart with [0, used) allocated and the rest of capacity free
+     */
+    void Reset(size_t capacity, size_t used);
+
+    size_t GetCapacity() const { return m_capacity; }
+    size_t GetUsed() const { return m_used; }
+    size_t GetFreeRangeCount() const { return m_free.size(); }
+
+private:
+    std::map<size_t, size_t> m_free;    // Offset -> length
+    size_t m_capacity;
+    size_t m_used;
+};
+
+/**
+ * @brief Sub-allocated vertex/index buffers for one vertex format
+ */
+class GeometryPool {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = 0;
+
+    /**
+     * @brief Where an allocation currently lives; changes when the pool compacts
+     */
+    struct Range {
+        GLint baseVertex;
+        GLuint vertexCount;
+        GLuint firstIndex;
+        GLuint indexCount;
+    };
+
+    struct Stats {
+        size_t capacityBytes;   // Vertex and index buffer sizes
+        size_t usedBytes;
+        size_t allocations;
+        size_t freeRanges;      // Holes in either buffer
+        size_t compactions;
+        size_t growths;
+    };
+
+    /**
+     * @param name Label for log output
+     * @param format Vertex layout; every allocation uses it
+     * @param initialVertices Vertex buffer capacity created on first use
+     * @param initialIndices Index buffer capacity created on first use
+     */
+    GeometryPool(std::string name, VertexFormat format, size_t initialVertices, size_t initialIndices);
+    ~GeometryPool();
+
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    /**
+     * @brief Copy vertices and indices into the pool
+     *
+     * Either part may be empty, e.g. index data shared by many vertex
+     * ranges. Indices are relative to the allocation's first vertex.
+     */
+    Handle Allocate(const void* vertexData, size_t vertexCount, const unsigned int* indexData, size_t indexCount);
+
+    /**
+     * @brief Return an allocation's ranges to the free lists; unknown handles are ignored
+     */
+    void Free(Handle handle);
+
+    const Range& GetRange(Handle handle) const { return m_blocks[handle - 1].range; }
+
+    /**
+     * @brief Command drawing count indices from indexOffset within the allocation
+     */
+    DrawElementsIndirectCommand MakeCommand(Handle handle, GLuint indexOffset, GLuint indexCount) const;
+
+    void Bind() const;
+    void Draw(const DrawElementsIndirectCommand& command) const;
+
+    /**
+     * @brief Submit a batch of draws against this pool's buffers
+     *
+     * The commands are streamed through the StreamBuffer ring.
+     */
+    void MultiDraw(std::span<const DrawElementsIndirectCommand> commands);
+
+    /**
+     * @brief Submit commands already in a GPU buffer, e.g. written by a compute pass
+     *
+     * Needs SupportsMultiDrawIndirect(). With SupportsIndirectCount() the
+     * draw count is read from countBuffer; otherwise all maxDrawCount
+     * commands are issued and unused ones must have a zero count.
+     */
+    void MultiDrawIndirect(GLuint commandBuffer, GLsizei maxDrawCount, GLuint countBuffer = 0) const;
+
+    /**
+     * @brief Bumped whenever compaction moves allocations; cached commands are stale after a change
+     */
+    size_t GetGeneration() const { return m_compactions + m_growths; }
+
+    /**
+     * @brief Delete the GL buffers and forget all allocations
+     */
+    void Release();
+
+    Stats GetStats() const;
+
+    static bool SupportsMultiDrawIndirect();
+    static bool SupportsIndirectCount();
+
+    /**
+     * @brief Release every live pool; call before the GL context is destroyed
+     */
+    static void ReleaseAll();
+    static Stats GetTotalStats();
+
+private:
+    struct Block {
+        Range range;
+        bool live;
+    };
+
+    struct Buffer {
+        GLuint id = 0;
+        RangeAllocator allocator;
+        size_t elementSize = 0;
+    };
+
+    void CreateBuffers();
+    void BindAttributes();
+
+    /**
+     * @brief Pack live ranges into a new buffer of at least the needed capacity
+     */
+    void Repack(Buffer& buffer, size_t required, bool vertices);
+
+    std::string m_name;
+    VertexFormat m_format;
+    size_t m_initialVertices;
+    size_t m_initialIndices;
+
+    GLuint m_vao;
+    Buffer m_vertices;
+    Buffer m_indices;
+
+    std::vector<Block> m_blocks;        // Handle - 1 -> block
+    std::vector<Handle> m_freeHandles;
+    size_t m_liveBlocks;
+    size_t m_compactions;
+    size_t m_growths;
+
+    static std::vector<GeometryPool*> s_pools;
+};
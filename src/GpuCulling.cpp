@@ -0,0 +1,309 @@
+﻿#include "GpuCulling.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+std::vector<GpuCulling::Batch*> GpuCulling::Batch::s_batches;
+
+GpuCulling::Batch::Batch()
+    : m_commandBuffer(0)
+    , m_countBuffer(0)
+    , m_visibilityBuffer(0)
+    , m_readbackBuffer(0)
+    , m_itemCount(0)
+    , m_capacity(0)
+    , m_readbackFence(nullptr)
+    , m_readbackCount(0)
+    , m_hiddenCount(0)
+{
+    s_batches.push_back(this);
+}
+
+GpuCulling::Batch::~Batch() {
+    Release();
+    s_batches.erase(std::remove(s_batches.begin(), s_batches.end(), this), s_batches.end());
+}
+
+void GpuCulling::Batch::SetItems(std::span<const CullItem> items) {
+    Reserve(items.size());
+    m_itemCount = items.size();
+    m_items.assign(items.begin(), items.end());
+    m_itemStream = {};
+
+    // New items start visible until their first result comes back
+    m_visibility.resize(m_itemCount, 1);
+}
+
+bool GpuCulling::Batch::ResolveVisibility() {
+    if (m_readbackFence == nullptr) {
+        return false;
+    }
+    GLenum status = glClientWaitSync(m_readbackFence, 0, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+        return false;
+    }
+    glDeleteSync(m_readbackFence);
+    m_readbackFence = nullptr;
+
+    size_t count = std::min(m_readbackCount, m_visibility.size());
+    glBindBuffer(GL_COPY_READ_BUFFER, m_readbackBuffer);
+    glGetBufferSubData(GL_COPY_READ_BUFFER, 0, count * sizeof(GLuint), m_visibility.data());
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    m_hiddenCount = static_cast<size_t>(std::count(m_visibility.begin(), m_visibility.begin() + count, 0u));
+    return true;
+}
+
+void GpuCulling::Batch::Release() {
+    if (m_readbackFence != nullptr) {
+        glDeleteSync(m_readbackFence);
+        m_readbackFence = nullptr;
+    }
+    for (GLuint* buffer : { &m_commandBuffer, &m_countBuffer, &m_visibilityBuffer, &m_readbackBuffer }) {
+        if (*buffer != 0) {
+            glDeleteBuffers(1, buffer);
+            *buffer = 0;
+        }
+    }
+    m_items.clear();
+    m_itemStream = {};
+    m_itemCount = 0;
+    m_capacity = 0;
+    m_visibility.clear();
+    m_hiddenCount = 0;
+}
+
+void GpuCulling::Batch::ReleaseAll() {
+    for (Batch* batch : s_batches) {
+        batch->Release();
+    }
+}
+
+void GpuCulling::Batch::Reserve(size_t count) {
+    if (count <= m_capacity && m_commandBuffer != 0) {
+        return;
+    }
+
+    size_t capacity = std::max(m_capacity, MIN_BATCH_CAPACITY);
+    while (capacity < count) {
+        capacity *= 2;
+    }
+
+    // Contents are rewritten by the next SetItems/Cull, so the old buffers are simply dropped
+    if (m_readbackFence != nullptr) {
+        glDeleteSync(m_readbackFence);
+        m_readbackFence = nullptr;
+    }
+    for (GLuint* buffer : { &m_commandBuffer, &m_countBuffer, &m_visibilityBuffer, &m_readbackBuffer }) {
+        if (*buffer == 0) {
+            glGenBuffers(1, buffer);
+        }
+    }
+
+    auto allocate = [](GLuint buffer, size_t bytes, GLenum usage) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, usage);
+    };
+    allocate(m_commandBuffer, capacity * sizeof(DrawElementsIndirectCommand), GL_DYNAMIC_COPY);
+    allocate(m_countBuffer, sizeof(GLuint), GL_DYNAMIC_COPY);
+    allocate(m_visibilityBuffer, capacity * sizeof(GLuint), GL_DYNAMIC_COPY);
+    allocate(m_readbackBuffer, capacity * sizeof(GLuint), GL_STREAM_READ);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    m_capacity = capacity;
+}
+
+GpuCulling::GpuCulling()
+    : m_pyramid(0)
+    , m_pyramidWidth(0)
+    , m_pyramidHeight(0)
+    , m_pyramidLevels(0)
+    , m_pyramidViewProjection(1.0f)
+    , m_pyramidValid(false)
+    , m_enabled(true)
+    , m_storageAlignment(16)
+{
+}
+
+GpuCulling::~GpuCulling() {
+    Shutdown();
+}
+
+bool GpuCulling::Initialize() {
+    if (!IsSupported()) {
+        std::cout << "[GpuCulling] Compute shaders need GL 4.3; drawing without culling" << std::endl;
+        return false;
+    }
+
+    m_cullShader = std::make_unique<Shader>(std::string("resources/shaders/cull_instances.comp"));
+    m_pyramidShader = std::make_unique<Shader>(std::string("resources/shaders/hiz_pyramid.comp"));
+    if (!m_cullShader->IsLinked() || !m_pyramidShader->IsLinked()) {
+        std::cerr << "[GpuCulling] Failed to build the culling programs; drawing without culling" << std::endl;
+        m_cullShader.reset();
+        m_pyramidShader.reset();
+        return false;
+    }
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    m_storageAlignment = std::max<size_t>(static_cast<size_t>(alignment), 16);
+
+    std::cout << "[GpuCulling] Compute culling ready (indirect count: "
+              << (GeometryPool::SupportsIndirectCount() ? "yes" : "no") << ")" << std::endl;
+    return true;
+}
+
+void GpuCulling::Shutdown() {
+    m_cullShader.reset();
+    m_pyramidShader.reset();
+    if (m_pyramid != 0) {
+        glDeleteTextures(1, &m_pyramid);
+        m_pyramid = 0;
+    }
+    m_pyramidWidth = 0;
+    m_pyramidHeight = 0;
+    m_pyramidLevels = 0;
+    m_pyramidValid = false;
+}
+
+bool GpuCulling::IsSupported() {
+    return GLAD_GL_VERSION_4_3 != 0;
+}
+
+void GpuCulling::Cull(Batch& batch, const glm::mat4& viewProjection, bool readVisibility) {
+    if (!IsEnabled() || batch.m_itemCount == 0) {
+        return;
+    }
+
+    // Frustum planes from the rows of the view-projection matrix
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++) {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+    }
+    const glm::vec4 planes[6] = {
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[3] + rows[2], rows[3] - rows[2]
+    };
+
+    m_cullShader->Use();
+    for (int i = 0; i < 6; i++) {
+        m_cullShader->SetVec4("frustumPlanes[" + std::to_string(i) + "]", planes[i]);
+    }
+    m_cullShader->SetInt("itemCount", static_cast<int>(batch.m_itemCount));
+    m_cullShader->SetBool("useOcclusion", m_pyramidValid);
+    if (m_pyramidValid) {
+        glActiveTexture(GL_TEXTURE0 + PYRAMID_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, m_pyramid);
+        glActiveTexture(GL_TEXTURE0);
+        m_cullShader->SetInt("depthPyramid", PYRAMID_TEXTURE_UNIT);
+        m_cullShader->SetMat4("pyramidViewProjection", m_pyramidViewProjection);
+        m_cullShader->SetVec2("pyramidSize", glm::vec2(m_pyramidWidth, m_pyramidHeight));
+        m_cullShader->SetInt("pyramidLevels", m_pyramidLevels);
+    }
+
+    // Without an indirect count the draw reads every slot, so stale ones must be zero
+    const GLuint zero = 0;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, batch.m_countBuffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(GLuint), &zero);
+    if (!GeometryPool::SupportsIndirectCount()) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, batch.m_commandBuffer);
+        glClearBufferData(GL_COPY_WRITE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    StreamBuffer& stream = StreamBuffer::Get();
+    if (!stream.IsResident(batch.m_itemStream)) {
+        batch.m_itemStream = stream.Write(batch.m_items.data(), batch.m_items.size() * sizeof(CullItem), m_storageAlignment);
+        if (batch.m_itemStream.buffer == 0) {
+            return;
+        }
+    }
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, batch.m_itemStream.buffer,
+                      batch.m_itemStream.offset, batch.m_itemStream.bytes);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch.m_commandBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, batch.m_countBuffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, batch.m_visibilityBuffer);
+
+    GLuint groups = static_cast<GLuint>((batch.m_itemCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE);
+    glDispatchCompute(groups, 1, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    if (readVisibility) {
+        // An unread older copy is dropped; the newer result supersedes it
+        if (batch.m_readbackFence != nullptr) {
+            glDeleteSync(batch.m_readbackFence);
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, batch.m_visibilityBuffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, batch.m_readbackBuffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, batch.m_itemCount * sizeof(GLuint));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        batch.m_readbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        batch.m_readbackCount = batch.m_itemCount;
+    }
+}
+
+void GpuCulling::BuildDepthPyramid(GLuint depthTexture, int width, int height, const glm::mat4& viewProjection,
+                                   float nearPlane, float farPlane) {
+    if (!IsEnabled() || depthTexture == 0 || width <= 0 || height <= 0) {
+        m_pyramidValid = false;
+        return;
+    }
+    if (width != m_pyramidWidth || height != m_pyramidHeight) {
+        ResizePyramid(width, height);
+    }
+
+    m_pyramidShader->Use();
+    m_pyramidShader->SetFloat("nearPlane", nearPlane);
+    m_pyramidShader->SetFloat("farPlane", farPlane);
+
+    // Level 0: linear depth straight from the depth buffer
+    glActiveTexture(GL_TEXTURE0 + PYRAMID_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+    glActiveTexture(GL_TEXTURE0);
+    m_pyramidShader->SetInt("sceneDepth", PYRAMID_TEXTURE_UNIT);
+    m_pyramidShader->SetBool("fromDepth", true);
+    glBindImageTexture(0, m_pyramid, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+    glDispatchCompute((width + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE,
+                      (height + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, 1);
+
+    // Each further level keeps the farthest depth of the texels below it
+    m_pyramidShader->SetBool("fromDepth", false);
+    for (int level = 1; level < m_pyramidLevels; level++) {
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+        int levelWidth = std::max(1, width >> level);
+        int levelHeight = std::max(1, height >> level);
+        glBindImageTexture(1, m_pyramid, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+        glBindImageTexture(0, m_pyramid, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+        glDispatchCompute((levelWidth + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE,
+                          (levelHeight + PYRAMID_GROUP_SIZE - 1) / PYRAMID_GROUP_SIZE, 1);
+    }
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+    m_pyramidViewProjection = viewProjection;
+    m_pyramidValid = true;
+}
+
+size_t GpuCulling::GetPyramidBytes() const {
+    // A full mip chain adds about a third to level 0
+    return static_cast<size_t>(m_pyramidWidth) * m_pyramidHeight * sizeof(float) * 4 / 3;
+}
+
+void GpuCulling::ResizePyramid(int width, int height) {
+    if (m_pyramid != 0) {
+        glDeleteTextures(1, &m_pyramid);
+    }
+
+    m_pyramidWidth = width;
+    m_pyramidHeight = height;
+    m_pyramidLevels = static_cast<int>(std::floor(std::log2(static_cast<float>(std::max(width, height))))) + 1;
+
+    glGenTextures(1, &m_pyramid);
+    glBindTexture(GL_TEXTURE_2D, m_pyramid);
+    glTexStorage2D(GL_TEXTURE_2D, m_pyramidLevels, GL_R32F, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_pyramidValid = false;
+}
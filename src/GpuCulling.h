@@ -0,0 +1,187 @@
+﻿/**
+ * @file GpuCulling.h
+ * @brief Compute-shader frustum and occlusion culling for indirect draws
+ *
+ * Objects are described as CullItems (object-space bounds, transform
+ * and the draw command that renders them). They are kept on the CPU and
+ * streamed through the StreamBuffer ring by every Cull(), because ring
+ * data only lasts one frame. Each frame a compute pass
+ * tests every item against the camera frustum and against a hierarchical
+ * depth (Hi-Z) pyramid built from the previous frame's depth buffer, then:
+ * - Appends the commands of visible items to a compacted indirect buffer
+ *   with an atomic counter, ready for GeometryPool::MultiDrawIndirect()
+ * - Writes one visibility flag per item, which can be copied back for
+ *   draws that still need per-object CPU state; the copy is fenced and
+ *   picked up a frame later, so reading it never stalls
+ *
+ * The pyramid stores linear view depth, keeping the farthest value of
+ * each texel block. An item counts as occluded when its nearest corner is
+ * behind the farthest depth over its screen rectangle, fetched from the
+ * mip where that rectangle spans at most 2x2 texels. Levels keep odd
+ * sizes, so the rectangle is mapped through level-0 texels and the fetch
+ * footprint is widened by a texel on each side. Items that were partly off
+ * screen or crossed the near plane last frame are never occlusion-culled.
+ *
+ * Needs GL 4.3 for compute shaders and storage buffers; Initialize()
+ * fails on the 4.1 baseline and callers keep drawing everything. Batch
+ * buffers are created on first use, so batches can be members of objects
+ * built before the GL context; Batch::ReleaseAll() frees them at shutdown.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+#include "GeometryPool.h"
+#include "Shader.h"
+#include "StreamBuffer.h"
+
+/**
+ * @brief One cullable object, laid out for the std430 item buffer
+ */
+struct CullItem {
+    glm::vec4 boundsMin;                    // Object-space box; w unused
+    glm::vec4 boundsMax;
+    glm::mat4 transform;                    // Object to world
+    DrawElementsIndirectCommand command;    // Emitted when visible
+    GLuint padding[3];
+};
+static_assert(sizeof(CullItem) == 128, "CullItem must match the std430 layout in cull_instances.comp");
+
+/**
+ * @brief Compute culling passes and the Hi-Z pyramid they test against
+ */
+class GpuCulling {
+public:
+    /**
+     * @brief Items plus the GPU buffers their culling results land in
+     */
+    class Batch {
+    public:
+        Batch();
+        ~Batch();
+
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+
+        /**
+         * @brief Replace the item list
+         *
+         * Items are streamed by every Cull() anyway, so this is only a CPU
+         * copy: static sets call it when they change, moving objects every
+         * frame.
+         */
+        void SetItems(std::span<const CullItem> items);
+
+        /**
+         * @brief Take the visibility flags of the last read-back Cull() once the GPU has written them
+         * @return True if new flags arrived; they follow the item order of that Cull()
+         */
+        bool ResolveVisibility();
+
+        /**
+         * @brief Visibility from the last resolved cull; items not culled yet count as visible
+         */
+        bool IsVisible(size_t index) const { return index >= m_visibility.size() || m_visibility[index] != 0; }
+
+        size_t GetItemCount() const { return m_itemCount; }
+        size_t GetHiddenCount() const { return m_hiddenCount; }
+        GLuint GetCommandBuffer() const { return m_commandBuffer; }
+        GLuint GetCountBuffer() const { return m_countBuffer; }
+
+        void Release();
+
+        /**
+         * @brief Release every live batch; call before the GL context is destroyed
+         */
+        static void ReleaseAll();
+
+    private:
+        friend class GpuCulling;
+
+        void Reserve(size_t count);
+
+        std::vector<CullItem> m_items;
+        StreamAllocation m_itemStream;  // Where m_items currently sit in the ring
+        GLuint m_commandBuffer;     // Compacted commands of visible items
+        GLuint m_countBuffer;       // Number of them
+        GLuint m_visibilityBuffer;  // One uint per item
+        GLuint m_readbackBuffer;
+        size_t m_itemCount;
+        size_t m_capacity;
+
+        GLsync m_readbackFence;
+        size_t m_readbackCount;
+        std::vector<GLuint> m_visibility;
+        size_t m_hiddenCount;
+
+        static std::vector<Batch*> s_batches;
+    };
+
+    GpuCulling();
+    ~GpuCulling();
+
+    /**
+     * @brief Compile the compute programs
+     * @return False without GL 4.3 or if a program fails to build
+     */
+    bool Initialize();
+    void Shutdown();
+
+    static bool IsSupported();
+
+    bool IsEnabled() const { return m_enabled && m_cullShader != nullptr; }
+    void SetEnabled(bool enabled) { m_enabled = enabled; }
+
+    /**
+     * @brief Test a batch and write its compacted commands
+     *
+     * Changes the current program; bind the draw shader afterwards.
+     *
+     * @param viewProjection Camera the items are drawn with (frustum test)
+     * @param readVisibility Copy the per-item flags back for Batch::ResolveVisibility()
+     */
+    void Cull(Batch& batch, const glm::mat4& viewProjection, bool readVisibility);
+
+    /**
+     * @brief Build the Hi-Z pyramid from this frame's depth for next frame's tests
+     *
+     * @param depthTexture Scene depth, sampled with texelFetch
+     * @param viewProjection Camera the depth was rendered with
+     * @param nearPlane Near plane used to linearise the depth
+     * @param farPlane Largest far plane any pass of the scene used (keeps the pyramid conservative)
+     */
+    void BuildDepthPyramid(GLuint depthTexture, int width, int height, const glm::mat4& viewProjection,
+                           float nearPlane, float farPlane);
+
+    /**
+     * @brief Stop occlusion tests until the next BuildDepthPyramid(), e.g. when no depth texture exists
+     */
+    void InvalidateDepthPyramid() { m_pyramidValid = false; }
+
+    bool HasDepthPyramid() const { return m_pyramidValid; }
+    size_t GetPyramidBytes() const;
+
+private:
+    void ResizePyramid(int width, int height);
+
+    std::unique_ptr<Shader> m_cullShader;
+    std::unique_ptr<Shader> m_pyramidShader;
+
+    GLuint m_pyramid;                       // R32F, full mip chain
+    int m_pyramidWidth;
+    int m_pyramidHeight;
+    int m_pyramidLevels;
+    glm::mat4 m_pyramidViewProjection;
+    bool m_pyramidValid;
+    bool m_enabled;
+    size_t m_storageAlignment;              // GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT
+
+    static constexpr GLuint CULL_GROUP_SIZE = 64;       // Matches local_size_x in cull_instances.comp
+    static constexpr GLuint PYRAMID_GROUP_SIZE = 8;     // Matches local_size_x/y in hiz_pyramid.comp
+    static constexpr GLuint PYRAMID_TEXTURE_UNIT = 14;  // Clear of the material and shadow units
+    static constexpr size_t MIN_BATCH_CAPACITY = 64;
+};
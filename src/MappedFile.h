@@ -0,0 +1,45 @@
+﻿/**
+ * @file MappedFile.h
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Lets loaders read large binary files in place: the OS pages data in
+ * as it is touched instead of copying the file through a read buffer.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief RAII wrapper around a read-only file mapping
+ */
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map path into memory, closing any previous mapping
+     * @return False if the file is missing, empty or cannot be mapped
+     */
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+    const unsigned char* GetData() const { return m_data; }
+    size_t GetSize() const { return m_size; }
+
+private:
+    const unsigned char* m_data;
+    size_t m_size;
+#ifdef _WIN32
+    void* m_file;       // HANDLE
+    void* m_mapping;    // HANDLE
+#else
+    int m_descriptor;
+#endif
+};
@@ -1,10 +1,27 @@
 ﻿#include "Mesh.h"
+#include <algorithm>
 #include <sstream>
 
+// Room for a few detailed models before the pool first has to grow
+static constexpr size_t POOL_INITIAL_VERTICES = 128 * 1024;
+static constexpr size_t POOL_INITIAL_INDICES = 512 * 1024;
+
+GeometryPool& Mesh::GetGeometryPool() {
+    static GeometryPool pool("Meshes", {
+        sizeof(Vertex), {
+            { 0, 3, offsetof(Vertex, Position) },
+            { 1, 3, offsetof(Vertex, Normal) },
+            { 2, 2, offsetof(Vertex, TexCoords) },
+            { 3, 3, offsetof(Vertex, Tangent) },
+            { 4, 3, offsetof(Vertex, Bitangent) }
+        }
+    }, POOL_INITIAL_VERTICES, POOL_INITIAL_INDICES);
+    return pool;
+}
 
 Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices) {
-    this->vertices = vertices;
-    this->indices = indices;
+    this->vertices = std::move(vertices);
+    this->indices = std::move(indices);
     this->textures = std::vector<Texture>(); 
 
     
@@ -12,16 +29,75 @@ Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices) {
 }
 
 Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures) {
-    this->vertices = vertices;
-    this->indices = indices;
-    this->textures = textures;
+    this->vertices = std::move(vertices);
+    this->indices = std::move(indices);
+    this->textures = std::move(textures);
 
     
     SetupMesh();
 }
 
-void Mesh::Draw(Shader& shader) {
+Mesh::Mesh(std::span<const Vertex> vertices, std::span<const unsigned int> indices, std::vector<Texture> textures,
+           const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<MeshLod> lods) {
+    this->textures = std::move(textures);
+    this->boundsMin = boundsMin;
+    this->boundsMax = boundsMax;
+    this->lods = std::move(lods);
+
+    UploadBuffers(vertices.data(), vertices.size(), indices.data(), indices.size());
+}
+
+Mesh::~Mesh() {
+    ReleaseBuffers();
+}
+
+Mesh::Mesh(Mesh&& other) noexcept
+    : vertices(std::move(other.vertices))
+    , indices(std::move(other.indices))
+    , textures(std::move(other.textures))
+    , boundsMin(other.boundsMin)
+    , boundsMax(other.boundsMax)
+    , geometry(other.geometry)
+    , vertexCount(other.vertexCount)
+    , indexCount(other.indexCount)
+    , lods(std::move(other.lods)) {
+    other.geometry = GeometryPool::INVALID_HANDLE;
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    if (this != &other) {
+        ReleaseBuffers();
+        vertices = std::move(other.vertices);
+        indices = std::move(other.indices);
+        textures = std::move(other.textures);
+        boundsMin = other.boundsMin;
+        boundsMax = other.boundsMax;
+        geometry = other.geometry;
+        vertexCount = other.vertexCount;
+        indexCount = other.indexCount;
+        lods = std::move(other.lods);
+        other.geometry = GeometryPool::INVALID_HANDLE;
+    }
+    return *this;
+}
+
+size_t Mesh::GetGpuBytes() const {
+    return vertexCount * sizeof(Vertex) + indexCount * sizeof(unsigned int);
+}
+
+void Mesh::Draw(Shader& shader, int lod) const {
+    BindTextures(shader);
+
+    GeometryPool& pool = GetGeometryPool();
+    pool.Bind();
+    pool.Draw(GetDrawCommand(lod));
+    glBindVertexArray(0);
+
     
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void Mesh::BindTextures(Shader& shader) const {
     unsigned int diffuseNr = 1;
     unsigned int specularNr = 1;
     unsigned int normalNr = 1;
@@ -47,55 +123,59 @@ void Mesh::Draw(Shader& shader) {
         
         glBindTexture(GL_TEXTURE_2D, textures[i].ID);
     }
+}
 
-    
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+DrawElementsIndirectCommand Mesh::GetDrawCommand(int lod) const {
+    const MeshLod& level = lods[std::clamp(lod, 0, static_cast<int>(lods.size()) - 1)];
+    return GetGeometryPool().MakeCommand(geometry, level.indexOffset, level.indexCount);
+}
 
-    
-    glActiveTexture(GL_TEXTURE0);
+bool Mesh::HasSameTextures(const Mesh& other) const {
+    if (textures.size() != other.textures.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < textures.size(); i++) {
+        if (textures[i].ID != other.textures[i].ID || textures[i].type != other.textures[i].type) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void Mesh::SetupMesh() {
     
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-    
-    
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+    boundsMin = glm::vec3(0.0f);
+    boundsMax = glm::vec3(0.0f);
+    if (!vertices.empty()) {
+        boundsMin = vertices[0].Position;
+        boundsMax = vertices[0].Position;
+        for (const Vertex& vertex : vertices) {
+            boundsMin = glm::min(boundsMin, vertex.Position);
+            boundsMax = glm::max(boundsMax, vertex.Position);
+        }
+    }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+    UploadBuffers(vertices.data(), vertices.size(), indices.data(), indices.size());
+}
 
-    
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    
-    
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Normal));
-    
-    
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, TexCoords));
-    
-    
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Tangent));
-    
-    
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, Bitangent));
+void Mesh::UploadBuffers(const Vertex* vertexData, size_t vertexCount, const unsigned int* indexData, size_t indexCount) {
+    this->vertexCount = vertexCount;
+    this->indexCount = indexCount;
+    if (lods.empty()) {
+        lods.push_back({ 0, static_cast<unsigned int>(indexCount), 0.0f });
+    }
 
-    glBindVertexArray(0);
+    geometry = GetGeometryPool().Allocate(vertexData, vertexCount, indexData, indexCount);
 }
 
 
-void Mesh::draw(Shader& shader) {
+void Mesh::draw(Shader& shader) const {
     Draw(shader); 
 }
+
+void Mesh::ReleaseBuffers() {
+    if (geometry != GeometryPool::INVALID_HANDLE) {
+        GetGeometryPool().Free(geometry);
+        geometry = GeometryPool::INVALID_HANDLE;
+    }
+}
@@ -8,9 +8,11 @@
  * 
  * Features:
  * - Vertex attribute management (position, normal, texture coords, tangents)
- * - OpenGL buffer setup and management
+ * - Geometry sub-allocated from one GeometryPool shared by all meshes,
+ *   so drawing meshes back to back needs no VAO switch
  * - Texture binding and shader integration
  * - Efficient rendering with indexed geometry
+ * - Sole ownership of its pool allocation; meshes move but never copy
  */
 
 #pragma once
@@ -19,9 +21,11 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "GeometryPool.h"
 #include "Shader.h"
 #include "Texture.h"
 
+#include <span>
 #include <string>
 #include <vector>
 
@@ -39,6 +43,17 @@ struct Vertex {
     glm::vec3 Bitangent;  // Bitangent vector for normal mapping
 };
 
+/**
+ * @brief One detail level: a range of the mesh's index buffer
+ * 
+ * All levels index the same vertex buffer; level 0 is the full mesh.
+ */
+struct MeshLod {
+    unsigned int indexOffset;   // First index of the level
+    unsigned int indexCount;
+    float error;                // Object-space simplification error (0 for level 0)
+};
+
 /**
  * @brief Mesh class for rendering 3D geometry
  * 
@@ -56,10 +71,11 @@ struct Vertex {
 class Mesh {
 public:
     // Mesh data
-    std::vector<Vertex> vertices;        // All vertices in the mesh
-    std::vector<unsigned int> indices;   // Triangle indices for rendering
+    std::vector<Vertex> vertices;        // All vertices in the mesh (empty when uploaded from a cooked file)
+    std::vector<unsigned int> indices;   // Triangle indices for rendering (empty when uploaded from a cooked file)
     std::vector<Texture> textures;       // Textures associated with this mesh
-    unsigned int VAO;                    // Vertex Array Object ID
+    glm::vec3 boundsMin;                 // Object-space bounding box
+    glm::vec3 boundsMax;
 
     /**
      * @brief Constructor for indexed mesh
@@ -83,6 +99,34 @@ public:
      */
     Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures); 
 
+    /**
+     * @brief Constructor uploading straight from external memory
+     * 
+     * Used for cooked meshes: the data goes from the mapped file to the
+     * GPU without a CPU-side copy, so the vertices and indices members
+     * stay empty.
+     * 
+     * @param vertices Vertex data in GPU layout
+     * @param indices Triangle indices
+     * @param textures Textures for this mesh
+     * @param boundsMin Precomputed bounding box minimum
+     * @param boundsMax Precomputed bounding box maximum
+     * @param lods Detail levels inside indices; empty means one level covering all of them
+     */
+    Mesh(std::span<const Vertex> vertices, std::span<const unsigned int> indices, std::vector<Texture> textures,
+         const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::vector<MeshLod> lods = {});
+
+    /**
+     * @brief Destructor - returns the geometry to the pool
+     */
+    ~Mesh();
+
+    // A copy would free the same pool allocation twice; moving hands it over
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&& other) noexcept;
+    Mesh& operator=(Mesh&& other) noexcept;
+
     /**
      * @brief Render the mesh using the specified shader
      * 
@@ -90,20 +134,58 @@ public:
      * the mesh using indexed drawing. Both naming conventions supported.
      * 
      * @param shader Shader program to use for rendering
+     * @param lod Detail level; clamped to the coarsest available
      */
-    void draw(Shader& shader);  // Legacy naming
-    void Draw(Shader& shader);  // Modern naming
+    void draw(Shader& shader) const;  // Legacy naming
+    void Draw(Shader& shader, int lod = 0) const;  // Modern naming
 
-private:
-    // OpenGL buffer object IDs
-    unsigned int VBO, EBO;  // Vertex Buffer Object, Element Buffer Object
+    /**
+     * @brief Bind the textures and set their sampler uniforms
+     */
+    void BindTextures(Shader& shader) const;
 
     /**
-     * @brief Initialize OpenGL buffers and vertex attributes
+     * @brief Draw command for one detail level in the shared mesh pool
      * 
-     * Sets up VAO, VBO, and EBO with the mesh data and configures
-     * vertex attribute pointers for position, normal, texture coordinates,
-     * tangent, and bitangent vectors.
+     * Lets callers batch meshes with the same textures into one MultiDraw.
+     */
+    DrawElementsIndirectCommand GetDrawCommand(int lod = 0) const;
+
+    bool HasSameTextures(const Mesh& other) const;
+
+    /**
+     * @brief Pool holding the geometry of every Mesh
+     */
+    static GeometryPool& GetGeometryPool();
+
+    /**
+     * @brief Bytes held in this mesh's vertex and index ranges
+     */
+    size_t GetGpuBytes() const;
+
+    size_t GetVertexCount() const { return vertexCount; }
+    size_t GetIndexCount() const { return indexCount; }
+    int GetLodCount() const { return static_cast<int>(lods.size()); }
+    const MeshLod& GetLod(int lod) const { return lods[lod]; }
+
+private:
+    GeometryPool::Handle geometry;  // Vertex and index ranges in the shared pool
+    size_t vertexCount;     // Counts of the uploaded buffers
+    size_t indexCount;      // Every level's indices
+    std::vector<MeshLod> lods;
+
+    /**
+     * @brief Compute the bounds and upload the vertex and index members
      */
     void SetupMesh();
+
+    /**
+     * @brief Copy the given data into the shared mesh pool
+     */
+    void UploadBuffers(const Vertex* vertexData, size_t vertexCount, const unsigned int* indexData, size_t indexCount);
+
+    /**
+     * @brief Return the pool allocation and reset the handle
+     */
+    void ReleaseBuffers();
 };
@@ -0,0 +1,265 @@
+﻿/**
+ * @file MeshOptimizer.cpp
+ * @brief Tipsify vertex cache ordering, overdraw clustering and fetch remapping
+ */
+
+#include "MeshOptimizer.h"
+#include <algorithm>
+
+// FIFO cache model shared by every pass: a vertex is resident while fewer
+// than cacheSize other vertices were transformed after it
+static unsigned int CacheMisses(const unsigned int* triangle, std::vector<unsigned int>& cacheTime,
+                                unsigned int& timestamp, unsigned int cacheSize) {
+    unsigned int misses = 0;
+    for (int k = 0; k < 3; k++) {
+        unsigned int vertex = triangle[k];
+        if (timestamp - cacheTime[vertex] > cacheSize) {
+            cacheTime[vertex] = timestamp++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+void MeshOptimizer::CacheStats::Merge(const CacheStats& other) {
+    triangles += other.triangles;
+    vertices += other.vertices;
+    transformed += other.transformed;
+}
+
+void MeshOptimizer::Report::Merge(const Report& other) {
+    before.Merge(other.before);
+    after.Merge(other.after);
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::AnalyzeVertexCache(std::span<const unsigned int> indices, size_t vertexCount,
+                                                            unsigned int cacheSize) {
+    CacheStats stats{ indices.size() / 3, 0, 0 };
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    unsigned int timestamp = cacheSize + 1;
+
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        stats.transformed += CacheMisses(&indices[i], cacheTime, timestamp, cacheSize);
+        for (int k = 0; k < 3; k++) {
+            if (!referenced[indices[i + k]]) {
+                referenced[indices[i + k]] = true;
+                stats.vertices++;
+            }
+        }
+    }
+    return stats;
+}
+
+void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0) {
+        return;
+    }
+
+    // Vertex -> triangle adjacency, packed per vertex
+    std::vector<unsigned int> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        liveTriangles[indices[i]]++;
+    }
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++) {
+        offsets[v + 1] = offsets[v] + liveTriangles[v];
+    }
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int k = 0; k < 3; k++) {
+            adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+        }
+    }
+
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned int> deadEnds;
+    std::vector<unsigned int> candidates;
+    std::vector<unsigned int> result;
+    deadEnds.reserve(triangleCount * 3);
+    result.reserve(triangleCount * 3);
+
+    unsigned int timestamp = cacheSize + 1;
+    unsigned int cursor = 0;    // Input-order fallback once the dead-end stack runs dry
+    unsigned int fanning = 0;
+
+    while (fanning != INVALID_INDEX) {
+        // Emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (unsigned int a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+            unsigned int triangle = adjacency[a];
+            if (emitted[triangle]) {
+                continue;
+            }
+            for (int k = 0; k < 3; k++) {
+                unsigned int vertex = indices[triangle * 3 + k];
+                result.push_back(vertex);
+                deadEnds.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (timestamp - cacheTime[vertex] > cacheSize) {
+                    cacheTime[vertex] = timestamp++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // Next fan: the oldest candidate that stays resident while its own
+        // remaining triangles are emitted
+        unsigned int next = INVALID_INDEX;
+        int bestPriority = -1;
+        for (unsigned int vertex : candidates) {
+            if (liveTriangles[vertex] == 0) {
+                continue;
+            }
+            int priority = 0;
+            unsigned int age = timestamp - cacheTime[vertex];
+            if (age + 2 * liveTriangles[vertex] <= cacheSize) {
+                priority = static_cast<int>(age);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        // Dead end: most recently used vertex with work left, else the next one in input order
+        while (next == INVALID_INDEX && !deadEnds.empty()) {
+            unsigned int vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[vertex] > 0) {
+                next = vertex;
+            }
+        }
+        while (next == INVALID_INDEX && cursor < vertexCount) {
+            if (liveTriangles[cursor] > 0) {
+                next = cursor;
+            }
+            cursor++;
+        }
+
+        fanning = next;
+    }
+
+    indices.swap(result);
+}
+
+void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, std::span<const glm::vec3> positions,
+                                     float threshold, unsigned int cacheSize) {
+    size_t triangleCount = indices.size() / 3;
+    if (triangleCount < 2 || positions.empty()) {
+        return;
+    }
+
+    std::vector<unsigned int> cacheTime(positions.size(), 0);
+    unsigned int timestamp = cacheSize + 1;
+
+    // Hard boundaries: a triangle with three misses starts from a cold cache
+    // anyway, so the order can be broken there for free
+    std::vector<size_t> hardBoundaries;
+    for (size_t t = 0; t < triangleCount; t++) {
+        if (CacheMisses(&indices[t * 3], cacheTime, timestamp, cacheSize) == 3 || t == 0) {
+            hardBoundaries.push_back(t);
+        }
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // Soft boundaries: inside a run, close a cluster once its ACMR is within
+    // threshold of the whole run's, paying the cold-cache cost once per cluster
+    std::vector<size_t> clusterStarts;
+    for (size_t h = 0; h + 1 < hardBoundaries.size(); h++) {
+        size_t start = hardBoundaries[h];
+        size_t end = hardBoundaries[h + 1];
+
+        timestamp += cacheSize + 1;
+        size_t runMisses = 0;
+        for (size_t t = start; t < end; t++) {
+            runMisses += CacheMisses(&indices[t * 3], cacheTime, timestamp, cacheSize);
+        }
+        float clusterLimit = threshold * static_cast<float>(runMisses) / static_cast<float>(end - start);
+
+        timestamp += cacheSize + 1;
+        clusterStarts.push_back(start);
+        size_t clusterStart = start;
+        size_t clusterMisses = 0;
+        for (size_t t = start; t + 1 < end; t++) {
+            clusterMisses += CacheMisses(&indices[t * 3], cacheTime, timestamp, cacheSize);
+            if (clusterMisses <= clusterLimit * static_cast<float>(t + 1 - clusterStart)) {
+                clusterStarts.push_back(t + 1);
+                clusterStart = t + 1;
+                clusterMisses = 0;
+                timestamp += cacheSize + 1;
+            }
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+
+    // Area-weighted centroid and normal of the mesh and of each cluster
+    struct Cluster {
+        size_t start;
+        size_t end;
+        float sortKey;
+    };
+    auto accumulate = [&](size_t start, size_t end, glm::vec3& centroid, glm::vec3& normal) {
+        float area = 0.0f;
+        centroid = glm::vec3(0.0f);
+        normal = glm::vec3(0.0f);
+        glm::vec3 plainCentroid(0.0f);
+        for (size_t t = start; t < end; t++) {
+            const glm::vec3& p0 = positions[indices[t * 3]];
+            const glm::vec3& p1 = positions[indices[t * 3 + 1]];
+            const glm::vec3& p2 = positions[indices[t * 3 + 2]];
+            glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+            float faceArea = glm::length(faceNormal);
+            glm::vec3 faceCentroid = (p0 + p1 + p2) / 3.0f;
+            centroid += faceCentroid * faceArea;
+            plainCentroid += faceCentroid;
+            normal += faceNormal;
+            area += faceArea;
+        }
+        centroid = area > 0.0f ? centroid / area : plainCentroid / static_cast<float>(end - start);
+    };
+
+    glm::vec3 meshCentroid, meshNormal;
+    accumulate(0, triangleCount, meshCentroid, meshNormal);
+
+    std::vector<Cluster> clusters;
+    clusters.reserve(clusterStarts.size() - 1);
+    for (size_t c = 0; c + 1 < clusterStarts.size(); c++) {
+        Cluster cluster{ clusterStarts[c], clusterStarts[c + 1], 0.0f };
+        glm::vec3 centroid, normal;
+        accumulate(cluster.start, cluster.end, centroid, normal);
+        float normalLength = glm::length(normal);
+        if (normalLength > 0.0f) {
+            cluster.sortKey = glm::dot(centroid - meshCentroid, normal / normalLength);
+        }
+        clusters.push_back(cluster);
+    }
+
+    // Outward-facing clusters first: they tend to hide the ones behind them
+    std::stable_sort(clusters.begin(), clusters.end(),
+                     [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (const Cluster& cluster : clusters) {
+        result.insert(result.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3);
+    }
+    indices.swap(result);
+}
+
+size_t MeshOptimizer::OptimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount,
+                                          std::vector<unsigned int>& remap) {
+    remap.assign(vertexCount, INVALID_INDEX);
+    unsigned int nextVertex = 0;
+    for (unsigned int& index : indices) {
+        if (remap[index] == INVALID_INDEX) {
+            remap[index] = nextVertex++;
+        }
+        index = remap[index];
+    }
+    return nextVertex;
+}
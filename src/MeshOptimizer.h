@@ -0,0 +1,135 @@
+﻿/**
+ * @file MeshOptimizer.h
+ * @brief Index and vertex reordering for GPU-friendly meshes
+ *
+ * Runs once at import/cook time, never per frame:
+ * - Vertex cache: Tipsify (Sander et al. 2007) reorders triangles so
+ *   recently transformed vertices are reused before they leave the
+ *   post-transform cache
+ * - Overdraw: the cache-ordered triangles are cut into clusters that
+ *   cost little extra cache misses, and clusters facing away from the
+ *   mesh centre are drawn first so they occlude the rest
+ * - Vertex fetch: vertices are renumbered in first-use order so the
+ *   vertex buffer is read front to back
+ *
+ * Cache efficiency is reported as ACMR (vertices transformed per
+ * triangle, 0.5 is the limit for large regular meshes, 3 is the worst)
+ * and ATVR (vertices transformed per unique vertex, 1 is optimal),
+ * measured against a FIFO cache model.
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+class MeshOptimizer {
+public:
+    // FIFO entries assumed by the cache model; safe for every GL 4.x GPU
+    static constexpr unsigned int CACHE_SIZE = 16;
+    // Clusters may cost this factor more cache misses to reduce overdraw
+    static constexpr float OVERDRAW_THRESHOLD = 1.05f;
+
+    /**
+     * @brief Simulated post-transform cache behaviour of an index buffer
+     */
+    struct CacheStats {
+        size_t triangles;
+        size_t vertices;        // Unique vertices referenced
+        size_t transformed;     // Cache misses, i.e. vertex shader invocations
+
+        float GetACMR() const { return triangles > 0 ? static_cast<float>(transformed) / triangles : 0.0f; }
+        float GetATVR() const { return vertices > 0 ? static_cast<float>(transformed) / vertices : 0.0f; }
+        void Merge(const CacheStats& other);
+    };
+
+    /**
+     * @brief Cache statistics before and after Optimize()
+     */
+    struct Report {
+        CacheStats before;
+        CacheStats after;
+
+        void Merge(const Report& other);
+    };
+
+    /**
+     * @brief Run the FIFO cache model over a triangle list
+     */
+    static CacheStats AnalyzeVertexCache(std::span<const unsigned int> indices, size_t vertexCount,
+                                         unsigned int cacheSize = CACHE_SIZE);
+
+    /**
+     * @brief Reorder triangles for the post-transform cache (Tipsify)
+     */
+    static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount,
+                                    unsigned int cacheSize = CACHE_SIZE);
+
+    /**
+     * @brief Reorder cache-optimized triangles in clusters to reduce overdraw
+     *
+     * Expects the output of OptimizeVertexCache(); cluster boundaries are
+     * taken from its cache behaviour.
+     *
+     * @param positions Vertex positions indexed like indices
+     * @param threshold Allowed ACMR growth per cluster (1.0 keeps it intact)
+     */
+    static void OptimizeOverdraw(std::vector<unsigned int>& indices, std::span<const glm::vec3> positions,
+                                 float threshold = OVERDRAW_THRESHOLD, unsigned int cacheSize = CACHE_SIZE);
+
+    /**
+     * @brief Renumber vertices in the order the index buffer first uses them
+     *
+     * Rewrites indices in place. Unreferenced vertices are dropped.
+     *
+     * @param remap Receives the new index of every old vertex (~0u if dropped)
+     * @return Number of vertices after the remap
+     */
+    static size_t OptimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount,
+                                      std::vector<unsigned int>& remap);
+
+    /**
+     * @brief Move vertices to the slots chosen by OptimizeVertexFetch()
+     */
+    template <typename V>
+    static void RemapVertices(std::vector<V>& vertices, const std::vector<unsigned int>& remap, size_t newCount) {
+        std::vector<V> reordered(newCount);
+        for (size_t i = 0; i < vertices.size(); i++) {
+            if (remap[i] != INVALID_INDEX) {
+                reordered[remap[i]] = vertices[i];
+            }
+        }
+        vertices.swap(reordered);
+    }
+
+    /**
+     * @brief Full pass: vertex cache, overdraw, then vertex fetch order
+     *
+     * @param position Member of V holding the vertex position
+     */
+    template <typename V>
+    static Report Optimize(std::vector<V>& vertices, std::vector<unsigned int>& indices, glm::vec3 V::*position,
+                           float overdrawThreshold = OVERDRAW_THRESHOLD) {
+        Report report;
+        report.before = AnalyzeVertexCache(indices, vertices.size());
+
+        OptimizeVertexCache(indices, vertices.size());
+
+        std::vector<glm::vec3> positions(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            positions[i] = vertices[i].*position;
+        }
+        OptimizeOverdraw(indices, positions, overdrawThreshold);
+
+        std::vector<unsigned int> remap;
+        size_t vertexCount = OptimizeVertexFetch(indices, vertices.size(), remap);
+        RemapVertices(vertices, remap, vertexCount);
+
+        report.after = AnalyzeVertexCache(indices, vertices.size());
+        return report;
+    }
+
+    static constexpr unsigned int INVALID_INDEX = ~0u;
+};
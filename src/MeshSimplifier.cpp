@@ -0,0 +1,303 @@
+﻿/**
+ * @file MeshSimplifier.cpp
+ * @brief Quadric error edge collapse and LOD chain generation
+ */
+
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+    // Sum of squared distances to a set of planes, weighted by triangle area
+    struct Quadric {
+        double a2, ab, ac, ad;
+        double b2, bc, bd;
+        double c2, cd;
+        double d2;
+        double weight;
+
+        void AddPlane(const glm::dvec3& normal, double distance, double planeWeight) {
+            a2 += normal.x * normal.x * planeWeight;
+            ab += normal.x * normal.y * planeWeight;
+            ac += normal.x * normal.z * planeWeight;
+            ad += normal.x * distance * planeWeight;
+            b2 += normal.y * normal.y * planeWeight;
+            bc += normal.y * normal.z * planeWeight;
+            bd += normal.y * distance * planeWeight;
+            c2 += normal.z * normal.z * planeWeight;
+            cd += normal.z * distance * planeWeight;
+            d2 += distance * distance * planeWeight;
+            weight += planeWeight;
+        }
+
+        void Add(const Quadric& other) {
+            a2 += other.a2; ab += other.ab; ac += other.ac; ad += other.ad;
+            b2 += other.b2; bc += other.bc; bd += other.bd;
+            c2 += other.c2; cd += other.cd;
+            d2 += other.d2;
+            weight += other.weight;
+        }
+
+        // Mean squared distance of p to the accumulated planes
+        double Evaluate(const glm::vec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            double sum = a2 * x * x + b2 * y * y + c2 * z * z + d2 +
+                         2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+            return weight > 0.0 ? std::max(sum, 0.0) / weight : 0.0;
+        }
+    };
+
+    struct Collapse {
+        unsigned int from;
+        unsigned int to;
+        double cost;
+    };
+
+    uint64_t EdgeKey(unsigned int a, unsigned int b) {
+        return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+    }
+
+    // Vertex -> triangle lists over the current index buffer, packed per vertex
+    void BuildAdjacency(const std::vector<unsigned int>& indices, size_t vertexCount,
+                        std::vector<unsigned int>& offsets, std::vector<unsigned int>& triangles) {
+        offsets.assign(vertexCount + 1, 0);
+        for (unsigned int index : indices) {
+            offsets[index + 1]++;
+        }
+        for (size_t v = 0; v < vertexCount; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+        triangles.resize(indices.size());
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            triangles[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+    }
+
+}
+
+std::vector<unsigned int> MeshSimplifier::Simplify(std::span<const glm::vec3> positions, std::span<const unsigned int> indices,
+                                                   size_t targetIndexCount, float& error) {
+    error = 0.0f;
+    std::vector<unsigned int> result(indices.begin(), indices.begin() + indices.size() / 3 * 3);
+    size_t vertexCount = positions.size();
+    if (result.size() <= targetIndexCount || vertexCount == 0) {
+        return result;
+    }
+
+    // Vertices sharing a position are one point of the surface; the first
+    // one found stands for the group when classifying edges
+    std::vector<unsigned int> canonical(vertexCount);
+    std::vector<bool> locked(vertexCount, false);
+    {
+        struct PositionHash {
+            size_t operator()(const glm::vec3& p) const {
+                // Adding zero folds -0 into +0 so equal positions hash alike
+                glm::vec3 folded = p + glm::vec3(0.0f);
+                uint32_t bits[3];
+                std::memcpy(bits, &folded, sizeof(bits));
+                return (size_t(bits[0]) * 73856093u) ^ (size_t(bits[1]) * 19349663u) ^ (size_t(bits[2]) * 83492791u);
+            }
+        };
+        std::unordered_map<glm::vec3, unsigned int, PositionHash> firstAtPosition;
+        firstAtPosition.reserve(vertexCount);
+        for (unsigned int v = 0; v < vertexCount; v++) {
+            auto inserted = firstAtPosition.emplace(positions[v], v);
+            canonical[v] = inserted.first->second;
+            if (!inserted.second) {
+                // Attribute seam: moving either copy would tear the surface
+                locked[v] = true;
+                locked[inserted.first->second] = true;
+            }
+        }
+    }
+
+    // Open borders and non-manifold edges stay put as well
+    {
+        std::unordered_map<uint64_t, unsigned int> edgeUse;
+        edgeUse.reserve(result.size());
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                edgeUse[EdgeKey(canonical[result[i + k]], canonical[result[i + (k + 1) % 3]])]++;
+            }
+        }
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                unsigned int a = result[i + k];
+                unsigned int b = result[i + (k + 1) % 3];
+                if (edgeUse[EdgeKey(canonical[a], canonical[b])] != 2) {
+                    locked[a] = true;
+                    locked[b] = true;
+                }
+            }
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertexCount, Quadric{});
+    for (size_t i = 0; i < result.size(); i += 3) {
+        glm::dvec3 p0(positions[result[i]]);
+        glm::dvec3 p1(positions[result[i + 1]]);
+        glm::dvec3 p2(positions[result[i + 2]]);
+        glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+        double area = glm::length(normal);
+        if (area <= 0.0) {
+            continue;
+        }
+        normal /= area;
+        double distance = -glm::dot(normal, p0);
+        for (int k = 0; k < 3; k++) {
+            quadrics[result[i + k]].AddPlane(normal, distance, area);
+        }
+    }
+
+    std::vector<unsigned int> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<unsigned int> offsets, adjacency;
+    std::vector<Collapse> collapses;
+    double maxCost = 0.0;
+
+    // Passes of independent collapses: within a pass no two collapses share
+    // a one-ring, so the flip checks stay valid without updating triangles
+    while (result.size() > targetIndexCount) {
+        BuildAdjacency(result, vertexCount, offsets, adjacency);
+
+        collapses.clear();
+        for (size_t i = 0; i < result.size(); i += 3) {
+            for (int k = 0; k < 3; k++) {
+                unsigned int a = result[i + k];
+                unsigned int b = result[i + (k + 1) % 3];
+                // Each interior edge is seen twice; keep one direction pair
+                if (a > b && !locked[a] && !locked[b]) {
+                    continue;
+                }
+                Quadric merged = quadrics[a];
+                merged.Add(quadrics[b]);
+                if (!locked[a]) {
+                    collapses.push_back({ a, b, merged.Evaluate(positions[b]) });
+                }
+                if (!locked[b]) {
+                    collapses.push_back({ b, a, merged.Evaluate(positions[a]) });
+                }
+            }
+        }
+        if (collapses.empty()) {
+            break;
+        }
+        std::sort(collapses.begin(), collapses.end(),
+                  [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+        for (unsigned int v = 0; v < vertexCount; v++) {
+            remap[v] = v;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+
+        size_t triangleCount = result.size() / 3;
+        size_t targetTriangles = targetIndexCount / 3;
+        size_t performed = 0;
+
+        for (const Collapse& collapse : collapses) {
+            if (triangleCount <= targetTriangles) {
+                break;
+            }
+            unsigned int from = collapse.from;
+            unsigned int to = collapse.to;
+            if (touched[from] || touched[to]) {
+                continue;
+            }
+
+            // Reject collapses that would flip or flatten a surviving triangle
+            bool valid = true;
+            size_t removed = 0;
+            for (unsigned int a = offsets[from]; a < offsets[from + 1] && valid; a++) {
+                const unsigned int* triangle = &result[adjacency[a] * 3];
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                    removed++;
+                    continue;
+                }
+                glm::vec3 before[3], after[3];
+                for (int k = 0; k < 3; k++) {
+                    before[k] = positions[triangle[k]];
+                    after[k] = triangle[k] == from ? positions[to] : before[k];
+                }
+                glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+                if (glm::dot(normalBefore, normalAfter) <= 0.25f * glm::length(normalBefore) * glm::length(normalAfter)) {
+                    valid = false;
+                }
+            }
+            if (!valid || removed == 0) {
+                continue;
+            }
+
+            remap[from] = to;
+            quadrics[to].Add(quadrics[from]);
+            maxCost = std::max(maxCost, collapse.cost);
+            triangleCount -= removed;
+            performed++;
+
+            // Freeze the one-ring of the moved vertex for the rest of the pass
+            for (unsigned int a = offsets[from]; a < offsets[from + 1]; a++) {
+                const unsigned int* triangle = &result[adjacency[a] * 3];
+                touched[triangle[0]] = true;
+                touched[triangle[1]] = true;
+                touched[triangle[2]] = true;
+            }
+        }
+
+        if (performed == 0) {
+            break;
+        }
+
+        // Apply the pass and drop triangles that collapsed to an edge
+        size_t write = 0;
+        for (size_t i = 0; i < result.size(); i += 3) {
+            unsigned int a = remap[result[i]];
+            unsigned int b = remap[result[i + 1]];
+            unsigned int c = remap[result[i + 2]];
+            if (a != b && b != c && a != c) {
+                result[write++] = a;
+                result[write++] = b;
+                result[write++] = c;
+            }
+        }
+        result.resize(write);
+    }
+
+    error = static_cast<float>(std::sqrt(maxCost));
+    return result;
+}
+
+std::vector<MeshSimplifier::Level> MeshSimplifier::GenerateLods(std::span<const glm::vec3> positions,
+                                                                std::span<const unsigned int> indices) {
+    std::vector<Level> levels;
+    if (indices.size() / 3 < MIN_LOD_TRIANGLES) {
+        return levels;
+    }
+
+    size_t previousCount = indices.size();
+    float previousError = 0.0f;
+    for (int lod = 1; lod < MAX_LODS; lod++) {
+        size_t target = static_cast<size_t>(previousCount * LOD_REDUCTION) / 3 * 3;
+
+        // Simplifying from the full mesh keeps each level's error honest
+        Level level;
+        level.indices = Simplify(positions, indices, target, level.error);
+
+        // Give up once the locked vertices stop further reduction
+        if (level.indices.size() < 3 || level.indices.size() > previousCount * 0.85f) {
+            break;
+        }
+        level.error = std::max(level.error, previousError);
+        MeshOptimizer::OptimizeVertexCache(level.indices, positions.size());
+
+        previousCount = level.indices.size();
+        previousError = level.error;
+        levels.push_back(std::move(level));
+    }
+    return levels;
+}
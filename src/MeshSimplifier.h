@@ -0,0 +1,57 @@
+﻿/**
+ * @file MeshSimplifier.h
+ * @brief Quadric error simplification for automatic mesh LODs
+ *
+ * Garland-Heckbert edge collapses restricted to existing vertices: every
+ * collapse moves one vertex onto a neighbour, so a simplified level is just
+ * a shorter index list over the original vertex buffer. All levels of a
+ * mesh then share one VBO and one EBO and differ only in the index range
+ * that is drawn.
+ *
+ * Vertices on open borders, on attribute seams (several vertices at one
+ * position) and on non-manifold edges never move, which keeps outlines,
+ * UV seams and hard edges intact at the cost of some reduction.
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+class MeshSimplifier {
+public:
+    static constexpr int MAX_LODS = 4;                  // Including the full-detail level
+    static constexpr size_t MIN_LOD_TRIANGLES = 64;     // Smaller meshes get no extra levels
+    static constexpr float LOD_REDUCTION = 0.5f;        // Triangle ratio between neighbouring levels
+
+    /**
+     * @brief One generated detail level
+     */
+    struct Level {
+        std::vector<unsigned int> indices;
+        float error;            // Largest collapse error, object-space distance
+    };
+
+    /**
+     * @brief Collapse edges until at most targetIndexCount indices remain
+     *
+     * Stops early when no collapse is possible without flipping a triangle.
+     *
+     * @param error Receives the largest collapse error
+     * @return Simplified triangle list over the same vertices
+     */
+    static std::vector<unsigned int> Simplify(std::span<const glm::vec3> positions, std::span<const unsigned int> indices,
+                                              size_t targetIndexCount, float& error);
+
+    /**
+     * @brief Coarser levels for a mesh, each simplified from the full mesh
+     *
+     * Every level targets LOD_REDUCTION of the previous one's triangles.
+     * Generation stops once a level no longer gets meaningfully smaller.
+     *
+     * @return Up to MAX_LODS - 1 levels, finest first; empty for small meshes
+     */
+    static std::vector<Level> GenerateLods(std::span<const glm::vec3> positions, std::span<const unsigned int> indices);
+};
@@ -4,7 +4,9 @@
  */
 
 #include "Model.h"
+#include "CookedMesh.h"
 #include "Texture.h"
+#include <algorithm>
 
 /**
  * @brief Constructor - Initialize model and load from file
@@ -14,9 +16,27 @@
  * 
  * @param path File path to the 3D model file (supports OBJ, FBX, DAE, etc.)
  * @param gamma Whether to enable gamma correction for loaded textures
+ * @param importFlags ASSIMP post-processing steps to apply
  */
-Model::Model(const std::string& path, bool gamma) : gammaCorrection(gamma) {
-    LoadModel(path);
+Model::Model(const std::string& path, bool gamma, unsigned int importFlags)
+    : gammaCorrection(gamma), boundsMin(0.0f), boundsMax(0.0f), ready(false) {
+    std::unique_ptr<ModelImport> data = Import(path, importFlags);
+    Upload(*data);
+}
+
+Model::Model() : gammaCorrection(false), boundsMin(0.0f), boundsMax(0.0f), ready(false) {
+}
+
+/**
+ * @brief Create an empty model that a loader fills in later
+ * 
+ * @param gamma Whether to enable gamma correction for loaded textures
+ * @return Model that draws nothing until Upload() runs
+ */
+std::shared_ptr<Model> Model::CreatePending(bool gamma) {
+    std::shared_ptr<Model> model(new Model());
+    model->gammaCorrection = gamma;
+    return model;
 }
 
 /**
@@ -28,19 +48,90 @@ Model::Model(const std::string& path, bool gamma) : gammaCorrection(gamma) {
  * 
  * @param shader The shader program to use for rendering all meshes
  */
-void Model::Draw(Shader& shader) {
-    for (unsigned int i = 0; i < meshes.size(); i++)
-        meshes[i].Draw(shader);
+void Model::Draw(Shader& shader, int lod) const {
+    if (meshes.empty()) {
+        return;
+    }
+
+    // All meshes live in one pool: runs of meshes sharing textures go out as one multi-draw
+    static std::vector<DrawElementsIndirectCommand> commands;   // Scratch; drawing is GL-thread only
+    GeometryPool& pool = Mesh::GetGeometryPool();
+    pool.Bind();
+    for (size_t i = 0; i < meshes.size(); i++) {
+        if (i == 0 || !meshes[i].HasSameTextures(meshes[i - 1])) {
+            pool.MultiDraw(commands);
+            commands.clear();
+            meshes[i].BindTextures(shader);
+        }
+        commands.push_back(meshes[i].GetDrawCommand(lod));
+    }
+    pool.MultiDraw(commands);
+    commands.clear();
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void Model::DrawDepth(int lod) const {
+    if (meshes.empty()) {
+        return;
+    }
+
+    static std::vector<DrawElementsIndirectCommand> commands;   // Scratch; drawing is GL-thread only
+    GeometryPool& pool = Mesh::GetGeometryPool();
+    pool.Bind();
+    for (const Mesh& mesh : meshes) {
+        commands.push_back(mesh.GetDrawCommand(lod));
+    }
+    pool.MultiDraw(commands);
+    commands.clear();
+    glBindVertexArray(0);
+}
+
+int Model::SelectLod(float screenSize, int currentLod) const {
+    int lodCount = GetLodCount();
+    if (lodCount <= 1) {
+        return 0;
+    }
+    currentLod = std::clamp(currentLod, 0, lodCount - 1);
+    auto pixelError = [&](int lod) { return lodErrors[lod] * screenSize; };
+
+    // Coarsest level within the error budget; errors only grow with the level
+    int target = 0;
+    while (target + 1 < lodCount && pixelError(target + 1) <= LOD_PIXEL_ERROR) {
+        target++;
+    }
+
+    // Coarser only with margin to spare, finer only once the current level is clearly too coarse
+    if (target > currentLod) {
+        while (target > currentLod && pixelError(target) > LOD_PIXEL_ERROR * (1.0f - LOD_HYSTERESIS)) {
+            target--;
+        }
+    } else if (target < currentLod && pixelError(currentLod) <= LOD_PIXEL_ERROR * (1.0f + LOD_HYSTERESIS)) {
+        target = currentLod;
+    }
+    return target;
+}
+
+size_t Model::GetGpuBytes() const {
+    size_t bytes = 0;
+    for (const Mesh& mesh : meshes) {
+        bytes += mesh.GetGpuBytes();
+    }
+    return bytes;
 }
 
 /**
- * @brief Load 3D model from file using ASSIMP library
+ * @brief Read 3D model from file using ASSIMP library
  * 
  * Uses ASSIMP to import the model file and convert it into renderable format.
+ * Runs without a GL context; Upload() does the GPU side.
  * Applies various post-processing steps to optimize the model data for OpenGL.
  * Provides detailed debugging information about the loaded model structure.
  * 
- * Post-processing steps applied:
+ * A valid cooked copy of the model (see CookedMesh.h) is used instead when
+ * one exists; otherwise one is written after a successful import.
+ * 
+ * Post-processing steps applied by default (DEFAULT_IMPORT_FLAGS):
  * - Triangulate: Convert all faces to triangles
  * - GenSmoothNormals: Generate smooth vertex normals
  * - FlipUVs: Flip texture coordinates for OpenGL coordinate system
@@ -51,76 +142,124 @@ void Model::Draw(Shader& shader) {
  * - SortByPType: Sort primitives by type for better rendering efficiency
  * 
  * @param path File path to the 3D model file
+ * @param importFlags ASSIMP post-processing steps to apply
+ * @return Imported mesh data ready for Upload()
  */
-void Model::LoadModel(const std::string& path) {
-    // Create ASSIMP importer and load the model with optimization flags
+std::unique_ptr<ModelImport> Model::Import(const std::string& path, unsigned int importFlags) {
+    auto data = std::make_unique<ModelImport>();
+    data->path = path;
+    data->boundsMin = glm::vec3(0.0f);
+    data->boundsMax = glm::vec3(0.0f);
+    data->optimization = MeshOptimizer::Report{};
+    data->fromCooked = false;
+    data->succeeded = false;
+
+    // Extract directory path for relative texture loading
+    data->directory = path.substr(0, path.find_last_of('/'));
+
+    // Skip ASSIMP entirely when the cooked file is still current
+    if (data->cooked.Open(path, importFlags)) {
+        data->meshes = data->cooked.GetMeshes();
+        data->boundsMin = data->cooked.GetBoundsMin();
+        data->boundsMax = data->cooked.GetBoundsMax();
+        data->fromCooked = true;
+        data->succeeded = true;
+        std::cout << "Loaded cooked model: " << path << " (" << data->meshes.size() << " meshes, "
+                  << data->cooked.GetFileSize() / 1024 << " KB)" << std::endl;
+        return data;
+    }
+
+    // Create ASSIMP importer and load the model with the requested post-processing
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, 
-        aiProcess_Triangulate |           // Convert polygons to triangles
-        aiProcess_GenSmoothNormals |      // Generate smooth normals if missing
-        aiProcess_FlipUVs |               // Flip UV coordinates for OpenGL
-        aiProcess_CalcTangentSpace |      // Calculate tangent space for normal mapping
-        aiProcess_JoinIdenticalVertices | // Remove duplicate vertices
-        aiProcess_ImproveCacheLocality |  // Optimize for GPU cache
-        aiProcess_FixInfacingNormals |    // Fix incorrect normals
-        aiProcess_SortByPType);           // Sort primitives by type
+    const aiScene* scene = importer.ReadFile(path, importFlags);
     
     // Check if model loading was successful
     if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
         std::cerr << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
         std::cerr << "Failed to load model: " << path << std::endl;
-        return;
+        return data;
     }
     
     // Print successful loading information
     std::cout << "ASSIMP: Successfully loaded model: " << path << std::endl;
     std::cout << "ASSIMP: Meshes: " << scene->mNumMeshes << ", Materials: " << scene->mNumMaterials << std::endl;
     
-    // Debug: Print detailed mesh information for troubleshooting
-    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
-        aiMesh* mesh = scene->mMeshes[i];
-        std::cout << "  Mesh " << i << ": " << mesh->mNumVertices << " vertices, " 
-                  << mesh->mNumFaces << " faces" << std::endl;
-        
-        // Print vertex position range for debugging geometry issues
-        if (mesh->mNumVertices > 0) {
-            std::cout << "    First vertex: (" << mesh->mVertices[0].x << ", " 
-                      << mesh->mVertices[0].y << ", " << mesh->mVertices[0].z << ")" << std::endl;
-            std::cout << "    Last vertex: (" << mesh->mVertices[mesh->mNumVertices-1].x << ", " 
-                      << mesh->mVertices[mesh->mNumVertices-1].y << ", " 
-                      << mesh->mVertices[mesh->mNumVertices-1].z << ")" << std::endl;
-        }
+    // Start recursive processing from the root node
+    ProcessNode(scene->mRootNode, scene, *data);
+    for (size_t i = 0; i < data->meshes.size(); i++) {
+        const CookedMeshFile::MeshView& mesh = data->meshes[i];
+        data->boundsMin = i == 0 ? mesh.boundsMin : glm::min(data->boundsMin, mesh.boundsMin);
+        data->boundsMax = i == 0 ? mesh.boundsMax : glm::max(data->boundsMax, mesh.boundsMax);
     }
-    
-    // Debug: Print material information for texture/lighting troubleshooting
-    for (unsigned int i = 0; i < scene->mNumMaterials; i++) {
-        aiMaterial* material = scene->mMaterials[i];
-        aiString name;
-        material->Get(AI_MATKEY_NAME, name);
-        std::cout << "  Material " << i << ": " << name.C_Str() << std::endl;
-        
-        // Extract and print material color properties
-        aiColor3D diffuse, ambient, specular;
-        float shininess;
-        if (material->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse) == AI_SUCCESS) {
-            std::cout << "    Diffuse: (" << diffuse.r << ", " << diffuse.g << ", " << diffuse.b << ")" << std::endl;
-        }
-        if (material->Get(AI_MATKEY_COLOR_AMBIENT, ambient) == AI_SUCCESS) {
-            std::cout << "    Ambient: (" << ambient.r << ", " << ambient.g << ", " << ambient.b << ")" << std::endl;
+    data->succeeded = true;
+
+    const MeshOptimizer::Report& report = data->optimization;
+    std::cout << "Mesh optimization: ACMR " << report.before.GetACMR() << " -> " << report.after.GetACMR()
+              << ", ATVR " << report.before.GetATVR() << " -> " << report.after.GetATVR() << std::endl;
+
+    std::vector<size_t> lodTriangles;
+    for (const CookedMeshFile::MeshView& view : data->meshes) {
+        for (size_t lod = 0; lod < view.lods.size(); lod++) {
+            if (lod >= lodTriangles.size()) {
+                lodTriangles.push_back(0);
+            }
+            lodTriangles[lod] += view.lods[lod].indexCount / 3;
         }
-        if (material->Get(AI_MATKEY_COLOR_SPECULAR, specular) == AI_SUCCESS) {
-            std::cout << "    Specular: (" << specular.r << ", " << specular.g << ", " << specular.b << ")" << std::endl;
+    }
+    if (!lodTriangles.empty()) {
+        std::cout << "Mesh LODs (triangles):";
+        for (size_t triangles : lodTriangles) {
+            std::cout << " " << triangles;
         }
-        if (material->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS) {
-            std::cout << "    Shininess: " << shininess << std::endl;
+        std::cout << std::endl;
+    }
+
+    // Cook the result so the next launch can skip the import
+    if (!data->meshes.empty()) {
+        CookedMeshFile::Write(path, importFlags, data->meshes);
+    }
+    return data;
+}
+
+/**
+ * @brief Create GPU meshes from imported data
+ * 
+ * Each mesh is uploaded straight from the import's views (the mapped
+ * cooked file or the ASSIMP output), so the model keeps no CPU copy of
+ * the vertex data. Textures are resolved against the model directory and
+ * shared through textures_loaded.
+ * 
+ * @param data Result of Import()
+ */
+void Model::Upload(const ModelImport& data) {
+    directory = data.directory;
+    meshes.reserve(data.meshes.size());
+    for (const CookedMeshFile::MeshView& view : data.meshes) {
+        std::vector<Texture> textures;
+        for (const CookedMeshFile::TextureRef& reference : view.textures) {
+            textures.push_back(FindOrLoadTexture(directory + "/" + reference.path, reference.type));
         }
+        meshes.emplace_back(view.vertices, view.indices, std::move(textures), view.boundsMin, view.boundsMax, view.lods);
     }
-    
-    // Extract directory path for relative texture loading
-    directory = path.substr(0, path.find_last_of('/'));
+    boundsMin = data.boundsMin;
+    boundsMax = data.boundsMax;
 
-    // Start recursive processing from the root node
-    ProcessNode(scene->mRootNode, scene);
+    // Errors relative to the model's size so SelectLod() only needs its projection
+    float diagonal = glm::length(boundsMax - boundsMin);
+    lodErrors.assign(1, 0.0f);
+    for (const Mesh& mesh : meshes) {
+        for (int lod = 1; lod < mesh.GetLodCount(); lod++) {
+            if (lod >= GetLodCount()) {
+                lodErrors.push_back(0.0f);
+            }
+            float error = diagonal > 0.0f ? mesh.GetLod(lod).error / diagonal : 0.0f;
+            lodErrors[lod] = std::max(lodErrors[lod], error);
+        }
+    }
+    for (size_t lod = 1; lod < lodErrors.size(); lod++) {
+        lodErrors[lod] = std::max(lodErrors[lod], lodErrors[lod - 1]);
+    }
+    ready = true;
 }
 
 /**
@@ -135,27 +274,28 @@ void Model::LoadModel(const std::string& path) {
  * 
  * @param node Current ASSIMP node being processed
  * @param scene Complete ASSIMP scene data containing all meshes and materials
+ * @param data Import receiving the converted meshes
  */
-void Model::ProcessNode(aiNode* node, const aiScene* scene) {
+void Model::ProcessNode(aiNode* node, const aiScene* scene, ModelImport& data) {
     // Process each mesh located at the current node
     for (unsigned int i = 0; i < node->mNumMeshes; i++) {
         // The node contains indices to meshes in the scene's mesh array
         // Retrieve the actual mesh and convert it to our format
         aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-        meshes.push_back(ProcessMesh(mesh, scene));
+        ProcessMesh(mesh, scene, data);
     }
     
     // Recursively process each child node
     for (unsigned int i = 0; i < node->mNumChildren; i++) {
-        ProcessNode(node->mChildren[i], scene);
+        ProcessNode(node->mChildren[i], scene, data);
     }
 }
 
 /**
  * @brief Convert ASSIMP mesh to our Mesh format
  * 
- * Processes an individual mesh from ASSIMP and converts it into our own Mesh format
- * that can be rendered with OpenGL. This involves extracting vertex data, indices,
+ * Processes an individual mesh from ASSIMP and converts it into the vertex layout
+ * uploaded to OpenGL. This involves extracting vertex data, indices, bounds
  * and material information.
  * 
  * For each vertex, we extract:
@@ -166,13 +306,14 @@ void Model::ProcessNode(aiNode* node, const aiScene* scene) {
  * 
  * @param mesh ASSIMP mesh to convert
  * @param scene Complete ASSIMP scene (needed for material access)
- * @return Converted Mesh object ready for OpenGL rendering
+ * @param data Import receiving the mesh data and its view
  */
-Mesh Model::ProcessMesh(aiMesh* mesh, const aiScene* scene) {
+void Model::ProcessMesh(aiMesh* mesh, const aiScene* scene, ModelImport& data) {
     // Data containers for the mesh
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
-    std::vector<Texture> textures;
+    std::vector<CookedMeshFile::TextureRef> textures;
+    vertices.reserve(mesh->mNumVertices);
 
     // Process vertices - extract all vertex attribute data
     for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
@@ -223,44 +364,83 @@ Mesh Model::ProcessMesh(aiMesh* mesh, const aiScene* scene) {
     }
     
     // Process indices - extract face/triangle information
+    bool trianglesOnly = true;
     for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
         aiFace face = mesh->mFaces[i];
+        trianglesOnly = trianglesOnly && face.mNumIndices == 3;
         // Retrieve all indices for this face and add them to the indices vector
         for (unsigned int j = 0; j < face.mNumIndices; j++)
             indices.push_back(face.mIndices[j]);
     }
     
+    // Reorder for the vertex cache, overdraw and vertex fetch; the cooked
+    // file stores the result so this only runs on import
+    if (trianglesOnly) {
+        data.optimization.Merge(MeshOptimizer::Optimize(vertices, indices, &Vertex::Position));
+    }
+    
+    // Simplified levels share the vertex buffer; their indices follow level 0
+    std::vector<MeshLod> lods;
+    if (trianglesOnly) {
+        std::vector<glm::vec3> positions(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++) {
+            positions[i] = vertices[i].Position;
+        }
+        std::vector<MeshSimplifier::Level> levels = MeshSimplifier::GenerateLods(positions, indices);
+        if (!levels.empty()) {
+            lods.push_back({ 0, static_cast<unsigned int>(indices.size()), 0.0f });
+            for (const MeshSimplifier::Level& level : levels) {
+                lods.push_back({ static_cast<unsigned int>(indices.size()), static_cast<unsigned int>(level.indices.size()), level.error });
+                indices.insert(indices.end(), level.indices.begin(), level.indices.end());
+            }
+        }
+    }
+    
     // Process materials - extract texture information
     aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
     
     // Load different types of textures for comprehensive material support
     
     // 1. Diffuse maps (base color/albedo textures)
-    std::vector<Texture> diffuseMaps = LoadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
-    textures.insert(textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+    CollectMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse", textures);
     
     // 2. Specular maps (shininess/reflection textures)
-    std::vector<Texture> specularMaps = LoadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
-    textures.insert(textures.end(), specularMaps.begin(), specularMaps.end());
+    CollectMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular", textures);
     
     // 3. Normal maps (surface detail textures for advanced lighting)
-    std::vector<Texture> normalMaps = LoadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal");
-    textures.insert(textures.end(), normalMaps.begin(), normalMaps.end());
+    CollectMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal", textures);
     
     // 4. Height maps (displacement/parallax mapping)
-    std::vector<Texture> heightMaps = LoadMaterialTextures(material, aiTextureType_AMBIENT, "texture_height");
-    textures.insert(textures.end(), heightMaps.begin(), heightMaps.end());
+    CollectMaterialTextures(material, aiTextureType_AMBIENT, "texture_height", textures);
 
-    // Create and return the completed mesh object
-    return Mesh(vertices, indices, textures);
+    // Bounds for culling and the cooked file
+    CookedMeshFile::MeshView view;
+    view.boundsMin = glm::vec3(0.0f);
+    view.boundsMax = glm::vec3(0.0f);
+    if (!vertices.empty()) {
+        view.boundsMin = vertices[0].Position;
+        view.boundsMax = vertices[0].Position;
+        for (const Vertex& vertex : vertices) {
+            view.boundsMin = glm::min(view.boundsMin, vertex.Position);
+            view.boundsMax = glm::max(view.boundsMax, vertex.Position);
+        }
+    }
+
+    // Moving the vectors keeps their buffers, so the views stay valid
+    data.vertexStorage.push_back(std::move(vertices));
+    data.indexStorage.push_back(std::move(indices));
+    view.vertices = data.vertexStorage.back();
+    view.indices = data.indexStorage.back();
+    view.lods = std::move(lods);
+    view.textures = std::move(textures);
+    data.meshes.push_back(std::move(view));
 }
 
 /**
- * @brief Load textures of a specific type from material
+ * @brief Collect textures of a specific type from material
  * 
- * Extracts texture file paths from ASSIMP material and loads the actual texture files.
- * Implements texture caching to avoid loading the same texture multiple times,
- * which improves performance and reduces memory usage.
+ * Extracts texture file paths from ASSIMP material. Loading happens in Upload(),
+ * which caches textures to avoid loading the same file multiple times.
  * 
  * Supports various texture types:
  * - Diffuse: Base color textures
@@ -271,33 +451,36 @@ Mesh Model::ProcessMesh(aiMesh* mesh, const aiScene* scene) {
  * @param mat ASSIMP material containing texture file references
  * @param type ASSIMP texture type to extract (diffuse, specular, etc.)
  * @param typeName String identifier for the texture type (used in shaders)
- * @return Vector of loaded Texture objects
+ * @param textures Receives the type and model-relative path of each texture
  */
-std::vector<Texture> Model::LoadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName) {
-    std::vector<Texture> textures;
-    
+void Model::CollectMaterialTextures(aiMaterial* mat, aiTextureType type, const std::string& typeName,
+                                    std::vector<CookedMeshFile::TextureRef>& textures) {
     // Process all textures of the specified type in this material
     for (unsigned int i = 0; i < mat->GetTextureCount(type); i++) {
         aiString str;
         mat->GetTexture(type, i, &str); // Get texture file path
-        
-        // Check if this texture was already loaded (texture caching)
-        bool skip = false;
-        for (unsigned int j = 0; j < textures_loaded.size(); j++) {
-            if (std::strcmp(textures_loaded[j].path.data(), str.C_Str()) == 0) {
-                textures.push_back(textures_loaded[j]); // Reuse cached texture
-                skip = true; // Skip loading since we already have it
-                break;
-            }
-        }
-        
-        // Load new texture if not found in cache
-        if (!skip) {   
-            // Create new texture with full path (directory + filename)
-            Texture texture(directory + "/" + str.C_Str(), typeName);
-            textures.push_back(texture);
-            textures_loaded.push_back(texture);  // Add to cache for future use
+        textures.push_back({ typeName, str.C_Str() });
+    }
+}
+
+/**
+ * @brief Reuse a texture this model already loaded, or load it
+ * 
+ * @param fullPath Texture path including the model directory
+ * @param typeName String identifier for the texture type (used in shaders)
+ * @return The cached or newly loaded texture
+ */
+Texture Model::FindOrLoadTexture(const std::string& fullPath, const std::string& typeName) {
+    // Check if this texture was already loaded (texture caching)
+    // Loaded textures store their full path, so compare against that
+    for (unsigned int j = 0; j < textures_loaded.size(); j++) {
+        if (textures_loaded[j].path == fullPath) {
+            return textures_loaded[j]; // Reuse cached texture
         }
     }
-    return textures;
+    
+    // Create new texture with full path (directory + filename)
+    Texture texture(fullPath, typeName);
+    textures_loaded.push_back(texture);  // Add to cache for future use
+    return texture;
 }
@@ -17,7 +17,10 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include "CookedMesh.h"
 #include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
 #include "Shader.h"
 
 #include <string>
@@ -25,8 +28,30 @@
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <vector>
 
+/**
+ * @brief CPU-side model data between file import and GPU upload
+ * 
+ * Filled by Model::Import() on any thread and turned into meshes by
+ * Model::Upload() on the GL thread. Mesh views point either into the
+ * mapped cooked file or into the owned vertex and index storage.
+ */
+struct ModelImport {
+    std::string path;
+    std::string directory;
+    std::vector<CookedMeshFile::MeshView> meshes;
+    std::vector<std::vector<Vertex>> vertexStorage;       // ASSIMP imports only
+    std::vector<std::vector<unsigned int>> indexStorage;
+    CookedMeshFile cooked;                                 // Keeps the mapping alive until upload
+    glm::vec3 boundsMin;
+    glm::vec3 boundsMax;
+    MeshOptimizer::Report optimization;                    // Summed over all meshes; ASSIMP imports only
+    bool fromCooked;
+    bool succeeded;
+};
+
 /**
  * @brief 3D Model class for loading and rendering complex models
  * 
@@ -39,22 +64,84 @@
  * 
  * The class uses ASSIMP library to import various 3D file formats
  * and converts them into renderable mesh objects with associated textures.
+ * 
+ * A Model owns its GPU buffers and cannot be copied. Placed objects should
+ * get models through ModelCache so each file is imported and uploaded once.
+ * 
+ * Loading is split so it can be streamed: Import() reads the file on any
+ * thread and Upload() creates the meshes on the GL thread. A model created
+ * with CreatePending() draws nothing and reports !IsReady() until then.
  */
 class Model {
 public:
+    // ASSIMP post-processing steps applied when no other flags are given
+    static constexpr unsigned int DEFAULT_IMPORT_FLAGS =
+        aiProcess_Triangulate |
+        aiProcess_GenSmoothNormals |
+        aiProcess_FlipUVs |
+        aiProcess_CalcTangentSpace |
+        aiProcess_JoinIdenticalVertices |
+        aiProcess_FixInfacingNormals |
+        aiProcess_SortByPType;
+
     // Model data storage
     std::vector<Texture> textures_loaded;  // Cache of loaded textures to avoid duplicates
     std::vector<Mesh> meshes;              // All meshes that make up this model
     std::string directory;                 // Directory path where model file is located
     bool gammaCorrection;                  // Whether to apply gamma correction to textures
+    glm::vec3 boundsMin;                   // Object-space bounding box of all meshes
+    glm::vec3 boundsMax;
+    std::vector<float> lodErrors;          // Per detail level: worst mesh error / bounding box diagonal
+
+    // Screen-space LOD selection: a level is used while its error covers at
+    // most LOD_PIXEL_ERROR pixels; LOD_HYSTERESIS widens that band when
+    // leaving the current level so objects near a threshold don't flicker
+    static constexpr float LOD_PIXEL_ERROR = 1.0f;
+    static constexpr float LOD_HYSTERESIS = 0.25f;
 
     /**
      * @brief Constructor - loads a model from file
      * 
      * @param path File path to the 3D model file
      * @param gamma Whether to enable gamma correction for textures
+     * @param importFlags ASSIMP post-processing steps (aiProcess_*)
+     */
+    Model(const std::string& path, bool gamma = false, unsigned int importFlags = DEFAULT_IMPORT_FLAGS);
+
+    /**
+     * @brief Create an empty model to be filled later by Upload()
+     * 
+     * @param gamma Whether to enable gamma correction for textures
+     */
+    static std::shared_ptr<Model> CreatePending(bool gamma = false);
+
+    /**
+     * @brief Read a model file into CPU memory
+     * 
+     * Uses a valid cooked file when there is one; otherwise imports with
+     * ASSIMP and writes the cooked file. Makes no GL calls, so it is safe
+     * to run on a loader thread.
+     * 
+     * @param path File path to the 3D model file
+     * @param importFlags ASSIMP post-processing steps (aiProcess_*)
+     * @return Imported data; succeeded is false if the file could not be read
      */
-    Model(const std::string& path, bool gamma = false);
+    static std::unique_ptr<ModelImport> Import(const std::string& path, unsigned int importFlags = DEFAULT_IMPORT_FLAGS);
+
+    /**
+     * @brief Create the GPU meshes and load the textures of imported data
+     * 
+     * Must run on the GL thread. Marks the model ready even when the
+     * import failed, leaving it empty.
+     * 
+     * @param data Result of Import()
+     */
+    void Upload(const ModelImport& data);
+
+    /**
+     * @brief False while a streamed model is still waiting for Upload()
+     */
+    bool IsReady() const { return ready; }
 
     /**
      * @brief Render the entire model using the specified shader
@@ -64,20 +151,40 @@ public:
      * activated and has appropriate uniforms set.
      * 
      * @param shader The shader program to use for rendering
+     * @param lod Detail level from SelectLod(); 0 is full detail
      */
-    void Draw(Shader& shader);
+    void Draw(Shader& shader, int lod = 0) const;
 
-private:
     /**
-     * @brief Load model data from file using ASSIMP
-     * 
-     * Uses ASSIMP library to import the model file and process it
-     * into a format suitable for OpenGL rendering. Applies post-processing
-     * options for optimization and compatibility.
+     * @brief Draw positions only, for depth passes; binds no textures
+     *
+     * Every mesh goes out in a single multi-draw. The depth program must be
+     * active with its model matrix set.
+     */
+    void DrawDepth(int lod = 0) const;
+
+    int GetLodCount() const { return static_cast<int>(lodErrors.size()); }
+
+    /**
+     * @brief Detail level for the model's projected size on screen
      * 
-     * @param path File path to the model file
+     * @param screenSize Projected bounding box diagonal in pixels
+     * @param currentLod Level drawn last frame, for hysteresis
      */
-    void LoadModel(const std::string& path);
+    int SelectLod(float screenSize, int currentLod) const;
+
+    /**
+     * @brief Bytes held in the vertex and index buffers of all meshes
+     */
+    size_t GetGpuBytes() const;
+
+private:
+    bool ready;                            // Meshes uploaded (or the import failed)
+
+    /**
+     * @brief Constructor for CreatePending()
+     */
+    Model();
 
     /**
      * @brief Recursively process ASSIMP scene nodes
@@ -88,33 +195,42 @@ private:
      * 
      * @param node Current ASSIMP node to process
      * @param scene The complete ASSIMP scene data
+     * @param data Import receiving the meshes
      */
-    void ProcessNode(aiNode* node, const aiScene* scene);
+    static void ProcessNode(aiNode* node, const aiScene* scene, ModelImport& data);
 
     /**
-     * @brief Convert ASSIMP mesh to our Mesh format
+     * @brief Convert ASSIMP mesh to our vertex format
      * 
      * Extracts vertex data, indices, and material information from
-     * an ASSIMP mesh and creates our own Mesh object that can be
-     * rendered with OpenGL.
+     * an ASSIMP mesh into the import's storage, ready for upload.
      * 
      * @param mesh ASSIMP mesh to convert
      * @param scene The complete ASSIMP scene (for material access)
-     * @return Converted Mesh object ready for rendering
+     * @param data Import receiving the mesh
      */
-    Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene);
+    static void ProcessMesh(aiMesh* mesh, const aiScene* scene, ModelImport& data);
 
     /**
-     * @brief Load textures for a material from ASSIMP
+     * @brief Collect texture references for a material from ASSIMP
      * 
-     * Extracts texture information from ASSIMP material and loads
-     * the actual texture files. Maintains a cache to avoid loading
-     * the same texture multiple times.
+     * Extracts texture file names from the ASSIMP material. The files
+     * themselves are loaded by Upload(), which shares repeated textures.
      * 
      * @param mat ASSIMP material containing texture information
      * @param type Type of texture to load (diffuse, specular, normal, etc.)
      * @param typeName String name for the texture type
-     * @return Vector of loaded Texture objects
+     * @param textures Receives one reference per texture
+     */
+    static void CollectMaterialTextures(aiMaterial* mat, aiTextureType type, const std::string& typeName,
+                                        std::vector<CookedMeshFile::TextureRef>& textures);
+
+    /**
+     * @brief Return the already loaded texture at fullPath or load it
+     * 
+     * @param fullPath Texture path including the model directory
+     * @param typeName String name for the texture type
+     * @return Loaded Texture object
      */
-    std::vector<Texture> LoadMaterialTextures(aiMaterial* mat, aiTextureType type, std::string typeName);
+    Texture FindOrLoadTexture(const std::string& fullPath, const std::string& typeName);
 };
@@ -0,0 +1,102 @@
+﻿/**
+ * @file ModelCache.cpp
+ * @brief Implementation of the shared model cache
+ */
+
+#include "ModelCache.h"
+#include <filesystem>
+#include <iostream>
+
+ModelCache& ModelCache::Get() {
+    static ModelCache cache;
+    return cache;
+}
+
+ModelCache::ModelCache()
+    : m_hits(0)
+    , m_imports(0)
+{
+}
+
+ModelCache::Key ModelCache::MakeKey(const std::string& path, unsigned int importFlags, bool gamma) const {
+    return Key{ std::filesystem::path(path).lexically_normal().generic_string(), importFlags, gamma };
+}
+
+ModelHandle ModelCache::Load(const std::string& path, unsigned int importFlags, bool gamma) {
+    Key key = MakeKey(path, importFlags, gamma);
+
+    auto it = m_models.find(key);
+    if (it != m_models.end()) {
+        m_hits++;
+        return it->second;
+    }
+
+    auto model = std::make_shared<Model>(key.path, gamma, importFlags);
+    m_imports++;
+    if (model->meshes.empty()) {
+        std::cerr << "[ModelCache] No meshes imported from " << key.path << std::endl;
+    }
+
+    m_models.emplace(std::move(key), model);
+    return model;
+}
+
+ModelHandle ModelCache::LoadAsync(const std::string& path, AssetStreamer& streamer, unsigned int importFlags, bool gamma) {
+    Key key = MakeKey(path, importFlags, gamma);
+
+    auto it = m_models.find(key);
+    if (it != m_models.end()) {
+        m_hits++;
+        return it->second;
+    }
+
+    std::shared_ptr<Model> model = Model::CreatePending(gamma);
+    m_imports++;
+
+    // The job owns the model too, so releasing the entry mid-load is safe
+    std::string modelPath = key.path;
+    streamer.Submit([model, modelPath, importFlags]() -> AssetStreamer::UploadStep {
+        std::shared_ptr<ModelImport> data = Model::Import(modelPath, importFlags);
+        return [model, data]() {
+            model->Upload(*data);
+            if (model->meshes.empty()) {
+                std::cerr << "[ModelCache] No meshes imported from " << data->path << std::endl;
+            }
+        };
+    });
+
+    m_models.emplace(std::move(key), model);
+    return model;
+}
+
+ModelCache::Stats ModelCache::GetStats() const {
+    Stats stats{ m_hits, m_imports, 0, 0 };
+    for (const auto& entry : m_models) {
+        if (!entry.second->IsReady()) {
+            stats.pending++;
+        }
+        stats.gpuBytes += entry.second->GetGpuBytes();
+    }
+    return stats;
+}
+
+size_t ModelCache::ReleaseUnused() {
+    size_t released = 0;
+    for (auto it = m_models.begin(); it != m_models.end();) {
+        if (it->second.use_count() == 1) {
+            it = m_models.erase(it);
+            released++;
+        } else {
+            ++it;
+        }
+    }
+    return released;
+}
+
+void ModelCache::Clear() {
+    if (!m_models.empty()) {
+        std::cout << "[ModelCache] Releasing " << m_models.size() << " models ("
+                  << m_imports << " imports, " << m_hits << " cache hits)" << std::endl;
+    }
+    m_models.clear();
+}
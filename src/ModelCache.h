@@ -0,0 +1,108 @@
+﻿/**
+ * @file ModelCache.h
+ * @brief Process-wide cache of imported models shared between placed objects
+ *
+ * Each (path, import flags, gamma) combination is imported through ASSIMP
+ * and uploaded to the GPU once. Every placed object that uses the model
+ * receives a handle to the same immutable Model, so load time and GPU
+ * memory stay flat however many instances are placed.
+ *
+ * Entries stay resident after their last handle is dropped so a level
+ * reload reuses them; ReleaseUnused() and Clear() give the memory back.
+ * Clear() must run while the GL context is still current.
+ *
+ * LoadAsync() returns immediately with a pending model and imports it
+ * through an AssetStreamer; the handle becomes IsReady() once the upload
+ * step has run on the GL thread.
+ */
+
+#pragma once
+
+#include "AssetStreamer.h"
+#include "Model.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Shared, read-only reference to a cached model
+ */
+using ModelHandle = std::shared_ptr<const Model>;
+
+/**
+ * @brief Path-keyed store of imported models
+ */
+class ModelCache {
+public:
+    struct Stats {
+        size_t hits;            // Load() calls served from the cache
+        size_t imports;         // Load() calls that read the model file
+        size_t pending;         // Streamed models not uploaded yet
+        size_t gpuBytes;        // Vertex and index buffer bytes of resident models
+    };
+
+    static ModelCache& Get();
+
+    /**
+     * @brief Handle to the model at path, importing it on first use
+     *
+     * Paths are normalised, so "a/./b.obj" and "a/b.obj" share an entry.
+     * A file that fails to import is cached as an empty model and not
+     * retried until it is released.
+     */
+    ModelHandle Load(const std::string& path, unsigned int importFlags = Model::DEFAULT_IMPORT_FLAGS,
+                     bool gamma = false);
+
+    /**
+     * @brief Handle to the model at path, importing it in the background
+     *
+     * A cached model, pending or not, is returned as is. Otherwise the
+     * returned model is empty until streamer runs its upload step; draw a
+     * placeholder while IsReady() is false.
+     */
+    ModelHandle LoadAsync(const std::string& path, AssetStreamer& streamer,
+                          unsigned int importFlags = Model::DEFAULT_IMPORT_FLAGS, bool gamma = false);
+
+    /**
+     * @brief Drop entries no handle refers to any more
+     * @return Number of models freed
+     */
+    size_t ReleaseUnused();
+
+    /**
+     * @brief Drop every entry; models still held by handles live on until released
+     */
+    void Clear();
+
+    size_t GetModelCount() const { return m_models.size(); }
+    Stats GetStats() const;
+
+private:
+    ModelCache();
+    ModelCache(const ModelCache&) = delete;
+    ModelCache& operator=(const ModelCache&) = delete;
+
+    struct Key {
+        std::string path;
+        unsigned int importFlags;
+        bool gamma;
+
+        bool operator==(const Key& other) const {
+            return importFlags == other.importFlags && gamma == other.gamma && path == other.path;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<std::string>()(key.path) ^ (std::hash<unsigned int>()(key.importFlags) * 31) ^ (key.gamma ? 0x9e3779b9u : 0u);
+        }
+    };
+
+    Key MakeKey(const std::string& path, unsigned int importFlags, bool gamma) const;
+
+    // Mutable so streamed models can be filled in; handles only see const
+    std::unordered_map<Key, std::shared_ptr<Model>, KeyHash> m_models;
+    size_t m_hits;
+    size_t m_imports;
+};
@@ -0,0 +1,280 @@
+﻿#include "PerformanceOverlay.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+using CustomGUI::UIBatch;
+
+PerformanceOverlay::PerformanceOverlay()
+    : m_graphTop(0.0f)
+    , m_graphRangeMs(33.3f)
+    , m_costMs(0.0f)
+    , m_initialized(false)
+{
+}
+
+PerformanceOverlay::~PerformanceOverlay() {
+    Shutdown();
+}
+
+bool PerformanceOverlay::Initialize() {
+    if (m_initialized) {
+        return true;
+    }
+
+    if (!m_batch.Initialize()) {
+        std::cerr << "[PerformanceOverlay] ERROR: Failed to initialize UI batch" << std::endl;
+        return false;
+    }
+
+    m_panelVertices.reserve(4096);
+    m_graphVertices.reserve((GRAPH_SAMPLES + 2) * 4);
+    m_initialized = true;
+    return true;
+}
+
+void PerformanceOverlay::Shutdown() {
+    if (!m_initialized) {
+        return;
+    }
+
+    m_batch.Shutdown();
+    m_panelVertices.clear();
+    m_graphVertices.clear();
+    m_initialized = false;
+}
+
+void PerformanceOverlay::Render(int width, int height) {
+    if (!m_initialized || width <= 0 || height <= 0) {
+        return;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const PerformanceProfiler& profiler = PerformanceProfiler::getInstance();
+
+    float sinceRebuild = std::chrono::duration<float>(start - m_lastRebuild).count();
+    if (m_panelVertices.empty() || sinceRebuild >= REBUILD_INTERVAL) {
+        RebuildPanel(profiler);
+        m_lastRebuild = start;
+    }
+    RebuildGraph(profiler);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+
+    m_batch.SetViewportHeight(height);
+    m_batch.Begin(glm::ortho(0.0f, (float)width, (float)height, 0.0f, -1.0f, 1.0f));
+    m_batch.AddVertices(m_panelVertices);
+    m_batch.AddVertices(m_graphVertices);
+    m_batch.Flush();
+
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+
+    float cost = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    m_costMs = m_costMs * 0.95f + cost * 0.05f;
+}
+
+void PerformanceOverlay::RebuildPanel(const PerformanceProfiler& profiler) {
+    const CustomGUI::GlyphAtlas& atlas = *m_batch.GetAtlas();
+    const glm::vec4 textColor(0.9f, 0.9f, 0.9f, 1.0f);
+    const glm::vec4 labelColor(0.6f, 0.75f, 1.0f, 1.0f);
+    char buffer[128];
+
+    float targetMs = 1000.0f / std::max(1.0f, profiler.GetTargetFPS());
+    m_graphRangeMs = targetMs * 2.0f;
+
+    // Sections sorted by name so colours stay put between rebuilds
+    m_cpuSegments.clear();
+    for (const auto& [name, timing] : profiler.GetSectionTimings()) {
+        if (timing.frameTime > 0.0f || timing.depth == 0) {
+            m_cpuSegments.push_back({ name, timing.frameTime, glm::vec4(0.0f), timing.depth == 0 });
+        }
+    }
+    std::sort(m_cpuSegments.begin(), m_cpuSegments.end(),
+              [](const Segment& a, const Segment& b) { return a.name < b.name; });
+
+    m_gpuSegments.clear();
+    for (const auto& [name, time] : profiler.GetGpuSections()) {
+        m_gpuSegments.push_back({ name, time, glm::vec4(0.0f), true });
+    }
+
+    size_t colorIndex = 0;
+    for (auto& segment : m_cpuSegments) {
+        segment.color = segment.stacked ? GetSegmentColor(colorIndex++) : textColor;
+    }
+    for (auto& segment : m_gpuSegments) {
+        segment.color = GetSegmentColor(colorIndex++);
+    }
+
+    m_panelVertices.clear();
+    float x = PANEL_X + PADDING;
+    float y = PANEL_Y + PADDING;
+    float innerWidth = PANEL_WIDTH - 2.0f * PADDING;
+
+    size_t frames = profiler.GetHistorySize();
+    float maxFrameTime = 0.0f;
+    for (size_t i = frames - std::min<size_t>(frames, GRAPH_SAMPLES); i < frames; ++i) {
+        maxFrameTime = std::max(maxFrameTime, profiler.GetHistoryFrame(i).frameTime);
+    }
+    std::snprintf(buffer, sizeof(buffer), "FPS %.0f  %.2f ms  avg %.2f  max %.2f",
+                  profiler.GetSmoothedFPS(), profiler.GetCurrentFrameTime(),
+                  profiler.GetAverageFrameTime(60), maxFrameTime);
+    AppendLine(buffer, x, y, textColor);
+
+    // Graph background and the target frame time line; the bars are added every frame
+    m_graphTop = y;
+    UIBatch::AppendRect(m_panelVertices, atlas, glm::vec2(x, y), glm::vec2(innerWidth, GRAPH_HEIGHT),
+                        glm::vec4(0.0f, 0.0f, 0.0f, 0.35f));
+    UIBatch::AppendRect(m_panelVertices, atlas, glm::vec2(x, y + GRAPH_HEIGHT * 0.5f), glm::vec2(innerWidth, 1.0f),
+                        glm::vec4(1.0f, 1.0f, 1.0f, 0.3f));
+    y += GRAPH_HEIGHT + 6.0f;
+
+    float cpuTotal = 0.0f;
+    for (const auto& segment : m_cpuSegments) {
+        cpuTotal += segment.stacked ? segment.timeMs : 0.0f;
+    }
+    float gpuTotal = 0.0f;
+    for (const auto& segment : m_gpuSegments) {
+        gpuTotal += segment.timeMs;
+    }
+
+    UIBatch::AppendText(m_panelVertices, atlas, "CPU", x, y, TEXT_SCALE, labelColor);
+    AppendStackedBar(m_cpuSegments, x + LABEL_WIDTH, y + 1.0f);
+    y += LINE_HEIGHT;
+    UIBatch::AppendText(m_panelVertices, atlas, "GPU", x, y, TEXT_SCALE, labelColor);
+    AppendStackedBar(m_gpuSegments, x + LABEL_WIDTH, y + 1.0f);
+    y += LINE_HEIGHT + 4.0f;
+
+    std::snprintf(buffer, sizeof(buffer), "CPU %.2f ms", cpuTotal);
+    AppendLine(buffer, x, y, labelColor);
+    for (const auto& segment : m_cpuSegments) {
+        float indent = segment.stacked ? 0.0f : 8.0f;
+        if (segment.stacked) {
+            UIBatch::AppendRect(m_panelVertices, atlas, glm::vec2(x, y + 1.0f), glm::vec2(6.0f, 6.0f), segment.color);
+        }
+        std::snprintf(buffer, sizeof(buffer), "%-24.24s %6.2f ms", segment.name.c_str(), segment.timeMs);
+        AppendLine(buffer, x + 10.0f + indent, y, textColor);
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "GPU %.2f ms", gpuTotal);
+    AppendLine(buffer, x, y, labelColor);
+    for (const auto& segment : m_gpuSegments) {
+        UIBatch::AppendRect(m_panelVertices, atlas, glm::vec2(x, y + 1.0f), glm::vec2(6.0f, 6.0f), segment.color);
+        std::snprintf(buffer, sizeof(buffer), "%-24.24s %6.2f ms", segment.name.c_str(), segment.timeMs);
+        AppendLine(buffer, x + 10.0f, y, textColor);
+    }
+
+    if (!profiler.GetCounters().empty()) {
+        AppendLine("Counters", x, y, labelColor);
+        for (const auto& [name, value] : profiler.GetCounters()) {
+            std::snprintf(buffer, sizeof(buffer), "%-24.24s %9zu", name.c_str(), value);
+            AppendLine(buffer, x + 10.0f, y, textColor);
+        }
+    }
+
+    if (!profiler.GetMemoryCounters().empty()) {
+        AppendLine("Memory", x, y, labelColor);
+        for (const auto& [name, bytes] : profiler.GetMemoryCounters()) {
+            std::snprintf(buffer, sizeof(buffer), "%-24.24s %9s", name.c_str(), FormatBytes(bytes).c_str());
+            AppendLine(buffer, x + 10.0f, y, textColor);
+        }
+    }
+
+    const PerformanceProfiler::FrameStats* last = frames > 0 ? &profiler.GetHistoryFrame(frames - 1) : nullptr;
+    std::snprintf(buffer, sizeof(buffer), "Draw calls %d  Triangles %d",
+                  last ? last->drawCalls : 0, last ? last->triangles : 0);
+    AppendLine(buffer, x, y, textColor);
+
+    std::snprintf(buffer, sizeof(buffer), "Overlay %.3f ms (budget %.3f)", m_costMs, COST_BUDGET_MS);
+    AppendLine(buffer, x, y, m_costMs > COST_BUDGET_MS ? glm::vec4(1.0f, 0.4f, 0.3f, 1.0f) : textColor);
+
+    // The background is sized to the content, so it goes in front of it afterwards
+    std::vector<CustomGUI::UIVertex> background;
+    UIBatch::AppendRect(background, atlas, glm::vec2(PANEL_X, PANEL_Y),
+                        glm::vec2(PANEL_WIDTH, y + PADDING - PANEL_Y), glm::vec4(0.05f, 0.05f, 0.08f, 0.75f));
+    m_panelVertices.insert(m_panelVertices.begin(), background.begin(), background.end());
+}
+
+void PerformanceOverlay::RebuildGraph(const PerformanceProfiler& profiler) {
+    m_graphVertices.clear();
+
+    glm::vec2 white = m_batch.GetAtlas()->GetWhiteUV();
+    float targetMs = m_graphRangeMs * 0.5f;
+    float barWidth = (PANEL_WIDTH - 2.0f * PADDING) / GRAPH_SAMPLES;
+    float bottom = m_graphTop + GRAPH_HEIGHT;
+
+    // Newest frame on the right edge
+    size_t frames = profiler.GetHistorySize();
+    size_t samples = std::min<size_t>(frames, GRAPH_SAMPLES);
+    float x = PANEL_X + PADDING + (GRAPH_SAMPLES - samples) * barWidth;
+
+    for (size_t i = frames - samples; i < frames; ++i) {
+        float frameTime = profiler.GetHistoryFrame(i).frameTime;
+        float barHeight = std::min(frameTime / m_graphRangeMs, 1.0f) * GRAPH_HEIGHT;
+
+        glm::vec4 color(0.3f, 0.85f, 0.35f, 0.9f);
+        if (frameTime > m_graphRangeMs) {
+            color = glm::vec4(0.95f, 0.25f, 0.2f, 0.9f);
+        } else if (frameTime > targetMs * 1.05f) {
+            color = glm::vec4(0.95f, 0.8f, 0.2f, 0.9f);
+        }
+
+        UIBatch::AppendQuad(m_graphVertices, x, bottom - barHeight, x + barWidth, bottom, white, white, color);
+        x += barWidth;
+    }
+}
+
+void PerformanceOverlay::AppendStackedBar(const std::vector<Segment>& segments, float x, float y) {
+    const CustomGUI::GlyphAtlas& atlas = *m_batch.GetAtlas();
+    float width = PANEL_X + PANEL_WIDTH - PADDING - x;
+    float end = x + width;
+
+    UIBatch::AppendRect(m_panelVertices, atlas, glm::vec2(x, y), glm::vec2(width, BAR_HEIGHT),
+                        glm::vec4(0.0f, 0.0f, 0.0f, 0.35f));
+
+    for (const auto& segment : segments) {
+        if (!segment.stacked || x >= end) {
+            continue;
+        }
+        float segmentWidth = std::min(segment.timeMs / m_graphRangeMs * width, end - x);
+        UIBatch::AppendRect(m_panelVertices, atlas, glm::vec2(x, y), glm::vec2(segmentWidth, BAR_HEIGHT), segment.color);
+        x += segmentWidth;
+    }
+
+    // Target frame time marker at the middle of the bar
+    UIBatch::AppendRect(m_panelVertices, atlas, glm::vec2(end - width * 0.5f, y - 1.0f), glm::vec2(1.0f, BAR_HEIGHT + 2.0f),
+                        glm::vec4(1.0f, 1.0f, 1.0f, 0.6f));
+}
+
+void PerformanceOverlay::AppendLine(const std::string& text, float x, float& y, const glm::vec4& color) {
+    UIBatch::AppendText(m_panelVertices, *m_batch.GetAtlas(), text, x, y, TEXT_SCALE, color);
+    y += LINE_HEIGHT;
+}
+
+glm::vec4 PerformanceOverlay::GetSegmentColor(size_t index) {
+    static const glm::vec4 palette[] = {
+        glm::vec4(0.35f, 0.65f, 1.0f, 1.0f),
+        glm::vec4(1.0f, 0.6f, 0.2f, 1.0f),
+        glm::vec4(0.45f, 0.9f, 0.45f, 1.0f),
+        glm::vec4(0.9f, 0.4f, 0.85f, 1.0f),
+        glm::vec4(1.0f, 0.9f, 0.3f, 1.0f),
+        glm::vec4(0.3f, 0.9f, 0.9f, 1.0f),
+        glm::vec4(0.95f, 0.35f, 0.35f, 1.0f)
+    };
+    return palette[index % (sizeof(palette) / sizeof(palette[0]))];
+}
+
+std::string PerformanceOverlay::FormatBytes(size_t bytes) {
+    char buffer[32];
+    if (bytes >= 1024 * 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+    } else if (bytes >= 1024) {
+        std::snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%zu B", bytes);
+    }
+    return buffer;
+}
@@ -0,0 +1,92 @@
+﻿/**
+ * @file PerformanceOverlay.h
+ * @brief On-screen performance overlay drawn through the GUI batcher
+ *
+ * Shows, in a corner panel:
+ * - A rolling frame-time graph read from the profiler's history ring
+ * - Stacked CPU section and GPU pass bars with a legend
+ * - Counters (chunks, physics actors, queue depths) and memory figures
+ *   reported to the profiler by other systems
+ * - The overlay's own CPU cost
+ *
+ * Everything is submitted to a private CustomGUI::UIBatch and drawn with a
+ * single glDrawElements. Text and bars are rebuilt a few times per second;
+ * only the graph is regenerated every frame.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "CustomGUI/UIBatch.h"
+#include "PerformanceProfiler.h"
+
+/**
+ * @brief Frame-time graph and timing breakdown panel
+ *
+ * Call Render() at the end of the GUI pass while the overlay is enabled.
+ */
+class PerformanceOverlay {
+public:
+    PerformanceOverlay();
+    ~PerformanceOverlay();
+
+    bool Initialize();
+    void Shutdown();
+
+    /**
+     * @brief Draw the overlay into the current framebuffer
+     * @param width Viewport width in pixels
+     * @param height Viewport height in pixels
+     */
+    void Render(int width, int height);
+
+    /**
+     * @brief Smoothed CPU time spent building and submitting the overlay
+     */
+    float GetCostMs() const { return m_costMs; }
+
+private:
+    struct Segment {
+        std::string name;
+        float timeMs;
+        glm::vec4 color;
+        bool stacked;       // Part of the bar; nested sections are listed only
+    };
+
+    void RebuildPanel(const PerformanceProfiler& profiler);
+    void RebuildGraph(const PerformanceProfiler& profiler);
+    void AppendStackedBar(const std::vector<Segment>& segments, float x, float y);
+    void AppendLine(const std::string& text, float x, float& y, const glm::vec4& color);
+
+    static glm::vec4 GetSegmentColor(size_t index);
+    static std::string FormatBytes(size_t bytes);
+
+    CustomGUI::UIBatch m_batch;
+    std::vector<CustomGUI::UIVertex> m_panelVertices;   // Background, text and bars
+    std::vector<CustomGUI::UIVertex> m_graphVertices;   // Frame-time graph, rebuilt every frame
+    std::vector<Segment> m_cpuSegments;
+    std::vector<Segment> m_gpuSegments;
+
+    std::chrono::high_resolution_clock::time_point m_lastRebuild;
+    float m_graphTop;
+    float m_graphRangeMs;   // Frame time at the top of the graph and the end of the bars
+    float m_costMs;
+    bool m_initialized;
+
+    static constexpr float PANEL_X = 10.0f;
+    static constexpr float PANEL_Y = 10.0f;
+    static constexpr float PANEL_WIDTH = 360.0f;
+    static constexpr float PADDING = 8.0f;
+    static constexpr float TEXT_SCALE = 1.0f;
+    static constexpr float LINE_HEIGHT = 11.0f;
+    static constexpr float LABEL_WIDTH = 32.0f;
+    static constexpr float BAR_HEIGHT = 7.0f;
+    static constexpr float GRAPH_HEIGHT = 70.0f;
+    static constexpr int GRAPH_SAMPLES = 172;
+    static constexpr float REBUILD_INTERVAL = 0.25f;   // Seconds between text rebuilds
+    static constexpr float COST_BUDGET_MS = 0.1f;
+};
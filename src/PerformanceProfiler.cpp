@@ -26,13 +26,25 @@ void PerformanceProfiler::EndFrame() {
     smoothedFPS = smoothedFPS * (1.0f - fpsAlpha) + currentFrame.fps * fpsAlpha;
     
     
+    // Only outermost sections count, nested ones are already inside them
     currentFrame.cpuTime = 0.0f;
-    for (const auto& [name, timing] : timingSections) {
-        currentFrame.cpuTime += timing.totalTime;
+    for (auto& [name, timing] : timingSections) {
+        timing.frameTime = timing.pendingTime;
+        timing.pendingTime = 0.0f;
+        if (timing.depth == 0) {
+            currentFrame.cpuTime += timing.frameTime;
+        }
     }
     
     
-    currentFrame.gpuTime = CalculateGPUTime();
+    if (gpuSections.empty()) {
+        currentFrame.gpuTime = CalculateGPUTime();
+    } else {
+        currentFrame.gpuTime = 0.0f;
+        for (const auto& [name, time] : gpuSections) {
+            currentFrame.gpuTime += time;
+        }
+    }
     
     
     AddFrameToHistory(currentFrame);
@@ -55,6 +67,7 @@ void PerformanceProfiler::BeginSection(const std::string& sectionName) {
     if (!enableProfiling) return;
     
     auto& section = timingSections[sectionName];
+    section.depth = sectionDepth++;
     section.startTime = std::chrono::high_resolution_clock::now();
 }
 
@@ -63,12 +76,14 @@ void PerformanceProfiler::EndSection(const std::string& sectionName) {
     
     auto endTime = std::chrono::high_resolution_clock::now();
     auto& section = timingSections[sectionName];
+    sectionDepth = std::max(0, sectionDepth - 1);
     
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(endTime - section.startTime);
     float sectionTime = duration.count() / 1000.0f; 
     
     
     section.totalTime += sectionTime;
+    section.pendingTime += sectionTime;
     section.callCount++;
     section.avgTime = section.totalTime / section.callCount;
     section.maxTime = std::max(section.maxTime, sectionTime);
@@ -84,39 +99,48 @@ void PerformanceProfiler::UpdateMemoryUsage(size_t memoryBytes) {
     currentFrame.memoryUsage = memoryBytes;
 }
 
+void PerformanceProfiler::ReportGpuTime(const std::string& name, float milliseconds) {
+    gpuSections[name] = milliseconds;
+}
+
+const PerformanceProfiler::FrameStats& PerformanceProfiler::GetHistoryFrame(size_t index) const {
+    size_t capacity = frameHistory.size();
+    return frameHistory[(historyHead + capacity - historyCount + index) % capacity];
+}
+
 float PerformanceProfiler::GetAverageFPS(int frameCount) const {
-    if (frameHistory.empty()) return 0.0f;
+    if (historyCount == 0) return 0.0f;
     
-    int count = std::min(frameCount, (int)frameHistory.size());
+    int count = std::min(frameCount, (int)historyCount);
     float totalFPS = 0.0f;
     
-    for (int i = frameHistory.size() - count; i < frameHistory.size(); i++) {
-        totalFPS += frameHistory[i].fps;
+    for (size_t i = historyCount - count; i < historyCount; i++) {
+        totalFPS += GetHistoryFrame(i).fps;
     }
     
     return totalFPS / count;
 }
 
 float PerformanceProfiler::GetAverageFrameTime(int frameCount) const {
-    if (frameHistory.empty()) return 0.0f;
+    if (historyCount == 0) return 0.0f;
     
-    int count = std::min(frameCount, (int)frameHistory.size());
+    int count = std::min(frameCount, (int)historyCount);
     float totalTime = 0.0f;
     
-    for (int i = frameHistory.size() - count; i < frameHistory.size(); i++) {
-        totalTime += frameHistory[i].frameTime;
+    for (size_t i = historyCount - count; i < historyCount; i++) {
+        totalTime += GetHistoryFrame(i).frameTime;
     }
     
     return totalTime / count;
 }
 
 bool PerformanceProfiler::IsPerformanceCritical() const {
-    if (frameHistory.size() < 10) return false;
+    if (historyCount < 10) return false;
     
     
     int criticalFrames = 0;
-    for (int i = std::max(0, (int)frameHistory.size() - 10); i < frameHistory.size(); i++) {
-        if (frameHistory[i].frameTime > criticalFrameTime) {
+    for (size_t i = historyCount - 10; i < historyCount; i++) {
+        if (GetHistoryFrame(i).frameTime > criticalFrameTime) {
             criticalFrames++;
         }
     }
@@ -195,8 +219,8 @@ void PerformanceProfiler::ExportToFile(const std::string& filename) const {
     file << "\\n=== Frame History ===\\n";
     file << "Frame,FPS,FrameTime(ms),CPUTime(ms),GPUTime(ms),DrawCalls,Triangles,Memory(MB)\\n";
     
-    for (size_t i = 0; i < frameHistory.size(); i++) {
-        const auto& frame = frameHistory[i];
+    for (size_t i = 0; i < historyCount; i++) {
+        const auto& frame = GetHistoryFrame(i);
         file << i << "," << frame.fps << "," << frame.frameTime << "," 
              << frame.cpuTime << "," << frame.gpuTime << "," 
              << frame.drawCalls << "," << frame.triangles << "," 
@@ -214,8 +238,12 @@ void PerformanceProfiler::PrintRealTimeStats() const {
 }
 
 void PerformanceProfiler::ClearHistory() {
-    frameHistory.clear();
+    historyHead = 0;
+    historyCount = 0;
     timingSections.clear();
+    gpuSections.clear();
+    counters.clear();
+    memoryCounters.clear();
 }
 
 size_t PerformanceProfiler::GetEstimatedMemoryUsage() const {
@@ -236,12 +264,16 @@ float PerformanceProfiler::GetGPULoad() const {
 }
 
 void PerformanceProfiler::AddFrameToHistory(const FrameStats& frame) {
-    frameHistory.push_back(frame);
-    
-    
-    if (frameHistory.size() > maxFrameHistory) {
-        frameHistory.erase(frameHistory.begin());
+    // Fixed-size ring: the oldest frame is overwritten instead of shifting the whole history
+    if (frameHistory.size() != static_cast<size_t>(maxFrameHistory)) {
+        frameHistory.assign(maxFrameHistory, FrameStats{});
+        historyHead = 0;
+        historyCount = 0;
     }
+    
+    frameHistory[historyHead] = frame;
+    historyHead = (historyHead + 1) % frameHistory.size();
+    historyCount = std::min(historyCount + 1, frameHistory.size());
 }
 
 float PerformanceProfiler::CalculateGPUTime() const {
@@ -253,31 +285,6 @@ float PerformanceProfiler::CalculateGPUTime() const {
 }
 
 
-void PerformanceMonitor::RenderOverlay() {
-    auto& profiler = PerformanceProfiler::getInstance();
-    
-    
-    
-    static int frameCounter = 0;
-    frameCounter++;
-    
-    if (frameCounter % 60 == 0) { 
-        std::cout << "\\n[PERFORMANCE OVERLAY]" << std::endl;
-        std::cout << "FPS: " << profiler.GetCurrentFPS() << std::endl;
-        std::cout << "Frame Time: " << profiler.GetCurrentFrameTime() << "ms" << std::endl;
-        std::cout << "GPU Load: " << (profiler.GetGPULoad() * 100) << "%" << std::endl;
-        
-        auto bottlenecks = profiler.GetBottlenecks();
-        if (!bottlenecks.empty()) {
-            std::cout << "Bottlenecks:" << std::endl;
-            for (const auto& bottleneck : bottlenecks) {
-                std::cout << "  - " << bottleneck << std::endl;
-            }
-        }
-        std::cout << std::endl;
-    }
-}
-
 void PerformanceMonitor::LogPerformanceWarnings() {
     auto& profiler = PerformanceProfiler::getInstance();
     
@@ -21,6 +21,7 @@
 #pragma once
 
 #include <chrono>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -72,17 +73,28 @@ public:
         float avgTime = 0.0f;       // Average execution time per call
         float maxTime = 0.0f;       // Maximum recorded execution time
         float minTime = FLT_MAX;    // Minimum recorded execution time
+        float frameTime = 0.0f;     // Time spent in the section during the last completed frame
+        float pendingTime = 0.0f;   // Time accumulated so far in the current frame
+        int depth = 0;              // Nesting level; depth 0 sections partition the frame
     };
 
 private:
     static PerformanceProfiler* instance;  // Singleton instance
     
     // Frame performance tracking
-    std::vector<FrameStats> frameHistory;  // Historical frame performance data
-    FrameStats currentFrame;               // Current frame statistics
+    std::vector<FrameStats> frameHistory;  // Ring buffer of recent frames
+    size_t historyHead = 0;                // Slot the next frame is written to
+    size_t historyCount = 0;               // Valid frames in the ring
+    FrameStats currentFrame = {};          // Current frame statistics
     
     // Custom section timing
     std::unordered_map<std::string, SectionTiming> timingSections;  // Named timing sections
+    int sectionDepth = 0;                                           // Currently open sections
+    
+    // Values reported by other systems for display
+    std::map<std::string, float> gpuSections;      // GPU time per pass in milliseconds
+    std::map<std::string, size_t> counters;        // Queue depths and object counts
+    std::map<std::string, size_t> memoryCounters;  // GPU/CPU memory in bytes
     
     // Configuration settings
     bool enableProfiling = true;        // Master enable/disable switch
@@ -173,6 +185,27 @@ public:
      */
     void UpdateMemoryUsage(size_t memoryBytes);
     
+    /**
+     * @brief Report the GPU time of a render pass
+     * 
+     * When any pass is reported, the frame's gpuTime is their sum instead
+     * of the draw-call estimate.
+     * 
+     * @param name Pass name shown in the overlay
+     * @param milliseconds Latest resolved timer query result
+     */
+    void ReportGpuTime(const std::string& name, float milliseconds);
+    
+    /**
+     * @brief Set a named count such as a queue depth
+     */
+    void SetCounter(const std::string& name, size_t value) { counters[name] = value; }
+    
+    /**
+     * @brief Set a named memory figure in bytes
+     */
+    void SetMemoryCounter(const std::string& name, size_t bytes) { memoryCounters[name] = bytes; }
+    
     // Performance query methods
     /**
      * @brief Get average FPS over specified number of frames
@@ -202,6 +235,24 @@ public:
      */
     float GetCurrentFrameTime() const { return currentFrame.frameTime; }
     
+    /**
+     * @brief Number of frames held in the history ring
+     */
+    size_t GetHistorySize() const { return historyCount; }
+    
+    /**
+     * @brief Frame from the history ring
+     * @param index 0 is the oldest frame, GetHistorySize() - 1 the newest
+     */
+    const FrameStats& GetHistoryFrame(size_t index) const;
+    
+    const std::unordered_map<std::string, SectionTiming>& GetSectionTimings() const { return timingSections; }
+    const std::map<std::string, float>& GetGpuSections() const { return gpuSections; }
+    const std::map<std::string, size_t>& GetCounters() const { return counters; }
+    const std::map<std::string, size_t>& GetMemoryCounters() const { return memoryCounters; }
+    float GetSmoothedFPS() const { return smoothedFPS; }
+    float GetTargetFPS() const { return targetFPS; }
+    
     // Performance analysis methods
     /**
      * @brief Check if performance is currently critical
@@ -318,7 +369,6 @@ public:
 
 class PerformanceMonitor {
 public:
-    static void RenderOverlay();
     static void LogPerformanceWarnings();
     static void CheckPerformanceThresholds();
 };
@@ -182,6 +182,13 @@ float PhysicsManager::GetGroundHeight(const glm::vec3& position) {
     return -0.1f; 
 }
 
+size_t PhysicsManager::GetActorCount() const {
+    if (!m_scene) {
+        return 0;
+    }
+    return m_scene->getNbActors(PxActorTypeFlag::eRIGID_STATIC | PxActorTypeFlag::eRIGID_DYNAMIC);
+}
+
 void PhysicsManager::CreateTerrainCollision(const std::vector<glm::vec3>& vertices, const std::vector<unsigned int>& indices) {
     if (vertices.empty() || indices.empty()) {
         std::cout << "Warning: Empty terrain data provided for collision creation" << std::endl;
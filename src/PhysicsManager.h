@@ -176,6 +176,11 @@ public:
      */
     float GetGroundHeight(const glm::vec3& position);
     
+    /**
+     * @brief Number of rigid actors in the scene
+     */
+    size_t GetActorCount() const;
+    
     /**
      * @brief Access to core PhysX objects
      * 
@@ -1,7 +1,9 @@
 ﻿#include "PostProcessing.h"
 #include "Shader.h"
 #include <iostream>
+#include <iomanip>
 #include <chrono>
+#include <algorithm>
 
 
 FramebufferManager::FramebufferManager() : m_currentBuffer(0) {
@@ -12,116 +14,67 @@ FramebufferManager::~FramebufferManager() {
 }
 
 bool FramebufferManager::Initialize(int width, int height) {
-    
-    if (!CreateFramebuffer(m_sceneBuffer, width, height, true)) {
-        std::cerr << "Failed to create scene framebuffer" << std::endl;
+    if (width <= 0 || height <= 0) {
+        std::cerr << "Invalid framebuffer size " << width << "x" << height << std::endl;
         return false;
     }
 
+    Cleanup();
+    
+    m_sceneBuffer.width = width;
+    m_sceneBuffer.height = height;
+
     
     for (int i = 0; i < 2; ++i) {
-        if (!CreateFramebuffer(m_postProcessBuffer[i], width, height, false)) {
-            std::cerr << "Failed to create post-process framebuffer " << i << std::endl;
-            return false;
-        }
+        m_postProcessBuffer[i].width = width;
+        m_postProcessBuffer[i].height = height;
     }
 
     
     int bloomWidth = width / 2;
     int bloomHeight = height / 2;
-    for (int i = 0; i < 4; ++i) {
-        if (!CreateFramebuffer(m_bloomBuffer[i], bloomWidth, bloomHeight, false)) {
-            std::cerr << "Failed to create bloom framebuffer " << i << std::endl;
-            return false;
-        }
+    for (int i = 0; i < BLOOM_MIP_COUNT; ++i) {
+        m_bloomBuffer[i].width = std::max(bloomWidth, 1);
+        m_bloomBuffer[i].height = std::max(bloomHeight, 1);
         bloomWidth /= 2;
         bloomHeight /= 2;
     }
 
-    std::cout << "FramebufferManager initialized successfully" << std::endl;
     return true;
 }
 
-bool FramebufferManager::CreateFramebuffer(FramebufferData& fb, int width, int height, bool needsNormal) {
-    fb.width = width;
-    fb.height = height;
-
-    
-    glGenFramebuffers(1, &fb.fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, fb.fbo);
-
-    
-    glGenTextures(1, &fb.colorTexture);
-    glBindTexture(GL_TEXTURE_2D, fb.colorTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, fb.colorTexture, 0);
-
-    
-    glGenTextures(1, &fb.depthTexture);
-    glBindTexture(GL_TEXTURE_2D, fb.depthTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, fb.depthTexture, 0);
-
-    
-    if (needsNormal) {
-        glGenTextures(1, &fb.normalTexture);
-        glBindTexture(GL_TEXTURE_2D, fb.normalTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, fb.normalTexture, 0);
-
-        
-        GLenum drawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
-        glDrawBuffers(2, drawBuffers);
+void FramebufferManager::Cleanup() {
+    // The render graph owns every texture and framebuffer, only drop the references
+    m_sceneBuffer.fbo = 0;
+    m_sceneBuffer.colorTexture = 0;
+    m_sceneBuffer.depthTexture = 0;
+    for (int i = 0; i < 2; ++i) {
+        m_postProcessBuffer[i].fbo = 0;
+        m_postProcessBuffer[i].colorTexture = 0;
     }
-
-    
-    if (!CheckFramebufferComplete(fb.fbo)) {
-        DeleteFramebuffer(fb);
-        return false;
+    for (int i = 0; i < BLOOM_MIP_COUNT; ++i) {
+        m_bloomBuffer[i].fbo = 0;
+        m_bloomBuffer[i].colorTexture = 0;
     }
+}
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    return true;
+void FramebufferManager::SetSceneTarget(GLuint fbo, GLuint colorTexture, GLuint depthTexture) {
+    m_sceneBuffer.fbo = fbo;
+    m_sceneBuffer.colorTexture = colorTexture;
+    m_sceneBuffer.depthTexture = depthTexture;
 }
 
-void FramebufferManager::DeleteFramebuffer(FramebufferData& fb) {
-    if (fb.fbo) {
-        glDeleteFramebuffers(1, &fb.fbo);
-        fb.fbo = 0;
-    }
-    if (fb.colorTexture) {
-        glDeleteTextures(1, &fb.colorTexture);
-        fb.colorTexture = 0;
-    }
-    if (fb.depthTexture) {
-        glDeleteTextures(1, &fb.depthTexture);
-        fb.depthTexture = 0;
-    }
-    if (fb.normalTexture) {
-        glDeleteTextures(1, &fb.normalTexture);
-        fb.normalTexture = 0;
+void FramebufferManager::SetPostProcessTarget(int index, GLuint fbo, GLuint colorTexture) {
+    if (index >= 0 && index < 2) {
+        m_postProcessBuffer[index].fbo = fbo;
+        m_postProcessBuffer[index].colorTexture = colorTexture;
     }
 }
 
-void FramebufferManager::Cleanup() {
-    DeleteFramebuffer(m_sceneBuffer);
-    for (int i = 0; i < 2; ++i) {
-        DeleteFramebuffer(m_postProcessBuffer[i]);
-    }
-    for (int i = 0; i < 4; ++i) {
-        DeleteFramebuffer(m_bloomBuffer[i]);
+void FramebufferManager::SetBloomTarget(int level, GLuint fbo, GLuint colorTexture) {
+    if (level >= 0 && level < BLOOM_MIP_COUNT) {
+        m_bloomBuffer[level].fbo = fbo;
+        m_bloomBuffer[level].colorTexture = colorTexture;
     }
 }
 
@@ -150,12 +103,33 @@ GLuint FramebufferManager::GetPostProcessTexture(int index) const {
 }
 
 GLuint FramebufferManager::GetBloomTexture(int level) const {
-    if (level >= 0 && level < 4) {
+    if (level >= 0 && level < BLOOM_MIP_COUNT) {
         return m_bloomBuffer[level].colorTexture;
     }
     return 0;
 }
 
+void FramebufferManager::BindBloomFramebuffer(int level) {
+    if (level >= 0 && level < BLOOM_MIP_COUNT) {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_bloomBuffer[level].fbo);
+        glViewport(0, 0, m_bloomBuffer[level].width, m_bloomBuffer[level].height);
+    }
+}
+
+GLuint FramebufferManager::GetPostProcessFramebuffer(int index) const {
+    if (index >= 0 && index < 2) {
+        return m_postProcessBuffer[index].fbo;
+    }
+    return 0;
+}
+
+glm::ivec2 FramebufferManager::GetBloomSize(int level) const {
+    if (level >= 0 && level < BLOOM_MIP_COUNT) {
+        return glm::ivec2(m_bloomBuffer[level].width, m_bloomBuffer[level].height);
+    }
+    return glm::ivec2(0);
+}
+
 bool FramebufferManager::CheckFramebufferComplete(GLuint fbo) const {
     glBindFramebuffer(GL_FRAMEBUFFER, fbo);
     GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
@@ -181,9 +155,6 @@ bool FramebufferManager::CheckFramebufferComplete(GLuint fbo) const {
 }
 
 void FramebufferManager::ResizeFramebuffers(int width, int height) {
-    
-    Cleanup();
-    
     Initialize(width, height);
 }
 
@@ -221,19 +192,29 @@ void ToneMappingEffect::Apply(GLuint inputTexture, GLuint outputFBO, int width,
     
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, inputTexture);
+    
+    DrawFullscreenQuad();
 }
 
 
 BloomEffect::BloomEffect(FramebufferManager* fbManager) 
-    : m_fbManager(fbManager), m_threshold(1.0f), m_blurPasses(5) {
+    : m_threshold(1.0f), m_softKnee(0.5f), m_mipLevels(FramebufferManager::BLOOM_MIP_COUNT),
+      m_karisAverage(false), m_fbManager(fbManager) {
+    m_intensity = 0.3f;
+}
+
+void BloomEffect::SetMipLevels(int levels) {
+    m_mipLevels = std::max(1, std::min(levels, FramebufferManager::BLOOM_MIP_COUNT));
 }
 
 bool BloomEffect::Initialize() {
     try {
         m_brightFilterShader = std::make_unique<Shader>("resources/shaders/postprocess/fullscreen.vert", 
                                                         "resources/shaders/postprocess/bright_filter.frag");
-        m_blurShader = std::make_unique<Shader>("resources/shaders/postprocess/fullscreen.vert", 
-                                               "resources/shaders/postprocess/gaussian_blur.frag");
+        m_downsampleShader = std::make_unique<Shader>("resources/shaders/postprocess/fullscreen.vert", 
+                                                      "resources/shaders/postprocess/bloom_downsample.frag");
+        m_upsampleShader = std::make_unique<Shader>("resources/shaders/postprocess/fullscreen.vert", 
+                                                    "resources/shaders/postprocess/bloom_upsample.frag");
         m_combineShader = std::make_unique<Shader>("resources/shaders/postprocess/fullscreen.vert", 
                                                   "resources/shaders/postprocess/bloom_combine.frag");
         std::cout << "BloomEffect initialized successfully" << std::endl;
@@ -245,15 +226,47 @@ bool BloomEffect::Initialize() {
 }
 
 void BloomEffect::Apply(GLuint inputTexture, GLuint outputFBO, int width, int height) {
-    if (!m_enabled || !m_brightFilterShader || !m_blurShader || !m_combineShader) return;
+    if (!m_enabled || !m_brightFilterShader || !m_downsampleShader || !m_upsampleShader || !m_combineShader) return;
 
     glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glActiveTexture(GL_TEXTURE0);
     
+    // Bright-pass prefilter fused with the first downsample (full res -> mip 0)
+    m_fbManager->BindBloomFramebuffer(0);
+    m_brightFilterShader->Use();
+    m_brightFilterShader->SetInt("sourceTexture", 0);
+    m_brightFilterShader->SetVec2("sourceTexelSize", glm::vec2(1.0f / width, 1.0f / height));
+    m_brightFilterShader->SetFloat("threshold", m_threshold);
+    m_brightFilterShader->SetFloat("softKnee", m_softKnee);
+    m_brightFilterShader->SetBool("useKarisAverage", m_karisAverage);
+    glBindTexture(GL_TEXTURE_2D, inputTexture);
+    DrawFullscreenQuad();
     
     
+    m_downsampleShader->Use();
+    m_downsampleShader->SetInt("sourceTexture", 0);
+    for (int level = 1; level < m_mipLevels; ++level) {
+        glm::ivec2 sourceSize = m_fbManager->GetBloomSize(level - 1);
+        m_fbManager->BindBloomFramebuffer(level);
+        m_downsampleShader->SetVec2("sourceTexelSize", 1.0f / glm::vec2(sourceSize));
+        glBindTexture(GL_TEXTURE_2D, m_fbManager->GetBloomTexture(level - 1));
+        DrawFullscreenQuad();
+    }
     
-    
-    
+    // Walk back up, accumulating each level into the next larger one
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE);
+    m_upsampleShader->Use();
+    m_upsampleShader->SetInt("sourceTexture", 0);
+    for (int level = m_mipLevels - 1; level > 0; --level) {
+        glm::ivec2 sourceSize = m_fbManager->GetBloomSize(level);
+        m_fbManager->BindBloomFramebuffer(level - 1);
+        m_upsampleShader->SetVec2("sourceTexelSize", 1.0f / glm::vec2(sourceSize));
+        glBindTexture(GL_TEXTURE_2D, m_fbManager->GetBloomTexture(level));
+        DrawFullscreenQuad();
+    }
+    glDisable(GL_BLEND);
     
     
     glBindFramebuffer(GL_FRAMEBUFFER, outputFBO);
@@ -262,10 +275,14 @@ void BloomEffect::Apply(GLuint inputTexture, GLuint outputFBO, int width, int he
     m_combineShader->Use();
     m_combineShader->SetInt("sceneTexture", 0);
     m_combineShader->SetInt("bloomTexture", 1);
-    m_combineShader->SetFloat("bloomIntensity", m_intensity);
+    m_combineShader->SetFloat("bloomIntensity", m_intensity / static_cast<float>(m_mipLevels));
     
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, inputTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, m_fbManager->GetBloomTexture(0));
+    DrawFullscreenQuad();
+    glActiveTexture(GL_TEXTURE0);
 }
 
 
@@ -304,13 +321,23 @@ void FXAAEffect::Apply(GLuint inputTexture, GLuint outputFBO, int width, int hei
     
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, inputTexture);
+    
+    DrawFullscreenQuad();
 }
 
 
 PostProcessManager::PostProcessManager() 
     : m_quality(PostProcessQuality::BASIC), m_enabled(true), 
       m_quadVAO(0), m_quadVBO(0), m_postProcessTime(0.0f),
-      m_frameWidth(0), m_frameHeight(0) {
+      m_frameWidth(0), m_frameHeight(0), m_timerFrame(0),
+      m_sceneColor(RenderGraph::INVALID_RESOURCE), m_sceneDepth(RenderGraph::INVALID_RESOURCE) {
+    for (auto& timer : m_timers) {
+        for (int i = 0; i < TIMER_FRAMES; ++i) {
+            timer.queries[i] = 0;
+            timer.pending[i] = false;
+        }
+        timer.timeMs = 0.0f;
+    }
 }
 
 PostProcessManager::~PostProcessManager() {
@@ -330,6 +357,7 @@ bool PostProcessManager::Initialize(int width, int height) {
 
     
     CreateFullscreenQuad();
+    CreateTimers();
 
     
     m_toneMappingEffect = std::make_unique<ToneMappingEffect>();
@@ -350,10 +378,78 @@ bool PostProcessManager::Initialize(int width, int height) {
         return false;
     }
 
+    m_toneMappingEffect->SetFullscreenQuad(m_quadVAO);
+    m_bloomEffect->SetFullscreenQuad(m_quadVAO);
+    m_fxaaEffect->SetFullscreenQuad(m_quadVAO);
+    
+    // Re-apply the tier so effect toggles match the current quality
+    SetQuality(m_quality);
+
     std::cout << "PostProcessManager initialized successfully" << std::endl;
     return true;
 }
 
+void PostProcessManager::CreateTimers() {
+    for (auto& timer : m_timers) {
+        glGenQueries(TIMER_FRAMES, timer.queries);
+    }
+}
+
+void PostProcessManager::DeleteTimers() {
+    for (auto& timer : m_timers) {
+        if (timer.queries[0] != 0) {
+            glDeleteQueries(TIMER_FRAMES, timer.queries);
+        }
+        for (int i = 0; i < TIMER_FRAMES; ++i) {
+            timer.queries[i] = 0;
+            timer.pending[i] = false;
+        }
+    }
+}
+
+void PostProcessManager::ResolveTimers() {
+    // Slot about to be reused was issued TIMER_FRAMES - 1 frames ago
+    for (auto& timer : m_timers) {
+        if (!timer.pending[m_timerFrame]) {
+            timer.timeMs = 0.0f;
+            continue;
+        }
+        
+        GLint available = 0;
+        glGetQueryObjectiv(timer.queries[m_timerFrame], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(timer.queries[m_timerFrame], GL_QUERY_RESULT, &elapsed);
+            timer.timeMs = static_cast<float>(elapsed / 1.0e6);
+        }
+        timer.pending[m_timerFrame] = false;
+    }
+}
+
+void PostProcessManager::BeginTimer(TimedEffect effect) {
+    GpuTimer& timer = m_timers[static_cast<int>(effect)];
+    glBeginQuery(GL_TIME_ELAPSED, timer.queries[m_timerFrame]);
+}
+
+void PostProcessManager::EndTimer(TimedEffect effect) {
+    glEndQuery(GL_TIME_ELAPSED);
+    m_timers[static_cast<int>(effect)].pending[m_timerFrame] = true;
+}
+
+void PostProcessManager::LogEffectTimings() const {
+    static int frameCounter = 0;
+    if (++frameCounter % 60 != 0) {
+        return;
+    }
+    
+    std::cout << "[PostProcess] " << GetQualityName(m_quality) << std::fixed << std::setprecision(3)
+              << " | Bloom: " << GetEffectGpuTime(TimedEffect::BLOOM) << "ms"
+              << " | ToneMapping: " << GetEffectGpuTime(TimedEffect::TONE_MAPPING) << "ms"
+              << " | FXAA: " << GetEffectGpuTime(TimedEffect::FXAA) << "ms"
+              << " | CPU: " << m_postProcessTime << "ms" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
 void PostProcessManager::CreateFullscreenQuad() {
     float quadVertices[] = {
         
@@ -384,79 +480,145 @@ void PostProcessManager::RenderFullscreenQuad() {
     glBindVertexArray(0);
 }
 
-void PostProcessManager::BeginSceneRender() {
-    if (!m_enabled || !m_fbManager) return;
-    m_fbManager->BindSceneFramebuffer();
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-}
-
-void PostProcessManager::EndSceneRender() {
-    if (!m_enabled || !m_fbManager) return;
-    m_fbManager->BindDefaultFramebuffer();
-}
-
-void PostProcessManager::ApplyPostProcessing() {
-    if (!m_enabled || m_quality == PostProcessQuality::DISABLED) {
-        
-        
+void PostProcessManager::AddScenePass(RenderGraph& graph, RenderGraph::ResourceHandle shadowMap,
+                                      std::function<void()> renderScene) {
+    m_sceneColor = graph.CreateTexture("SceneColor", { m_frameWidth, m_frameHeight, GL_RGBA16F });
+    m_sceneDepth = graph.CreateTexture("SceneDepth", { m_frameWidth, m_frameHeight, GL_DEPTH_COMPONENT24 });
+    
+    RenderGraph::ResourceHandle sceneColor = m_sceneColor;
+    RenderGraph::ResourceHandle sceneDepth = m_sceneDepth;
+    graph.AddPass("Scene", { shadowMap }, { sceneColor, sceneDepth },
+        [this, &graph, sceneColor, sceneDepth, renderScene]() {
+            m_fbManager->SetSceneTarget(graph.GetFramebuffer({ sceneColor }, sceneDepth),
+                                        graph.GetTexture(sceneColor), graph.GetTexture(sceneDepth));
+            m_fbManager->BindSceneFramebuffer();
+            glEnable(GL_DEPTH_TEST);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            
+            renderScene();
+            
+            m_fbManager->BindDefaultFramebuffer();
+            glViewport(0, 0, m_frameWidth, m_frameHeight);
+        });
+}
+
+void PostProcessManager::AddPostProcessPasses(RenderGraph& graph, RenderGraph::ResourceHandle output) {
+    if (!IsActive() || m_sceneColor == RenderGraph::INVALID_RESOURCE) {
         return;
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
-
-    GLuint currentTexture = m_fbManager->GetSceneColorTexture();
-    int currentBuffer = 0;
-
+    // Effects ping-pong through transient targets; the last one writes the output
+    const bool runBloom = m_bloomEffect->IsEnabled();
+    const bool runFXAA = m_fxaaEffect->IsEnabled();
     
-    switch (m_quality) {
-    case PostProcessQuality::BASIC:
-        
-        glBindFramebuffer(GL_FRAMEBUFFER, 0); 
-        glViewport(0, 0, m_frameWidth, m_frameHeight);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        m_toneMappingEffect->Apply(currentTexture, 0, m_frameWidth, m_frameHeight);
-        RenderFullscreenQuad();
-        break;
-
-    case PostProcessQuality::ADVANCED:
-        
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(0, 0, m_frameWidth, m_frameHeight);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        
-        m_toneMappingEffect->Apply(currentTexture, 0, m_frameWidth, m_frameHeight);
-        RenderFullscreenQuad();
-        break;
-
-    case PostProcessQuality::ULTRA:
-        
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glViewport(0, 0, m_frameWidth, m_frameHeight);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    RenderGraph::ResourceHandle current = m_sceneColor;
+    
+    if (runBloom) {
+        std::vector<RenderGraph::ResourceHandle> writes;
+        std::vector<RenderGraph::ResourceHandle> mips;
+        for (int level = 0; level < m_bloomEffect->GetMipLevels(); ++level) {
+            glm::ivec2 size = m_fbManager->GetBloomSize(level);
+            mips.push_back(graph.CreateTexture("BloomMip" + std::to_string(level), { size.x, size.y, GL_RGBA16F }));
+            writes.push_back(mips.back());
+        }
+        RenderGraph::ResourceHandle bloomOutput = graph.CreateTexture("BloomComposite", { m_frameWidth, m_frameHeight, GL_RGBA16F });
+        writes.push_back(bloomOutput);
         
-        m_toneMappingEffect->Apply(currentTexture, 0, m_frameWidth, m_frameHeight);
-        RenderFullscreenQuad();
-        break;
+        RenderGraph::ResourceHandle input = current;
+        graph.AddPass("Bloom", { input }, writes, [this, &graph, input, mips, bloomOutput]() {
+            m_postProcessStart = std::chrono::high_resolution_clock::now();
+            ResolveTimers();
+            
+            for (int level = 0; level < static_cast<int>(mips.size()); ++level) {
+                m_fbManager->SetBloomTarget(level, graph.GetFramebuffer({ mips[level] }), graph.GetTexture(mips[level]));
+            }
+            GLuint outputFBO = graph.GetFramebuffer({ bloomOutput });
+            m_fbManager->SetPostProcessTarget(0, outputFBO, graph.GetTexture(bloomOutput));
+            
+            BeginTimer(TimedEffect::BLOOM);
+            m_bloomEffect->Apply(graph.GetTexture(input), outputFBO, m_frameWidth, m_frameHeight);
+            EndTimer(TimedEffect::BLOOM);
+        });
+        current = bloomOutput;
     }
+    
+    RenderGraph::ResourceHandle toneMapOutput = output;
+    if (runFXAA) {
+        // Scene colour is dead by now, so this aliases its texture
+        toneMapOutput = graph.CreateTexture("ToneMapped", { m_frameWidth, m_frameHeight, GL_RGBA16F });
+    }
+    
+    RenderGraph::ResourceHandle toneMapInput = current;
+    graph.AddPass("ToneMapping", { toneMapInput }, { toneMapOutput },
+        [this, &graph, runBloom, runFXAA, toneMapInput, toneMapOutput]() {
+            if (!runBloom) {
+                m_postProcessStart = std::chrono::high_resolution_clock::now();
+                ResolveTimers();
+            }
+            
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_BLEND);
+            BeginTimer(TimedEffect::TONE_MAPPING);
+            m_toneMappingEffect->Apply(graph.GetTexture(toneMapInput), graph.GetFramebuffer({ toneMapOutput }),
+                                       m_frameWidth, m_frameHeight);
+            EndTimer(TimedEffect::TONE_MAPPING);
+            
+            if (!runFXAA) {
+                FinishFrame();
+            }
+        });
+    
+    if (runFXAA) {
+        graph.AddPass("FXAA", { toneMapOutput }, { output }, [this, &graph, toneMapOutput, output]() {
+            BeginTimer(TimedEffect::FXAA);
+            m_fxaaEffect->Apply(graph.GetTexture(toneMapOutput), graph.GetFramebuffer({ output }),
+                                m_frameWidth, m_frameHeight);
+            EndTimer(TimedEffect::FXAA);
+            
+            FinishFrame();
+        });
+    }
+    
+    m_sceneColor = RenderGraph::INVALID_RESOURCE;
+    m_sceneDepth = RenderGraph::INVALID_RESOURCE;
+}
 
+void PostProcessManager::FinishFrame() {
+    m_timerFrame = (m_timerFrame + 1) % TIMER_FRAMES;
+    glEnable(GL_DEPTH_TEST);
+    
     auto end = std::chrono::high_resolution_clock::now();
-    m_postProcessTime = std::chrono::duration<float, std::milli>(end - start).count();
+    m_postProcessTime = std::chrono::duration<float, std::milli>(end - m_postProcessStart).count();
 }
 
 void PostProcessManager::SetQuality(PostProcessQuality quality) {
     m_quality = quality;
-    std::cout << "Post-Processing Quality: ";
+    
+    // Each tier adds cost on top of the previous one
+    if (m_bloomEffect) {
+        m_bloomEffect->SetEnabled(quality == PostProcessQuality::ADVANCED || quality == PostProcessQuality::ULTRA);
+        m_bloomEffect->SetMipLevels(quality == PostProcessQuality::ULTRA ? FramebufferManager::BLOOM_MIP_COUNT : 3);
+        m_bloomEffect->SetKarisAverage(quality == PostProcessQuality::ULTRA);
+    }
+    if (m_fxaaEffect) {
+        m_fxaaEffect->SetEnabled(quality == PostProcessQuality::ULTRA);
+    }
+    
+    std::cout << "Post-Processing Quality: " << GetQualityName(quality) << std::endl;
+}
+
+const char* PostProcessManager::GetQualityName(PostProcessQuality quality) {
     switch (quality) {
-    case PostProcessQuality::DISABLED: std::cout << "DISABLED"; break;
-    case PostProcessQuality::BASIC: std::cout << "BASIC"; break;
-    case PostProcessQuality::ADVANCED: std::cout << "ADVANCED"; break;
-    case PostProcessQuality::ULTRA: std::cout << "ULTRA"; break;
+    case PostProcessQuality::DISABLED: return "DISABLED";
+    case PostProcessQuality::BASIC: return "BASIC";
+    case PostProcessQuality::ADVANCED: return "ADVANCED";
+    case PostProcessQuality::ULTRA: return "ULTRA";
     }
-    std::cout << std::endl;
+    return "UNKNOWN";
 }
 
 void PostProcessManager::OnWindowResize(int width, int height) {
+    if (width <= 0 || height <= 0) return;
     m_frameWidth = width;
     m_frameHeight = height;
     if (m_fbManager) {
@@ -474,6 +636,7 @@ void PostProcessManager::Cleanup() {
         m_quadVBO = 0;
     }
     
+    DeleteTimers();
     m_fbManager.reset();
     m_toneMappingEffect.reset();
     m_bloomEffect.reset();
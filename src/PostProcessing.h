@@ -23,16 +23,20 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <functional>
+#include <chrono>
+#include "RenderGraph.h"
 
 // Forward declaration to avoid circular includes
 class Shader;
 
 /**
- * @brief Framebuffer management system for multi-pass rendering
+ * @brief Per-frame view of the post-processing render targets
  * 
- * Manages multiple framebuffer objects and their associated textures
- * for complex post-processing pipelines. Handles creation, binding,
- * and cleanup of render targets with proper error checking.
+ * The textures and framebuffers themselves are transient RenderGraph
+ * resources; the passes bind this frame's graph targets here so effects
+ * can keep addressing them as "scene", "ping-pong" and "bloom mip" buffers.
+ * Only the target sizes persist between frames.
  */
 class FramebufferManager {
 public:
@@ -58,7 +62,7 @@ public:
 private:
     FramebufferData m_sceneBuffer;          // Primary scene rendering buffer
     FramebufferData m_postProcessBuffer[2]; // Ping-pong buffers for multi-pass effects
-    FramebufferData m_bloomBuffer[4];       // Bloom effect mip-map chain buffers
+    FramebufferData m_bloomBuffer[4];       // Bloom mip chain, 1/2 down to 1/16 resolution
     int m_currentBuffer;                    // Current active post-process buffer index
 
 public:
@@ -68,24 +72,24 @@ public:
     FramebufferManager();
     
     /**
-     * @brief Destructor - ensures proper cleanup of OpenGL resources
+     * @brief Destructor
      */
     ~FramebufferManager();
 
     /**
-     * @brief Initialize all framebuffers with specified dimensions
+     * @brief Record target dimensions for the given frame size
      * 
-     * Creates and configures all framebuffer objects and their textures.
-     * Must be called after OpenGL context creation.
+     * No GL objects are created here; the render graph allocates the
+     * targets on demand each frame.
      * 
      * @param width Framebuffer width in pixels
      * @param height Framebuffer height in pixels
-     * @return True if initialization successful, false otherwise
+     * @return True if the dimensions are valid
      */
     bool Initialize(int width, int height);
     
     /**
-     * @brief Clean up all OpenGL framebuffer resources
+     * @brief Forget this frame's graph targets
      */
     void Cleanup();
     
@@ -114,6 +118,13 @@ public:
      */
     void BindDefaultFramebuffer();
     
+    /**
+     * @brief Attach this frame's graph targets
+     */
+    void SetSceneTarget(GLuint fbo, GLuint colorTexture, GLuint depthTexture);
+    void SetPostProcessTarget(int index, GLuint fbo, GLuint colorTexture);
+    void SetBloomTarget(int level, GLuint fbo, GLuint colorTexture);
+    
     // Texture accessor methods for shader binding
     /**
      * @brief Get the scene color texture for post-processing
@@ -150,10 +161,37 @@ public:
     GLuint GetBloomTexture(int level) const;
     
     /**
-     * @brief Resize all framebuffers to new dimensions
+     * @brief Bind a bloom mip framebuffer and set its viewport
+     * 
+     * @param level Bloom mip level (0-3)
+     */
+    void BindBloomFramebuffer(int level);
+    
+    /**
+     * @brief Get post-process framebuffer object by index
+     * 
+     * @param index Buffer index (0 or 1)
+     * @return OpenGL framebuffer ID for the specified post-process buffer
+     */
+    GLuint GetPostProcessFramebuffer(int index) const;
+    
+    /**
+     * @brief Get scene target dimensions
+     */
+    glm::ivec2 GetSceneSize() const { return glm::ivec2(m_sceneBuffer.width, m_sceneBuffer.height); }
+    
+    /**
+     * @brief Get bloom mip dimensions
      * 
-     * Recreates all framebuffer textures with new size. Call when
-     * window is resized to maintain proper rendering resolution.
+     * @param level Bloom mip level (0-3)
+     * @return Size in pixels of the bloom buffer
+     */
+    glm::ivec2 GetBloomSize(int level) const;
+    
+    static constexpr int BLOOM_MIP_COUNT = 4;
+    
+    /**
+     * @brief Update target dimensions after a window resize
      * 
      * @param width New framebuffer width
      * @param height New framebuffer height
@@ -169,27 +207,37 @@ public:
      * @return True if framebuffer is complete and ready for use
      */
     bool CheckFramebufferComplete(GLuint fbo) const;
-
-private:
-    bool CreateFramebuffer(FramebufferData& fb, int width, int height, bool needsNormal = false);
-    void DeleteFramebuffer(FramebufferData& fb);
 };
 
 
+/**
+ * @brief Base class for a full-screen post-processing effect
+ * 
+ * Apply() reads inputTexture, renders into outputFBO and issues its own
+ * full-screen draws through the quad shared by the PostProcessManager.
+ */
 class PostProcessEffect {
 protected:
     std::unique_ptr<Shader> m_shader;
     bool m_enabled;
     float m_intensity;
+    GLuint m_quadVAO;
+
+    void DrawFullscreenQuad() const {
+        glBindVertexArray(m_quadVAO);
+        glDrawArrays(GL_TRIANGLES, 0, 6);
+        glBindVertexArray(0);
+    }
 
 public:
-    PostProcessEffect() : m_enabled(true), m_intensity(1.0f) {}
+    PostProcessEffect() : m_enabled(true), m_intensity(1.0f), m_quadVAO(0) {}
     virtual ~PostProcessEffect() = default;
 
     virtual bool Initialize() = 0;
     virtual void Apply(GLuint inputTexture, GLuint outputFBO, int width, int height) = 0;
     virtual void SetParameter(const std::string& name, float value) {}
     
+    void SetFullscreenQuad(GLuint quadVAO) { m_quadVAO = quadVAO; }
     void SetEnabled(bool enabled) { m_enabled = enabled; }
     void SetIntensity(float intensity) { m_intensity = intensity; }
     bool IsEnabled() const { return m_enabled; }
@@ -228,14 +276,25 @@ public:
 };
 
 
+/**
+ * @brief Dual-filter bloom over the FramebufferManager bloom mip chain
+ * 
+ * The bright-pass prefilter downsamples the scene into mip 0, then each
+ * level is downsampled with a 5-tap kernel and the chain is walked back up
+ * with an 8-tap tent, additively blending into the next larger mip. Cost
+ * scales with the number of mip levels and the optional Karis average.
+ */
 class BloomEffect : public PostProcessEffect {
 private:
     std::unique_ptr<Shader> m_brightFilterShader;
-    std::unique_ptr<Shader> m_blurShader;
+    std::unique_ptr<Shader> m_downsampleShader;
+    std::unique_ptr<Shader> m_upsampleShader;
     std::unique_ptr<Shader> m_combineShader;
     
     float m_threshold;
-    int m_blurPasses;
+    float m_softKnee;
+    int m_mipLevels;
+    bool m_karisAverage;    // Luma-weighted prefilter to suppress fireflies
     FramebufferManager* m_fbManager;
 
 public:
@@ -246,10 +305,14 @@ public:
     void Apply(GLuint inputTexture, GLuint outputFBO, int width, int height) override;
     
     void SetThreshold(float threshold) { m_threshold = threshold; }
-    void SetBlurPasses(int passes) { m_blurPasses = passes; }
+    void SetSoftKnee(float softKnee) { m_softKnee = softKnee; }
+    void SetMipLevels(int levels);
+    void SetKarisAverage(bool enabled) { m_karisAverage = enabled; }
     
     float GetThreshold() const { return m_threshold; }
-    int GetBlurPasses() const { return m_blurPasses; }
+    float GetSoftKnee() const { return m_softKnee; }
+    int GetMipLevels() const { return m_mipLevels; }
+    bool GetKarisAverage() const { return m_karisAverage; }
 };
 
 
@@ -276,6 +339,18 @@ public:
 };
 
 
+/**
+ * @brief Declares the HDR scene target and the effect chain as render-graph passes
+ * 
+ * Quality tiers:
+ * - DISABLED: scene renders straight to the default framebuffer
+ * - BASIC:    HDR target + tone mapping (one full-screen pass)
+ * - ADVANCED: + 3-level dual-filter bloom
+ * - ULTRA:    + 4-level bloom with Karis-average prefilter, + FXAA
+ * 
+ * Each effect is timed with GL_TIME_ELAPSED queries that are read back a few
+ * frames later so timing never stalls the pipeline.
+ */
 class PostProcessManager {
 public:
     enum class PostProcessQuality {
@@ -284,6 +359,13 @@ public:
         ADVANCED = 2,
         ULTRA = 3
     };
+    
+    enum class TimedEffect {
+        BLOOM = 0,
+        TONE_MAPPING = 1,
+        FXAA = 2,
+        COUNT = 3
+    };
 
 private:
     std::unique_ptr<FramebufferManager> m_fbManager;
@@ -301,6 +383,21 @@ private:
     
     float m_postProcessTime;
     int m_frameWidth, m_frameHeight;
+    
+    // GPU timers, one query per effect per in-flight frame
+    static constexpr int TIMER_FRAMES = 3;
+    struct GpuTimer {
+        GLuint queries[TIMER_FRAMES];
+        bool pending[TIMER_FRAMES];
+        float timeMs;
+    };
+    GpuTimer m_timers[static_cast<int>(TimedEffect::COUNT)];
+    int m_timerFrame;
+    
+    // This frame's graph resources
+    RenderGraph::ResourceHandle m_sceneColor;
+    RenderGraph::ResourceHandle m_sceneDepth;
+    std::chrono::high_resolution_clock::time_point m_postProcessStart;
 
 public:
     PostProcessManager();
@@ -309,9 +406,25 @@ public:
     bool Initialize(int width, int height);
     void Cleanup();
     
-    void BeginSceneRender();
-    void EndSceneRender();
-    void ApplyPostProcessing();
+    /**
+     * @brief Declare the HDR scene targets and the pass that renders into them
+     * 
+     * @param graph Frame graph being built
+     * @param shadowMap Shadow map sampled by the scene (may be invalid)
+     * @param renderScene Draws the scene; the HDR target is bound and cleared beforehand
+     */
+    void AddScenePass(RenderGraph& graph, RenderGraph::ResourceHandle shadowMap, std::function<void()> renderScene);
+    
+    /**
+     * @brief Declare the effect passes enabled by the current quality tier
+     * 
+     * Must follow AddScenePass. Intermediate targets are transient, so the
+     * ping-pong buffers alias the scene colour once it is no longer read.
+     * 
+     * @param graph Frame graph being built
+     * @param output Final target, normally the imported backbuffer
+     */
+    void AddPostProcessPasses(RenderGraph& graph, RenderGraph::ResourceHandle output);
     
     void SetQuality(PostProcessQuality quality);
     void SetEnabled(bool enabled) { m_enabled = enabled; }
@@ -319,6 +432,18 @@ public:
     PostProcessQuality GetQuality() const { return m_quality; }
     bool IsEnabled() const { return m_enabled; }
     
+    /**
+     * @brief True when the scene should be rendered into the HDR target
+     */
+    bool IsActive() const { return m_enabled && m_quality != PostProcessQuality::DISABLED && m_fbManager; }
+    
+    /**
+     * @brief Depth target declared by the last AddScenePass (invalid before the first)
+     */
+    RenderGraph::ResourceHandle GetSceneDepth() const { return m_sceneDepth; }
+    int GetFrameWidth() const { return m_frameWidth; }
+    int GetFrameHeight() const { return m_frameHeight; }
+    
     
     ToneMappingEffect* GetToneMappingEffect() const { return m_toneMappingEffect.get(); }
     BloomEffect* GetBloomEffect() const { return m_bloomEffect.get(); }
@@ -327,12 +452,28 @@ public:
     
     float GetPostProcessTime() const { return m_postProcessTime; }
     
+    /**
+     * @brief Latest resolved GPU time of one effect (0 when it did not run)
+     */
+    float GetEffectGpuTime(TimedEffect effect) const { return m_timers[static_cast<int>(effect)].timeMs; }
+    
+    /**
+     * @brief Print per-effect GPU times, throttled to once per second of frames
+     */
+    void LogEffectTimings() const;
+    
+    static const char* GetQualityName(PostProcessQuality quality);
+    
     
     void OnWindowResize(int width, int height);
 
 private:
     void CreateFullscreenQuad();
     void RenderFullscreenQuad();
-    GLuint CreateTempFramebuffer(int width, int height);
-    void DeleteTempFramebuffer(GLuint fbo, GLuint texture);
+    void CreateTimers();
+    void DeleteTimers();
+    void ResolveTimers();
+    void BeginTimer(TimedEffect effect);
+    void EndTimer(TimedEffect effect);
+    void FinishFrame();
 };
@@ -0,0 +1,348 @@
+﻿#include "RenderGraph.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+
+
+
+
+RenderGraph::RenderGraph()
+    : m_stats{}
+    , m_lastReportedBytes(0)
+    , m_frameIndex(0)
+    , m_compiled(false)
+{
+}
+
+RenderGraph::~RenderGraph() {
+    Cleanup();
+}
+
+void RenderGraph::BeginFrame() {
+    m_resources.clear();
+    m_passes.clear();
+    m_compiled = false;
+    ++m_frameIndex;
+}
+
+RenderGraph::ResourceHandle RenderGraph::CreateTexture(const std::string& name, const TextureDesc& desc) {
+    Resource resource;
+    resource.name = name;
+    resource.type = ResourceType::TRANSIENT;
+    resource.desc = desc;
+    resource.importedTexture = 0;
+    resource.importedBytes = 0;
+    resource.firstPass = -1;
+    resource.lastPass = -1;
+    resource.physicalIndex = -1;
+    m_resources.push_back(resource);
+    return static_cast<ResourceHandle>(m_resources.size() - 1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::ImportTexture(const std::string& name, GLuint texture, size_t sizeBytes) {
+    Resource resource;
+    resource.name = name;
+    resource.type = ResourceType::IMPORTED;
+    resource.desc = { 0, 0, GL_NONE };
+    resource.importedTexture = texture;
+    resource.importedBytes = sizeBytes;
+    resource.firstPass = -1;
+    resource.lastPass = -1;
+    resource.physicalIndex = -1;
+    m_resources.push_back(resource);
+    return static_cast<ResourceHandle>(m_resources.size() - 1);
+}
+
+RenderGraph::ResourceHandle RenderGraph::ImportBackbuffer(const std::string& name) {
+    ResourceHandle handle = ImportTexture(name, 0, 0);
+    m_resources[handle].type = ResourceType::BACKBUFFER;
+    return handle;
+}
+
+void RenderGraph::AddPass(const std::string& name,
+                          std::initializer_list<ResourceHandle> reads,
+                          std::initializer_list<ResourceHandle> writes,
+                          std::function<void()> execute) {
+    AddPass(name, std::vector<ResourceHandle>(reads), std::vector<ResourceHandle>(writes), std::move(execute));
+}
+
+void RenderGraph::AddPass(const std::string& name,
+                          const std::vector<ResourceHandle>& reads,
+                          const std::vector<ResourceHandle>& writes,
+                          std::function<void()> execute) {
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+
+    for (ResourceHandle handle : reads) {
+        if (handle != INVALID_RESOURCE) {
+            pass.reads.push_back(handle);
+        }
+    }
+    for (ResourceHandle handle : writes) {
+        if (handle != INVALID_RESOURCE) {
+            pass.writes.push_back(handle);
+        }
+    }
+
+    m_passes.push_back(std::move(pass));
+}
+
+void RenderGraph::Compile() {
+    // Lifetimes: first and last pass touching each resource
+    for (int passIndex = 0; passIndex < static_cast<int>(m_passes.size()); ++passIndex) {
+        const Pass& pass = m_passes[passIndex];
+
+        for (ResourceHandle handle : pass.writes) {
+            Resource& resource = m_resources[handle];
+            if (resource.firstPass < 0) {
+                resource.firstPass = passIndex;
+            }
+            resource.lastPass = passIndex;
+        }
+        for (ResourceHandle handle : pass.reads) {
+            Resource& resource = m_resources[handle];
+            if (resource.firstPass < 0) {
+                if (resource.type == ResourceType::TRANSIENT) {
+                    std::cerr << "[RenderGraph] Pass '" << pass.name << "' reads '" << resource.name
+                              << "' before any pass writes it" << std::endl;
+                }
+                resource.firstPass = passIndex;
+            }
+            resource.lastPass = passIndex;
+        }
+    }
+
+    for (auto& pooled : m_pool) {
+        pooled.inUse = false;
+    }
+
+    // Walk the timeline, returning textures to the pool as soon as their last reader ran
+    m_stats = MemoryStats{};
+    m_stats.passes = static_cast<int>(m_passes.size());
+
+    for (int passIndex = 0; passIndex < static_cast<int>(m_passes.size()); ++passIndex) {
+        for (auto& resource : m_resources) {
+            if (resource.type == ResourceType::TRANSIENT && resource.firstPass == passIndex) {
+                resource.physicalIndex = AcquirePooledTexture(resource.desc);
+            }
+        }
+        for (auto& resource : m_resources) {
+            if (resource.type == ResourceType::TRANSIENT && resource.lastPass == passIndex &&
+                resource.physicalIndex >= 0) {
+                m_pool[resource.physicalIndex].inUse = false;
+            }
+        }
+    }
+
+    std::vector<bool> physicalUsed(m_pool.size(), false);
+    for (const auto& resource : m_resources) {
+        if (resource.type == ResourceType::TRANSIENT) {
+            if (resource.physicalIndex < 0) {
+                continue;   // Declared but never used by a pass
+            }
+            m_stats.transientTextures++;
+            m_stats.unaliasedBytes += static_cast<size_t>(resource.desc.width) * resource.desc.height *
+                                      GetBytesPerPixel(resource.desc.internalFormat);
+            if (!physicalUsed[resource.physicalIndex]) {
+                physicalUsed[resource.physicalIndex] = true;
+                m_stats.pooledTextures++;
+                m_stats.pooledBytes += static_cast<size_t>(resource.desc.width) * resource.desc.height *
+                                       GetBytesPerPixel(resource.desc.internalFormat);
+            }
+        } else if (resource.type == ResourceType::IMPORTED) {
+            m_stats.importedBytes += resource.importedBytes;
+        }
+    }
+
+    TrimPool();
+    m_compiled = true;
+
+    size_t totalBytes = m_stats.pooledBytes + m_stats.importedBytes;
+    if (totalBytes != m_lastReportedBytes) {
+        m_lastReportedBytes = totalBytes;
+        LogMemoryStats();
+    }
+}
+
+int RenderGraph::AcquirePooledTexture(const TextureDesc& desc) {
+    for (int i = 0; i < static_cast<int>(m_pool.size()); ++i) {
+        PooledTexture& pooled = m_pool[i];
+        if (!pooled.inUse && pooled.texture != 0 && pooled.desc == desc) {
+            pooled.inUse = true;
+            pooled.lastUsedFrame = m_frameIndex;
+            return i;
+        }
+    }
+
+
+    GLenum format = GL_RGBA;
+    GLenum type = GL_FLOAT;
+    if (desc.internalFormat == GL_DEPTH_COMPONENT24) {
+        format = GL_DEPTH_COMPONENT;
+    } else if (desc.internalFormat == GL_RGBA8) {
+        type = GL_UNSIGNED_BYTE;
+    }
+
+    PooledTexture pooled;
+    pooled.desc = desc;
+    pooled.inUse = true;
+    pooled.lastUsedFrame = m_frameIndex;
+
+    glGenTextures(1, &pooled.texture);
+    glBindTexture(GL_TEXTURE_2D, pooled.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, desc.internalFormat, desc.width, desc.height, 0, format, type, nullptr);
+    GLint filter = (format == GL_DEPTH_COMPONENT) ? GL_NEAREST : GL_LINEAR;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Reuse a slot freed by TrimPool before growing
+    for (int i = 0; i < static_cast<int>(m_pool.size()); ++i) {
+        if (m_pool[i].texture == 0) {
+            m_pool[i] = pooled;
+            return i;
+        }
+    }
+    m_pool.push_back(pooled);
+    return static_cast<int>(m_pool.size() - 1);
+}
+
+void RenderGraph::TrimPool() {
+    // Resizes and quality changes leave textures nobody asks for again
+    for (auto& pooled : m_pool) {
+        if (pooled.texture != 0 && m_frameIndex - pooled.lastUsedFrame > POOL_TRIM_FRAMES) {
+            DeleteFramebuffersUsing(pooled.texture);
+            glDeleteTextures(1, &pooled.texture);
+            pooled.texture = 0;
+        }
+    }
+}
+
+void RenderGraph::DeleteFramebuffersUsing(GLuint texture) {
+    for (auto it = m_framebuffers.begin(); it != m_framebuffers.end();) {
+        if (std::find(it->first.begin(), it->first.end(), texture) != it->first.end()) {
+            glDeleteFramebuffers(1, &it->second);
+            it = m_framebuffers.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void RenderGraph::Execute() {
+    if (!m_compiled) {
+        Compile();
+    }
+
+    for (auto& pass : m_passes) {
+        if (pass.execute) {
+            pass.execute();
+        }
+    }
+}
+
+GLuint RenderGraph::GetTexture(ResourceHandle handle) const {
+    if (handle < 0 || handle >= static_cast<ResourceHandle>(m_resources.size())) {
+        return 0;
+    }
+
+    const Resource& resource = m_resources[handle];
+    if (resource.type == ResourceType::TRANSIENT) {
+        return resource.physicalIndex >= 0 ? m_pool[resource.physicalIndex].texture : 0;
+    }
+    return resource.importedTexture;
+}
+
+GLuint RenderGraph::GetFramebuffer(std::initializer_list<ResourceHandle> colors, ResourceHandle depth) {
+    std::vector<GLuint> key;
+    for (ResourceHandle handle : colors) {
+        if (m_resources[handle].type == ResourceType::BACKBUFFER) {
+            return 0;
+        }
+        key.push_back(GetTexture(handle));
+    }
+    // Separator keeps colour-only and colour+depth keys distinct
+    key.push_back(0xFFFFFFFFu);
+    if (depth != INVALID_RESOURCE) {
+        key.push_back(GetTexture(depth));
+    }
+
+    auto it = m_framebuffers.find(key);
+    if (it != m_framebuffers.end()) {
+        return it->second;
+    }
+
+
+    GLuint fbo = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    std::vector<GLenum> drawBuffers;
+    int attachment = 0;
+    for (ResourceHandle handle : colors) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + attachment, GL_TEXTURE_2D, GetTexture(handle), 0);
+        drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + attachment);
+        ++attachment;
+    }
+    if (depth != INVALID_RESOURCE) {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, GetTexture(depth), 0);
+    }
+
+    if (drawBuffers.empty()) {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    } else {
+        glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    }
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[RenderGraph] Framebuffer incomplete: 0x" << std::hex << status << std::dec << std::endl;
+    }
+
+    m_framebuffers[key] = fbo;
+    return fbo;
+}
+
+void RenderGraph::LogMemoryStats() const {
+    const double toMB = 1.0 / (1024.0 * 1024.0);
+    std::cout << "[RenderGraph] " << m_stats.passes << " passes, "
+              << m_stats.transientTextures << " transient targets in "
+              << m_stats.pooledTextures << " pooled textures" << std::endl;
+    std::cout << "[RenderGraph] Render-target memory: " << std::fixed << std::setprecision(2)
+              << (m_stats.pooledBytes + m_stats.importedBytes) * toMB << " MB (transient "
+              << m_stats.pooledBytes * toMB << " MB, " << m_stats.unaliasedBytes * toMB
+              << " MB without aliasing; imported " << m_stats.importedBytes * toMB << " MB)" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+void RenderGraph::Cleanup() {
+    for (auto& entry : m_framebuffers) {
+        glDeleteFramebuffers(1, &entry.second);
+    }
+    m_framebuffers.clear();
+
+    for (auto& pooled : m_pool) {
+        if (pooled.texture != 0) {
+            glDeleteTextures(1, &pooled.texture);
+        }
+    }
+    m_pool.clear();
+
+    m_resources.clear();
+    m_passes.clear();
+    m_compiled = false;
+}
+
+size_t RenderGraph::GetBytesPerPixel(GLenum internalFormat) {
+    switch (internalFormat) {
+        case GL_RGBA16F:            return 8;
+        case GL_RGBA8:              return 4;
+        case GL_DEPTH_COMPONENT24:  return 4;   // Padded to 32 bits on most drivers
+        default:                    return 4;
+    }
+}
@@ -0,0 +1,193 @@
+﻿/**
+ * @file RenderGraph.h
+ * @brief Frame graph for render passes and transient render targets
+ *
+ * Each frame the renderer declares its passes together with the textures
+ * they read and write. The graph then:
+ * - Computes the first and last pass that touches every transient texture
+ * - Assigns physical textures from a persistent pool, so textures with the
+ *   same size and format whose lifetimes do not overlap share memory
+ * - Caches framebuffer objects per attachment combination
+ * - Executes passes in declaration order and reports render-target memory
+ *
+ * Persistent targets owned elsewhere (shadow maps, the backbuffer) are
+ * imported so their passes still take part in ordering and reporting.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Declarative per-frame render graph with pooled transient textures
+ *
+ * Typical frame:
+ * @code
+ * graph.BeginFrame();
+ * auto color = graph.CreateTexture("SceneColor", { width, height, GL_RGBA16F });
+ * graph.AddPass("Scene", {}, { color }, [&]() { ... });
+ * graph.Compile();
+ * graph.Execute();
+ * @endcode
+ */
+class RenderGraph {
+public:
+    using ResourceHandle = int;
+    static constexpr ResourceHandle INVALID_RESOURCE = -1;
+
+    /**
+     * @brief Description of a transient 2D render target
+     */
+    struct TextureDesc {
+        int width;
+        int height;
+        GLenum internalFormat;  // GL_RGBA16F, GL_RGBA8 or GL_DEPTH_COMPONENT24
+
+        bool operator==(const TextureDesc& other) const {
+            return width == other.width && height == other.height && internalFormat == other.internalFormat;
+        }
+    };
+
+    /**
+     * @brief Render-target memory for the last compiled frame
+     */
+    struct MemoryStats {
+        size_t pooledBytes;         // Transient textures actually allocated
+        size_t unaliasedBytes;      // What the transient textures would cost without aliasing
+        size_t importedBytes;       // Persistent targets owned outside the graph
+        int transientTextures;      // Transient resources declared this frame
+        int pooledTextures;         // Physical textures backing them
+        int passes;
+    };
+
+    RenderGraph();
+    ~RenderGraph();
+
+    /**
+     * @brief Drop last frame's passes and resources (the texture pool is kept)
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Declare a transient texture that lives only inside this frame
+     */
+    ResourceHandle CreateTexture(const std::string& name, const TextureDesc& desc);
+
+    /**
+     * @brief Import a texture owned outside the graph
+     * @param sizeBytes GPU memory used by the texture, for reporting only
+     */
+    ResourceHandle ImportTexture(const std::string& name, GLuint texture, size_t sizeBytes);
+
+    /**
+     * @brief Import the default framebuffer
+     */
+    ResourceHandle ImportBackbuffer(const std::string& name);
+
+    /**
+     * @brief Add a pass; invalid handles in reads/writes are ignored
+     */
+    void AddPass(const std::string& name,
+                 std::initializer_list<ResourceHandle> reads,
+                 std::initializer_list<ResourceHandle> writes,
+                 std::function<void()> execute);
+
+    /**
+     * @brief Add a pass with a dynamically built write list
+     */
+    void AddPass(const std::string& name,
+                 const std::vector<ResourceHandle>& reads,
+                 const std::vector<ResourceHandle>& writes,
+                 std::function<void()> execute);
+
+    /**
+     * @brief Compute lifetimes and assign pooled textures to transient resources
+     */
+    void Compile();
+
+    /**
+     * @brief Run every pass in declaration order
+     */
+    void Execute();
+
+    /**
+     * @brief Physical texture behind a resource (valid after Compile)
+     */
+    GLuint GetTexture(ResourceHandle handle) const;
+
+    /**
+     * @brief Framebuffer with the given attachments, created on first use and cached
+     *
+     * Passing the backbuffer as the only colour attachment returns 0.
+     */
+    GLuint GetFramebuffer(std::initializer_list<ResourceHandle> colors,
+                          ResourceHandle depth = INVALID_RESOURCE);
+
+    const TextureDesc& GetDesc(ResourceHandle handle) const { return m_resources[handle].desc; }
+    const MemoryStats& GetMemoryStats() const { return m_stats; }
+
+    /**
+     * @brief Print the memory report for the current frame
+     */
+    void LogMemoryStats() const;
+
+    /**
+     * @brief Delete every pooled texture and cached framebuffer
+     */
+    void Cleanup();
+
+    static size_t GetBytesPerPixel(GLenum internalFormat);
+
+private:
+    enum class ResourceType {
+        TRANSIENT,
+        IMPORTED,
+        BACKBUFFER
+    };
+
+    struct Resource {
+        std::string name;
+        ResourceType type;
+        TextureDesc desc;
+        GLuint importedTexture;
+        size_t importedBytes;
+        int firstPass;
+        int lastPass;
+        int physicalIndex;      // Index into m_pool for transient resources
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<ResourceHandle> reads;
+        std::vector<ResourceHandle> writes;
+        std::function<void()> execute;
+    };
+
+    struct PooledTexture {
+        GLuint texture;
+        TextureDesc desc;
+        bool inUse;
+        int lastUsedFrame;
+    };
+
+    int AcquirePooledTexture(const TextureDesc& desc);
+    void TrimPool();
+    void DeleteFramebuffersUsing(GLuint texture);
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<PooledTexture> m_pool;
+    std::map<std::vector<GLuint>, GLuint> m_framebuffers;   // Attachment textures -> FBO
+
+    MemoryStats m_stats;
+    size_t m_lastReportedBytes;
+    int m_frameIndex;
+    bool m_compiled;
+
+    static constexpr int POOL_TRIM_FRAMES = 120;    // Drop textures unused for this long
+};
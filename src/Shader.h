@@ -3,8 +3,9 @@
  * @brief OpenGL shader program management system
  * 
  * Provides a comprehensive system for loading, compiling, and managing
- * OpenGL shader programs. Supports vertex and fragment shaders with
- * convenient uniform variable setting methods.
+ * OpenGL shader programs. Supports vertex/fragment pairs and, on GL 4.3+,
+ * single-stage compute programs, with convenient uniform variable setting
+ * methods.
  * 
  * Features:
  * - Automatic shader compilation and linking
@@ -53,6 +54,13 @@ public:
     Shader(const char* vertexPath, const char* fragmentPath);
     Shader(const std::string& vertexPath, const std::string& fragmentPath); 
     
+    /**
+     * @brief Constructor for a compute program (needs GL 4.3)
+     * 
+     * @param computePath Path to compute shader source file
+     */
+    explicit Shader(const std::string& computePath);
+    
     /**
      * @brief Destructor - cleanup OpenGL resources
      */
@@ -67,6 +75,11 @@ public:
     void use() const;     // Legacy naming
     void Use() const;     // Modern naming
 
+    /**
+     * @brief Whether the program compiled and linked
+     */
+    bool IsLinked() const;
+
     // Convenience uniform setters (legacy naming)
     void setMat4(const std::string& name, const glm::mat4& mat) const;
     void setVec3(const std::string& name, const glm::vec3& value) const;
@@ -136,7 +149,7 @@ private:
      * debugging shader code problems.
      * 
      * @param shader OpenGL shader/program ID to check
-     * @param type Type of check ("VERTEX", "FRAGMENT", or "PROGRAM")
+     * @param type Type of check ("VERTEX", "FRAGMENT", "COMPUTE" or "PROGRAM")
      */
     void CheckCompileErrors(unsigned int shader, const std::string& type);
 };
@@ -0,0 +1,173 @@
+﻿#include "ShadowFilterBenchmark.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+
+
+
+
+ShadowFilterBenchmark::ShadowFilterBenchmark()
+    : m_shadowMapping(nullptr)
+    , m_originalMode(ShadowMapping::FilterMode::PCF_3x3)
+    , m_timerQuery(0)
+    , m_accumulatedTime(0)
+    , m_running(false)
+    , m_phase(Phase::WARMUP)
+    , m_modeIndex(0)
+    , m_frame(0)
+    , m_width(0)
+    , m_height(0)
+{
+}
+
+ShadowFilterBenchmark::~ShadowFilterBenchmark() {
+    if (m_timerQuery != 0) {
+        glDeleteQueries(1, &m_timerQuery);
+    }
+}
+
+void ShadowFilterBenchmark::Start(ShadowMapping* shadowMapping, int width, int height) {
+    if (m_running || !shadowMapping || width <= 0 || height <= 0) {
+        return;
+    }
+
+    if (m_timerQuery == 0) {
+        glGenQueries(1, &m_timerQuery);
+    }
+
+    m_shadowMapping = shadowMapping;
+    m_originalMode = shadowMapping->GetFilterMode();
+    m_width = width;
+    m_height = height;
+
+    // The reference mode runs first so every later capture can be scored immediately
+    m_modes.clear();
+    m_modes.push_back(ShadowMapping::FilterMode::PCF_5x5);
+    for (int i = 0; i < ShadowMapping::FILTER_MODE_COUNT; ++i) {
+        auto mode = static_cast<ShadowMapping::FilterMode>(i);
+        if (mode != ShadowMapping::FilterMode::PCF_5x5) {
+            m_modes.push_back(mode);
+        }
+    }
+
+    m_results.clear();
+    m_reference.clear();
+    m_capture.assign(static_cast<size_t>(width) * height, 0);
+
+    m_modeIndex = 0;
+    m_phase = Phase::WARMUP;
+    m_frame = 0;
+    m_accumulatedTime = 0;
+    m_running = true;
+
+    std::cout << "[ShadowFilterBenchmark] Running " << m_modes.size()
+              << " filter modes, hold the camera still..." << std::endl;
+}
+
+void ShadowFilterBenchmark::BeginFrame() {
+    if (!m_running) {
+        return;
+    }
+
+    m_shadowMapping->SetFilterMode(m_modes[m_modeIndex]);
+
+    if (m_phase == Phase::TIMING) {
+        glBeginQuery(GL_TIME_ELAPSED, m_timerQuery);
+    }
+}
+
+void ShadowFilterBenchmark::EndFrame() {
+    if (!m_running) {
+        return;
+    }
+
+    switch (m_phase) {
+        case Phase::WARMUP:
+            if (++m_frame >= WARMUP_FRAMES) {
+                m_phase = Phase::TIMING;
+                m_frame = 0;
+            }
+            break;
+
+        case Phase::TIMING: {
+            glEndQuery(GL_TIME_ELAPSED);
+
+            // Blocking readback is acceptable here: it only stalls the CPU, not the measured GPU work
+            GLuint64 elapsed = 0;
+            glGetQueryObjectui64v(m_timerQuery, GL_QUERY_RESULT, &elapsed);
+            m_accumulatedTime += elapsed;
+
+            if (++m_frame >= TIMED_FRAMES) {
+                m_phase = Phase::CAPTURE;
+                m_frame = 0;
+            }
+            break;
+        }
+
+        case Phase::CAPTURE: {
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, m_width, m_height, GL_RED, GL_UNSIGNED_BYTE, m_capture.data());
+
+            Result result;
+            result.mode = m_modes[m_modeIndex];
+            result.gpuTimeMs = static_cast<float>(m_accumulatedTime / static_cast<double>(TIMED_FRAMES) / 1.0e6);
+            result.taps = ShadowMapping::GetFilterTapCount(result.mode);
+            result.rmse = 0.0;
+
+            if (m_reference.empty()) {
+                m_reference = m_capture;
+            } else {
+                double sum = 0.0;
+                for (size_t i = 0; i < m_capture.size(); ++i) {
+                    double diff = (static_cast<double>(m_capture[i]) - m_reference[i]) / 255.0;
+                    sum += diff * diff;
+                }
+                result.rmse = std::sqrt(sum / static_cast<double>(m_capture.size()));
+            }
+
+            m_results.push_back(result);
+            AdvanceMode();
+            break;
+        }
+    }
+}
+
+void ShadowFilterBenchmark::AdvanceMode() {
+    m_phase = Phase::WARMUP;
+    m_frame = 0;
+    m_accumulatedTime = 0;
+
+    if (++m_modeIndex >= static_cast<int>(m_modes.size())) {
+        Finish();
+    }
+}
+
+void ShadowFilterBenchmark::Finish() {
+    m_running = false;
+    m_shadowMapping->SetFilterMode(m_originalMode);
+    PrintResults();
+
+    m_reference.clear();
+    m_reference.shrink_to_fit();
+    m_capture.clear();
+    m_capture.shrink_to_fit();
+}
+
+void ShadowFilterBenchmark::PrintResults() const {
+    std::cout << "[ShadowFilterBenchmark] Results (" << m_width << "x" << m_height
+              << ", reference PCF_5x5):" << std::endl;
+    std::cout << "  " << std::left << std::setw(18) << "Mode"
+              << std::right << std::setw(12) << "GPU ms"
+              << std::setw(8) << "Taps"
+              << std::setw(12) << "RMSE" << std::endl;
+
+    for (const auto& result : m_results) {
+        std::cout << "  " << std::left << std::setw(18) << ShadowMapping::GetFilterModeName(result.mode)
+                  << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << result.gpuTimeMs
+                  << std::setw(8) << result.taps
+                  << std::setprecision(4) << std::setw(12) << result.rmse << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
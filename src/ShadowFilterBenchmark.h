@@ -0,0 +1,94 @@
+﻿/**
+ * @file ShadowFilterBenchmark.h
+ * @brief In-game comparison of shadow filter modes
+ *
+ * Cycles the directional shadow map through every FilterMode and reports,
+ * per mode:
+ * - GPU time of the shadow-receiving scene pass (GL_TIME_ELAPSED queries)
+ * - Number of shadow map fetches per fragment
+ * - RMSE of the shadow factor against the PCF 5x5 reference image
+ *
+ * The camera should be held still while a run is in progress so every
+ * mode sees the same frame.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <vector>
+#include "ShadowMapping.h"
+
+/**
+ * @brief Frame-driven benchmark state machine for shadow filtering
+ *
+ * Call BeginFrame() before the shadow-receiving scene pass and EndFrame()
+ * after it. While IsCapturing() is true the receiving shaders should output
+ * their raw shadow factor (shadowDebugView) so it can be read back.
+ */
+class ShadowFilterBenchmark {
+public:
+    /**
+     * @brief Per-mode benchmark result
+     */
+    struct Result {
+        ShadowMapping::FilterMode mode;
+        float gpuTimeMs;    // Average scene pass time
+        int taps;           // Shadow map fetches per fragment
+        double rmse;        // Shadow factor error vs reference (0-1 range)
+    };
+
+    ShadowFilterBenchmark();
+    ~ShadowFilterBenchmark();
+
+    /**
+     * @brief Start a run over every filter mode
+     * @param shadowMapping Shadow map whose filter mode is cycled
+     * @param width Framebuffer width used for the quality capture
+     * @param height Framebuffer height used for the quality capture
+     */
+    void Start(ShadowMapping* shadowMapping, int width, int height);
+
+    /**
+     * @brief Apply this frame's filter mode and begin GPU timing
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Finish GPU timing or read back the capture, then advance
+     */
+    void EndFrame();
+
+    bool IsRunning() const { return m_running; }
+    bool IsCapturing() const { return m_running && m_phase == Phase::CAPTURE; }
+    const std::vector<Result>& GetResults() const { return m_results; }
+
+private:
+    enum class Phase {
+        WARMUP,
+        TIMING,
+        CAPTURE
+    };
+
+    void AdvanceMode();
+    void Finish();
+    void PrintResults() const;
+
+    ShadowMapping* m_shadowMapping;
+    ShadowMapping::FilterMode m_originalMode;
+    std::vector<ShadowMapping::FilterMode> m_modes;
+    std::vector<Result> m_results;
+    std::vector<unsigned char> m_reference;
+    std::vector<unsigned char> m_capture;
+
+    GLuint m_timerQuery;
+    GLuint64 m_accumulatedTime;
+    bool m_running;
+    Phase m_phase;
+    int m_modeIndex;
+    int m_frame;
+    int m_width;
+    int m_height;
+
+    static constexpr int WARMUP_FRAMES = 10;
+    static constexpr int TIMED_FRAMES = 60;
+};
@@ -4,6 +4,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 #include <algorithm>
+#include <cmath>
 
 
 
@@ -15,6 +16,8 @@ ShadowMapping::ShadowMapping(ShadowQuality quality, FilterMode filterMode)
     , m_shadowMapSize(static_cast<int>(quality))
     , m_quality(quality)
     , m_filterMode(filterMode)
+    , m_depthSampler(0)
+    , m_compareSampler(0)
     , m_lightType(LightType::DIRECTIONAL)
     , m_lightPosition(0.0f, 10.0f, 0.0f)
     , m_lightDirection(0.0f, -1.0f, 0.0f)
@@ -30,7 +33,27 @@ ShadowMapping::ShadowMapping(ShadowQuality quality, FilterMode filterMode)
     , m_enableSlopeScaledBias(true)
     , m_enableDebugView(false)
     , m_enableCulling(true)
+    , m_cascadeCount(0)
+    , m_cascadeSplitLambda(0.75f)
+    , m_cascadeFitMargin(0.2f)
+    , m_enableStaticCache(true)
+    , m_staticCacheFBO(0)
+    , m_staticCacheMap(0)
+    , m_staticCacheRebuilds(0)
 {
+    // Near cascades follow the camera every frame, far ones can lag behind
+    const int defaultIntervals[MAX_CASCADES] = { 1, 1, 2, 4 };
+    for (int i = 0; i < MAX_CASCADES; i++) {
+        m_cascades[i].splitDistance = 0.0f;
+        m_cascades[i].lightSpaceMatrix = glm::mat4(1.0f);
+        m_cascades[i].fitCenter = glm::vec3(0.0f);
+        m_cascades[i].fitRadius = 0.0f;
+        m_cascades[i].updateInterval = defaultIntervals[i];
+        m_cascades[i].framesSinceUpdate = 0;
+        m_cascades[i].needsRender = true;
+        m_cascades[i].staticDirty = true;
+    }
+    
     std::cout << "[ShadowMapping] Initialized with quality: " << m_shadowMapSize << "x" << m_shadowMapSize << std::endl;
 }
 
@@ -44,6 +67,9 @@ bool ShadowMapping::Initialize() {
     std::cout << "[ShadowMapping] Initializing shadow mapping system..." << std::endl;
     
     
+    CreateSamplers();
+    
+    
     if (!CreateShadowMapFBO()) {
         std::cerr << "[ShadowMapping] Failed to create shadow map FBO" << std::endl;
         return false;
@@ -70,6 +96,18 @@ void ShadowMapping::Cleanup() {
         m_shadowMap = 0;
     }
     
+    DeleteStaticCache();
+    
+    if (m_depthSampler != 0) {
+        glDeleteSamplers(1, &m_depthSampler);
+        m_depthSampler = 0;
+    }
+    
+    if (m_compareSampler != 0) {
+        glDeleteSamplers(1, &m_compareSampler);
+        m_compareSampler = 0;
+    }
+    
     m_shadowMapShader.reset();
     m_shadowReceiveShader.reset();
     
@@ -85,42 +123,36 @@ bool ShadowMapping::CreateShadowMapFBO() {
     
     
     glGenTextures(1, &m_shadowMap);
-    glBindTexture(GL_TEXTURE_2D, m_shadowMap);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, 
-                 m_shadowMapSize, m_shadowMapSize, 0, 
-                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    const GLenum target = GetTextureTarget();
+    glBindTexture(target, m_shadowMap);
+    if (IsCascaded()) {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24,
+                     m_shadowMapSize, m_shadowMapSize, m_cascadeCount, 0,
+                     GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, 
+                     m_shadowMapSize, m_shadowMapSize, 0, 
+                     GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    }
     
     
-    switch (m_filterMode) {
-        case FilterMode::NEAREST:
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            break;
-        case FilterMode::LINEAR:
-        case FilterMode::PCF_2x2:
-        case FilterMode::PCF_3x3:
-        case FilterMode::PCF_5x5:
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            break;
-    }
+    ApplyFilterParameters();
     
     
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
     float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-    glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glTexParameterfv(target, GL_TEXTURE_BORDER_COLOR, borderColor);
     
     
-    if (m_filterMode >= FilterMode::PCF_2x2) {
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    if (IsCascaded()) {
+        // Layers are attached one at a time in BeginCascadePass
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_shadowMap, 0, 0);
+    } else {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_shadowMap, 0);
     }
     
     
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_shadowMap, 0);
-    
-    
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     
@@ -133,10 +165,290 @@ bool ShadowMapping::CreateShadowMapFBO() {
     }
     
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    std::cout << "[ShadowMapping] Shadow map FBO created successfully (" << m_shadowMapSize << "x" << m_shadowMapSize << ")" << std::endl;
+    
+    for (int i = 0; i < MAX_CASCADES; i++) {
+        m_cascades[i].needsRender = true;
+        m_cascades[i].staticDirty = true;
+    }
+    
+    if (IsStaticCacheEnabled() && !CreateStaticCache()) {
+        std::cerr << "[ShadowMapping] Static shadow cache unavailable, rendering all casters every refresh" << std::endl;
+        m_enableStaticCache = false;
+    }
+    
+    std::cout << "[ShadowMapping] Shadow map FBO created successfully (" << m_shadowMapSize << "x" << m_shadowMapSize;
+    if (IsCascaded()) {
+        std::cout << " x " << m_cascadeCount << " cascades";
+    }
+    std::cout << ")" << std::endl;
+    return true;
+}
+
+bool ShadowMapping::CreateStaticCache() {
+    DeleteStaticCache();
+    
+    // Same format as the live map so layers can be copied with a depth blit
+    glGenTextures(1, &m_staticCacheMap);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, m_staticCacheMap);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24,
+                 m_shadowMapSize, m_shadowMapSize, m_cascadeCount, 0,
+                 GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    glGenFramebuffers(1, &m_staticCacheFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_staticCacheFBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticCacheMap, 0, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[ShadowMapping] Static cache framebuffer not complete: " << status << std::endl;
+        DeleteStaticCache();
+        return false;
+    }
+    
+    std::cout << "[ShadowMapping] Static shadow cache created (" << m_cascadeCount << " layers)" << std::endl;
     return true;
 }
 
+void ShadowMapping::DeleteStaticCache() {
+    if (m_staticCacheFBO != 0) {
+        glDeleteFramebuffers(1, &m_staticCacheFBO);
+        m_staticCacheFBO = 0;
+    }
+    
+    if (m_staticCacheMap != 0) {
+        glDeleteTextures(1, &m_staticCacheMap);
+        m_staticCacheMap = 0;
+    }
+}
+
+void ShadowMapping::EnableStaticCache(bool enable) {
+    if (enable == m_enableStaticCache) return;
+    
+    m_enableStaticCache = enable;
+    if (!enable) {
+        DeleteStaticCache();
+    } else if (m_shadowMap != 0 && IsCascaded()) {
+        m_enableStaticCache = CreateStaticCache();
+    }
+    InvalidateStaticCache();
+}
+
+void ShadowMapping::InvalidateStaticCache() {
+    for (int i = 0; i < MAX_CASCADES; i++) {
+        m_cascades[i].staticDirty = true;
+        m_cascades[i].needsRender = true;
+    }
+}
+
+bool ShadowMapping::CascadeStaticDirty(int cascade) const {
+    if (cascade < 0 || cascade >= m_cascadeCount) return false;
+    return m_cascades[cascade].staticDirty;
+}
+
+void ShadowMapping::CreateSamplers() {
+    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    
+    // Raw depth reads for the manual filter modes
+    if (m_depthSampler == 0) {
+        glGenSamplers(1, &m_depthSampler);
+    }
+    glSamplerParameteri(m_depthSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glSamplerParameteri(m_depthSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glSamplerParameterfv(m_depthSampler, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glSamplerParameteri(m_depthSampler, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+    
+    // Bilinear hardware comparison: one fetch returns a filtered 2x2 PCF result
+    if (m_compareSampler == 0) {
+        glGenSamplers(1, &m_compareSampler);
+    }
+    glSamplerParameteri(m_compareSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glSamplerParameteri(m_compareSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glSamplerParameteri(m_compareSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glSamplerParameteri(m_compareSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glSamplerParameterfv(m_compareSampler, GL_TEXTURE_BORDER_COLOR, borderColor);
+    glSamplerParameteri(m_compareSampler, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glSamplerParameteri(m_compareSampler, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+}
+
+void ShadowMapping::ApplyFilterParameters() {
+    const GLenum target = GetTextureTarget();
+    GLint filter = (m_filterMode == FilterMode::NEAREST) ? GL_NEAREST : GL_LINEAR;
+    
+    // The texture itself always holds raw depth; comparison goes through m_compareSampler
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(target, GL_TEXTURE_COMPARE_MODE, GL_NONE);
+    
+    if (m_depthSampler != 0) {
+        glSamplerParameteri(m_depthSampler, GL_TEXTURE_MIN_FILTER, filter);
+        glSamplerParameteri(m_depthSampler, GL_TEXTURE_MAG_FILTER, filter);
+    }
+}
+
+const char* ShadowMapping::GetFilterModeName(FilterMode mode) {
+    switch (mode) {
+        case FilterMode::NEAREST:          return "NEAREST";
+        case FilterMode::LINEAR:           return "LINEAR";
+        case FilterMode::PCF_2x2:          return "PCF_2x2";
+        case FilterMode::PCF_3x3:          return "PCF_3x3";
+        case FilterMode::PCF_5x5:          return "PCF_5x5";
+        case FilterMode::HARDWARE_PCF:     return "HARDWARE_PCF";
+        case FilterMode::HARDWARE_PCF_3x3: return "HARDWARE_PCF_3x3";
+        case FilterMode::POISSON_DISK:     return "POISSON_DISK";
+    }
+    return "UNKNOWN";
+}
+
+int ShadowMapping::GetFilterTapCount(FilterMode mode) {
+    switch (mode) {
+        case FilterMode::NEAREST:          return 1;
+        case FilterMode::LINEAR:           return 1;
+        case FilterMode::PCF_2x2:          return 4;
+        case FilterMode::PCF_3x3:          return 9;
+        case FilterMode::PCF_5x5:          return 25;
+        case FilterMode::HARDWARE_PCF:     return 1;
+        case FilterMode::HARDWARE_PCF_3x3: return 4;
+        case FilterMode::POISSON_DISK:     return 8;
+    }
+    return 0;
+}
+
+void ShadowMapping::SetCascadeCount(int count) {
+    int newCount = (count < 2) ? 0 : std::min(count, MAX_CASCADES);
+    if (newCount == m_cascadeCount) {
+        return;
+    }
+    
+    if (newCount > 0 && m_lightType != LightType::DIRECTIONAL) {
+        std::cerr << "[ShadowMapping] Cascades are only supported for directional lights" << std::endl;
+        return;
+    }
+    
+    m_cascadeCount = newCount;
+    
+    
+    if (m_shadowMap != 0) {
+        glDeleteTextures(1, &m_shadowMap);
+        glDeleteFramebuffers(1, &m_shadowMapFBO);
+        m_shadowMap = 0;
+        m_shadowMapFBO = 0;
+        DeleteStaticCache();
+        CreateShadowMapFBO();
+    }
+    
+    std::cout << "[ShadowMapping] Cascade count set to: " << m_cascadeCount << std::endl;
+}
+
+void ShadowMapping::SetCascadeUpdateInterval(int cascade, int frames) {
+    if (cascade < 0 || cascade >= MAX_CASCADES) return;
+    m_cascades[cascade].updateInterval = std::max(frames, 1);
+}
+
+void ShadowMapping::UpdateCascades(const glm::mat4& cameraView, float fovY, float aspect,
+                                   float cameraNear, float cameraFar) {
+    if (!IsCascaded()) return;
+    
+    PROFILE_FUNCTION();
+    
+    // Practical split scheme: blend of logarithmic and uniform distribution
+    const float range = cameraFar - cameraNear;
+    const float ratio = cameraFar / cameraNear;
+    float sliceNear = cameraNear;
+    
+    for (int i = 0; i < m_cascadeCount; i++) {
+        float p = static_cast<float>(i + 1) / static_cast<float>(m_cascadeCount);
+        float logSplit = cameraNear * std::pow(ratio, p);
+        float uniformSplit = cameraNear + range * p;
+        float split = m_cascadeSplitLambda * logSplit + (1.0f - m_cascadeSplitLambda) * uniformSplit;
+        
+        Cascade& cascade = m_cascades[i];
+        cascade.splitDistance = split;
+        cascade.framesSinceUpdate++;
+        
+        glm::vec3 center;
+        float radius;
+        CalculateSliceBounds(cameraView, fovY, aspect, sliceNear, split, center, radius);
+        
+        // Re-fit only once the slice leaves the slack around the last fit
+        bool refit = cascade.fitRadius <= 0.0f ||
+                     std::abs(radius - cascade.fitRadius) > 0.01f ||
+                     glm::length(center - cascade.fitCenter) > radius * m_cascadeFitMargin;
+        
+        if (refit) {
+            cascade.fitCenter = center;
+            cascade.fitRadius = radius;
+            cascade.lightSpaceMatrix = CalculateCascadeMatrix(center, radius * (1.0f + m_cascadeFitMargin));
+            cascade.staticDirty = true;
+            cascade.needsRender = true;
+        } else if (cascade.staticDirty || cascade.framesSinceUpdate >= cascade.updateInterval) {
+            cascade.needsRender = true;
+        }
+        
+        sliceNear = split;
+    }
+}
+
+bool ShadowMapping::CascadeNeedsRender(int cascade) const {
+    if (cascade < 0 || cascade >= m_cascadeCount) return false;
+    return m_cascades[cascade].needsRender;
+}
+
+void ShadowMapping::CalculateSliceBounds(const glm::mat4& cameraView, float fovY, float aspect,
+                                         float sliceNear, float sliceFar,
+                                         glm::vec3& center, float& radius) const {
+    
+    glm::mat4 sliceProjection = glm::perspective(fovY, aspect, sliceNear, sliceFar);
+    glm::mat4 invViewProj = glm::inverse(sliceProjection * cameraView);
+    
+    glm::vec3 corners[8];
+    center = glm::vec3(0.0f);
+    int index = 0;
+    for (int x = 0; x < 2; x++) {
+        for (int y = 0; y < 2; y++) {
+            for (int z = 0; z < 2; z++) {
+                glm::vec4 corner = invViewProj * glm::vec4(2.0f * x - 1.0f, 2.0f * y - 1.0f, 2.0f * z - 1.0f, 1.0f);
+                corners[index] = glm::vec3(corner) / corner.w;
+                center += corners[index];
+                index++;
+            }
+        }
+    }
+    center /= 8.0f;
+    
+    // Bounding sphere keeps the projection size stable while the camera rotates
+    radius = 0.0f;
+    for (const auto& corner : corners) {
+        radius = std::max(radius, glm::length(corner - center));
+    }
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+}
+
+glm::mat4 ShadowMapping::CalculateCascadeMatrix(const glm::vec3& center, float radius) const {
+    // Pull the near plane back so casters outside the slice still land in the map
+    const float casterDistance = m_farPlane;
+    glm::vec3 up = std::abs(glm::dot(m_lightDirection, glm::vec3(0, 1, 0))) > 0.99f ? 
+                   glm::vec3(1, 0, 0) : glm::vec3(0, 1, 0);
+    glm::mat4 lightView = glm::lookAt(center - m_lightDirection * (radius + casterDistance), center, up);
+    glm::mat4 lightProjection = glm::ortho(-radius, radius, -radius, radius,
+                                           0.0f, 2.0f * radius + casterDistance);
+    
+    // Snap to whole texels to avoid shimmering edges when the camera moves
+    glm::vec4 origin = lightProjection * lightView * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    origin *= static_cast<float>(m_shadowMapSize) * 0.5f;
+    glm::vec4 offset = (glm::round(origin) - origin) * (2.0f / static_cast<float>(m_shadowMapSize));
+    lightProjection[3][0] += offset.x;
+    lightProjection[3][1] += offset.y;
+    
+    return lightProjection * lightView;
+}
+
 void ShadowMapping::SetLight(LightType type, const glm::vec3& position, 
                            const glm::vec3& direction, float fov) {
     m_lightType = type;
@@ -192,6 +504,12 @@ void ShadowMapping::CalculateLightSpaceMatrix() {
     
     m_lightSpaceMatrix = m_lightProjection * m_lightView;
     
+    // Cascade fits depend on the light, force a re-fit and static re-render
+    for (int i = 0; i < MAX_CASCADES; i++) {
+        m_cascades[i].fitRadius = 0.0f;
+    }
+    InvalidateStaticCache();
+    
     
     if (m_enableCulling) {
         CalculateFrustumPlanes();
@@ -282,10 +600,54 @@ void ShadowMapping::BeginShadowMapPass() {
     
     
     glBindFramebuffer(GL_FRAMEBUFFER, m_shadowMapFBO);
+    ApplyShadowPassState(m_lightSpaceMatrix, true);
+}
+
+void ShadowMapping::BeginCascadePass(int cascade) {
+    PROFILE_SECTION("Shadow Cascade Rendering");
+    
+    if (cascade < 0 || cascade >= m_cascadeCount) return;
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, m_shadowMapFBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_shadowMap, 0, cascade);
+    
+    bool useCache = IsStaticCacheEnabled() && !m_cascades[cascade].staticDirty;
+    if (useCache) {
+        // Start from the cached static casters instead of an empty layer
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_staticCacheFBO);
+        glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticCacheMap, 0, cascade);
+        glBlitFramebuffer(0, 0, m_shadowMapSize, m_shadowMapSize,
+                          0, 0, m_shadowMapSize, m_shadowMapSize,
+                          GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_shadowMapFBO);
+    }
+    
+    ApplyShadowPassState(m_cascades[cascade].lightSpaceMatrix, !useCache);
+    
+    m_cascades[cascade].needsRender = false;
+    m_cascades[cascade].framesSinceUpdate = 0;
+}
+
+void ShadowMapping::BeginStaticCachePass(int cascade) {
+    PROFILE_SECTION("Static Shadow Cache Rendering");
+    
+    if (cascade < 0 || cascade >= m_cascadeCount || !IsStaticCacheEnabled()) return;
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, m_staticCacheFBO);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticCacheMap, 0, cascade);
+    ApplyShadowPassState(m_cascades[cascade].lightSpaceMatrix, true);
+    
+    m_cascades[cascade].staticDirty = false;
+    m_staticCacheRebuilds++;
+}
+
+void ShadowMapping::ApplyShadowPassState(const glm::mat4& lightSpaceMatrix, bool clearDepth) {
     glViewport(0, 0, m_shadowMapSize, m_shadowMapSize);
     
     
-    glClear(GL_DEPTH_BUFFER_BIT);
+    if (clearDepth) {
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
     
     
     glEnable(GL_DEPTH_TEST);
@@ -304,7 +666,7 @@ void ShadowMapping::BeginShadowMapPass() {
     
     if (m_shadowMapShader) {
         m_shadowMapShader->use();
-        m_shadowMapShader->SetMat4("lightSpaceMatrix", m_lightSpaceMatrix);
+        m_shadowMapShader->SetMat4("lightSpaceMatrix", lightSpaceMatrix);
     }
 }
 
@@ -324,7 +686,25 @@ void ShadowMapping::BeginShadowReceivePass(const glm::mat4& viewMatrix, const gl
 
 void ShadowMapping::BindShadowMap(int textureUnit) {
     glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(GL_TEXTURE_2D, m_shadowMap);
+    glBindTexture(GetTextureTarget(), m_shadowMap);
+    glBindSampler(textureUnit, m_depthSampler);
+}
+
+size_t ShadowMapping::GetMemoryUsage() const {
+    // DEPTH_COMPONENT24 is stored as 32 bits per texel
+    size_t layerBytes = static_cast<size_t>(m_shadowMapSize) * m_shadowMapSize * 4;
+    size_t layers = IsCascaded() ? static_cast<size_t>(m_cascadeCount) : 1;
+    size_t bytes = m_shadowMap != 0 ? layerBytes * layers : 0;
+    if (m_staticCacheMap != 0) {
+        bytes += layerBytes * layers;
+    }
+    return bytes;
+}
+
+void ShadowMapping::BindShadowCompareMap(int textureUnit) {
+    glActiveTexture(GL_TEXTURE0 + textureUnit);
+    glBindTexture(GetTextureTarget(), m_shadowMap);
+    glBindSampler(textureUnit, m_compareSampler);
 }
 
 void ShadowMapping::SetShadowUniforms(Shader* shader) {
@@ -340,6 +720,17 @@ void ShadowMapping::SetShadowUniforms(Shader* shader) {
     shader->SetFloat("shadowMapSize", static_cast<float>(m_shadowMapSize));
 }
 
+void ShadowMapping::SetCascadeUniforms(Shader* shader) {
+    if (!shader) return;
+    
+    shader->SetInt("cascadeCount", m_cascadeCount);
+    for (int i = 0; i < m_cascadeCount; i++) {
+        std::string index = "[" + std::to_string(i) + "]";
+        shader->SetFloat("cascadeSplits" + index, m_cascades[i].splitDistance);
+        shader->SetMat4("lightSpaceMatrices" + index, m_cascades[i].lightSpaceMatrix);
+    }
+}
+
 void ShadowMapping::SetShadowQuality(ShadowQuality quality) {
     if (quality != m_quality) {
         m_quality = quality;
@@ -352,6 +743,7 @@ void ShadowMapping::SetShadowQuality(ShadowQuality quality) {
             if (m_shadowMap != 0) {
                 glDeleteTextures(1, &m_shadowMap);
                 glDeleteFramebuffers(1, &m_shadowMapFBO);
+                DeleteStaticCache();
                 CreateShadowMapFBO();
             }
             
@@ -366,31 +758,11 @@ void ShadowMapping::SetFilterMode(FilterMode mode) {
         
         
         if (m_shadowMap != 0) {
-            glBindTexture(GL_TEXTURE_2D, m_shadowMap);
-            
-            switch (m_filterMode) {
-                case FilterMode::NEAREST:
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
-                    break;
-                case FilterMode::LINEAR:
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_NONE);
-                    break;
-                case FilterMode::PCF_2x2:
-                case FilterMode::PCF_3x3:
-                case FilterMode::PCF_5x5:
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
-                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
-                    break;
-            }
+            glBindTexture(GetTextureTarget(), m_shadowMap);
+            ApplyFilterParameters();
         }
         
-        std::cout << "[ShadowMapping] Filter mode updated to: " << static_cast<int>(mode) << std::endl;
+        std::cout << "[ShadowMapping] Filter mode updated to: " << GetFilterModeName(mode) << std::endl;
     }
 }
 
@@ -410,6 +782,7 @@ ShadowMapping::ShadowStats ShadowMapping::GetPerformanceStats() const {
     stats.culledObjects = 0;   
     stats.shadowMapRenderTime = 0.0f; 
     stats.totalShadowTime = 0.0f;     
+    stats.staticCacheRebuilds = m_staticCacheRebuilds;
     return stats;
 }
 
@@ -458,6 +831,30 @@ ShadowMapping* ShadowMappingManager::AddShadowLight(int lightIndex,
     return result;
 }
 
+ShadowMapping* ShadowMappingManager::AddCascadedShadowLight(int lightIndex,
+                                                           int cascadeCount,
+                                                           ShadowMapping::ShadowQuality quality) {
+    
+    if (lightIndex >= static_cast<int>(m_shadowMaps.size())) {
+        m_shadowMaps.resize(lightIndex + 1);
+    }
+    
+    
+    auto shadowMap = std::make_unique<ShadowMapping>(quality, ShadowMapping::FilterMode::PCF_3x3);
+    shadowMap->SetCascadeCount(cascadeCount);
+    if (!shadowMap->Initialize()) {
+        std::cerr << "[ShadowMappingManager] Failed to initialize cascaded shadow mapping for light " << lightIndex << std::endl;
+        return nullptr;
+    }
+    
+    ShadowMapping* result = shadowMap.get();
+    m_shadowMaps[lightIndex] = std::move(shadowMap);
+    
+    std::cout << "[ShadowMappingManager] Added cascaded shadow light " << lightIndex 
+              << " (" << result->GetCascadeCount() << " cascades)" << std::endl;
+    return result;
+}
+
 void ShadowMappingManager::RemoveShadowLight(int lightIndex) {
     if (lightIndex >= 0 && lightIndex < static_cast<int>(m_shadowMaps.size())) {
         m_shadowMaps[lightIndex].reset();
@@ -487,6 +884,54 @@ void ShadowMappingManager::RenderAllShadowMaps(int windowWidth, int windowHeight
     }
 }
 
+void ShadowMappingManager::RenderCascadedShadowMaps(const glm::mat4& cameraView, float fovY, float aspect,
+                                                    float cameraNear, float cameraFar,
+                                                    const std::function<void(const glm::mat4&)>& renderStaticCasters,
+                                                    const std::function<void(const glm::mat4&)>& renderDynamicCasters,
+                                                    int windowWidth, int windowHeight) {
+    if (!m_globalShadowsEnabled) return;
+    
+    PROFILE_SECTION("Cascaded Shadow Maps Rendering");
+    
+    for (auto& shadowMap : m_shadowMaps) {
+        if (!shadowMap || !shadowMap->IsCascaded()) continue;
+        
+        shadowMap->UpdateCascades(cameraView, fovY, aspect, cameraNear, cameraFar);
+        
+        for (int cascade = 0; cascade < shadowMap->GetCascadeCount(); cascade++) {
+            if (!shadowMap->CascadeNeedsRender(cascade)) continue;
+            
+            const glm::mat4& lightSpaceMatrix = shadowMap->GetCascadeLightSpaceMatrix(cascade);
+            
+            if (shadowMap->IsStaticCacheEnabled()) {
+                // Static casters only when the cached layer went stale
+                if (shadowMap->CascadeStaticDirty(cascade)) {
+                    shadowMap->BeginStaticCachePass(cascade);
+                    renderStaticCasters(lightSpaceMatrix);
+                    shadowMap->EndShadowMapPass(windowWidth, windowHeight);
+                }
+                
+                shadowMap->BeginCascadePass(cascade);
+                renderDynamicCasters(lightSpaceMatrix);
+                shadowMap->EndShadowMapPass(windowWidth, windowHeight);
+            } else {
+                shadowMap->BeginCascadePass(cascade);
+                renderStaticCasters(lightSpaceMatrix);
+                renderDynamicCasters(lightSpaceMatrix);
+                shadowMap->EndShadowMapPass(windowWidth, windowHeight);
+            }
+        }
+    }
+}
+
+void ShadowMappingManager::InvalidateStaticShadows() {
+    for (auto& shadowMap : m_shadowMaps) {
+        if (shadowMap) {
+            shadowMap->InvalidateStaticCache();
+        }
+    }
+}
+
 void ShadowMappingManager::SetupShadowReceive(const glm::mat4& viewMatrix, const glm::mat4& projMatrix) {
     if (!m_globalShadowsEnabled) return;
     
@@ -26,6 +26,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
 #include <vector>
+#include <functional>
 
 class Shader;
 
@@ -63,9 +64,28 @@ public:
         LINEAR,         // Basic linear filtering
         PCF_2x2,        // 2x2 Percentage Closer Filtering
         PCF_3x3,        // 3x3 PCF - good balance
-        PCF_5x5         // 5x5 PCF - softest shadows, highest cost
+        PCF_5x5,        // 5x5 PCF - softest shadows, highest cost
+        HARDWARE_PCF,       // 1 bilinear comparison tap (hardware 2x2)
+        HARDWARE_PCF_3x3,   // 4 bilinear comparison taps, 3x3 footprint
+        POISSON_DISK        // 8 rotated Poisson taps, 5x5-like softness
     };
 
+    static constexpr int FILTER_MODE_COUNT = 8;
+
+    /**
+     * @brief Human readable filter mode name
+     * @param mode Filter mode
+     * @return Static name string
+     */
+    static const char* GetFilterModeName(FilterMode mode);
+
+    /**
+     * @brief Depth texture fetches per fragment for a filter mode
+     * @param mode Filter mode
+     * @return Number of texture instructions issued by the shader
+     */
+    static int GetFilterTapCount(FilterMode mode);
+
     /**
      * @brief Supported light types for shadow casting
      * 
@@ -78,6 +98,30 @@ public:
         SPOT            // Cone-shaped spot lights
     };
 
+    static constexpr int MAX_CASCADES = 4;
+
+    /**
+     * @brief One slice of a cascaded directional shadow map
+     * 
+     * Each cascade covers a view-space depth range of the camera frustum
+     * and owns one layer of the shadow map texture array. Distant cascades
+     * can be refreshed less often than every frame.
+     * 
+     * The light projection is fitted with some slack and only re-fitted once
+     * the camera slice drifts out of it, so static casters rendered into the
+     * cache layer stay valid across many frames.
+     */
+    struct Cascade {
+        float splitDistance;        // Far edge of the slice in view-space depth
+        glm::mat4 lightSpaceMatrix; // Light projection fitted to the slice
+        glm::vec3 fitCenter;        // Slice bounding sphere the matrix was fitted to
+        float fitRadius;
+        int updateInterval;         // Re-render every N frames
+        int framesSinceUpdate;      // Frames since the layer was last rendered
+        bool needsRender;           // Layer must be redrawn this frame
+        bool staticDirty;           // Cached static casters are out of date
+    };
+
 private:
     // OpenGL shadow mapping resources
     GLuint m_shadowMapFBO;      // Shadow map framebuffer object
@@ -85,6 +129,8 @@ private:
     int m_shadowMapSize;        // Current shadow map resolution
     ShadowQuality m_quality;    // Current quality setting
     FilterMode m_filterMode;    // Current filtering method
+    GLuint m_depthSampler;      // Raw depth reads (sampler2DArray)
+    GLuint m_compareSampler;    // Hardware depth comparison (sampler2DArrayShadow)
 
     // Light configuration
     LightType m_lightType;      // Type of light casting shadows
@@ -114,6 +160,18 @@ private:
     bool m_enableCulling;
     glm::vec4 m_frustumPlanes[6];
 
+    // Cascaded shadow maps (directional lights only, 0 = single map)
+    int m_cascadeCount;
+    float m_cascadeSplitLambda;     // 0 = uniform splits, 1 = logarithmic splits
+    float m_cascadeFitMargin;       // Extra projection radius before a re-fit is needed
+    Cascade m_cascades[MAX_CASCADES];
+
+    // Static caster cache (cascaded maps only)
+    bool m_enableStaticCache;
+    GLuint m_staticCacheFBO;        // Read framebuffer for copying cached layers
+    GLuint m_staticCacheMap;        // Depth array holding static casters only
+    int m_staticCacheRebuilds;      // Number of cache layer re-renders
+
 public:
 
     ShadowMapping(ShadowQuality quality = ShadowQuality::MEDIUM, 
@@ -149,6 +207,17 @@ public:
 
     void BindShadowMap(int textureUnit = 0);
 
+    /**
+     * @brief Bind the shadow map with the hardware comparison sampler
+     * 
+     * The same texture is bound twice: once for raw depth reads used by the
+     * manual filter modes, and once through a GL_COMPARE_REF_TO_TEXTURE
+     * sampler object for the sampler2DArrayShadow based modes.
+     * 
+     * @param textureUnit Texture unit for the comparison sampler
+     */
+    void BindShadowCompareMap(int textureUnit);
+
 
     void SetShadowUniforms(Shader* shader);
 
@@ -158,9 +227,103 @@ public:
 
     GLuint GetShadowMapTexture() const { return m_shadowMap; }
 
+    /**
+     * @brief GPU memory held by the shadow map and its static cache, in bytes
+     */
+    size_t GetMemoryUsage() const;
+
+    /**
+     * @brief Texture target of the shadow map
+     * @return GL_TEXTURE_2D_ARRAY when cascaded, GL_TEXTURE_2D otherwise
+     */
+    GLenum GetTextureTarget() const { return IsCascaded() ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D; }
+
+    /**
+     * @brief Enable cascaded shadow maps for a directional light
+     * 
+     * Recreates the depth texture as an array with one layer per cascade.
+     * Values below 2 disable cascading, values above MAX_CASCADES are clamped.
+     * 
+     * @param count Number of cascades (2-4), or 0 for a single shadow map
+     */
+    void SetCascadeCount(int count);
+    int GetCascadeCount() const { return m_cascadeCount; }
+    bool IsCascaded() const { return m_cascadeCount > 0; }
+
+    /**
+     * @brief Blend factor of the practical split scheme
+     * @param lambda 0 = uniform splits, 1 = logarithmic splits
+     */
+    void SetCascadeSplitLambda(float lambda) { m_cascadeSplitLambda = glm::clamp(lambda, 0.0f, 1.0f); }
+
+    /**
+     * @brief Set how often a cascade is re-rendered
+     * @param cascade Cascade index
+     * @param frames Re-render every N frames (1 = every frame)
+     */
+    void SetCascadeUpdateInterval(int cascade, int frames);
+
+    /**
+     * @brief Recalculate split distances and cascade matrices for the camera
+     * 
+     * Only cascades that are due for an update this frame get a new light
+     * matrix, so the matrix stays consistent with the layer contents.
+     * 
+     * @param cameraView Camera view matrix
+     * @param fovY Vertical field of view in radians
+     * @param aspect Viewport aspect ratio
+     * @param cameraNear Near plane of the shadowed range
+     * @param cameraFar Far plane of the shadowed range
+     */
+    void UpdateCascades(const glm::mat4& cameraView, float fovY, float aspect, float cameraNear, float cameraFar);
+
+    bool CascadeNeedsRender(int cascade) const;
+
+    /**
+     * @brief Bind the layer of one cascade for depth rendering
+     * @param cascade Cascade index
+     */
+    void BeginCascadePass(int cascade);
+
+    /**
+     * @brief Static shadow caster cache
+     * 
+     * When enabled, static casters (terrain) are rendered into a separate
+     * depth array only when the light moves, terrain chunks change or a
+     * cascade is re-fitted. BeginCascadePass then copies the cached layer
+     * and only dynamic casters are drawn on top.
+     */
+    void EnableStaticCache(bool enable);
+    bool IsStaticCacheEnabled() const { return m_enableStaticCache && IsCascaded(); }
+    void InvalidateStaticCache();
+    bool CascadeStaticDirty(int cascade) const;
+
+    /**
+     * @brief Bind the cache layer of one cascade for static caster rendering
+     * @param cascade Cascade index
+     */
+    void BeginStaticCachePass(int cascade);
+
+    /**
+     * @brief Slack added to the cascade projection, as a fraction of its radius
+     * @param margin Larger values re-fit (and re-render statics) less often
+     */
+    void SetCascadeFitMargin(float margin) { m_cascadeFitMargin = glm::clamp(margin, 0.0f, 1.0f); }
+
+    const glm::mat4& GetCascadeLightSpaceMatrix(int cascade) const { return m_cascades[cascade].lightSpaceMatrix; }
+    float GetCascadeSplit(int cascade) const { return m_cascades[cascade].splitDistance; }
+
+    /**
+     * @brief Upload cascadeCount, cascadeSplits[] and lightSpaceMatrices[]
+     * @param shader Shader receiving the cascade uniforms
+     */
+    void SetCascadeUniforms(Shader* shader);
+
     
     void SetShadowQuality(ShadowQuality quality);
     void SetFilterMode(FilterMode mode);
+    FilterMode GetFilterMode() const { return m_filterMode; }
+    int GetShadowMapSize() const { return m_shadowMapSize; }
     void SetDepthBias(float bias) { m_depthBias = bias; }
     void SetNormalBias(float bias) { m_normalBias = bias; }
     void EnableSlopeScaledBias(bool enable) { m_enableSlopeScaledBias = enable; }
@@ -177,6 +340,7 @@ public:
         int culledObjects;
         float shadowMapRenderTime;
         float totalShadowTime;
+        int staticCacheRebuilds;
     };
     
     ShadowStats GetPerformanceStats() const;
@@ -185,8 +349,24 @@ private:
 
     bool CreateShadowMapFBO();
 
+    void CreateSamplers();
+
+    void ApplyFilterParameters();
+
+    bool CreateStaticCache();
+
+    void DeleteStaticCache();
+
+    void ApplyShadowPassState(const glm::mat4& lightSpaceMatrix, bool clearDepth);
+
     void CalculateLightSpaceMatrix();
 
+    void CalculateSliceBounds(const glm::mat4& cameraView, float fovY, float aspect,
+                              float sliceNear, float sliceFar,
+                              glm::vec3& center, float& radius) const;
+
+    glm::mat4 CalculateCascadeMatrix(const glm::vec3& center, float radius) const;
+
     glm::mat4 CalculateOrthographicProjection(const glm::vec3& sceneMin, const glm::vec3& sceneMax);
 
 
@@ -225,6 +405,33 @@ public:
     void RenderAllShadowMaps(int windowWidth, int windowHeight);
 
 
+    ShadowMapping* AddCascadedShadowLight(int lightIndex,
+                                          int cascadeCount,
+                                          ShadowMapping::ShadowQuality quality = ShadowMapping::ShadowQuality::HIGH);
+
+    /**
+     * @brief Refresh the due cascades of every cascaded light
+     * 
+     * @param cameraView Camera view matrix
+     * @param fovY Vertical field of view in radians
+     * @param aspect Viewport aspect ratio
+     * @param cameraNear Near plane of the shadowed range
+     * @param cameraFar Far plane of the shadowed range
+     * @param renderStaticCasters Draws casters that never move (terrain)
+     * @param renderDynamicCasters Draws animated casters, redrawn every refresh
+     * @param windowWidth Viewport width restored after the pass
+     * @param windowHeight Viewport height restored after the pass
+     */
+    void RenderCascadedShadowMaps(const glm::mat4& cameraView, float fovY, float aspect,
+                                  float cameraNear, float cameraFar,
+                                  const std::function<void(const glm::mat4&)>& renderStaticCasters,
+                                  const std::function<void(const glm::mat4&)>& renderDynamicCasters,
+                                  int windowWidth, int windowHeight);
+
+
+    void InvalidateStaticShadows();
+
+
     void SetupShadowReceive(const glm::mat4& viewMatrix, const glm::mat4& projMatrix);
 
 
@@ -0,0 +1,280 @@
+﻿/**
+ * @file SpatialHashGrid.h
+ * @brief Uniform spatial hash over world-space points
+ *
+ * Buckets objects by the XZ cell they fall into so proximity queries only
+ * look at the few cells around the query point instead of every object:
+ * - Insert/Update/Remove are O(1); Update only touches the buckets when an
+ *   object crosses a cell boundary
+ * - Range queries visit the cells overlapped by the query circle
+ * - Nearest-neighbour queries search rings of cells outwards and stop as
+ *   soon as no unvisited ring can hold anything closer
+ *
+ * Only occupied cells are stored, so the grid covers an unbounded streamed
+ * world. Distances are measured in 3D; the Y axis is not bucketed because
+ * the world is a heightfield.
+ */
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Hash grid keyed by a caller-chosen object ID
+ *
+ * @tparam T Object identifier (pointer, index, ...) usable with std::hash
+ */
+template <typename T>
+class SpatialHashGrid {
+public:
+    explicit SpatialHashGrid(float cellSize = 4.0f)
+        : m_cellSize(cellSize)
+        , m_inverseCellSize(1.0f / cellSize)
+        , m_minCell(0)
+        , m_maxCell(0)
+    {
+    }
+
+    /**
+     * @brief Add an object, or move it if it is already present
+     */
+    void Insert(const T& id, const glm::vec3& position) {
+        Update(id, position);
+    }
+
+    /**
+     * @brief Move an object; only re-buckets it when its cell changes
+     */
+    void Update(const T& id, const glm::vec3& position) {
+        CellKey key = KeyOf(position);
+
+        auto it = m_index.find(id);
+        if (it != m_index.end()) {
+            Location& location = it->second;
+            if (location.cell == key) {
+                m_cells[key][location.slot].position = position;
+                return;
+            }
+            RemoveFromCell(location.cell, location.slot);
+            m_index.erase(it);
+        }
+
+        std::vector<Entry>& cell = m_cells[key];
+        m_index[id] = { key, cell.size() };
+        cell.push_back({ id, position });
+        ExpandBounds(CellOf(position));
+    }
+
+    /**
+     * @brief Remove an object
+     * @return False if it was not in the grid
+     */
+    bool Remove(const T& id) {
+        auto it = m_index.find(id);
+        if (it == m_index.end()) {
+            return false;
+        }
+        RemoveFromCell(it->second.cell, it->second.slot);
+        m_index.erase(it);
+        return true;
+    }
+
+    void Clear() {
+        m_cells.clear();
+        m_index.clear();
+        m_minCell = glm::ivec2(0);
+        m_maxCell = glm::ivec2(0);
+    }
+
+    bool Contains(const T& id) const { return m_index.find(id) != m_index.end(); }
+    size_t Size() const { return m_index.size(); }
+    size_t GetCellCount() const { return m_cells.size(); }
+    float GetCellSize() const { return m_cellSize; }
+
+    /**
+     * @brief Collect every accepted object within radius of center
+     */
+    template <typename Predicate>
+    void QueryRange(const glm::vec3& center, float radius, std::vector<T>& out, Predicate accept) const {
+        float radiusSquared = radius * radius;
+        auto visit = [&](const std::vector<Entry>& entries) {
+            for (const Entry& entry : entries) {
+                glm::vec3 offset = entry.position - center;
+                if (glm::dot(offset, offset) <= radiusSquared && accept(entry.id)) {
+                    out.push_back(entry.id);
+                }
+            }
+        };
+
+        glm::ivec2 minCell = CellOf(center - glm::vec3(radius));
+        glm::ivec2 maxCell = CellOf(center + glm::vec3(radius));
+        minCell = glm::max(minCell, m_minCell);
+        maxCell = glm::min(maxCell, m_maxCell);
+        if (minCell.x > maxCell.x || minCell.y > maxCell.y) {
+            return;
+        }
+
+        // Large radii: walking the occupied cells is cheaper than probing empty ones
+        size_t covered = static_cast<size_t>(maxCell.x - minCell.x + 1) * static_cast<size_t>(maxCell.y - minCell.y + 1);
+        if (covered > m_cells.size()) {
+            for (const auto& cell : m_cells) {
+                visit(cell.second);
+            }
+            return;
+        }
+
+        for (int z = minCell.y; z <= maxCell.y; ++z) {
+            for (int x = minCell.x; x <= maxCell.x; ++x) {
+                auto it = m_cells.find(MakeKey(x, z));
+                if (it != m_cells.end()) {
+                    visit(it->second);
+                }
+            }
+        }
+    }
+
+    void QueryRange(const glm::vec3& center, float radius, std::vector<T>& out) const {
+        QueryRange(center, radius, out, [](const T&) { return true; });
+    }
+
+    /**
+     * @brief Closest accepted object no further than maxDistance
+     *
+     * @param result Receives the object's ID when one is found
+     * @param distance Receives its distance from center
+     * @return True if an object was found
+     */
+    template <typename Predicate>
+    bool FindNearest(const glm::vec3& center, float maxDistance, T& result, float& distance, Predicate accept) const {
+        if (m_index.empty()) {
+            return false;
+        }
+
+        float best = maxDistance;
+        bool found = false;
+        auto visit = [&](const std::vector<Entry>& entries) {
+            for (const Entry& entry : entries) {
+                float entryDistance = glm::length(entry.position - center);
+                if (entryDistance <= best && accept(entry.id)) {
+                    best = entryDistance;
+                    result = entry.id;
+                    found = true;
+                }
+            }
+        };
+        auto visitCell = [&](int x, int z) {
+            auto it = m_cells.find(MakeKey(x, z));
+            if (it != m_cells.end()) {
+                visit(it->second);
+            }
+        };
+
+        glm::ivec2 origin = CellOf(center);
+        glm::ivec2 farthest = glm::max(glm::abs(origin - m_minCell), glm::abs(origin - m_maxCell));
+        int maxRing = std::max(farthest.x, farthest.y);
+
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            // Anything in this ring or beyond is at least (ring - 1) whole cells away
+            float ringDistance = (ring - 1) * m_cellSize;
+            if (ringDistance > best || (found && ringDistance >= best)) {
+                break;
+            }
+
+            size_t ringArea = static_cast<size_t>(2 * ring + 1) * static_cast<size_t>(2 * ring + 1);
+            if (ringArea > m_cells.size()) {
+                for (const auto& cell : m_cells) {
+                    visit(cell.second);
+                }
+                break;
+            }
+
+            if (ring == 0) {
+                visitCell(origin.x, origin.y);
+                continue;
+            }
+            for (int x = origin.x - ring; x <= origin.x + ring; ++x) {
+                visitCell(x, origin.y - ring);
+                visitCell(x, origin.y + ring);
+            }
+            for (int z = origin.y - ring + 1; z <= origin.y + ring - 1; ++z) {
+                visitCell(origin.x - ring, z);
+                visitCell(origin.x + ring, z);
+            }
+        }
+
+        if (found) {
+            distance = best;
+        }
+        return found;
+    }
+
+    bool FindNearest(const glm::vec3& center, float maxDistance, T& result, float& distance) const {
+        return FindNearest(center, maxDistance, result, distance, [](const T&) { return true; });
+    }
+
+private:
+    using CellKey = int64_t;
+
+    struct Entry {
+        T id;
+        glm::vec3 position;
+    };
+
+    struct Location {
+        CellKey cell;
+        size_t slot;    // Index inside the cell's entry list
+    };
+
+    glm::ivec2 CellOf(const glm::vec3& position) const {
+        return glm::ivec2(static_cast<int>(std::floor(position.x * m_inverseCellSize)),
+                          static_cast<int>(std::floor(position.z * m_inverseCellSize)));
+    }
+
+    CellKey KeyOf(const glm::vec3& position) const {
+        glm::ivec2 cell = CellOf(position);
+        return MakeKey(cell.x, cell.y);
+    }
+
+    static CellKey MakeKey(int x, int z) {
+        return (static_cast<CellKey>(x) << 32) | static_cast<uint32_t>(z);
+    }
+
+    void ExpandBounds(const glm::ivec2& cell) {
+        if (m_index.size() == 1) {
+            m_minCell = cell;
+            m_maxCell = cell;
+        } else {
+            m_minCell = glm::min(m_minCell, cell);
+            m_maxCell = glm::max(m_maxCell, cell);
+        }
+    }
+
+    // Swap-and-pop so removal never shifts a bucket
+    void RemoveFromCell(CellKey key, size_t slot) {
+        auto it = m_cells.find(key);
+        std::vector<Entry>& entries = it->second;
+
+        if (slot + 1 != entries.size()) {
+            entries[slot] = entries.back();
+            m_index[entries[slot].id].slot = slot;
+        }
+        entries.pop_back();
+
+        if (entries.empty()) {
+            m_cells.erase(it);
+        }
+    }
+
+    float m_cellSize;
+    float m_inverseCellSize;
+    std::unordered_map<CellKey, std::vector<Entry>> m_cells;
+    std::unordered_map<T, Location> m_index;
+    glm::ivec2 m_minCell;   // Occupied cell extent; only grows until Clear()
+    glm::ivec2 m_maxCell;
+};
@@ -0,0 +1,207 @@
+﻿#include "StreamBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+StreamBuffer& StreamBuffer::Get() {
+    static StreamBuffer stream;
+    return stream;
+}
+
+StreamBuffer::StreamBuffer()
+    : m_buffer(0)
+    , m_mapped(nullptr)
+    , m_segmentSize(0)
+    , m_head(0)
+    , m_frame(0)
+    , m_fences{}
+    , m_bytesThisFrame(0)
+    , m_bytesLastFrame(0)
+    , m_fenceWaits(0)
+    , m_fenceWaitMs(0.0)
+    , m_growths(0)
+{
+}
+
+bool StreamBuffer::Initialize(size_t segmentSize) {
+    if (m_buffer != 0) {
+        return true;
+    }
+    if (!CreateBuffer(segmentSize)) {
+        return false;
+    }
+    std::cout << "[StreamBuffer] " << FRAME_COUNT << " x " << (m_segmentSize >> 10) << " KB ring, "
+              << (m_mapped ? "persistently mapped" : "unsynchronized range maps (no GL 4.4)") << std::endl;
+    return true;
+}
+
+bool StreamBuffer::CreateBuffer(size_t segmentSize) {
+    size_t bytes = segmentSize * FRAME_COUNT;
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, bytes, nullptr, flags);
+        m_mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bytes, flags));
+    } else {
+        glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+        m_mapped = nullptr;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if ((GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) && m_mapped == nullptr) {
+        std::cerr << "[StreamBuffer] Failed to map the ring" << std::endl;
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+        return false;
+    }
+    m_segmentSize = segmentSize;
+    return true;
+}
+
+void StreamBuffer::Shutdown() {
+    for (GLsync& fence : m_fences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (!m_retired.empty()) {
+        glDeleteBuffers(static_cast<GLsizei>(m_retired.size()), m_retired.data());
+        m_retired.clear();
+    }
+    if (m_buffer != 0) {
+        // Deleting a mapped buffer unmaps it
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+    m_mapped = nullptr;
+    m_segmentSize = 0;
+    m_head = 0;
+}
+
+void StreamBuffer::BeginFrame() {
+    if (m_buffer == 0) {
+        return;
+    }
+    // Anything that could still be drawn from them was submitted last frame
+    if (!m_retired.empty()) {
+        glDeleteBuffers(static_cast<GLsizei>(m_retired.size()), m_retired.data());
+        m_retired.clear();
+    }
+    m_frame++;
+    m_head = 0;
+    WaitForSegment(static_cast<int>(m_frame % FRAME_COUNT));
+}
+
+void StreamBuffer::EndFrame() {
+    m_bytesLastFrame = m_bytesThisFrame;
+    m_bytesThisFrame = 0;
+    if (m_buffer == 0) {
+        return;
+    }
+    GLsync& fence = m_fences[m_frame % FRAME_COUNT];
+    if (fence != nullptr) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamBuffer::WaitForSegment(int segment) {
+    GLsync& fence = m_fences[segment];
+    if (fence == nullptr) {
+        return;
+    }
+
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        // The GPU is FRAME_COUNT frames behind; this is the only place the ring stalls
+        auto start = std::chrono::steady_clock::now();
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NS);
+        } while (status == GL_TIMEOUT_EXPIRED);
+        m_fenceWaits++;
+        m_fenceWaitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::Grow(size_t minimumSegmentSize) {
+    size_t segmentSize = std::max(m_segmentSize, DEFAULT_SEGMENT_SIZE);
+    while (segmentSize < minimumSegmentSize) {
+        segmentSize *= 2;
+    }
+
+    // The old buffer's pending work is tracked by GL itself; the new one has none
+    for (GLsync& fence : m_fences) {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    m_retired.push_back(m_buffer);
+    m_buffer = 0;
+    m_mapped = nullptr;
+    if (CreateBuffer(segmentSize)) {
+        m_growths++;
+        std::cout << "[StreamBuffer] Grew to " << FRAME_COUNT << " x " << (m_segmentSize >> 10) << " KB" << std::endl;
+    }
+    m_head = 0;
+}
+
+StreamAllocation StreamBuffer::Write(const void* data, size_t bytes, size_t alignment) {
+    if (bytes == 0) {
+        return {};
+    }
+    if (m_buffer == 0 && !Initialize()) {
+        return {};
+    }
+
+    alignment = std::max<size_t>(alignment, 1);
+    size_t offset = (m_head + alignment - 1) / alignment * alignment;
+    if (offset + bytes > m_segmentSize) {
+        Grow(std::max(m_segmentSize * 2, bytes + alignment));
+        if (m_buffer == 0) {
+            return {};
+        }
+        offset = 0;
+    }
+    m_head = offset + bytes;
+    offset += (m_frame % FRAME_COUNT) * m_segmentSize;
+
+    if (m_mapped != nullptr) {
+        // Coherent mapping: visible to every command issued after this
+        std::memcpy(m_mapped + offset, data, bytes);
+    } else {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+        void* range = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, bytes,
+                                       GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        if (range == nullptr) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            return {};
+        }
+        std::memcpy(range, data, bytes);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    m_bytesThisFrame += bytes;
+    return { m_buffer, offset, bytes, m_frame };
+}
+
+bool StreamBuffer::IsResident(const StreamAllocation& allocation) const {
+    return allocation.buffer != 0 && allocation.buffer == m_buffer && allocation.frame == m_frame;
+}
+
+StreamBuffer::Stats StreamBuffer::GetStats() const {
+    Stats stats = {};
+    stats.bytesLastFrame = m_bytesLastFrame;
+    stats.capacityBytes = m_segmentSize * FRAME_COUNT;
+    stats.fenceWaits = m_fenceWaits;
+    stats.fenceWaitMs = m_fenceWaitMs;
+    stats.growths = m_growths;
+    stats.persistent = m_mapped != nullptr;
+    return stats;
+}
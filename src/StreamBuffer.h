@@ -0,0 +1,128 @@
+﻿/**
+ * @file StreamBuffer.h
+ * @brief Per-frame ring allocator for dynamic GPU data
+ *
+ * Data rewritten every frame (GUI batches, text quads, culling items,
+ * indirect draw commands, light clusters) is copied into one large buffer instead of
+ * being respecified with glBufferData/glBufferSubData:
+ * - The buffer is split into FRAME_COUNT segments and each frame
+ *   allocates linearly from its own segment
+ * - EndFrame() fences the segment; BeginFrame() waits on that fence
+ *   before the segment is reused, which only blocks if the GPU is more
+ *   than FRAME_COUNT - 1 frames behind
+ * - With GL 4.4 (or ARB_buffer_storage) the buffer is mapped once,
+ *   persistent and coherent, so a write is a memcpy. On the GL 4.1
+ *   baseline each write maps just its range unsynchronized, which the
+ *   fences make safe
+ *
+ * Neither path orphans the buffer or lets the driver synchronise on it.
+ * A segment that overflows doubles the whole ring into a fresh buffer;
+ * earlier allocations of the frame keep pointing at the old one, which
+ * is deleted once no further work can use it.
+ *
+ * Allocations are only valid during the frame that wrote them. When a
+ * segment comes round again, BeginFrame() only waits for the frame that
+ * last wrote it, so the draws of the frames in between may still be
+ * reading older data. Users that keep data across frames check
+ * IsResident() and write it again in every frame that draws from it.
+ *
+ * The buffer is created on the first write, so users need not care
+ * whether the ring was initialized. Shutdown() must run while the GL
+ * context is still current.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Range of the ring holding one write
+ */
+struct StreamAllocation {
+    GLuint buffer = 0;      // Zero if the write failed
+    size_t offset = 0;      // Bytes from the start of the buffer
+    size_t bytes = 0;
+    uint64_t frame = 0;     // Frame that wrote it
+};
+
+/**
+ * @brief Process-wide streaming ring; see the file comment
+ */
+class StreamBuffer {
+public:
+    static constexpr int FRAME_COUNT = 3;
+    static constexpr size_t DEFAULT_SEGMENT_SIZE = 1 << 20;     // Per frame
+
+    /**
+     * @brief Counters for the performance overlay
+     */
+    struct Stats {
+        size_t bytesLastFrame;      // Written during the last finished frame
+        size_t capacityBytes;       // All segments
+        size_t fenceWaits;          // Frames that had to wait for their segment, ever
+        double fenceWaitMs;         // Time spent in those waits, ever
+        size_t growths;
+        bool persistent;            // Persistent mapping in use
+    };
+
+    static StreamBuffer& Get();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    bool Initialize(size_t segmentSize = DEFAULT_SEGMENT_SIZE);
+    void Shutdown();
+
+    /**
+     * @brief Move to the next segment, waiting until the GPU is done with it
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Fence the current segment; call after the frame's last draw
+     */
+    void EndFrame();
+
+    /**
+     * @brief Copy data into the current segment
+     *
+     * @param alignment Offset alignment the binding point needs (e.g. the
+     *                  shader storage offset alignment)
+     * @return The range written, or an allocation with buffer 0 on failure
+     */
+    StreamAllocation Write(const void* data, size_t bytes, size_t alignment = 16);
+
+    /**
+     * @brief Whether an allocation was written this frame and may still be drawn from
+     */
+    bool IsResident(const StreamAllocation& allocation) const;
+
+    Stats GetStats() const;
+
+private:
+    StreamBuffer();
+    ~StreamBuffer() = default;
+
+    bool CreateBuffer(size_t segmentSize);
+    void Grow(size_t minimumSegmentSize);
+    void WaitForSegment(int segment);
+
+    GLuint m_buffer;
+    uint8_t* m_mapped;                      // Persistent mapping, or null on the fallback path
+    size_t m_segmentSize;
+    size_t m_head;                          // Next free byte of the current segment, relative to it
+    uint64_t m_frame;
+    GLsync m_fences[FRAME_COUNT];
+    std::vector<GLuint> m_retired;          // Outgrown buffers still referenced by this frame
+
+    size_t m_bytesThisFrame;
+    size_t m_bytesLastFrame;
+    size_t m_fenceWaits;
+    double m_fenceWaitMs;
+    size_t m_growths;
+
+    static constexpr GLuint64 WAIT_TIMEOUT_NS = 1000000;
+};
@@ -1,10 +1,39 @@
 ﻿#include "TerrainGenerator.h"
+#include "MeshOptimizer.h"
 #include "Shader.h"
 #include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <cfloat>
 
+// Moller-Trumbore, two-sided; t is in units of direction's length
+static bool IntersectTriangle(const glm::vec3& origin, const glm::vec3& direction,
+                              const glm::vec3& v0, const glm::vec3& v1, const glm::vec3& v2, float& t) {
+    glm::vec3 edge1 = v1 - v0;
+    glm::vec3 edge2 = v2 - v0;
+    glm::vec3 p = glm::cross(direction, edge2);
+    float determinant = glm::dot(edge1, p);
+    if (std::abs(determinant) < 1e-12f) {
+        return false;
+    }
+    
+    float inverse = 1.0f / determinant;
+    glm::vec3 s = origin - v0;
+    float u = glm::dot(s, p) * inverse;
+    if (u < 0.0f || u > 1.0f) {
+        return false;
+    }
+    
+    glm::vec3 q = glm::cross(s, edge1);
+    float v = glm::dot(direction, q) * inverse;
+    if (v < 0.0f || u + v > 1.0f) {
+        return false;
+    }
+    
+    t = glm::dot(edge2, q) * inverse;
+    return true;
+}
+
 TerrainGenerator::TerrainGenerator(int chunkSize, float chunkScale)
     : m_chunkSize(chunkSize)
     , m_chunkScale(chunkScale)
@@ -14,22 +43,75 @@ TerrainGenerator::TerrainGenerator(int chunkSize, float chunkScale)
     , m_lastCenterPos(-9999.0f, -9999.0f)
     , m_renderDistance(100.0f)
     , m_terrainUpdated(false)
+    , m_geometryPool("Terrain", {
+          sizeof(TerrainVertex), {
+              { 0, 3, offsetof(TerrainVertex, position) },
+              { 1, 3, offsetof(TerrainVertex, normal) },
+              { 2, 2, offsetof(TerrainVertex, texCoord) },
+              { 3, 3, offsetof(TerrainVertex, color) }
+          }
+      }, static_cast<size_t>(chunkSize) * chunkSize * POOL_INITIAL_CHUNKS,
+      static_cast<size_t>(chunkSize - 1) * (chunkSize - 1) * 6)
+    , m_gridIndexBlock(GeometryPool::INVALID_HANDLE)
+    , m_cullItemsDirty(true)
+    , m_cullPoolGeneration(0)
+    , m_culled(false)
 {
     std::cout << "Terrain Generator initialized:" << std::endl;
     std::cout << "  Chunk Size: " << m_chunkSize << "x" << m_chunkSize << std::endl;
     std::cout << "  Chunk Scale: " << m_chunkScale << std::endl;
     std::cout << "  Height Scale: " << m_heightScale << std::endl;
+    
+    BuildGridLayout();
 }
 
-TerrainGenerator::~TerrainGenerator() {
+std::vector<unsigned int> TerrainGenerator::GenerateGridIndices(int chunkSize) {
+    std::vector<unsigned int> indices;
+    indices.reserve(static_cast<size_t>(chunkSize - 1) * (chunkSize - 1) * 6);
     
-    for (auto& chunk : m_chunks) {
-        if (chunk && chunk->isGenerated) {
-            glDeleteVertexArrays(1, &chunk->VAO);
-            glDeleteBuffers(1, &chunk->VBO);
-            glDeleteBuffers(1, &chunk->EBO);
+    for (int z = 0; z < chunkSize - 1; z++) {
+        for (int x = 0; x < chunkSize - 1; x++) {
+            unsigned int topLeft = z * chunkSize + x;
+            unsigned int topRight = topLeft + 1;
+            unsigned int bottomLeft = (z + 1) * chunkSize + x;
+            unsigned int bottomRight = bottomLeft + 1;
+            
+            
+            indices.push_back(topLeft);
+            indices.push_back(bottomLeft);
+            indices.push_back(topRight);
+            
+            
+            indices.push_back(topRight);
+            indices.push_back(bottomLeft);
+            indices.push_back(bottomRight);
         }
     }
+    return indices;
+}
+
+void TerrainGenerator::BuildGridLayout() {
+    size_t vertexCount = static_cast<size_t>(m_chunkSize) * m_chunkSize;
+    m_gridIndices = GenerateGridIndices(m_chunkSize);
+    MeshOptimizer::CacheStats before = MeshOptimizer::AnalyzeVertexCache(m_gridIndices, vertexCount);
+    
+    // Triangles keep their vertex order, so each cell's diagonal (which the
+    // height and ray queries assume) is unchanged. A heightfield seen from
+    // above has little self-overdraw, so only cache and fetch order are applied.
+    MeshOptimizer::OptimizeVertexCache(m_gridIndices, vertexCount);
+    
+    // CPU-side vertices stay row-major for the height queries; only the
+    // uploaded copy is renumbered
+    m_gridUploadIndices = m_gridIndices;
+    MeshOptimizer::OptimizeVertexFetch(m_gridUploadIndices, vertexCount, m_gridVertexRemap);
+    
+    MeshOptimizer::CacheStats after = MeshOptimizer::AnalyzeVertexCache(m_gridIndices, vertexCount);
+    std::cout << "  Grid ACMR: " << before.GetACMR() << " -> " << after.GetACMR()
+              << ", ATVR: " << before.GetATVR() << " -> " << after.GetATVR() << std::endl;
+}
+
+TerrainGenerator::~TerrainGenerator() {
+    // Chunk geometry goes with m_geometryPool
 }
 
 void TerrainGenerator::GenerateTerrainAt(const glm::vec2& centerPos) {
@@ -51,19 +133,12 @@ void TerrainGenerator::GenerateTerrainAt(const glm::vec2& centerPos) {
     for (int x = centerChunkX - radius; x <= centerChunkX + radius; x++) {
         for (int z = centerChunkZ - radius; z <= centerChunkZ + radius; z++) {
             
-            bool exists = false;
-            for (const auto& chunk : m_chunks) {
-                if (chunk && 
-                    abs(static_cast<int>(chunk->vertices[0].position.x / m_chunkScale) - x) < 1 &&
-                    abs(static_cast<int>(chunk->vertices[0].position.z / m_chunkScale) - z) < 1) {
-                    exists = true;
-                    break;
-                }
-            }
+            bool exists = m_chunkLookup.find(ChunkKey(x, z)) != m_chunkLookup.end();
             
             if (!exists) {
                 auto newChunk = std::unique_ptr<TerrainChunk>(CreateChunk(x, z));
                 if (newChunk) {
+                    m_chunkLookup[ChunkKey(x, z)] = newChunk.get();
                     m_chunks.push_back(std::move(newChunk));
                     newChunksGenerated = true;
                 }
@@ -72,12 +147,16 @@ void TerrainGenerator::GenerateTerrainAt(const glm::vec2& centerPos) {
     }
     
     
+    size_t chunkCount = m_chunks.size();
     CleanupDistantChunks(centerPos);
     
     
     if (newChunksGenerated) {
         m_terrainUpdated = true;
     }
+    if (newChunksGenerated || m_chunks.size() != chunkCount) {
+        m_cullItemsDirty = true;
+    }
     
     std::cout << "Generated terrain at (" << centerPos.x << ", " << centerPos.y 
               << ") - Total chunks: " << m_chunks.size() << std::endl;
@@ -85,9 +164,12 @@ void TerrainGenerator::GenerateTerrainAt(const glm::vec2& centerPos) {
 
 TerrainChunk* TerrainGenerator::CreateChunk(int chunkX, int chunkZ) {
     auto chunk = new TerrainChunk();
+    chunk->chunkX = chunkX;
+    chunk->chunkZ = chunkZ;
     
     try {
         GenerateChunkVertices(chunk, chunkX, chunkZ);
+        BuildHeightPyramid(chunk);
         CalculateNormals(chunk);
         AssignBiomeColors(chunk);
         SetupChunkBuffers(chunk);
@@ -132,23 +214,49 @@ void TerrainGenerator::GenerateChunkVertices(TerrainChunk* chunk, int chunkX, in
     }
     
     
-    for (int z = 0; z < m_chunkSize - 1; z++) {
-        for (int x = 0; x < m_chunkSize - 1; x++) {
-            unsigned int topLeft = z * m_chunkSize + x;
-            unsigned int topRight = topLeft + 1;
-            unsigned int bottomLeft = (z + 1) * m_chunkSize + x;
-            unsigned int bottomRight = bottomLeft + 1;
-            
-            
-            chunk->indices.push_back(topLeft);
-            chunk->indices.push_back(bottomLeft);
-            chunk->indices.push_back(topRight);
-            
-            
-            chunk->indices.push_back(topRight);
-            chunk->indices.push_back(bottomLeft);
-            chunk->indices.push_back(bottomRight);
+    chunk->indices = m_gridIndices;
+}
+
+void TerrainGenerator::BuildHeightPyramid(TerrainChunk* chunk) {
+    int cells = m_chunkSize - 1;
+    
+    chunk->heights.resize(chunk->vertices.size());
+    for (size_t i = 0; i < chunk->vertices.size(); i++) {
+        chunk->heights[i] = chunk->vertices[i].position.y;
+    }
+    
+    // Level 0 bounds the four corners of each cell
+    chunk->heightPyramid.clear();
+    std::vector<glm::vec2> cellBounds(static_cast<size_t>(cells) * cells);
+    for (int z = 0; z < cells; z++) {
+        for (int x = 0; x < cells; x++) {
+            const float* row0 = &chunk->heights[z * m_chunkSize + x];
+            const float* row1 = row0 + m_chunkSize;
+            cellBounds[z * cells + x] = glm::vec2(
+                std::min(std::min(row0[0], row0[1]), std::min(row1[0], row1[1])),
+                std::max(std::max(row0[0], row0[1]), std::max(row1[0], row1[1])));
+        }
+    }
+    chunk->heightPyramid.push_back(std::move(cellBounds));
+    
+    // Each further level merges 2x2 blocks until one node covers the chunk
+    int side = cells;
+    while (side > 1) {
+        int parentSide = (side + 1) / 2;
+        const std::vector<glm::vec2>& child = chunk->heightPyramid.back();
+        std::vector<glm::vec2> parent(static_cast<size_t>(parentSide) * parentSide, glm::vec2(FLT_MAX, -FLT_MAX));
+        
+        for (int z = 0; z < side; z++) {
+            for (int x = 0; x < side; x++) {
+                glm::vec2& bounds = parent[(z / 2) * parentSide + x / 2];
+                const glm::vec2& childBounds = child[z * side + x];
+                bounds.x = std::min(bounds.x, childBounds.x);
+                bounds.y = std::max(bounds.y, childBounds.y);
+            }
         }
+        
+        chunk->heightPyramid.push_back(std::move(parent));
+        side = parentSide;
     }
 }
 
@@ -197,46 +305,17 @@ void TerrainGenerator::AssignBiomeColors(TerrainChunk* chunk) {
 }
 
 void TerrainGenerator::SetupChunkBuffers(TerrainChunk* chunk) {
-    glGenVertexArrays(1, &chunk->VAO);
-    glGenBuffers(1, &chunk->VBO);
-    glGenBuffers(1, &chunk->EBO);
-    
-    glBindVertexArray(chunk->VAO);
-    
-    
-    glBindBuffer(GL_ARRAY_BUFFER, chunk->VBO);
-    glBufferData(GL_ARRAY_BUFFER, 
-                 chunk->vertices.size() * sizeof(TerrainVertex), 
-                 chunk->vertices.data(), 
-                 GL_STATIC_DRAW);
-    
-    
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk->EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, 
-                 chunk->indices.size() * sizeof(unsigned int), 
-                 chunk->indices.data(), 
-                 GL_STATIC_DRAW);
-    
-    
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex), 
-                         (void*)offsetof(TerrainVertex, normal));
-    glEnableVertexAttribArray(1);
-    
-    
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex), 
-                         (void*)offsetof(TerrainVertex, texCoord));
-    glEnableVertexAttribArray(2);
-    
+    if (m_gridIndexBlock == GeometryPool::INVALID_HANDLE) {
+        m_gridIndexBlock = m_geometryPool.Allocate(nullptr, 0, m_gridUploadIndices.data(), m_gridUploadIndices.size());
+    }
     
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(TerrainVertex), 
-                         (void*)offsetof(TerrainVertex, color));
-    glEnableVertexAttribArray(3);
+    // Upload in first-use order so the vertex fetch walks the buffer forwards
+    std::vector<TerrainVertex> uploadVertices(chunk->vertices.size());
+    for (size_t i = 0; i < chunk->vertices.size(); i++) {
+        uploadVertices[m_gridVertexRemap[i]] = chunk->vertices[i];
+    }
     
-    glBindVertexArray(0);
+    chunk->geometry = m_geometryPool.Allocate(uploadVertices.data(), uploadVertices.size(), nullptr, 0);
 }
 
 float TerrainGenerator::GetHeightNoise(float x, float z) {
@@ -294,49 +373,176 @@ glm::vec3 TerrainGenerator::GetBiomeColor(BiomeType biome, float height) {
     }
 }
 
-void TerrainGenerator::RenderTerrain(Shader& shader, const glm::mat4& view, const glm::mat4& projection) {
+void TerrainGenerator::CullTerrain(GpuCulling* culling, const glm::mat4& viewProjection) {
+    m_culled = false;
+    if (!culling || !culling->IsEnabled() || m_gridIndexBlock == GeometryPool::INVALID_HANDLE) {
+        return;
+    }
+    if (m_cullItemsDirty || m_cullPoolGeneration != m_geometryPool.GetGeneration()) {
+        RebuildCullItems();
+    }
+    culling->Cull(m_cullBatch, viewProjection, false);
+    m_culled = true;
+}
+
+void TerrainGenerator::RenderTerrain(Shader& shader, const glm::mat4& view, const glm::mat4& projection,
+                                     bool useCulledCommands) {
+    // Commands are only usable while the chunks and pool layout they were made from are unchanged
+    bool culled = useCulledCommands && m_culled && !m_cullItemsDirty &&
+                  m_cullPoolGeneration == m_geometryPool.GetGeneration();
+    if (culled) {
+        shader.Use();
+        shader.SetMat4("view", view);
+        shader.SetMat4("projection", projection);
+        shader.SetMat4("model", glm::mat4(1.0f));
+        
+        m_geometryPool.Bind();
+        m_geometryPool.MultiDrawIndirect(m_cullBatch.GetCommandBuffer(),
+                                         static_cast<GLsizei>(m_cullBatch.GetItemCount()),
+                                         m_cullBatch.GetCountBuffer());
+        glBindVertexArray(0);
+        return;
+    }
+    
     shader.Use();
     shader.SetMat4("view", view);
     shader.SetMat4("projection", projection);
     
+    shader.SetMat4("model", glm::mat4(1.0f));
+    if (m_gridIndexBlock == GeometryPool::INVALID_HANDLE) {
+        return;
+    }
+    
+    // Chunks differ only in their base vertex; nearest first so early-Z rejects the hidden ones
+    const GeometryPool::Range& grid = m_geometryPool.GetRange(m_gridIndexBlock);
+    glm::vec3 cameraPos = glm::vec3(glm::inverse(view)[3]);
+    m_sortedCommands.clear();
     for (const auto& chunk : m_chunks) {
         if (chunk && chunk->isGenerated) {
-            glm::mat4 model = glm::mat4(1.0f);
-            shader.SetMat4("model", model);
-            
-            glBindVertexArray(chunk->VAO);
-            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(chunk->indices.size()), GL_UNSIGNED_INT, 0);
+            glm::vec2 center = (glm::vec2(chunk->chunkX, chunk->chunkZ) + 0.5f) * m_chunkScale;
+            float distance = glm::length(center - glm::vec2(cameraPos.x, cameraPos.z));
+            m_sortedCommands.push_back({ distance, { grid.indexCount, 1, grid.firstIndex,
+                                                     m_geometryPool.GetRange(chunk->geometry).baseVertex, 0 } });
         }
     }
+    std::sort(m_sortedCommands.begin(), m_sortedCommands.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
     
+    m_drawCommands.clear();
+    for (const auto& entry : m_sortedCommands) {
+        m_drawCommands.push_back(entry.second);
+    }
+    
+    m_geometryPool.Bind();
+    m_geometryPool.MultiDraw(m_drawCommands);
     glBindVertexArray(0);
 }
 
+void TerrainGenerator::RebuildCullItems() {
+    const GeometryPool::Range& grid = m_geometryPool.GetRange(m_gridIndexBlock);
+    m_cullItems.clear();
+    for (const auto& chunk : m_chunks) {
+        if (!chunk || !chunk->isGenerated || chunk->heightPyramid.empty()) {
+            continue;
+        }
+        // The pyramid's root node holds the chunk's height range
+        const glm::vec2& heightRange = chunk->heightPyramid.back()[0];
+        CullItem item{};
+        item.boundsMin = glm::vec4(chunk->chunkX * m_chunkScale, heightRange.x, chunk->chunkZ * m_chunkScale, 0.0f);
+        item.boundsMax = glm::vec4((chunk->chunkX + 1) * m_chunkScale, heightRange.y, (chunk->chunkZ + 1) * m_chunkScale, 0.0f);
+        item.transform = glm::mat4(1.0f);
+        item.command = { grid.indexCount, 1, grid.firstIndex, m_geometryPool.GetRange(chunk->geometry).baseVertex, 0 };
+        m_cullItems.push_back(item);
+    }
+    
+    m_cullBatch.SetItems(m_cullItems);
+    m_cullItemsDirty = false;
+    m_cullPoolGeneration = m_geometryPool.GetGeneration();
+}
+
 float TerrainGenerator::GetHeightAt(float x, float z) {
+    const TerrainChunk* chunk = FindChunk(static_cast<int>(std::floor(x / m_chunkScale)),
+                                          static_cast<int>(std::floor(z / m_chunkScale)));
+    if (chunk && !chunk->heights.empty()) {
+        return SampleChunkHeight(*chunk, x, z);
+    }
     return GetHeightNoise(x, z);
 }
 
+void TerrainGenerator::GetHeightsAt(std::span<const glm::vec2> positions, std::span<float> heights) {
+    const TerrainChunk* chunk = nullptr;
+    int lastChunkX = 0, lastChunkZ = 0;
+    bool haveLookup = false;
+    
+    for (size_t i = 0; i < positions.size() && i < heights.size(); i++) {
+        const glm::vec2& position = positions[i];
+        int chunkX = static_cast<int>(std::floor(position.x / m_chunkScale));
+        int chunkZ = static_cast<int>(std::floor(position.y / m_chunkScale));
+        
+        if (!haveLookup || chunkX != lastChunkX || chunkZ != lastChunkZ) {
+            chunk = FindChunk(chunkX, chunkZ);
+            lastChunkX = chunkX;
+            lastChunkZ = chunkZ;
+            haveLookup = true;
+        }
+        
+        if (chunk && !chunk->heights.empty()) {
+            heights[i] = SampleChunkHeight(*chunk, position.x, position.y);
+        } else {
+            heights[i] = GetHeightNoise(position.x, position.y);
+        }
+    }
+}
+
+float TerrainGenerator::SampleChunkHeight(const TerrainChunk& chunk, float x, float z) const {
+    int cells = m_chunkSize - 1;
+    float cellsPerUnit = cells / m_chunkScale;
+    float localX = (x - chunk.chunkX * m_chunkScale) * cellsPerUnit;
+    float localZ = (z - chunk.chunkZ * m_chunkScale) * cellsPerUnit;
+    
+    int cellX = std::clamp(static_cast<int>(localX), 0, cells - 1);
+    int cellZ = std::clamp(static_cast<int>(localZ), 0, cells - 1);
+    float fx = std::clamp(localX - cellX, 0.0f, 1.0f);
+    float fz = std::clamp(localZ - cellZ, 0.0f, 1.0f);
+    
+    const float* row0 = &chunk.heights[cellZ * m_chunkSize + cellX];
+    const float* row1 = row0 + m_chunkSize;
+    
+    // Planar interpolation on the rendered triangle; the split runs from (1,0) to (0,1)
+    if (fx + fz <= 1.0f) {
+        return row0[0] + fx * (row0[1] - row0[0]) + fz * (row1[0] - row0[0]);
+    }
+    return row1[1] + (1.0f - fx) * (row1[0] - row1[1]) + (1.0f - fz) * (row0[1] - row1[1]);
+}
+
 glm::vec3 TerrainGenerator::FindSafeSpawnPoint(float preferredX, float preferredZ) {
     std::cout << "Finding safe spawn point near (" << preferredX << ", " << preferredZ << ")" << std::endl;
     
     
     float height = GetHeightAt(preferredX, preferredZ);
     
-    
-    float tolerance = 0.5f;  
-    bool isFlat = true;
-    
-    
-    for (float x = preferredX - 1.5f; x <= preferredX + 1.5f; x += 0.5f) {
-        for (float z = preferredZ - 1.5f; z <= preferredZ + 1.5f; z += 0.5f) {
-            float checkHeight = GetHeightAt(x, z);
-            if (abs(checkHeight - height) > tolerance) {
-                isFlat = false;
-                break;
+    // Height spread over a 3x3 unit patch, sampled in one batch
+    std::vector<glm::vec2> samplePositions;
+    std::vector<float> sampleHeights;
+    auto maxHeightDifference = [&](float centerX, float centerZ, float referenceHeight) {
+        samplePositions.clear();
+        for (float x = centerX - 1.5f; x <= centerX + 1.5f; x += 0.5f) {
+            for (float z = centerZ - 1.5f; z <= centerZ + 1.5f; z += 0.5f) {
+                samplePositions.emplace_back(x, z);
             }
         }
-        if (!isFlat) break;
-    }
+        sampleHeights.resize(samplePositions.size());
+        GetHeightsAt(samplePositions, sampleHeights);
+        
+        float maxDiff = 0.0f;
+        for (float sampleHeight : sampleHeights) {
+            maxDiff = std::max(maxDiff, std::abs(sampleHeight - referenceHeight));
+        }
+        return maxDiff;
+    };
+    
+    float tolerance = 0.5f;  
+    bool isFlat = maxHeightDifference(preferredX, preferredZ, height) <= tolerance;
     
     if (isFlat) {
         std::cout << "Preferred position is suitable. Height: " << height << std::endl;
@@ -358,15 +564,7 @@ glm::vec3 TerrainGenerator::FindSafeSpawnPoint(float preferredX, float preferred
             float testZ = preferredZ + radius * sin(radians);
             
             float testHeight = GetHeightAt(testX, testZ);
-            
-            
-            float maxHeightDiff = 0.0f;
-            for (float x = testX - 1.5f; x <= testX + 1.5f; x += 0.5f) {
-                for (float z = testZ - 1.5f; z <= testZ + 1.5f; z += 0.5f) {
-                    float checkHeight = GetHeightAt(x, z);
-                    maxHeightDiff = glm::max(maxHeightDiff, abs(checkHeight - testHeight));
-                }
-            }
+            float maxHeightDiff = maxHeightDifference(testX, testZ, testHeight);
             
             if (maxHeightDiff < minSteepness) {
                 minSteepness = maxHeightDiff;
@@ -405,18 +603,19 @@ bool TerrainGenerator::IsChunkVisible(int chunkX, int chunkZ, const glm::vec3& c
 void TerrainGenerator::CleanupDistantChunks(const glm::vec2& centerPos) {
     auto it = std::remove_if(m_chunks.begin(), m_chunks.end(),
         [this, centerPos](const std::unique_ptr<TerrainChunk>& chunk) {
-            if (!chunk || chunk->vertices.empty()) return true;
+            if (!chunk) return true;
+            if (chunk->vertices.empty()) {
+                m_chunkLookup.erase(ChunkKey(chunk->chunkX, chunk->chunkZ));
+                return true;
+            }
             
             glm::vec3 chunkCenter = chunk->vertices[chunk->vertices.size() / 2].position;
             float distance = glm::length(glm::vec2(chunkCenter.x - centerPos.x, chunkCenter.z - centerPos.y));
             
             if (distance > m_renderDistance * 1.5f) {
+                m_chunkLookup.erase(ChunkKey(chunk->chunkX, chunk->chunkZ));
                 
-                if (chunk->isGenerated) {
-                    glDeleteVertexArrays(1, &chunk->VAO);
-                    glDeleteBuffers(1, &chunk->VBO);
-                    glDeleteBuffers(1, &chunk->EBO);
-                }
+                m_geometryPool.Free(chunk->geometry);
                 return true;
             }
             return false;
@@ -459,3 +658,203 @@ bool TerrainGenerator::HasTerrainUpdated() {
 void TerrainGenerator::ResetTerrainUpdateFlag() {
     m_terrainUpdated = false;
 }
+
+const TerrainChunk* TerrainGenerator::FindChunk(int chunkX, int chunkZ) const {
+    auto it = m_chunkLookup.find(ChunkKey(chunkX, chunkZ));
+    return it != m_chunkLookup.end() ? it->second : nullptr;
+}
+
+int TerrainGenerator::GetPyramidSide(int level) const {
+    int side = m_chunkSize - 1;
+    for (int i = 0; i < level; i++) {
+        side = (side + 1) / 2;
+    }
+    return side;
+}
+
+bool TerrainGenerator::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                               glm::vec3& hitPoint, float& distance, glm::vec3* normal) const {
+    float length = glm::length(direction);
+    if (length < 1e-8f || m_chunkLookup.empty()) {
+        return false;
+    }
+    glm::vec3 dir = direction / length;
+    
+    // 2D DDA over the chunk grid; each chunk gets the ray interval spent above it
+    int chunkX = static_cast<int>(std::floor(origin.x / m_chunkScale));
+    int chunkZ = static_cast<int>(std::floor(origin.z / m_chunkScale));
+    int stepX = dir.x > 0.0f ? 1 : -1;
+    int stepZ = dir.z > 0.0f ? 1 : -1;
+    
+    float nextX = FLT_MAX, deltaX = FLT_MAX;
+    if (std::abs(dir.x) > 1e-8f) {
+        nextX = ((chunkX + (dir.x > 0.0f ? 1 : 0)) * m_chunkScale - origin.x) / dir.x;
+        deltaX = m_chunkScale / std::abs(dir.x);
+    }
+    float nextZ = FLT_MAX, deltaZ = FLT_MAX;
+    if (std::abs(dir.z) > 1e-8f) {
+        nextZ = ((chunkZ + (dir.z > 0.0f ? 1 : 0)) * m_chunkScale - origin.z) / dir.z;
+        deltaZ = m_chunkScale / std::abs(dir.z);
+    }
+    
+    float t = 0.0f;
+    while (t <= maxDistance) {
+        float tExit = std::min(std::min(nextX, nextZ), maxDistance);
+        
+        const TerrainChunk* chunk = FindChunk(chunkX, chunkZ);
+        if (chunk && !chunk->heightPyramid.empty()) {
+            int topLevel = static_cast<int>(chunk->heightPyramid.size()) - 1;
+            float tHit = 0.0f;
+            glm::vec3 hitNormal(0.0f, 1.0f, 0.0f);
+            if (RaycastHeightNode(*chunk, topLevel, 0, 0, origin, dir, t, tExit, tHit, hitNormal)) {
+                hitPoint = origin + dir * tHit;
+                distance = tHit;
+                if (normal) {
+                    *normal = hitNormal;
+                }
+                return true;
+            }
+        }
+        
+        if (tExit >= maxDistance) {
+            break;
+        }
+        if (nextX < nextZ) {
+            chunkX += stepX;
+            t = nextX;
+            nextX += deltaX;
+        } else {
+            chunkZ += stepZ;
+            t = nextZ;
+            nextZ += deltaZ;
+        }
+    }
+    
+    return false;
+}
+
+bool TerrainGenerator::ClipToCellBlock(const TerrainChunk& chunk, int level, int nodeX, int nodeZ,
+                                       const glm::vec3& origin, const glm::vec3& direction,
+                                       float& tMin, float& tMax) const {
+    int cells = m_chunkSize - 1;
+    float step = m_chunkScale / cells;
+    float startX = chunk.chunkX * m_chunkScale;
+    float startZ = chunk.chunkZ * m_chunkScale;
+    
+    float minBound[2] = { startX + (nodeX << level) * step, startZ + (nodeZ << level) * step };
+    float maxBound[2] = { startX + std::min((nodeX + 1) << level, cells) * step,
+                          startZ + std::min((nodeZ + 1) << level, cells) * step };
+    float rayOrigin[2] = { origin.x, origin.z };
+    float rayDirection[2] = { direction.x, direction.z };
+    
+    for (int axis = 0; axis < 2; axis++) {
+        if (std::abs(rayDirection[axis]) < 1e-8f) {
+            if (rayOrigin[axis] < minBound[axis] || rayOrigin[axis] > maxBound[axis]) {
+                return false;
+            }
+            continue;
+        }
+        
+        float t0 = (minBound[axis] - rayOrigin[axis]) / rayDirection[axis];
+        float t1 = (maxBound[axis] - rayOrigin[axis]) / rayDirection[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+    }
+    
+    return tMin <= tMax;
+}
+
+bool TerrainGenerator::RaycastHeightNode(const TerrainChunk& chunk, int level, int nodeX, int nodeZ,
+                                         const glm::vec3& origin, const glm::vec3& direction,
+                                         float tMin, float tMax, float& tHit, glm::vec3& normal) const {
+    const float epsilon = 1e-4f;
+    
+    // Skip the whole block if the ray passes entirely above or below it
+    const glm::vec2& bounds = chunk.heightPyramid[level][nodeZ * GetPyramidSide(level) + nodeX];
+    float y0 = origin.y + direction.y * tMin;
+    float y1 = origin.y + direction.y * tMax;
+    if (std::min(y0, y1) > bounds.y + epsilon || std::max(y0, y1) < bounds.x - epsilon) {
+        return false;
+    }
+    
+    if (level == 0) {
+        return RaycastCell(chunk, nodeX, nodeZ, origin, direction, tMin, tMax, tHit, normal);
+    }
+    
+    // Children are visited front to back so the first hit is the nearest
+    struct ChildSpan {
+        int x, z;
+        float tMin, tMax;
+    };
+    ChildSpan children[4];
+    int childCount = 0;
+    int childSide = GetPyramidSide(level - 1);
+    
+    for (int dz = 0; dz < 2; dz++) {
+        for (int dx = 0; dx < 2; dx++) {
+            int childX = nodeX * 2 + dx;
+            int childZ = nodeZ * 2 + dz;
+            if (childX >= childSide || childZ >= childSide) {
+                continue;
+            }
+            
+            float childMin = tMin;
+            float childMax = tMax;
+            if (ClipToCellBlock(chunk, level - 1, childX, childZ, origin, direction, childMin, childMax)) {
+                children[childCount++] = { childX, childZ, childMin, childMax };
+            }
+        }
+    }
+    
+    std::sort(children, children + childCount,
+              [](const ChildSpan& a, const ChildSpan& b) { return a.tMin < b.tMin; });
+    
+    for (int i = 0; i < childCount; i++) {
+        const ChildSpan& child = children[i];
+        if (RaycastHeightNode(chunk, level - 1, child.x, child.z, origin, direction,
+                              child.tMin, child.tMax, tHit, normal)) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+bool TerrainGenerator::RaycastCell(const TerrainChunk& chunk, int cellX, int cellZ,
+                                   const glm::vec3& origin, const glm::vec3& direction,
+                                   float tMin, float tMax, float& tHit, glm::vec3& normal) const {
+    float step = m_chunkScale / (m_chunkSize - 1);
+    float x0 = chunk.chunkX * m_chunkScale + cellX * step;
+    float z0 = chunk.chunkZ * m_chunkScale + cellZ * step;
+    const float* row0 = &chunk.heights[cellZ * m_chunkSize + cellX];
+    const float* row1 = row0 + m_chunkSize;
+    
+    glm::vec3 p00(x0, row0[0], z0);
+    glm::vec3 p10(x0 + step, row0[1], z0);
+    glm::vec3 p01(x0, row1[0], z0 + step);
+    glm::vec3 p11(x0 + step, row1[1], z0 + step);
+    
+    // Same diagonal split as the chunk's index buffer
+    const glm::vec3* triangles[2][3] = { { &p00, &p01, &p10 }, { &p10, &p01, &p11 } };
+    
+    const float epsilon = 1e-4f;
+    float best = tMax + epsilon;
+    bool hit = false;
+    for (const auto& triangle : triangles) {
+        float t = 0.0f;
+        if (IntersectTriangle(origin, direction, *triangle[0], *triangle[1], *triangle[2], t) &&
+            t >= tMin - epsilon && t >= 0.0f && t < best) {
+            best = t;
+            normal = glm::normalize(glm::cross(*triangle[1] - *triangle[0], *triangle[2] - *triangle[0]));
+            hit = true;
+        }
+    }
+    
+    if (hit) {
+        tHit = best;
+    }
+    return hit;
+}
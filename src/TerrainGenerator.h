@@ -27,6 +27,11 @@
 
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include "GeometryPool.h"
+#include "GpuCulling.h"
 
 /**
  * @brief Terrain vertex structure with complete rendering data
@@ -65,14 +70,20 @@ enum class BiomeType {
 struct TerrainChunk {
     std::vector<TerrainVertex> vertices;  // All vertices in this chunk
     std::vector<unsigned int> indices;    // Triangle indices for rendering
-    unsigned int VAO, VBO, EBO;          // OpenGL buffer objects
+    GeometryPool::Handle geometry;       // Vertex range in the terrain pool
     BiomeType biome;                     // Dominant biome type for this chunk
     bool isGenerated;                    // Whether chunk geometry is ready
+    int chunkX, chunkZ;                  // Chunk grid coordinates
+    
+    // Height queries run on these instead of re-evaluating noise
+    std::vector<float> heights;                         // Vertex heights, row-major by Z
+    std::vector<std::vector<glm::vec2>> heightPyramid;  // Min/max height per 2^level x 2^level cell block
     
     /**
      * @brief Default constructor initializing chunk to safe state
      */
-    TerrainChunk() : VAO(0), VBO(0), EBO(0), biome(BiomeType::GRASSLAND), isGenerated(false) {}
+    TerrainChunk() : geometry(GeometryPool::INVALID_HANDLE), biome(BiomeType::GRASSLAND), isGenerated(false),
+                     chunkX(0), chunkZ(0) {}
 };
 
 /**
@@ -120,14 +131,30 @@ public:
      * @brief Render all visible terrain chunks
      * 
      * Renders all currently loaded terrain chunks using the provided
-     * shader and camera matrices. Performs frustum culling and LOD
-     * selection for optimal performance.
+     * shader and camera matrices. Chunks share the grid indices in one
+     * geometry pool, so they go out as a single multi-draw. With culled
+     * commands, only the chunks that survived this frame's CullTerrain()
+     * are drawn, without reading anything back.
      * 
      * @param shader Shader program for terrain rendering
      * @param view Camera view transformation matrix
      * @param projection Camera projection matrix
+     * @param useCulledCommands Draw the result of this frame's CullTerrain() when there is one
+     */
+    void RenderTerrain(class Shader& shader, const glm::mat4& view, const glm::mat4& projection,
+                       bool useCulledCommands = false);
+    
+    /**
+     * @brief Test the chunks on the GPU once for every camera pass of the frame
+     * 
+     * The compacted commands are reused by each RenderTerrain() call with
+     * useCulledCommands, so the depth pre-pass and the colour pass draw
+     * the same chunks.
+     * 
+     * @param culling Frustum/Hi-Z culling to apply, or nullptr to draw every chunk
+     * @param viewProjection Camera the terrain is drawn with
      */
-    void RenderTerrain(class Shader& shader, const glm::mat4& view, const glm::mat4& projection);
+    void CullTerrain(GpuCulling* culling, const glm::mat4& viewProjection);
     
     /**
      * @brief Update level-of-detail based on camera position
@@ -143,7 +170,9 @@ public:
     /**
      * @brief Get terrain height at specific world coordinates
      * 
-     * Samples the terrain height function at the specified position.
+     * Inside a loaded chunk the cached vertex heights are interpolated
+     * across the same triangles that are rendered, so objects sit exactly
+     * on the visible surface. Elsewhere the height noise is evaluated.
      * Useful for placing objects on terrain surface or character movement.
      * 
      * @param x World X coordinate
@@ -152,6 +181,17 @@ public:
      */
     float GetHeightAt(float x, float z);
     
+    /**
+     * @brief Batched GetHeightAt
+     * 
+     * Consecutive positions in the same chunk reuse its lookup, so
+     * clustered samples (flatness checks, placement searches) are cheap.
+     * 
+     * @param positions World XZ positions
+     * @param heights Receives one height per position; must be at least as long
+     */
+    void GetHeightsAt(std::span<const glm::vec2> positions, std::span<float> heights);
+    
     /**
      * @brief Find safe spawn location near preferred coordinates
      * 
@@ -165,6 +205,26 @@ public:
      */
     glm::vec3 FindSafeSpawnPoint(float preferredX, float preferredZ);
     
+    /**
+     * @brief Intersect a ray with the loaded terrain mesh
+     * 
+     * Walks the chunks under the ray with a grid DDA, skips blocks of
+     * cells whose min/max height range the ray passes above or below,
+     * and tests the two triangles of each remaining cell exactly. The
+     * result matches the rendered surface; areas without loaded chunks
+     * are never hit.
+     * 
+     * @param origin Ray start
+     * @param direction Ray direction (need not be normalized)
+     * @param maxDistance Maximum distance along the ray
+     * @param hitPoint Receives the intersection point
+     * @param distance Receives the distance from origin to hitPoint
+     * @param normal Optional; receives the hit triangle's normal
+     * @return True if the ray hit the terrain within maxDistance
+     */
+    bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                 glm::vec3& hitPoint, float& distance, glm::vec3* normal = nullptr) const;
+    
     /**
      * @brief Extract collision mesh data for physics engine
      * 
@@ -195,6 +255,19 @@ public:
      */
     void ResetTerrainUpdateFlag();
     
+    /**
+     * @brief Number of chunks currently resident
+     */
+    size_t GetChunkCount() const { return m_chunks.size(); }
+    int GetChunkSize() const { return m_chunkSize; }
+    
+    /**
+     * @brief Row-major triangle list of a chunkSize x chunkSize vertex grid
+     * 
+     * The unoptimized layout, two triangles per cell; kept for comparisons.
+     */
+    static std::vector<unsigned int> GenerateGridIndices(int chunkSize);
+    
     /**
      * @brief Runtime parameter adjustment methods
      * 
@@ -215,10 +288,40 @@ private:
     
     // Chunk management
     std::vector<std::unique_ptr<TerrainChunk>> m_chunks;  // Active terrain chunks
+    std::unordered_map<int64_t, TerrainChunk*> m_chunkLookup;  // Chunk grid coordinates -> chunk
     glm::vec2 m_lastCenterPos;   // Last center position for change detection
     float m_renderDistance;      // Maximum distance for chunk visibility
     bool m_terrainUpdated;       // Flag indicating recent terrain changes
     
+    // Every chunk shares one grid topology, so it is optimized once
+    std::vector<unsigned int> m_gridIndices;        // Vertex-cache order over row-major vertices
+    std::vector<unsigned int> m_gridUploadIndices;  // Same triangles after the fetch remap
+    std::vector<unsigned int> m_gridVertexRemap;    // Row-major vertex -> slot in the GPU buffer
+    
+    // Chunk vertices sub-allocated from one buffer; the grid indices are stored once
+    GeometryPool m_geometryPool;
+    GeometryPool::Handle m_gridIndexBlock;
+    std::vector<DrawElementsIndirectCommand> m_drawCommands;   // Rebuilt every RenderTerrain()
+    std::vector<std::pair<float, DrawElementsIndirectCommand>> m_sortedCommands;   // Camera distance, command
+    
+    // Chunk bounds for GPU culling; rebuilt when chunks come or go or the pool repacks
+    GpuCulling::Batch m_cullBatch;
+    std::vector<CullItem> m_cullItems;
+    bool m_cullItemsDirty;
+    size_t m_cullPoolGeneration;
+    bool m_culled;                  // m_cullBatch holds commands for the current items
+    static constexpr size_t POOL_INITIAL_CHUNKS = 64;
+    
+    /**
+     * @brief Build the shared chunk index orders with MeshOptimizer
+     */
+    void BuildGridLayout();
+    
+    /**
+     * @brief Upload one bounds-and-command item per generated chunk for GPU culling
+     */
+    void RebuildCullItems();
+    
     // Core chunk generation pipeline
     /**
      * @brief Create new terrain chunk at specified grid coordinates
@@ -254,6 +357,30 @@ private:
      */
     void SetupChunkBuffers(TerrainChunk* chunk);
     
+    /**
+     * @brief Copy vertex heights and build the min/max pyramid for ray queries
+     * @param chunk Chunk whose vertices have been generated
+     */
+    void BuildHeightPyramid(TerrainChunk* chunk);
+    
+    // Ray queries against the height pyramid
+    const TerrainChunk* FindChunk(int chunkX, int chunkZ) const;
+    float SampleChunkHeight(const TerrainChunk& chunk, float x, float z) const;
+    bool RaycastHeightNode(const TerrainChunk& chunk, int level, int nodeX, int nodeZ,
+                           const glm::vec3& origin, const glm::vec3& direction,
+                           float tMin, float tMax, float& tHit, glm::vec3& normal) const;
+    bool RaycastCell(const TerrainChunk& chunk, int cellX, int cellZ,
+                     const glm::vec3& origin, const glm::vec3& direction,
+                     float tMin, float tMax, float& tHit, glm::vec3& normal) const;
+    bool ClipToCellBlock(const TerrainChunk& chunk, int level, int nodeX, int nodeZ,
+                         const glm::vec3& origin, const glm::vec3& direction,
+                         float& tMin, float& tMax) const;
+    int GetPyramidSide(int level) const;
+    
+    static int64_t ChunkKey(int chunkX, int chunkZ) {
+        return (static_cast<int64_t>(chunkX) << 32) | static_cast<uint32_t>(chunkZ);
+    }
+    
     // Noise generation and biome determination
     /**
      * @brief Generate height value using Perlin noise
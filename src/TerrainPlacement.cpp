@@ -98,18 +98,21 @@ glm::vec3 TerrainPlacement::FindNearbyFlatPosition(glm::vec3 center, TerrainGene
 float TerrainPlacement::GetAreaHeightVariation(glm::vec3 center, TerrainGenerator* terrain, float checkRadius) {
     if (!terrain) return 0.0f;
     
-    float centerHeight = terrain->GetHeightAt(center.x, center.z);
-    float maxDiff = 0.0f;
-    
-    
-    int checkPoints = 8;  
+    // Centre first, then a ring of points, fetched in one batch
+    const int checkPoints = 8;  
+    glm::vec2 positions[checkPoints + 1];
+    float heights[checkPoints + 1];
+    positions[0] = glm::vec2(center.x, center.z);
     for (int i = 0; i < checkPoints; i++) {
         float angle = (2.0f * M_PI * i) / checkPoints;
-        float checkX = center.x + checkRadius * cos(angle);
-        float checkZ = center.z + checkRadius * sin(angle);
-        
-        float checkHeight = terrain->GetHeightAt(checkX, checkZ);
-        float heightDiff = abs(checkHeight - centerHeight);
+        positions[i + 1] = glm::vec2(center.x + checkRadius * cos(angle), center.z + checkRadius * sin(angle));
+    }
+    terrain->GetHeightsAt(positions, heights);
+    
+    float centerHeight = heights[0];
+    float maxDiff = 0.0f;
+    for (int i = 1; i <= checkPoints; i++) {
+        float heightDiff = std::abs(heights[i] - centerHeight);
         maxDiff = glm::max(maxDiff, heightDiff);
     }
     
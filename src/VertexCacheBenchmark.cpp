@@ -0,0 +1,198 @@
+﻿/**
+ * @file VertexCacheBenchmark.cpp
+ * @brief Original vs optimized index order, measured on the GPU
+ */
+
+#include "VertexCacheBenchmark.h"
+#include "Model.h"
+#include "TerrainGenerator.h"
+#include <GLFW/glfw3.h>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+VertexCacheBenchmark::VertexCacheBenchmark()
+    : m_timeQuery(0)
+    , m_statisticsQuery(0)
+    , m_hasStatistics(false)
+{
+}
+
+void VertexCacheBenchmark::AddMesh(const std::string& name, std::vector<glm::vec3> positions,
+                                   std::vector<unsigned int> indices) {
+    if (positions.empty() || indices.size() < 3) {
+        return;
+    }
+    m_meshes.push_back({ name, std::move(positions), std::move(indices) });
+}
+
+void VertexCacheBenchmark::AddTerrainGrid(int chunkSize) {
+    std::vector<glm::vec3> positions;
+    positions.reserve(static_cast<size_t>(chunkSize) * chunkSize);
+    for (int z = 0; z < chunkSize; z++) {
+        for (int x = 0; x < chunkSize; x++) {
+            positions.emplace_back(static_cast<float>(x), 0.0f, static_cast<float>(z));
+        }
+    }
+    AddMesh("terrain grid " + std::to_string(chunkSize) + "x" + std::to_string(chunkSize),
+            std::move(positions), TerrainGenerator::GenerateGridIndices(chunkSize));
+}
+
+bool VertexCacheBenchmark::AddModelFile(const std::string& path) {
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, Model::DEFAULT_IMPORT_FLAGS);
+    if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+        std::cerr << "[VertexCacheBenchmark] Could not import " << path << std::endl;
+        return false;
+    }
+
+    std::string fileName = path.substr(path.find_last_of('/') + 1);
+    for (unsigned int m = 0; m < scene->mNumMeshes; m++) {
+        const aiMesh* mesh = scene->mMeshes[m];
+        std::vector<glm::vec3> positions(mesh->mNumVertices);
+        for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
+            positions[i] = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+        }
+
+        std::vector<unsigned int> indices;
+        indices.reserve(static_cast<size_t>(mesh->mNumFaces) * 3);
+        for (unsigned int f = 0; f < mesh->mNumFaces; f++) {
+            const aiFace& face = mesh->mFaces[f];
+            if (face.mNumIndices == 3) {
+                indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+            }
+        }
+
+        std::string name = scene->mNumMeshes > 1 ? fileName + "#" + std::to_string(m) : fileName;
+        AddMesh(name, std::move(positions), std::move(indices));
+    }
+    return true;
+}
+
+const std::vector<VertexCacheBenchmark::Result>& VertexCacheBenchmark::Run(Shader& shader) {
+    m_results.clear();
+    m_hasStatistics = glfwExtensionSupported("GL_ARB_pipeline_statistics_query") != 0;
+    if (!m_hasStatistics) {
+        std::cout << "[VertexCacheBenchmark] GL_ARB_pipeline_statistics_query not available; "
+                  << "reporting GPU time and the cache model only" << std::endl;
+    }
+
+    glGenQueries(1, &m_timeQuery);
+    if (m_hasStatistics) {
+        glGenQueries(1, &m_statisticsQuery);
+    }
+
+    shader.Use();
+    shader.SetMat4("lightSpaceMatrix", glm::mat4(1.0f));
+    shader.SetMat4("model", glm::mat4(1.0f));
+    glEnable(GL_RASTERIZER_DISCARD);
+
+    for (const TestMesh& mesh : m_meshes) {
+        Result result{};
+        result.name = mesh.name;
+
+        // Same steps as MeshOptimizer::Optimize(), on bare positions
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<unsigned int> indices = mesh.indices;
+        std::vector<glm::vec3> positions = mesh.positions;
+        MeshOptimizer::OptimizeVertexCache(indices, positions.size());
+        MeshOptimizer::OptimizeOverdraw(indices, positions);
+        std::vector<unsigned int> remap;
+        size_t vertexCount = MeshOptimizer::OptimizeVertexFetch(indices, positions.size(), remap);
+        MeshOptimizer::RemapVertices(positions, remap, vertexCount);
+        result.optimizeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+        result.before = MeshOptimizer::AnalyzeVertexCache(mesh.indices, mesh.positions.size());
+        result.after = MeshOptimizer::AnalyzeVertexCache(indices, positions.size());
+
+        Measure(mesh.positions, mesh.indices, result.invocationsBefore, result.gpuTimeBeforeMs);
+        Measure(positions, indices, result.invocationsAfter, result.gpuTimeAfterMs);
+        m_results.push_back(result);
+    }
+
+    glDisable(GL_RASTERIZER_DISCARD);
+    glDeleteQueries(1, &m_timeQuery);
+    if (m_statisticsQuery != 0) {
+        glDeleteQueries(1, &m_statisticsQuery);
+    }
+    m_timeQuery = 0;
+    m_statisticsQuery = 0;
+
+    PrintResults();
+    return m_results;
+}
+
+void VertexCacheBenchmark::Measure(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+                                   uint64_t& invocations, float& gpuTimeMs) {
+    GLuint vao, vbo, ebo;
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(glm::vec3), positions.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    GLsizei indexCount = static_cast<GLsizei>(indices.size());
+
+    // Warm-up draw so buffer creation is not timed
+    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+
+    glBeginQuery(GL_TIME_ELAPSED, m_timeQuery);
+    if (m_hasStatistics) {
+        glBeginQuery(VERTEX_SHADER_INVOCATIONS, m_statisticsQuery);
+    }
+    for (int i = 0; i < DRAWS_PER_SAMPLE; i++) {
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+    }
+    if (m_hasStatistics) {
+        glEndQuery(VERTEX_SHADER_INVOCATIONS);
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+
+    // Blocking read; acceptable for a one-shot benchmark
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(m_timeQuery, GL_QUERY_RESULT, &elapsed);
+    gpuTimeMs = static_cast<float>(elapsed) / 1.0e6f / DRAWS_PER_SAMPLE;
+
+    invocations = 0;
+    if (m_hasStatistics) {
+        GLuint64 count = 0;
+        glGetQueryObjectui64v(m_statisticsQuery, GL_QUERY_RESULT, &count);
+        invocations = count / DRAWS_PER_SAMPLE;
+    }
+
+    glBindVertexArray(0);
+    glDeleteVertexArrays(1, &vao);
+    glDeleteBuffers(1, &vbo);
+    glDeleteBuffers(1, &ebo);
+}
+
+void VertexCacheBenchmark::PrintResults() const {
+    std::cout << "\n=== Vertex Cache Benchmark (FIFO model: " << MeshOptimizer::CACHE_SIZE << " entries) ===" << std::endl;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %8s %8s  %13s  %13s  %17s  %15s  %7s",
+                  "Mesh", "Tris", "Verts", "ACMR", "ATVR", "VS invocations", "GPU ms/draw", "Opt ms");
+    std::cout << line << std::endl;
+
+    for (const Result& result : m_results) {
+        char invocations[32];
+        if (m_hasStatistics) {
+            std::snprintf(invocations, sizeof(invocations), "%7llu->%-7llu",
+                          static_cast<unsigned long long>(result.invocationsBefore),
+                          static_cast<unsigned long long>(result.invocationsAfter));
+        } else {
+            std::snprintf(invocations, sizeof(invocations), "n/a");
+        }
+        std::snprintf(line, sizeof(line), "%-24s %8zu %8zu  %5.3f->%-5.3f  %5.3f->%-5.3f  %17s  %6.3f->%-6.3f  %7.2f",
+                      result.name.c_str(), result.before.triangles, result.before.vertices,
+                      result.before.GetACMR(), result.after.GetACMR(),
+                      result.before.GetATVR(), result.after.GetATVR(),
+                      invocations, result.gpuTimeBeforeMs, result.gpuTimeAfterMs, result.optimizeMs);
+        std::cout << line << std::endl;
+    }
+}
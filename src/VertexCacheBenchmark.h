@@ -0,0 +1,89 @@
+﻿/**
+ * @file VertexCacheBenchmark.h
+ * @brief Vertex shader invocation benchmark for MeshOptimizer
+ *
+ * Draws every test mesh with its original index order and with the
+ * MeshOptimizer order and reports, per order:
+ * - Vertex shader invocations counted by the GPU, when the driver exposes
+ *   ARB_pipeline_statistics_query
+ * - GPU time per draw (GL_TIME_ELAPSED queries)
+ * - ACMR/ATVR predicted by the FIFO cache model
+ *
+ * Rasterization is discarded while measuring, so only the vertex stage
+ * does work and the frame being rendered is unaffected.
+ */
+
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MeshOptimizer.h"
+#include "Shader.h"
+
+/**
+ * @brief One-shot, blocking comparison of index orders
+ *
+ * Add meshes, then call Run() on the GL thread with a shader that reads
+ * positions from attribute 0.
+ */
+class VertexCacheBenchmark {
+public:
+    /**
+     * @brief Per-mesh benchmark result
+     */
+    struct Result {
+        std::string name;
+        MeshOptimizer::CacheStats before;       // FIFO model, original order
+        MeshOptimizer::CacheStats after;        // FIFO model, optimized order
+        uint64_t invocationsBefore;             // Per draw; 0 without the statistics query
+        uint64_t invocationsAfter;
+        float gpuTimeBeforeMs;                  // Per draw
+        float gpuTimeAfterMs;
+        float optimizeMs;                       // CPU time of the full optimization
+    };
+
+    VertexCacheBenchmark();
+
+    void AddMesh(const std::string& name, std::vector<glm::vec3> positions, std::vector<unsigned int> indices);
+
+    /**
+     * @brief Add a flat chunkSize x chunkSize grid in the terrain's row-major layout
+     */
+    void AddTerrainGrid(int chunkSize);
+
+    /**
+     * @brief Import every triangle mesh of a model file, skipping the cooked cache
+     * @return False if ASSIMP could not read the file
+     */
+    bool AddModelFile(const std::string& path);
+
+    /**
+     * @brief Measure every added mesh and print a table
+     */
+    const std::vector<Result>& Run(Shader& shader);
+
+    const std::vector<Result>& GetResults() const { return m_results; }
+
+private:
+    struct TestMesh {
+        std::string name;
+        std::vector<glm::vec3> positions;
+        std::vector<unsigned int> indices;
+    };
+
+    void Measure(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices,
+                 uint64_t& invocations, float& gpuTimeMs);
+    void PrintResults() const;
+
+    std::vector<TestMesh> m_meshes;
+    std::vector<Result> m_results;
+    GLuint m_timeQuery;
+    GLuint m_statisticsQuery;
+    bool m_hasStatistics;
+
+    static constexpr int DRAWS_PER_SAMPLE = 32;
+    static constexpr GLenum VERTEX_SHADER_INVOCATIONS = 0x82F0;     // GL_VERTEX_SHADER_INVOCATIONS_ARB
+};